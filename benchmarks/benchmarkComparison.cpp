@@ -0,0 +1,214 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ */
+
+
+#include <boost/test/unit_test.hpp>
+
+
+#include <iostream>
+#include <exception>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * Equality and tolerance checks of matrices
+ */
+#include "benchmarkFramework.hpp"
+#include "Matrix.hpp"
+
+BOOST_AUTO_TEST_SUITE( Comparison )
+
+/// Bytes read by one comparison of two size x size matrices
+template<typename T>
+inline size_t compareBytes(const size_t size) {
+  return 2*size*size*sizeof(T);
+}
+
+/// Comparison of two equal matrices, which must be scanned completely
+template<typename T>
+class benchCompare {
+protected:
+  /// Matrices to compare
+  anpi::Matrix<T> _a,_b;
+
+  /// Result, kept to avoid optimizing the comparison away
+  volatile bool _result;
+public:
+  /// Construct
+  benchCompare(const size_t) : _result(false) {}
+
+  /// Prepare the evaluation of given size
+  void prepare(const size_t size) {
+    _a = anpi::Matrix<T>(size,size,anpi::DoNotInitialize);
+    for (size_t r=0;r<size;++r) {
+      for (size_t c=0;c<size;++c) {
+        _a(r,c) = T((r*7+c*3)%17)/T(16);
+      }
+    }
+    _b = _a;
+  }
+};
+
+/// The former operator==: memcmp of whole rows
+template<typename T>
+class benchCompareMemcmp : public benchCompare<T> {
+public:
+  /// Constructor
+  benchCompareMemcmp(const size_t n) : benchCompare<T>(n) { }
+
+  // Evaluate the comparison
+  inline void eval() {
+    bool eq = true;
+    for (size_t r=0;eq && r<this->_a.rows();++r) {
+      eq = std::memcmp(this->_a[r],this->_b[r],
+                       this->_a.cols()*sizeof(T)) == 0;
+    }
+    this->_result = eq;
+  }
+};
+
+/// Hand-written elementwise loop with early exit
+template<typename T>
+class benchCompareLoop : public benchCompare<T> {
+public:
+  /// Constructor
+  benchCompareLoop(const size_t n) : benchCompare<T>(n) { }
+
+  // Evaluate the comparison
+  inline void eval() {
+    bool eq = true;
+    for (size_t r=0;eq && r<this->_a.rows();++r) {
+      for (size_t c=0;c<this->_a.cols();++c) {
+        if (this->_a(r,c) != this->_b(r,c)) {
+          eq = false;
+          break;
+        }
+      }
+    }
+    this->_result = eq;
+  }
+};
+
+/// SIMD operator==
+template<typename T>
+class benchCompareSIMD : public benchCompare<T> {
+public:
+  /// Constructor
+  benchCompareSIMD(const size_t n) : benchCompare<T>(n) { }
+
+  // Evaluate the comparison
+  inline void eval() {
+    this->_result = (this->_a == this->_b);
+  }
+};
+
+/// Hand-written tolerance loop
+template<typename T>
+class benchCloseLoop : public benchCompare<T> {
+public:
+  /// Constructor
+  benchCloseLoop(const size_t n) : benchCompare<T>(n) { }
+
+  // Evaluate the comparison
+  inline void eval() {
+    const T rtol = T(1.0e-5), atol = T(1.0e-8);
+    bool close = true;
+    for (size_t r=0;close && r<this->_a.rows();++r) {
+      for (size_t c=0;c<this->_a.cols();++c) {
+        const T a = this->_a(r,c), b = this->_b(r,c);
+        if (std::abs(a-b) > atol + rtol*std::abs(b)) {
+          close = false;
+          break;
+        }
+      }
+    }
+    this->_result = close;
+  }
+};
+
+/// SIMD allclose()
+template<typename T>
+class benchCloseSIMD : public benchCompare<T> {
+public:
+  /// Constructor
+  benchCloseSIMD(const size_t n) : benchCompare<T>(n) { }
+
+  // Evaluate the comparison
+  inline void eval() {
+    this->_result = anpi::allclose(this->_a,this->_b);
+  }
+};
+
+/// SIMD maxUlpDistance()
+template<typename T>
+class benchUlpSIMD : public benchCompare<T> {
+public:
+  /// Constructor
+  benchUlpSIMD(const size_t n) : benchCompare<T>(n) { }
+
+  // Evaluate the comparison
+  inline void eval() {
+    this->_result = (anpi::maxUlpDistance(this->_a,this->_b) == 0);
+  }
+};
+
+/// Benchmark one comparison and plot its throughput
+template<typename T,template<typename> class Bench>
+void runCompare(const std::vector<size_t>& sizes,
+                const std::string& name,
+                const std::string& legend,
+                const char* color) {
+  const size_t repetitions=20;
+  std::vector<anpi::benchmark::measurement> times,rates;
+
+  Bench<T> bench(0);
+  ANPI_BENCHMARK(sizes,repetitions,times,bench);
+  ::anpi::benchmark::computeRates(times,compareBytes<T>,rates);
+  ::anpi::benchmark::write(name,rates);
+  ::anpi::benchmark::plotRange(rates,legend,color);
+}
+
+BOOST_AUTO_TEST_CASE( Equality ) {
+
+  std::vector<size_t> sizes = {  24,  32,  48,  64,  96, 128, 192, 256,
+                                384, 512, 768,1024,1536,2048 };
+
+  runCompare<double,benchCompareMemcmp>(sizes,"cmp_double_memcmp.txt",
+                                        "memcmp rows (double) [GB/s]","r");
+  runCompare<double,benchCompareLoop>(sizes,"cmp_double_loop.txt",
+                                      "elementwise loop (double) [GB/s]","m");
+  runCompare<double,benchCompareSIMD>(sizes,"cmp_double_simd.txt",
+                                      "operator== (double) [GB/s]","b");
+  runCompare<float,benchCompareSIMD>(sizes,"cmp_float_simd.txt",
+                                     "operator== (float) [GB/s]","c");
+
+  ::anpi::benchmark::show();
+}
+
+BOOST_AUTO_TEST_CASE( Tolerance ) {
+
+  std::vector<size_t> sizes = {  24,  32,  48,  64,  96, 128, 192, 256,
+                                384, 512, 768,1024,1536,2048 };
+
+  runCompare<double,benchCloseLoop>(sizes,"close_double_loop.txt",
+                                    "tolerance loop (double) [GB/s]","r");
+  runCompare<double,benchCloseSIMD>(sizes,"close_double_simd.txt",
+                                    "allclose (double) [GB/s]","b");
+  runCompare<double,benchUlpSIMD>(sizes,"ulp_double_simd.txt",
+                                  "maxUlpDistance (double) [GB/s]","g");
+  runCompare<float,benchCloseSIMD>(sizes,"close_float_simd.txt",
+                                   "allclose (float) [GB/s]","c");
+  runCompare<float,benchUlpSIMD>(sizes,"ulp_float_simd.txt",
+                                 "maxUlpDistance (float) [GB/s]","y");
+
+  ::anpi::benchmark::show();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
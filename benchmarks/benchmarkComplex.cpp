@@ -0,0 +1,139 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ */
+
+
+#include <boost/test/unit_test.hpp>
+
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <complex>
+#include <string>
+#include <vector>
+
+/**
+ * Elementwise operations on complex matrices
+ */
+#include "benchmarkFramework.hpp"
+#include "Matrix.hpp"
+
+BOOST_AUTO_TEST_SUITE( Complex )
+
+/// Complex operations to benchmark
+enum class ComplexOp { Add, Hadamard, Conjugate, Magnitude };
+
+/// Bytes read and written by one operation on size x size matrices
+template<typename R>
+struct complexBytes {
+  ComplexOp _op;
+  complexBytes(const ComplexOp op) : _op(op) {}
+  inline size_t operator()(const size_t size) const {
+    const size_t c = sizeof(std::complex<R>);
+    switch (_op) {
+    case ComplexOp::Add:
+    case ComplexOp::Hadamard:  return 3*size*size*c;
+    case ComplexOp::Conjugate: return 2*size*size*c;
+    default:                   return size*size*(c+sizeof(R));
+    }
+  }
+};
+
+/// Operation on size x size complex matrices
+template<typename R,bool Simd>
+class benchComplex {
+protected:
+  /// Operation to benchmark
+  ComplexOp _op;
+
+  /// Operands
+  anpi::Matrix< std::complex<R> > _a,_b,_c;
+
+  /// Magnitudes
+  anpi::Matrix<R> _m;
+public:
+  /// Construct
+  benchComplex(const ComplexOp op) : _op(op) {}
+
+  /// Prepare the evaluation of given size
+  void prepare(const size_t size) {
+    typedef std::complex<R> C;
+    _a = anpi::Matrix<C>(size,size,anpi::DoNotInitialize);
+    _b = anpi::Matrix<C>(size,size,anpi::DoNotInitialize);
+    for (size_t r=0;r<size;++r) {
+      for (size_t c=0;c<size;++c) {
+        _a(r,c) = C(R((r*7+c*3)%17)/R(16),R((r+c)%5)-R(2));
+        _b(r,c) = C(R((r*5+c*11)%13)/R(12),R((r*3+c)%7)/R(6));
+      }
+    }
+  }
+
+  /// Evaluate the operation
+  inline void eval() {
+    if (Simd) {
+      switch (_op) {
+      case ComplexOp::Add:       anpi::simd::add(_a,_b,_c);      break;
+      case ComplexOp::Hadamard:  anpi::simd::hadamard(_a,_b,_c); break;
+      case ComplexOp::Conjugate: anpi::simd::conjugate(_a,_c);   break;
+      default:                   anpi::simd::magnitude(_a,_m);
+      }
+    } else {
+      switch (_op) {
+      case ComplexOp::Add:       anpi::fallback::add(_a,_b,_c);      break;
+      case ComplexOp::Hadamard:  anpi::fallback::hadamard(_a,_b,_c); break;
+      case ComplexOp::Conjugate: anpi::fallback::conjugate(_a,_c);   break;
+      default:                   anpi::fallback::magnitude(_a,_m);
+      }
+    }
+  }
+};
+
+/// Fallback and SIMD versions of one operation
+template<typename R>
+void compareComplex(const ComplexOp op,
+                    const std::string& tag,
+                    const std::vector<size_t>& sizes) {
+  const size_t repetitions=20;
+  {
+    std::vector<anpi::benchmark::measurement> times,rates;
+    benchComplex<R,false> b(op);
+    ANPI_BENCHMARK(sizes,repetitions,times,b);
+    ::anpi::benchmark::computeRates(times,complexBytes<R>(op),rates);
+    ::anpi::benchmark::write(tag+"_fallback.txt",rates);
+    ::anpi::benchmark::plotRange(rates,tag+" fallback [GB/s]","r");
+  }
+  {
+    std::vector<anpi::benchmark::measurement> times,rates;
+    benchComplex<R,true> b(op);
+    ANPI_BENCHMARK(sizes,repetitions,times,b);
+    ::anpi::benchmark::computeRates(times,complexBytes<R>(op),rates);
+    ::anpi::benchmark::write(tag+"_simd.txt",rates);
+    ::anpi::benchmark::plotRange(rates,tag+" simd [GB/s]","b");
+  }
+}
+
+BOOST_AUTO_TEST_CASE( Elementwise ) {
+
+  std::vector<size_t> sizes = {  24,  32,  48,  64,  96, 128, 192, 256,
+                                384, 512, 768,1024 };
+
+  compareComplex<double>(ComplexOp::Add,"cadd_double",sizes);
+  ::anpi::benchmark::show();
+
+  compareComplex<double>(ComplexOp::Hadamard,"chadamard_double",sizes);
+  compareComplex<float>(ComplexOp::Hadamard,"chadamard_float",sizes);
+  ::anpi::benchmark::show();
+
+  compareComplex<double>(ComplexOp::Conjugate,"cconj_double",sizes);
+  ::anpi::benchmark::show();
+
+  compareComplex<double>(ComplexOp::Magnitude,"cabs_double",sizes);
+  compareComplex<float>(ComplexOp::Magnitude,"cabs_float",sizes);
+  ::anpi::benchmark::show();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,167 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ */
+
+
+#include <boost/test/unit_test.hpp>
+
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <functional>
+#include <string>
+
+/**
+ * Benchmarks for the elementwise kernels
+ */
+#include "benchmarkFramework.hpp"
+#include "Matrix.hpp"
+#include "Allocator.hpp"
+
+BOOST_AUTO_TEST_SUITE( Elementwise )
+
+/**
+ * Benchmark for one elementwise kernel.
+ *
+ * The kernel receives the destination matrix first.  For in-place
+ * kernels the destination is initialized with a copy of the first
+ * operand.
+ */
+template<typename T>
+class benchElementwise {
+public:
+  typedef anpi::Matrix<T> matrix_type;
+  typedef std::function<void(matrix_type&,
+                             const matrix_type&,
+                             const matrix_type&)> kernel_type;
+protected:
+  /// Maximum allowed size for the square matrices
+  const size_t _maxSize;
+
+  /// Kernel being evaluated
+  kernel_type _kernel;
+
+  /// State of the benchmarked evaluation
+  matrix_type _a;
+  matrix_type _b;
+  matrix_type _c;
+public:
+  /// Construct
+  benchElementwise(const size_t maxSize,const kernel_type& kernel)
+    : _maxSize(maxSize),_kernel(kernel) {}
+
+  /// Prepare the evaluation of given size
+  void prepare(const size_t size) {
+    assert (size<=this->_maxSize);
+    this->_a.allocate(size,size);
+    this->_b.allocate(size,size);
+    for (size_t r=0;r<size;++r) {
+      for (size_t c=0;c<size;++c) {
+        this->_a(r,c)=T(1)+T((r+c)%7)/T(8);
+        this->_b(r,c)=T(1)+T((r*c)%5)/T(8);
+      }
+    }
+    this->_c=this->_a;
+  }
+
+  // Evaluate the kernel
+  inline void eval() {
+    this->_kernel(this->_c,this->_a,this->_b);
+  }
+};
+
+/// Measure one kernel and report it
+template<typename T>
+void measure(const std::vector<size_t>& sizes,
+             const typename benchElementwise<T>::kernel_type& kernel,
+             const std::string& name,
+             const std::string& color) {
+  const size_t repetitions=100;
+  std::vector<anpi::benchmark::measurement> times;
+
+  benchElementwise<T> be(sizes.back(),kernel);
+
+  ANPI_BENCHMARK(sizes,repetitions,times,be);
+
+  ::anpi::benchmark::write(name + ".txt",times);
+  ::anpi::benchmark::plotRange(times,name,color);
+}
+
+BOOST_AUTO_TEST_CASE( Kernels ) {
+
+  std::vector<size_t> sizes = {  24,  32,  48,  64,
+                                 96, 128, 192, 256,
+                                384, 512, 768,1024,
+                               1536,2048};
+
+  typedef anpi::Matrix<float> M;
+  const float alpha=0.5f;
+
+  // Subtraction
+  measure<float>(sizes,[](M& c,const M& a,const M& b) {
+      anpi::fallback::subtract(a,b,c); },"subtract_on_copy_float_fb","r");
+  measure<float>(sizes,[](M& c,const M& a,const M& b) {
+      anpi::simd::subtract(a,b,c); },"subtract_on_copy_float_simd","g");
+  measure<float>(sizes,[](M& c,const M&,const M& b) {
+      anpi::fallback::subtract(c,b); },"subtract_in_place_float_fb","b");
+  measure<float>(sizes,[](M& c,const M&,const M& b) {
+      anpi::simd::subtract(c,b); },"subtract_in_place_float_simd","m");
+
+  // Hadamard product
+  measure<float>(sizes,[](M& c,const M& a,const M& b) {
+      anpi::fallback::hadamard(a,b,c); },"hadamard_on_copy_float_fb","r");
+  measure<float>(sizes,[](M& c,const M& a,const M& b) {
+      anpi::simd::hadamard(a,b,c); },"hadamard_on_copy_float_simd","g");
+  measure<float>(sizes,[](M& c,const M&,const M& b) {
+      anpi::fallback::hadamard(c,b); },"hadamard_in_place_float_fb","b");
+  measure<float>(sizes,[](M& c,const M&,const M& b) {
+      anpi::simd::hadamard(c,b); },"hadamard_in_place_float_simd","m");
+
+  // Division
+  measure<float>(sizes,[](M& c,const M& a,const M& b) {
+      anpi::fallback::divide(a,b,c); },"divide_on_copy_float_fb","r");
+  measure<float>(sizes,[](M& c,const M& a,const M& b) {
+      anpi::simd::divide(a,b,c); },"divide_on_copy_float_simd","g");
+  measure<float>(sizes,[](M& c,const M&,const M& b) {
+      anpi::fallback::divide(c,b); },"divide_in_place_float_fb","b");
+  measure<float>(sizes,[](M& c,const M&,const M& b) {
+      anpi::simd::divide(c,b); },"divide_in_place_float_simd","m");
+
+  // Scaling
+  measure<float>(sizes,[alpha](M& c,const M& a,const M&) {
+      anpi::fallback::scale(a,alpha,c); },"scale_on_copy_float_fb","r");
+  measure<float>(sizes,[alpha](M& c,const M& a,const M&) {
+      anpi::simd::scale(a,alpha,c); },"scale_on_copy_float_simd","g");
+  measure<float>(sizes,[alpha](M& c,const M&,const M&) {
+      anpi::fallback::scale(c,alpha); },"scale_in_place_float_fb","b");
+  measure<float>(sizes,[alpha](M& c,const M&,const M&) {
+      anpi::simd::scale(c,alpha); },"scale_in_place_float_simd","m");
+
+  // axpy
+  measure<float>(sizes,[alpha](M& c,const M& a,const M& b) {
+      anpi::fallback::axpy(alpha,a,b,c); },"axpy_on_copy_float_fb","r");
+  measure<float>(sizes,[alpha](M& c,const M& a,const M& b) {
+      anpi::simd::axpy(alpha,a,b,c); },"axpy_on_copy_float_simd","g");
+  measure<float>(sizes,[alpha](M& c,const M&,const M& b) {
+      anpi::fallback::axpy(alpha,b,c); },"axpy_in_place_float_fb","b");
+  measure<float>(sizes,[alpha](M& c,const M&,const M& b) {
+      anpi::simd::axpy(alpha,b,c); },"axpy_in_place_float_simd","m");
+
+  // Fused multiply-add
+  measure<float>(sizes,[](M& c,const M& a,const M& b) {
+      anpi::fallback::fma(a,b,a,c); },"fma_on_copy_float_fb","r");
+  measure<float>(sizes,[](M& c,const M& a,const M& b) {
+      anpi::simd::fma(a,b,a,c); },"fma_on_copy_float_simd","g");
+  measure<float>(sizes,[](M& c,const M& a,const M& b) {
+      anpi::fallback::fma(c,b,a); },"fma_in_place_float_fb","b");
+  measure<float>(sizes,[](M& c,const M& a,const M& b) {
+      anpi::simd::fma(c,b,a); },"fma_in_place_float_simd","m");
+
+  ::anpi::benchmark::show();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
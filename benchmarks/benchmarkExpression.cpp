@@ -0,0 +1,143 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ */
+
+
+#include <boost/test/unit_test.hpp>
+
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+
+/**
+ * Benchmarks for the lazily evaluated matrix expressions
+ */
+#include "benchmarkFramework.hpp"
+#include "Matrix.hpp"
+#include "Allocator.hpp"
+
+BOOST_AUTO_TEST_SUITE( Expression )
+
+/// Benchmark for the chain e = a + b - c + d
+template<typename T>
+class benchChain {
+protected:
+  /// Maximum allowed size for the square matrices
+  const size_t _maxSize;
+
+  /// State of the benchmarked evaluation
+  anpi::Matrix<T> _a;
+  anpi::Matrix<T> _b;
+  anpi::Matrix<T> _c;
+  anpi::Matrix<T> _d;
+  anpi::Matrix<T> _e;
+public:
+  /// Construct
+  benchChain(const size_t maxSize) : _maxSize(maxSize) {}
+
+  /// Prepare the evaluation of given size
+  void prepare(const size_t size) {
+    assert (size<=this->_maxSize);
+    this->_a.allocate(size,size);
+    for (size_t r=0;r<size;++r) {
+      for (size_t c=0;c<size;++c) {
+        this->_a(r,c)=T((r+c)%7);
+      }
+    }
+    this->_b=this->_a;
+    this->_c=this->_a;
+    this->_d=this->_a;
+  }
+};
+
+/// Fused evaluation through expression templates
+template<typename T>
+class benchChainFused : public benchChain<T> {
+public:
+  /// Constructor
+  benchChainFused(const size_t n) : benchChain<T>(n) { }
+
+  // Evaluate the chain in one pass
+  inline void eval() {
+    this->_e = this->_a + this->_b - this->_c + this->_d;
+  }
+};
+
+/// Unfused evaluation, creating one temporary per operator
+template<typename T>
+class benchChainUnfused : public benchChain<T> {
+public:
+  /// Constructor
+  benchChainUnfused(const size_t n) : benchChain<T>(n) { }
+
+  // Evaluate the chain as three separate kernels
+  inline void eval() {
+    anpi::Matrix<T> t1,t2;
+    anpi::simd::add(this->_a,this->_b,t1);
+    anpi::simd::subtract(t1,this->_c,t2);
+    anpi::simd::add(t2,this->_d,this->_e);
+  }
+};
+
+/// Unfused evaluation, reusing preallocated temporaries
+template<typename T>
+class benchChainUnfusedNoAlloc : public benchChain<T> {
+  anpi::Matrix<T> _t;
+public:
+  /// Constructor
+  benchChainUnfusedNoAlloc(const size_t n) : benchChain<T>(n) { }
+
+  // Evaluate the chain as three separate kernels
+  inline void eval() {
+    anpi::simd::add(this->_a,this->_b,this->_t);
+    anpi::simd::subtract(this->_t,this->_c);
+    anpi::simd::add(this->_t,this->_d,this->_e);
+  }
+};
+
+BOOST_AUTO_TEST_CASE( Chain ) {
+
+  std::vector<size_t> sizes = {  24,  32,  48,  64,
+                                 96, 128, 192, 256,
+                                384, 512, 768,1024,
+                               1536,2048,3072,4096};
+
+  const size_t n=sizes.back();
+  const size_t repetitions=20;
+  std::vector<anpi::benchmark::measurement> times;
+
+  {
+    benchChainUnfused<float> bc(n);
+
+    ANPI_BENCHMARK(sizes,repetitions,times,bc);
+
+    ::anpi::benchmark::write("chain_float_unfused.txt",times);
+    ::anpi::benchmark::plotRange(times,"a+b-c+d (float) unfused","r");
+  }
+
+  {
+    benchChainUnfusedNoAlloc<float> bc(n);
+
+    ANPI_BENCHMARK(sizes,repetitions,times,bc);
+
+    ::anpi::benchmark::write("chain_float_unfused_noalloc.txt",times);
+    ::anpi::benchmark::plotRange(times,"a+b-c+d (float) unfused, no alloc","b");
+  }
+
+  {
+    benchChainFused<float> bc(n);
+
+    ANPI_BENCHMARK(sizes,repetitions,times,bc);
+
+    ::anpi::benchmark::write("chain_float_fused.txt",times);
+    ::anpi::benchmark::plotRange(times,"a+b-c+d (float) fused","g");
+  }
+
+  ::anpi::benchmark::show();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,154 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ */
+
+
+#include <boost/test/unit_test.hpp>
+
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <vector>
+
+/**
+ * Benchmarks for the Cholesky and QR decompositions
+ */
+#include "benchmarkFramework.hpp"
+#include "Matrix.hpp"
+#include "CholeskyDecomposition.hpp"
+#include "QRDecomposition.hpp"
+
+BOOST_AUTO_TEST_SUITE( Factorizations )
+
+/// Common state of the factorization benchmarks
+template<typename T>
+class benchFactorization {
+protected:
+  /// Matrix to decompose
+  anpi::Matrix<T> _a;
+
+  /// Factors
+  anpi::Matrix<T> _f;
+
+  /// Householder scalars
+  std::vector<T> _tau;
+public:
+  /// Construct
+  benchFactorization(const size_t) {}
+
+  /// Prepare a symmetric, diagonally dominant matrix of given size
+  void prepare(const size_t size) {
+    _a = anpi::Matrix<T>(size,size,anpi::DoNotInitialize);
+    for (size_t r=0;r<size;++r) {
+      for (size_t c=0;c<size;++c) {
+        _a(r,c)=T((r*7+c*7)%17)/T(16) + ((r==c) ? T(size) : T(0));
+      }
+    }
+  }
+};
+
+/// Unblocked Cholesky
+template<typename T>
+class benchCholeskyUnblocked : public benchFactorization<T> {
+public:
+  benchCholeskyUnblocked(const size_t n) : benchFactorization<T>(n) { }
+  inline void eval() { anpi::choleskyUnblocked(this->_a,this->_f); }
+};
+
+/// Blocked Cholesky
+template<typename T>
+class benchCholeskyBlocked : public benchFactorization<T> {
+public:
+  benchCholeskyBlocked(const size_t n) : benchFactorization<T>(n) { }
+  inline void eval() { anpi::cholesky(this->_a,this->_f); }
+};
+
+/// Unblocked QR
+template<typename T>
+class benchQRUnblocked : public benchFactorization<T> {
+public:
+  benchQRUnblocked(const size_t n) : benchFactorization<T>(n) { }
+  inline void eval() { anpi::qrUnblocked(this->_a,this->_f,this->_tau); }
+};
+
+/// Blocked QR
+template<typename T>
+class benchQRBlocked : public benchFactorization<T> {
+public:
+  benchQRBlocked(const size_t n) : benchFactorization<T>(n) { }
+  inline void eval() { anpi::qr(this->_a,this->_f,this->_tau); }
+};
+
+/// Floating point operations of the Cholesky decomposition
+inline double choleskyFlops(const size_t n) {
+  return 1.0/3.0*double(n)*double(n)*double(n);
+}
+
+/// Floating point operations of the QR decomposition of a square matrix
+inline double qrFlops(const size_t n) {
+  return 4.0/3.0*double(n)*double(n)*double(n);
+}
+
+/// Run one benchmark and plot its rate
+template<class B,class F>
+void runFactorization(const std::vector<size_t>& sizes,
+                      F flops,
+                      const std::string& file,
+                      const std::string& legend,
+                      const std::string& color) {
+  const size_t repetitions=3;
+  std::vector<anpi::benchmark::measurement> times,gflops;
+  B b(0);
+  ANPI_BENCHMARK(sizes,repetitions,times,b);
+  ::anpi::benchmark::computeRates(times,flops,gflops);
+  ::anpi::benchmark::write(file,gflops);
+  ::anpi::benchmark::plotRange(gflops,legend,color);
+}
+
+BOOST_AUTO_TEST_CASE( Cholesky ) {
+
+  std::vector<size_t> sizes = {  64,  96, 128, 192, 256, 384,
+                                512, 768,1024,1536,2048,3072 };
+
+  runFactorization< benchCholeskyUnblocked<float> >
+    (sizes,choleskyFlops,"cholesky_float_unblocked.txt",
+     "Cholesky (float) unblocked [GFLOP/s]","r");
+  runFactorization< benchCholeskyBlocked<float> >
+    (sizes,choleskyFlops,"cholesky_float_blocked.txt",
+     "Cholesky (float) blocked [GFLOP/s]","g");
+  runFactorization< benchCholeskyUnblocked<double> >
+    (sizes,choleskyFlops,"cholesky_double_unblocked.txt",
+     "Cholesky (double) unblocked [GFLOP/s]","m");
+  runFactorization< benchCholeskyBlocked<double> >
+    (sizes,choleskyFlops,"cholesky_double_blocked.txt",
+     "Cholesky (double) blocked [GFLOP/s]","k");
+
+  ::anpi::benchmark::show();
+}
+
+BOOST_AUTO_TEST_CASE( QR ) {
+
+  std::vector<size_t> sizes = {  64,  96, 128, 192, 256, 384,
+                                512, 768,1024,1536,2048 };
+
+  runFactorization< benchQRUnblocked<float> >
+    (sizes,qrFlops,"qr_float_unblocked.txt",
+     "QR (float) unblocked [GFLOP/s]","r");
+  runFactorization< benchQRBlocked<float> >
+    (sizes,qrFlops,"qr_float_blocked.txt",
+     "QR (float) blocked [GFLOP/s]","g");
+  runFactorization< benchQRUnblocked<double> >
+    (sizes,qrFlops,"qr_double_unblocked.txt",
+     "QR (double) unblocked [GFLOP/s]","m");
+  runFactorization< benchQRBlocked<double> >
+    (sizes,qrFlops,"qr_double_blocked.txt",
+     "QR (double) blocked [GFLOP/s]","k");
+
+  ::anpi::benchmark::show();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,207 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ */
+
+
+#include <boost/test/unit_test.hpp>
+
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+/**
+ * Small matrices with fixed and with dynamic dimensions
+ */
+#include "benchmarkFramework.hpp"
+#include "Matrix.hpp"
+#include "FixedMatrix.hpp"
+#include "LUDecomposition.hpp"
+
+BOOST_AUTO_TEST_SUITE( FixedMatrix )
+
+/// Operations benchmarked on each pair of matrices
+enum class SmallOp { Add, Multiply, Inverse };
+
+/// Name of each operation, for the plots and files
+inline std::string opName(const SmallOp op) {
+  switch (op) {
+  case SmallOp::Add:      return "add";
+  case SmallOp::Multiply: return "mul";
+  default:                return "inv";
+  }
+}
+
+/// Well conditioned entry (r,c) of the i-th matrix
+template<typename T>
+inline T smallEntry(const size_t i,const size_t r,const size_t c) {
+  return T((i*5+r*7+c*3)%17)/T(16) + ((r==c) ? T(2) : T(0));
+}
+
+/// One operation on each of "size" pairs of N x N fixed matrices
+template<typename T,size_t N>
+class benchFixed {
+protected:
+  typedef anpi::FixedMatrix<T,N,N> fixed_type;
+
+  /// Operation to benchmark
+  SmallOp _op;
+
+  /// Operands and results
+  std::vector<fixed_type> _a,_b,_c;
+public:
+  /// Construct
+  benchFixed(const SmallOp op) : _op(op) {}
+
+  /// Prepare the evaluation of given size
+  void prepare(const size_t size) {
+    _a.resize(size);
+    _b.resize(size);
+    _c.resize(size);
+    for (size_t i=0;i<size;++i) {
+      for (size_t r=0;r<N;++r) {
+        for (size_t c=0;c<N;++c) {
+          _a[i](r,c) = smallEntry<T>(i,r,c);
+          _b[i](r,c) = smallEntry<T>(i+1,c,r);
+        }
+      }
+    }
+  }
+
+  // Evaluate the operation on all pairs
+  inline void eval() {
+    const size_t n = _a.size();
+    switch (_op) {
+    case SmallOp::Add:
+      for (size_t i=0;i<n;++i) _c[i] = _a[i] + _b[i];
+      break;
+    case SmallOp::Multiply:
+      for (size_t i=0;i<n;++i) _c[i] = _a[i] * _b[i];
+      break;
+    default:
+      for (size_t i=0;i<n;++i) _c[i] = anpi::inverse(_a[i]);
+    }
+  }
+};
+
+/// One operation on each of "size" pairs of N x N dynamic matrices
+template<typename T,size_t N>
+class benchDynamic {
+protected:
+  /// Operation to benchmark
+  SmallOp _op;
+
+  /// Operands and results
+  std::vector< anpi::Matrix<T> > _a,_b,_c;
+
+  /// Identity, the right-hand sides of the inversion
+  anpi::Matrix<T> _eye;
+
+  /// Decomposition reused by the inversion
+  anpi::LUDecomposition<T> _lu;
+public:
+  /// Construct
+  benchDynamic(const SmallOp op) : _op(op),_eye(N,N,T(0)) {
+    for (size_t i=0;i<N;++i) {
+      _eye(i,i) = T(1);
+    }
+  }
+
+  /// Prepare the evaluation of given size
+  void prepare(const size_t size) {
+    _a.assign(size,anpi::Matrix<T>(N,N));
+    _b.assign(size,anpi::Matrix<T>(N,N));
+    _c.assign(size,anpi::Matrix<T>(N,N));
+    for (size_t i=0;i<size;++i) {
+      for (size_t r=0;r<N;++r) {
+        for (size_t c=0;c<N;++c) {
+          _a[i](r,c) = smallEntry<T>(i,r,c);
+          _b[i](r,c) = smallEntry<T>(i+1,c,r);
+        }
+      }
+    }
+  }
+
+  // Evaluate the operation on all pairs
+  inline void eval() {
+    const size_t n = _a.size();
+    switch (_op) {
+    case SmallOp::Add:
+      for (size_t i=0;i<n;++i) _c[i] = _a[i] + _b[i];
+      break;
+    case SmallOp::Multiply:
+      for (size_t i=0;i<n;++i) _c[i] = _a[i] * _b[i];
+      break;
+    default:
+      for (size_t i=0;i<n;++i) {
+        _lu.factorize(_a[i]);
+        _lu.solve(_eye,_c[i]);
+      }
+    }
+  }
+};
+
+/// Convert the measured times of "size" operations to ns per operation
+inline void nsPerOp(const std::vector<anpi::benchmark::measurement>& times,
+                    std::vector<anpi::benchmark::measurement>& ns) {
+  ns.resize(times.size());
+  for (size_t s=0;s<times.size();++s) {
+    const double f = 1.0e9/static_cast<double>(times[s].size);
+    ns[s].size    = times[s].size;
+    ns[s].average = times[s].average*f;
+    ns[s].stddev  = times[s].stddev*f;
+    ns[s].min     = times[s].min*f;
+    ns[s].max     = times[s].max*f;
+  }
+}
+
+/// Benchmark one operation on N x N matrices of both types
+template<typename T,size_t N>
+void runSmall(const SmallOp op,
+              const std::vector<size_t>& sizes,
+              const char* colorFixed,
+              const char* colorDynamic) {
+  const size_t repetitions=20;
+  std::vector<anpi::benchmark::measurement> times,ns;
+  const std::string tag = opName(op) + "_" + std::to_string(N);
+  const std::string label = opName(op) + " " + std::to_string(N) + "x" +
+                            std::to_string(N);
+
+  {
+    benchFixed<T,N> bf(op);
+    ANPI_BENCHMARK(sizes,repetitions,times,bf);
+    nsPerOp(times,ns);
+    ::anpi::benchmark::write("small_"+tag+"_fixed.txt",ns);
+    ::anpi::benchmark::plotRange(ns,label+" fixed [ns/op]",colorFixed);
+  }
+
+  {
+    benchDynamic<T,N> bd(op);
+    ANPI_BENCHMARK(sizes,repetitions,times,bd);
+    nsPerOp(times,ns);
+    ::anpi::benchmark::write("small_"+tag+"_dynamic.txt",ns);
+    ::anpi::benchmark::plotRange(ns,label+" dynamic [ns/op]",colorDynamic);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( Operations ) {
+
+  // number of matrices per evaluation
+  std::vector<size_t> sizes = { 64, 256, 1024, 4096, 16384 };
+
+  runSmall<double,4>(SmallOp::Add,sizes,"r","m");
+  runSmall<double,2>(SmallOp::Multiply,sizes,"b","c");
+  runSmall<double,3>(SmallOp::Multiply,sizes,"g","y");
+  runSmall<double,4>(SmallOp::Multiply,sizes,"k","r");
+  runSmall<double,3>(SmallOp::Inverse,sizes,"m","b");
+  runSmall<double,4>(SmallOp::Inverse,sizes,"c","g");
+
+  ::anpi::benchmark::show();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
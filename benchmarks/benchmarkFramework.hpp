@@ -12,6 +12,8 @@
 #define ANPI_BENCHMARK_FRAMEWORK_HPP
 
 #include <chrono>
+#include <cmath>
+#include <vector>
 #include <iostream>
 #include <ostream>
 #include <fstream>
@@ -42,9 +44,9 @@ namespace anpi {
     /**
      * Compute measurement statistics for each size
      */
-    void computeStats(const std::vector<size_t>& sizes,
-                      const anpi::Matrix<std::chrono::duration<double> >& mat,
-                      std::vector<measurement>& times) {
+    inline void computeStats(const std::vector<size_t>& sizes,
+                             const anpi::Matrix<std::chrono::duration<double> >& mat,
+                             std::vector<measurement>& times) {
 
       const size_t nums = sizes.size();
       times.resize(nums);
@@ -72,6 +74,35 @@ namespace anpi {
       }
     }
 
+    /**
+     * Convert time measurements into throughput measurements.
+     *
+     * The work function returns the amount of work done in one evaluation
+     * of the given size (e.g. number of floating point operations, or
+     * number of bytes), and the resulting measurements hold that work
+     * per second, scaled by the given unit (1e9 for GFLOP/s or GB/s).
+     *
+     * Since the rate is inversely proportional to the time, the minimum
+     * time becomes the maximum rate and vice versa.
+     */
+    template<class Work>
+    inline void computeRates(const std::vector<measurement>& times,
+                             Work work,
+                             std::vector<measurement>& rates,
+                             const double unit=1.0e9) {
+      rates.resize(times.size());
+      for (size_t s=0;s<times.size();++s) {
+        const measurement& t = times[s];
+        measurement& r = rates[s];
+        const double w = static_cast<double>(work(t.size))/unit;
+        r.size    = t.size;
+        r.average = w/t.average;
+        r.stddev  = w*t.stddev/sqr(t.average); // first order approximation
+        r.min     = w/t.max;
+        r.max     = w/t.min;
+      }
+    }
+
     /**
      * Save a file with each measurement in a row.
      *
@@ -82,8 +113,8 @@ namespace anpi {
      * # Minimum
      * # Maximum  
      */
-    void write(std::ostream& stream,
-               const std::vector<measurement>& m) {
+    inline void write(std::ostream& stream,
+                      const std::vector<measurement>& m) {
       for (auto i : m) {
         stream << i.size    << " \t";
         stream << i.average << " \t";
@@ -96,8 +127,8 @@ namespace anpi {
     /**
      * Save a file with each measurement in a row
      */
-    void write(const std::string& filename,
-               const std::vector<measurement>& m) {
+    inline void write(const std::string& filename,
+                      const std::vector<measurement>& m) {
       std::ofstream os(filename.c_str());
       write(os,m);
       os.close();
@@ -113,9 +144,9 @@ namespace anpi {
      * # Minimum
      * # Maximum  
      */
-    void plot(const std::vector<measurement>& m,
-              const std::string& legend,
-              const std::string& color = "r") {
+    inline void plot(const std::vector<measurement>& m,
+                     const std::string& legend,
+                     const std::string& color = "r") {
       std::vector<double> x(m.size()),y(m.size());
 
       for (size_t i=0;i<m.size();++i) {
@@ -138,9 +169,9 @@ namespace anpi {
      * # Minimum
      * # Maximum  
      */
-    void plotRange(const std::vector<measurement>& m,
-                   const std::string& legend,
-                   const std::string& color) {
+    inline void plotRange(const std::vector<measurement>& m,
+                          const std::string& legend,
+                          const std::string& color) {
       std::vector<double> x(m.size()),y(m.size()),miny(m.size()),maxy(m.size());
 
       for (size_t i=0;i<m.size();++i) {
@@ -156,7 +187,7 @@ namespace anpi {
       plotter.plot(x,y,miny,maxy,legend,color);
     }
     
-    void show() {
+    inline void show() {
        static anpi::Plot2d<double> plotter;
        plotter.show();
     }
@@ -0,0 +1,100 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ */
+
+
+#include <boost/test/unit_test.hpp>
+
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <string>
+
+/**
+ * Huge pages for large matrices
+ */
+#include "benchmarkFramework.hpp"
+#include "Matrix.hpp"
+#include "Allocator.hpp"
+#include "HugePageAllocator.hpp"
+
+BOOST_AUTO_TEST_SUITE( HugePages )
+
+/// Bytes moved by one on-copy addition of size x size matrices of T
+template<typename T>
+struct hugeAddBytes {
+  inline size_t operator()(const size_t size) const {
+    return 3*size*size*sizeof(T);
+  }
+};
+
+/// On-copy addition with matrices of the given allocator
+template<typename T,class Alloc>
+class benchHugeAdd {
+protected:
+  typedef anpi::Matrix<T,Alloc> matrix_type;
+
+  /// State of the benchmarked evaluation
+  matrix_type _a;
+  matrix_type _b;
+  matrix_type _c;
+public:
+  /// Construct
+  benchHugeAdd(const size_t) {}
+
+  /// Prepare the evaluation of given size
+  void prepare(const size_t size) {
+    _a = matrix_type(size,size,T(1));
+    _b = matrix_type(size,size,T(2));
+    _c = matrix_type(size,size,T(0));
+  }
+
+  // Evaluate add on-copy
+  inline void eval() {
+    anpi::simd::add(_a,_b,_c);
+  }
+};
+
+BOOST_AUTO_TEST_CASE( Add ) {
+
+  // from 256 KiB to 64 MiB per matrix, across the reach of the L2 TLB
+  // with 4 KiB pages (a few MiB on current CPUs)
+  std::vector<size_t> sizes = {  256,  384,  512,  768, 1024, 1536,
+                                2048, 3072, 4096 };
+
+  const size_t repetitions=20;
+  std::vector<anpi::benchmark::measurement> times,rates;
+
+  {
+    typedef anpi::aligned_row_allocator<float> alloc;
+    benchHugeAdd<float,alloc> ba(0);
+    ANPI_BENCHMARK(sizes,repetitions,times,ba);
+    ::anpi::benchmark::computeRates(times,hugeAddBytes<float>(),rates);
+    ::anpi::benchmark::write("huge_add_aligned_row_float.txt",rates);
+    ::anpi::benchmark::plotRange(rates,"aligned_row_allocator [GB/s]","r");
+  }
+
+  {
+    typedef anpi::huge_page_allocator<float> alloc;
+    {
+      // report what this system provides
+      anpi::Matrix<float,alloc> probe(4096,4096,anpi::DoNotInitialize);
+      std::cout << "huge_page_allocator uses "
+                << anpi::hugePageModeName(anpi::lastHugePageMode())
+                << std::endl;
+    }
+    benchHugeAdd<float,alloc> ba(0);
+    ANPI_BENCHMARK(sizes,repetitions,times,ba);
+    ::anpi::benchmark::computeRates(times,hugeAddBytes<float>(),rates);
+    ::anpi::benchmark::write("huge_add_huge_page_float.txt",rates);
+    ::anpi::benchmark::plotRange(rates,"huge_page_allocator [GB/s]","g");
+  }
+
+  ::anpi::benchmark::show();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
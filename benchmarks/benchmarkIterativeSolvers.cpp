@@ -0,0 +1,189 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ */
+
+
+#include <boost/test/unit_test.hpp>
+
+
+#include <iostream>
+#include <exception>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+/**
+ * Time to tolerance of the iterative solvers
+ */
+#include "benchmarkFramework.hpp"
+#include "IterativeSolvers.hpp"
+
+BOOST_AUTO_TEST_SUITE( IterativeSolvers )
+
+/// Relative tolerance of all solvers
+const double solverEps = 1.0e-6;
+
+/// Common state of the solver benchmarks
+class benchSolver {
+protected:
+  /// 2D Poisson problem with the given shift of the diagonal
+  const double _shift;
+
+  /// System matrix, right-hand side and solution
+  anpi::SparseMatrix<double> _a;
+  std::vector<double> _b;
+  std::vector<double> _x;
+
+public:
+  /// Iterations to tolerance, for each size
+  std::vector<anpi::benchmark::measurement> iterations;
+
+  /// Construct
+  benchSolver(const double shift) : _shift(shift) {}
+
+  /// Prepare a problem with size unknowns (a square grid)
+  void prepare(const size_t size) {
+    const size_t k = size_t(std::sqrt(double(size))+0.5);
+    std::vector< anpi::Triplet<double> > e;
+    e.reserve(5*k*k);
+    for (size_t i=0;i<k;++i) {
+      for (size_t j=0;j<k;++j) {
+        const size_t r = i*k+j;
+        e.push_back(anpi::Triplet<double>(r,r,4.0+_shift));
+        if (i>0)   e.push_back(anpi::Triplet<double>(r,r-k,-1.0));
+        if (i+1<k) e.push_back(anpi::Triplet<double>(r,r+k,-1.0));
+        if (j>0)   e.push_back(anpi::Triplet<double>(r,r-1,-1.0));
+        if (j+1<k) e.push_back(anpi::Triplet<double>(r,r+1,-1.0));
+      }
+    }
+    _a = anpi::SparseMatrix<double>(k*k,k*k,e);
+    _b.assign(k*k,1.0);
+
+    iterations.push_back(anpi::benchmark::measurement());
+    iterations.back().size = size;
+  }
+
+  /// Store the iterations of the last solve
+  void record(const size_t its) {
+    anpi::benchmark::measurement& m = iterations.back();
+    m.average = m.min = m.max = double(its);
+  }
+};
+
+/// Conjugate gradients
+class benchCG : public benchSolver {
+public:
+  /// Constructor
+  benchCG(const double shift) : benchSolver(shift) {}
+
+  // Solve from a zero initial guess
+  inline void eval() {
+    _x.clear();
+    record(anpi::solveCG(_a,_b,_x,solverEps,100000));
+  }
+};
+
+/// BiCGSTAB
+class benchBiCGSTAB : public benchSolver {
+public:
+  /// Constructor
+  benchBiCGSTAB(const double shift) : benchSolver(shift) {}
+
+  // Solve from a zero initial guess
+  inline void eval() {
+    _x.clear();
+    record(anpi::solveBiCGSTAB(_a,_b,_x,solverEps,100000));
+  }
+};
+
+/// Jacobi
+class benchJacobi : public benchSolver {
+public:
+  /// Constructor
+  benchJacobi(const double shift) : benchSolver(shift) {}
+
+  // Solve from a zero initial guess
+  inline void eval() {
+    _x.clear();
+    record(anpi::solveJacobi(_a,_b,_x,solverEps,100000));
+  }
+};
+
+/// Gauss-Seidel
+class benchGaussSeidel : public benchSolver {
+public:
+  /// Constructor
+  benchGaussSeidel(const double shift) : benchSolver(shift) {}
+
+  // Solve from a zero initial guess
+  inline void eval() {
+    _x.clear();
+    record(anpi::solveGaussSeidel(_a,_b,_x,solverEps,100000));
+  }
+};
+
+/// SOR, with a relaxation factor suited to the problem
+class benchSOR : public benchSolver {
+public:
+  /// Constructor
+  benchSOR(const double shift) : benchSolver(shift) {}
+
+  // Solve from a zero initial guess
+  inline void eval() {
+    _x.clear();
+    record(anpi::solveSOR(_a,_b,_x,1.5,solverEps,100000));
+  }
+};
+
+/// Benchmark one solver, writing times and iteration counts
+template<class B>
+void runSolver(const std::vector<size_t>& sizes,
+               const double shift,
+               const std::string& name,
+               const std::string& color) {
+  const size_t repetitions=3;
+  std::vector<anpi::benchmark::measurement> times;
+
+  B bs(shift);
+  ANPI_BENCHMARK(sizes,repetitions,times,bs);
+
+  for (const anpi::benchmark::measurement& m : bs.iterations) {
+    std::cout << name << ": " << m.size << " unknowns, "
+              << m.average << " iterations" << std::endl;
+  }
+  ::anpi::benchmark::write("iterative_"+name+"_time.txt",times);
+  ::anpi::benchmark::write("iterative_"+name+"_iterations.txt",bs.iterations);
+  ::anpi::benchmark::plotRange(times,name+" time to tolerance [s]",color);
+}
+
+BOOST_AUTO_TEST_CASE( Poisson ) {
+
+  // Krylov methods on the plain 2D Poisson problem
+  std::vector<size_t> sizes = { 256, 1024, 4096, 16384, 65536, 262144 };
+
+  runSolver<benchCG>(sizes,0.0,"cg","r");
+  runSolver<benchBiCGSTAB>(sizes,0.0,"bicgstab","g");
+
+  ::anpi::benchmark::show();
+}
+
+BOOST_AUTO_TEST_CASE( Stationary ) {
+
+  // all methods on a shifted, diagonally dominant Poisson problem,
+  // which the stationary iterations solve in a reasonable time
+  std::vector<size_t> sizes = { 256, 1024, 4096, 16384, 65536, 262144 };
+
+  runSolver<benchCG>(sizes,0.5,"cg_shifted","r");
+  runSolver<benchBiCGSTAB>(sizes,0.5,"bicgstab_shifted","g");
+  runSolver<benchJacobi>(sizes,0.5,"jacobi_shifted","b");
+  runSolver<benchGaussSeidel>(sizes,0.5,"gauss_seidel_shifted","m");
+  runSolver<benchSOR>(sizes,0.5,"sor_shifted","k");
+
+  ::anpi::benchmark::show();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
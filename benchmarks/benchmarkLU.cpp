@@ -0,0 +1,136 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ */
+
+
+#include <boost/test/unit_test.hpp>
+
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <vector>
+
+/**
+ * Benchmarks for the LU decomposition
+ */
+#include "benchmarkFramework.hpp"
+#include "Matrix.hpp"
+#include "LUDecomposition.hpp"
+
+BOOST_AUTO_TEST_SUITE( LU )
+
+/// Benchmark for the LU decomposition
+template<typename T>
+class benchLU {
+protected:
+  /// Matrix to decompose
+  anpi::Matrix<T> _a;
+
+  /// Packed factors
+  anpi::Matrix<T> _lu;
+
+  /// Row permutation
+  std::vector<size_t> _permut;
+public:
+  /// Construct
+  benchLU(const size_t) {}
+
+  /// Prepare the evaluation of given size
+  void prepare(const size_t size) {
+    _a = anpi::Matrix<T>(size,size,anpi::DoNotInitialize);
+    for (size_t r=0;r<size;++r) {
+      for (size_t c=0;c<size;++c) {
+        _a(r,c)=T((r*7+c*3)%17)/T(16) + ((r==c) ? T(1) : T(0));
+      }
+    }
+  }
+};
+
+/// Unblocked reference
+template<typename T>
+class benchLUUnblocked : public benchLU<T> {
+public:
+  /// Constructor
+  benchLUUnblocked(const size_t n) : benchLU<T>(n) { }
+
+  // Evaluate the decomposition
+  inline void eval() {
+    anpi::luUnblocked(this->_a,this->_lu,this->_permut);
+  }
+};
+
+/// Blocked right-looking decomposition
+template<typename T>
+class benchLUBlocked : public benchLU<T> {
+public:
+  /// Constructor
+  benchLUBlocked(const size_t n) : benchLU<T>(n) { }
+
+  // Evaluate the decomposition
+  inline void eval() {
+    anpi::lu(this->_a,this->_lu,this->_permut);
+  }
+};
+
+/// Floating point operations of the LU decomposition of the given size
+inline double luFlops(const size_t n) {
+  return 2.0/3.0*double(n)*double(n)*double(n);
+}
+
+BOOST_AUTO_TEST_CASE( Decomposition ) {
+
+  std::vector<size_t> sizes = {  64,  96, 128, 192, 256, 384,
+                                512, 768,1024,1536,2048,3072,4096 };
+
+  const size_t repetitions=3;
+  std::vector<anpi::benchmark::measurement> times;
+  std::vector<anpi::benchmark::measurement> gflops;
+
+  {
+    benchLUUnblocked<float> bl(0);
+
+    ANPI_BENCHMARK(sizes,repetitions,times,bl);
+    ::anpi::benchmark::computeRates(times,luFlops,gflops);
+
+    ::anpi::benchmark::write("lu_float_unblocked.txt",gflops);
+    ::anpi::benchmark::plotRange(gflops,"LU (float) unblocked [GFLOP/s]","r");
+  }
+
+  {
+    benchLUBlocked<float> bl(0);
+
+    ANPI_BENCHMARK(sizes,repetitions,times,bl);
+    ::anpi::benchmark::computeRates(times,luFlops,gflops);
+
+    ::anpi::benchmark::write("lu_float_blocked.txt",gflops);
+    ::anpi::benchmark::plotRange(gflops,"LU (float) blocked [GFLOP/s]","g");
+  }
+
+  {
+    benchLUUnblocked<double> bl(0);
+
+    ANPI_BENCHMARK(sizes,repetitions,times,bl);
+    ::anpi::benchmark::computeRates(times,luFlops,gflops);
+
+    ::anpi::benchmark::write("lu_double_unblocked.txt",gflops);
+    ::anpi::benchmark::plotRange(gflops,"LU (double) unblocked [GFLOP/s]","m");
+  }
+
+  {
+    benchLUBlocked<double> bl(0);
+
+    ANPI_BENCHMARK(sizes,repetitions,times,bl);
+    ::anpi::benchmark::computeRates(times,luFlops,gflops);
+
+    ::anpi::benchmark::write("lu_double_blocked.txt",gflops);
+    ::anpi::benchmark::plotRange(gflops,"LU (double) blocked [GFLOP/s]","k");
+  }
+
+  ::anpi::benchmark::show();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,161 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ */
+
+
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+
+
+#include <iostream>
+#include <exception>
+#include <memory>
+#include <cstdlib>
+#include <string>
+
+/**
+ * Streaming over file-backed matrices
+ */
+#include "benchmarkFramework.hpp"
+#include "Matrix.hpp"
+#include "Allocator.hpp"
+#include "MappedAllocator.hpp"
+
+BOOST_AUTO_TEST_SUITE( Mapped )
+
+/// Bytes moved by one on-copy addition of size x size matrices of T
+template<typename T>
+struct addBytes {
+  inline size_t operator()(const size_t size) const {
+    return 3*size*size*sizeof(T);
+  }
+};
+
+/// On-copy addition of two heap-backed matrices
+template<typename T>
+class benchAddHeap {
+protected:
+  /// State of the benchmarked evaluation
+  anpi::Matrix<T> _a;
+  anpi::Matrix<T> _b;
+  anpi::Matrix<T> _c;
+public:
+  /// Construct
+  benchAddHeap(const size_t) {}
+
+  /// Prepare the evaluation of given size
+  void prepare(const size_t size) {
+    _a = anpi::Matrix<T>(size,size,T(1));
+    _b = anpi::Matrix<T>(size,size,T(2));
+    _c.allocate(size,size);
+  }
+
+  // Evaluate add on-copy
+  inline void eval() {
+    anpi::simd::add(_a,_b,_c);
+  }
+};
+
+/**
+ * On-copy addition of two file-backed matrices into a third one.
+ *
+ * The files are created in the temporary directory and stay in the page
+ * cache, so this measures the cost of the mapping itself (page faults,
+ * write back) rather than of the disk.
+ */
+template<typename T>
+class benchAddMapped {
+protected:
+  typedef anpi::Matrix<T,anpi::mapped_allocator<T> > matrix_type;
+
+  /// Prefix of the temporary files
+  std::string _prefix;
+
+  /// Access pattern hint
+  anpi::MapAdvice _advice;
+
+  /// State of the benchmarked evaluation, the operands mapped read-only
+  std::unique_ptr<const matrix_type> _a;
+  std::unique_ptr<const matrix_type> _b;
+  matrix_type _c;
+public:
+  /// Construct
+  benchAddMapped(const anpi::MapAdvice advice) : _advice(advice) {
+    namespace fs = boost::filesystem;
+    _prefix = (fs::temp_directory_path() /
+               fs::unique_path("anpi-bench-%%%%-%%%%")).string();
+  }
+
+  /// Remove the temporary files
+  ~benchAddMapped() {
+    _a.reset();
+    _b.reset();
+    _c.clear();
+    boost::filesystem::remove(_prefix + "a.mat");
+    boost::filesystem::remove(_prefix + "b.mat");
+    boost::filesystem::remove(_prefix + "c.mat");
+  }
+
+  /// Prepare the evaluation of given size
+  void prepare(const size_t size) {
+    _a.reset();
+    _b.reset();
+    _c.clear();
+    {
+      matrix_type a=anpi::createMapped<T>(_prefix + "a.mat",size,size);
+      matrix_type b=anpi::createMapped<T>(_prefix + "b.mat",size,size);
+      a.fill(T(1));
+      b.fill(T(2));
+    }
+    // reopen, as a matrix that was stored before
+    _a.reset(new const matrix_type(
+      anpi::openMappedReadOnly<T>(_prefix + "a.mat",_advice)));
+    _b.reset(new const matrix_type(
+      anpi::openMappedReadOnly<T>(_prefix + "b.mat",_advice)));
+    _c = anpi::createMapped<T>(_prefix + "c.mat",size,size,_advice);
+  }
+
+  // Evaluate add on-copy
+  inline void eval() {
+    anpi::simd::add(*_a,*_b,_c);
+  }
+};
+
+BOOST_AUTO_TEST_CASE( StreamingAdd ) {
+
+  std::vector<size_t> sizes = {  256,  512, 1024, 1536, 2048, 3072, 4096 };
+
+  const size_t repetitions=20;
+  std::vector<anpi::benchmark::measurement> times,rates;
+
+  {
+    benchAddHeap<float> baf(0);
+    ANPI_BENCHMARK(sizes,repetitions,times,baf);
+    ::anpi::benchmark::computeRates(times,addBytes<float>(),rates);
+    ::anpi::benchmark::write("mapped_add_heap_float.txt",rates);
+    ::anpi::benchmark::plotRange(rates,"heap [GB/s]","r");
+  }
+
+  {
+    benchAddMapped<float> baf(anpi::MapAdvice::Sequential);
+    ANPI_BENCHMARK(sizes,repetitions,times,baf);
+    ::anpi::benchmark::computeRates(times,addBytes<float>(),rates);
+    ::anpi::benchmark::write("mapped_add_sequential_float.txt",rates);
+    ::anpi::benchmark::plotRange(rates,"mapped sequential [GB/s]","g");
+  }
+
+  {
+    benchAddMapped<float> baf(anpi::MapAdvice::Random);
+    ANPI_BENCHMARK(sizes,repetitions,times,baf);
+    ::anpi::benchmark::computeRates(times,addBytes<float>(),rates);
+    ::anpi::benchmark::write("mapped_add_random_float.txt",rates);
+    ::anpi::benchmark::plotRange(rates,"mapped random [GB/s]","b");
+  }
+
+  ::anpi::benchmark::show();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
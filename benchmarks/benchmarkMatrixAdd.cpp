@@ -16,6 +16,10 @@
 #include <exception>
 #include <cstdlib>
 #include <complex>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
 
 /**
  * Unit tests for the matrix class
@@ -24,7 +28,6 @@
 #include "Matrix.hpp"
 #include "Allocator.hpp"
 
-/*
 BOOST_AUTO_TEST_SUITE( Matrix )
 
 /// Benchmark for addition operations
@@ -192,5 +195,210 @@ BOOST_AUTO_TEST_CASE( Add ) {
   ::anpi::benchmark::show();
 }
   
-BOOST_AUTO_TEST_SUITE_END()
-*/
\ No newline at end of file
+/// Bytes moved by one on-copy addition of size x size matrices
+template<typename T>
+inline size_t addBytes(const size_t size) {
+  return 3*size*size*sizeof(T);
+}
+
+/**
+ * On-copy addition into a preallocated result, or in-place addition,
+ * with the streaming threshold fixed for the whole measurement.
+ */
+template<typename T,bool InPlace=false>
+class benchAddStreaming {
+protected:
+  /// Streaming threshold used during the evaluation
+  const size_t _threshold;
+
+  /// Threshold restored at destruction
+  const size_t _previous;
+
+  /// State of the benchmarked evaluation
+  anpi::Matrix<T> _a;
+  anpi::Matrix<T> _b;
+  anpi::Matrix<T> _c;
+public:
+  /// Construct
+  benchAddStreaming(const size_t threshold)
+    : _threshold(threshold),_previous(anpi::simd::streamingThreshold()) {
+    anpi::simd::setStreamingThreshold(_threshold);
+  }
+
+  /// Restore the threshold
+  ~benchAddStreaming() {
+    anpi::simd::setStreamingThreshold(_previous);
+  }
+
+  /// Prepare the evaluation of given size
+  void prepare(const size_t size) {
+    this->_a=anpi::Matrix<T>(size,size,T(1));
+    this->_b=anpi::Matrix<T>(size,size,T(2));
+    this->_c=anpi::Matrix<T>(size,size,T(0));
+  }
+
+  // Evaluate add on-copy or in place
+  inline void eval() {
+    if (InPlace) {
+      this->_a += this->_b;
+    } else {
+      anpi::simd::add(this->_a,this->_b,this->_c);
+    }
+  }
+};
+
+/**
+ * Regular against non-temporal stores of the on-copy addition.  Only
+ * the sizes whose result exceeds the last level cache benefit from the
+ * streaming stores; below it they force the result out to memory.
+ */
+BOOST_AUTO_TEST_CASE( Streaming ) {
+
+  std::vector<size_t> sizes = {  256,  512, 1024, 1536, 2048,
+                                3072, 4096, 5120, 6144 };
+
+  const size_t repetitions=10;
+  std::vector<anpi::benchmark::measurement> times,rates;
+
+  std::cout << "Last level cache: "
+            << anpi::simd::detectCacheSize()/1024 << " KiB" << std::endl;
+
+  {
+    benchAddStreaming<double> bas(anpi::simd::NoStreaming);
+    ANPI_BENCHMARK(sizes,repetitions,times,bas);
+    ::anpi::benchmark::computeRates(times,addBytes<double>,rates);
+    ::anpi::benchmark::write("add_on_copy_double_cached.txt",rates);
+    ::anpi::benchmark::plotRange(rates,"regular stores (double) [GB/s]","r");
+  }
+
+  {
+    benchAddStreaming<double> bas(0);
+    ANPI_BENCHMARK(sizes,repetitions,times,bas);
+    ::anpi::benchmark::computeRates(times,addBytes<double>,rates);
+    ::anpi::benchmark::write("add_on_copy_double_stream.txt",rates);
+    ::anpi::benchmark::plotRange(rates,"streaming stores (double) [GB/s]","b");
+  }
+
+  {
+    benchAddStreaming<double> bas(anpi::simd::streamingThreshold());
+    ANPI_BENCHMARK(sizes,repetitions,times,bas);
+    ::anpi::benchmark::computeRates(times,addBytes<double>,rates);
+    ::anpi::benchmark::write("add_on_copy_double_auto.txt",rates);
+    ::anpi::benchmark::plotRange(rates,"automatic (double) [GB/s]","g");
+  }
+
+  ::anpi::benchmark::show();
+
+  // in place the result overwrites lines just read, which must not be
+  // streamed even if the threshold asks for it
+  {
+    benchAddStreaming<double,true> bas(anpi::simd::NoStreaming);
+    ANPI_BENCHMARK(sizes,repetitions,times,bas);
+    ::anpi::benchmark::computeRates(times,addBytes<double>,rates);
+    ::anpi::benchmark::write("add_in_place_double_cached.txt",rates);
+    ::anpi::benchmark::plotRange(rates,"in place, regular (double) [GB/s]","r");
+  }
+
+  {
+    benchAddStreaming<double,true> bas(0);
+    ANPI_BENCHMARK(sizes,repetitions,times,bas);
+    ::anpi::benchmark::computeRates(times,addBytes<double>,rates);
+    ::anpi::benchmark::write("add_in_place_double_stream.txt",rates);
+    ::anpi::benchmark::plotRange(rates,"in place, threshold 0 (double) [GB/s]","b");
+  }
+
+  ::anpi::benchmark::show();
+}
+
+/**
+ * On-copy addition of matrices with the given allocator.  The matrices
+ * have one column more than the nominal size, so that the rows of the
+ * unpadded buffers never fill whole registers.
+ */
+template<typename T,class Alloc,bool Simd>
+class benchAddAlloc {
+protected:
+  /// State of the benchmarked evaluation
+  anpi::Matrix<T,Alloc> _a;
+  anpi::Matrix<T,Alloc> _b;
+  anpi::Matrix<T,Alloc> _c;
+public:
+  /// Construct
+  benchAddAlloc(const size_t) {}
+
+  /// Prepare the evaluation of given size
+  void prepare(const size_t size) {
+    this->_a=anpi::Matrix<T,Alloc>(size,size+1,T(1));
+    this->_b=anpi::Matrix<T,Alloc>(size,size+1,T(2));
+    this->_c=anpi::Matrix<T,Alloc>(size,size+1,T(0));
+  }
+
+  // Evaluate add on-copy
+  inline void eval() {
+    if (Simd) {
+      anpi::simd::add(this->_a,this->_b,this->_c);
+    } else {
+      anpi::fallback::add(this->_a,this->_b,this->_c);
+    }
+  }
+};
+
+/// Bytes moved by one on-copy addition of size x (size+1) matrices
+template<typename T>
+inline size_t addBytesOdd(const size_t size) {
+  return 3*size*(size+1)*sizeof(T);
+}
+
+/// Measure one addition variant and plot its throughput
+template<typename T,class Bench>
+void runAdd(const std::vector<size_t>& sizes,
+            const std::string& name,
+            const std::string& legend,
+            const char* color) {
+  const size_t repetitions=20;
+  std::vector<anpi::benchmark::measurement> times,rates;
+
+  Bench bench(0);
+  ANPI_BENCHMARK(sizes,repetitions,times,bench);
+  ::anpi::benchmark::computeRates(times,addBytesOdd<T>,rates);
+  ::anpi::benchmark::write(name,rates);
+  ::anpi::benchmark::plotRange(rates,legend,color);
+}
+
+/**
+ * Unpadded buffers of std::allocator, vectorized with unaligned loads
+ * and partial registers, against the scalar loops they used before and
+ * the padded buffers of the aligned allocator.
+ */
+BOOST_AUTO_TEST_CASE( Unpadded ) {
+
+  std::vector<size_t> sizes = {  24,  32,  48,  64,  96, 128, 192, 256,
+                                384, 512, 768,1024,1536,2048 };
+
+  typedef std::allocator<float>          salloc;
+  typedef anpi::aligned_allocator<float> aalloc;
+
+  runAdd<float,benchAddAlloc<float,salloc,false> >
+    (sizes,"add_float_stdalloc_fb.txt",
+     "std::allocator fallback (float) [GB/s]","r");
+  runAdd<float,benchAddAlloc<float,salloc,true> >
+    (sizes,"add_float_stdalloc_simd.txt",
+     "std::allocator simd (float) [GB/s]","b");
+  runAdd<float,benchAddAlloc<float,aalloc,true> >
+    (sizes,"add_float_aligned_simd.txt",
+     "aligned_allocator simd (float) [GB/s]","g");
+
+  ::anpi::benchmark::show();
+
+  typedef std::allocator<std::int16_t> ialloc;
+  runAdd<std::int16_t,benchAddAlloc<std::int16_t,ialloc,false> >
+    (sizes,"add_int16_stdalloc_fb.txt",
+     "std::allocator fallback (int16) [GB/s]","r");
+  runAdd<std::int16_t,benchAddAlloc<std::int16_t,ialloc,true> >
+    (sizes,"add_int16_stdalloc_simd.txt",
+     "std::allocator simd (int16) [GB/s]","b");
+
+  ::anpi::benchmark::show();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
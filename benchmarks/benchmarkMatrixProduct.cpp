@@ -0,0 +1,183 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ */
+
+
+#include <boost/test/unit_test.hpp>
+
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+
+/**
+ * Benchmarks for the matrix product
+ */
+#include "benchmarkFramework.hpp"
+#include "Matrix.hpp"
+#include "Allocator.hpp"
+
+BOOST_AUTO_TEST_SUITE( MatrixProduct )
+
+/// Benchmark for product operations
+template<typename T>
+class benchProduct {
+protected:
+  /// Maximum allowed size for the square matrices
+  const size_t _maxSize;
+
+  /// A large matrix holding
+  anpi::Matrix<T> _data;
+
+  /// State of the benchmarked evaluation
+  anpi::Matrix<T> _a;
+  anpi::Matrix<T> _b;
+  anpi::Matrix<T> _c;
+public:
+  /// Construct
+  benchProduct(const size_t maxSize)
+    : _maxSize(maxSize),_data(maxSize,maxSize,anpi::DoNotInitialize) {
+
+    for (size_t r=0;r<_maxSize;++r) {
+      for (size_t c=0;c<_maxSize;++c) {
+        _data(r,c)=T((r*7+c*3)%17)/T(16);
+      }
+    }
+  }
+
+  /// Prepare the evaluation of given size
+  void prepare(const size_t size) {
+    assert (size<=this->_maxSize);
+    this->_a=std::move(anpi::Matrix<T>(size,size,anpi::DoNotInitialize));
+    this->_a.fill(this->_data);
+    this->_b=this->_a;
+  }
+};
+
+/// Naive triple loop, as written without any library support
+template<typename T>
+class benchProductNaive : public benchProduct<T> {
+public:
+  /// Constructor
+  benchProductNaive(const size_t n) : benchProduct<T>(n) { }
+
+  // Evaluate the textbook i-j-k product
+  inline void eval() {
+    const size_t n=this->_a.rows();
+    this->_c.allocate(n,n);
+    for (size_t i=0;i<n;++i) {
+      for (size_t j=0;j<n;++j) {
+        T sum=T(0);
+        for (size_t k=0;k<n;++k) {
+          sum+=this->_a(i,k)*this->_b(k,j);
+        }
+        this->_c(i,j)=sum;
+      }
+    }
+  }
+};
+
+/// Provide the evaluation method for the fallback product
+template<typename T>
+class benchProductFallback : public benchProduct<T> {
+public:
+  /// Constructor
+  benchProductFallback(const size_t n) : benchProduct<T>(n) { }
+
+  // Evaluate product on-copy
+  inline void eval() {
+    anpi::fallback::multiply(this->_a,this->_b,this->_c);
+  }
+};
+
+/// Provide the evaluation method for the blocked SIMD product
+template<typename T>
+class benchProductSIMD : public benchProduct<T> {
+public:
+  /// Constructor
+  benchProductSIMD(const size_t n) : benchProduct<T>(n) { }
+
+  // Evaluate product on-copy
+  inline void eval() {
+    anpi::simd::multiply(this->_a,this->_b,this->_c);
+  }
+};
+
+/// Floating point operations of a square product of the given size
+inline double productFlops(const size_t n) {
+  return 2.0*double(n)*double(n)*double(n);
+}
+
+BOOST_AUTO_TEST_CASE( Product ) {
+
+  // the naive loops are too slow for the largest sizes
+  std::vector<size_t> smallSizes = {  24,  32,  48,  64,
+                                      96, 128, 192, 256,
+                                     384, 512, 768,1024};
+
+  std::vector<size_t> sizes = smallSizes;
+  sizes.push_back(1536);
+  sizes.push_back(2048);
+  sizes.push_back(3072);
+
+  const size_t repetitions=5;
+  std::vector<anpi::benchmark::measurement> times;
+  std::vector<anpi::benchmark::measurement> gflops;
+
+  {
+    benchProductNaive<float> bp(smallSizes.back());
+
+    ANPI_BENCHMARK(smallSizes,repetitions,times,bp);
+    ::anpi::benchmark::computeRates(times,productFlops,gflops);
+
+    ::anpi::benchmark::write("product_float_naive.txt",gflops);
+    ::anpi::benchmark::plotRange(gflops,"Product (float) naive [GFLOP/s]","r");
+  }
+
+  {
+    benchProductFallback<float> bp(smallSizes.back());
+
+    ANPI_BENCHMARK(smallSizes,repetitions,times,bp);
+    ::anpi::benchmark::computeRates(times,productFlops,gflops);
+
+    ::anpi::benchmark::write("product_float_fb.txt",gflops);
+    ::anpi::benchmark::plotRange(gflops,"Product (float) fallback [GFLOP/s]","b");
+  }
+
+  {
+    benchProductSIMD<float> bp(sizes.back());
+
+    ANPI_BENCHMARK(sizes,repetitions,times,bp);
+    ::anpi::benchmark::computeRates(times,productFlops,gflops);
+
+    ::anpi::benchmark::write("product_float_simd.txt",gflops);
+    ::anpi::benchmark::plotRange(gflops,"Product (float) simd [GFLOP/s]","g");
+  }
+
+  {
+    benchProductNaive<double> bp(smallSizes.back());
+
+    ANPI_BENCHMARK(smallSizes,repetitions,times,bp);
+    ::anpi::benchmark::computeRates(times,productFlops,gflops);
+
+    ::anpi::benchmark::write("product_double_naive.txt",gflops);
+    ::anpi::benchmark::plotRange(gflops,"Product (double) naive [GFLOP/s]","m");
+  }
+
+  {
+    benchProductSIMD<double> bp(sizes.back());
+
+    ANPI_BENCHMARK(sizes,repetitions,times,bp);
+    ::anpi::benchmark::computeRates(times,productFlops,gflops);
+
+    ::anpi::benchmark::write("product_double_simd.txt",gflops);
+    ::anpi::benchmark::plotRange(gflops,"Product (double) simd [GFLOP/s]","k");
+  }
+
+  ::anpi::benchmark::show();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,141 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ */
+
+
+#include <boost/test/unit_test.hpp>
+
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <string>
+
+/**
+ * Scaling of the multithreaded elementwise kernels
+ */
+#include "benchmarkFramework.hpp"
+#include "Matrix.hpp"
+#include "Allocator.hpp"
+#include "Parallel.hpp"
+
+BOOST_AUTO_TEST_SUITE( Parallel )
+
+/**
+ * Benchmark for a fixed matrix size, where the "size" given to
+ * ANPI_BENCHMARK is the number of threads.
+ */
+template<typename T>
+class benchThreads {
+protected:
+  /// Size of the square matrices
+  const size_t _n;
+
+  /// State of the benchmarked evaluation
+  anpi::Matrix<T> _a;
+  anpi::Matrix<T> _b;
+  anpi::Matrix<T> _c;
+public:
+  /// Construct
+  benchThreads(const size_t n)
+    : _n(n),_a(n,n,anpi::DoNotInitialize),_b(n,n,anpi::DoNotInitialize) {
+    for (size_t r=0;r<n;++r) {
+      for (size_t c=0;c<n;++c) {
+        _a(r,c)=T((r+c)%7);
+      }
+    }
+    _b=_a;
+    _c=_a;
+  }
+
+  /// Prepare the evaluation with the given number of threads
+  void prepare(const size_t threads) {
+    anpi::parallel::setThreads(threads);
+  }
+};
+
+/// On-copy addition
+template<typename T>
+class benchThreadsAdd : public benchThreads<T> {
+public:
+  /// Constructor
+  benchThreadsAdd(const size_t n) : benchThreads<T>(n) { }
+
+  // Evaluate add on-copy
+  inline void eval() {
+    anpi::simd::add(this->_a,this->_b,this->_c);
+  }
+};
+
+/// In-place axpy
+template<typename T>
+class benchThreadsAxpy : public benchThreads<T> {
+public:
+  /// Constructor
+  benchThreadsAxpy(const size_t n) : benchThreads<T>(n) { }
+
+  // Evaluate axpy in-place
+  inline void eval() {
+    anpi::simd::axpy(T(1)/T(2),this->_a,this->_c);
+  }
+};
+
+/// Fused expression
+template<typename T>
+class benchThreadsExpression : public benchThreads<T> {
+public:
+  /// Constructor
+  benchThreadsExpression(const size_t n) : benchThreads<T>(n) { }
+
+  // Evaluate a chain of sums
+  inline void eval() {
+    this->_c = this->_a + this->_b - this->_a + this->_b;
+  }
+};
+
+BOOST_AUTO_TEST_CASE( Scaling ) {
+
+  // from 1 thread up to the number of cores
+  std::vector<size_t> threads;
+  for (size_t t=1;t<=anpi::parallel::threads();++t) {
+    threads.push_back(t);
+  }
+
+  const size_t repetitions=20;
+  std::vector<anpi::benchmark::measurement> times;
+
+  const char* colors[] = { "r","g","b" };
+  const size_t sizes[] = { 1024, 2048, 4096 };
+
+  for (size_t i=0;i<3;++i) {
+    const size_t n=sizes[i];
+    const std::string sn=std::to_string(n);
+    {
+      benchThreadsAdd<float> bt(n);
+      ANPI_BENCHMARK(threads,repetitions,times,bt);
+      ::anpi::benchmark::write("threads_add_float_" + sn + ".txt",times);
+      ::anpi::benchmark::plotRange(times,"add " + sn,colors[i]);
+    }
+    {
+      benchThreadsAxpy<float> bt(n);
+      ANPI_BENCHMARK(threads,repetitions,times,bt);
+      ::anpi::benchmark::write("threads_axpy_float_" + sn + ".txt",times);
+      ::anpi::benchmark::plotRange(times,"axpy " + sn,colors[i]);
+    }
+    {
+      benchThreadsExpression<float> bt(n);
+      ANPI_BENCHMARK(threads,repetitions,times,bt);
+      ::anpi::benchmark::write("threads_expr_float_" + sn + ".txt",times);
+      ::anpi::benchmark::plotRange(times,"a+b-a+b " + sn,colors[i]);
+    }
+  }
+
+  anpi::parallel::setThreads(0);
+
+  ::anpi::benchmark::show();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
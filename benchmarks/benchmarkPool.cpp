@@ -0,0 +1,85 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ */
+
+
+#include <boost/test/unit_test.hpp>
+
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <string>
+
+/**
+ * Allocation churn of matrix temporaries
+ */
+#include "benchmarkFramework.hpp"
+#include "Matrix.hpp"
+#include "Allocator.hpp"
+#include "PoolAllocator.hpp"
+
+BOOST_AUTO_TEST_SUITE( Pool )
+
+/**
+ * Loop iteration creating and destroying temporaries, as in the body
+ * of an iterative method
+ */
+template<typename T,class Alloc>
+class benchTemporaries {
+protected:
+  typedef anpi::Matrix<T,Alloc> matrix_type;
+
+  /// State of the benchmarked evaluation
+  matrix_type _a;
+  matrix_type _b;
+  matrix_type _c;
+public:
+  /// Construct
+  benchTemporaries(const size_t) {}
+
+  /// Prepare the evaluation of given size
+  void prepare(const size_t size) {
+    _a = matrix_type(size,size,T(1));
+    _b = matrix_type(size,size,T(2));
+    _c = matrix_type(size,size,T(0));
+  }
+
+  // One iteration
+  inline void eval() {
+    matrix_type r(_a);          // copy
+    r -= _c;
+    matrix_type s(r + _b);      // new matrix from an expression
+    _c = matrix_type(s - _a);   // by-value temporary moved in
+  }
+};
+
+BOOST_AUTO_TEST_CASE( Temporaries ) {
+
+  std::vector<size_t> sizes = {   4,   8,  16,  24,  32,  48,  64,  96,
+                                128, 192, 256, 384, 512 };
+
+  const size_t repetitions=200;
+  std::vector<anpi::benchmark::measurement> times;
+
+  {
+    benchTemporaries<float,anpi::aligned_row_allocator<float> > bt(0);
+    ANPI_BENCHMARK(sizes,repetitions,times,bt);
+    ::anpi::benchmark::write("pool_aligned_row_float.txt",times);
+    ::anpi::benchmark::plotRange(times,"aligned_row_allocator","r");
+  }
+
+  {
+    benchTemporaries<float,anpi::pool_allocator<float> > bt(0);
+    ANPI_BENCHMARK(sizes,repetitions,times,bt);
+    ::anpi::benchmark::write("pool_pool_float.txt",times);
+    ::anpi::benchmark::plotRange(times,"pool_allocator","g");
+  }
+
+  ::anpi::benchmark::show();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,183 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ */
+
+
+#include <boost/test/unit_test.hpp>
+
+
+#include <iostream>
+#include <exception>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+/**
+ * Reductions over all entries of a matrix
+ */
+#include "benchmarkFramework.hpp"
+#include "MatrixReduction.hpp"
+
+BOOST_AUTO_TEST_SUITE( Reduction )
+
+/// Bytes read by one reduction of a size x size matrix
+template<typename T>
+struct reductionBytes {
+  size_t _operands;
+  reductionBytes(const size_t operands) : _operands(operands) {}
+  inline size_t operator()(const size_t size) const {
+    return _operands*size*size*sizeof(T);
+  }
+};
+
+/// Reductions to benchmark
+enum class ReductionOp { Sum, Dot, Max };
+
+/// Reduction of size x size matrices
+template<typename T>
+class benchReduction {
+protected:
+  /// Reduction to benchmark
+  ReductionOp _op;
+
+  /// Operands
+  anpi::Matrix<T> _a,_b;
+
+  /// Result, kept to avoid optimizing the reduction away
+  volatile T _result;
+public:
+  /// Construct
+  benchReduction(const ReductionOp op) : _op(op),_result(T(0)) {}
+
+  /// Prepare the evaluation of given size
+  void prepare(const size_t size) {
+    _a = anpi::Matrix<T>(size,size,anpi::DoNotInitialize);
+    _b = anpi::Matrix<T>(size,size,anpi::DoNotInitialize);
+    for (size_t r=0;r<size;++r) {
+      for (size_t c=0;c<size;++c) {
+        _a(r,c) = T((r*7+c*3)%17)/T(16);
+        _b(r,c) = T((r*5+c*11)%13)/T(12);
+      }
+    }
+  }
+};
+
+/// The scalar loops written so far in the client code
+template<typename T>
+class benchReductionLoop : public benchReduction<T> {
+public:
+  /// Constructor
+  benchReductionLoop(const ReductionOp op) : benchReduction<T>(op) { }
+
+  // Evaluate the reduction
+  inline void eval() {
+    const anpi::Matrix<T>& a = this->_a;
+    const anpi::Matrix<T>& b = this->_b;
+    T s = (this->_op == ReductionOp::Max) ? a(0,0) : T(0);
+    for (size_t r=0;r<a.rows();++r) {
+      for (size_t c=0;c<a.cols();++c) {
+        switch (this->_op) {
+        case ReductionOp::Sum: s += a(r,c);                    break;
+        case ReductionOp::Dot: s += a(r,c)*b(r,c);             break;
+        default:               s = (a(r,c) > s) ? a(r,c) : s;
+        }
+      }
+    }
+    this->_result = s;
+  }
+};
+
+/// SIMD reductions with the given summation mode
+template<typename T>
+class benchReductionSIMD : public benchReduction<T> {
+protected:
+  /// Accumulation of the sums
+  anpi::Summation _mode;
+public:
+  /// Constructor
+  benchReductionSIMD(const ReductionOp op,const anpi::Summation mode)
+    : benchReduction<T>(op),_mode(mode) { }
+
+  // Evaluate the reduction
+  inline void eval() {
+    switch (this->_op) {
+    case ReductionOp::Sum:
+      this->_result = anpi::sum(this->_a,_mode);
+      break;
+    case ReductionOp::Dot:
+      this->_result = anpi::dot(this->_a,this->_b,_mode);
+      break;
+    default:
+      this->_result = anpi::max(this->_a);
+    }
+  }
+};
+
+/// Benchmark and plot one reduction
+template<typename T,class Bench>
+void runReduction(Bench& bench,
+                  const std::vector<size_t>& sizes,
+                  const size_t operands,
+                  const std::string& name,
+                  const std::string& legend,
+                  const char* color) {
+  const size_t repetitions=20;
+  std::vector<anpi::benchmark::measurement> times,rates;
+
+  ANPI_BENCHMARK(sizes,repetitions,times,bench);
+  ::anpi::benchmark::computeRates(times,reductionBytes<T>(operands),rates);
+  ::anpi::benchmark::write(name,rates);
+  ::anpi::benchmark::plotRange(rates,legend,color);
+}
+
+/// Loop, plain, pairwise and Kahan versions of one reduction
+template<typename T>
+void compareReduction(const ReductionOp op,
+                      const size_t operands,
+                      const std::string& tag,
+                      const std::vector<size_t>& sizes) {
+  {
+    benchReductionLoop<T> b(op);
+    runReduction<T>(b,sizes,operands,tag+"_loop.txt",
+                    tag+" scalar loop [GB/s]","r");
+  }
+  {
+    benchReductionSIMD<T> b(op,anpi::Summation::Plain);
+    runReduction<T>(b,sizes,operands,tag+"_simd.txt",
+                    tag+" simd [GB/s]","b");
+  }
+  if (op != ReductionOp::Max) {
+    {
+      benchReductionSIMD<T> b(op,anpi::Summation::Pairwise);
+      runReduction<T>(b,sizes,operands,tag+"_pairwise.txt",
+                      tag+" simd pairwise [GB/s]","g");
+    }
+    {
+      benchReductionSIMD<T> b(op,anpi::Summation::Kahan);
+      runReduction<T>(b,sizes,operands,tag+"_kahan.txt",
+                      tag+" simd Kahan [GB/s]","m");
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( Throughput ) {
+
+  std::vector<size_t> sizes = {  24,  32,  48,  64,  96, 128, 192, 256,
+                                384, 512, 768,1024,1536,2048 };
+
+  compareReduction<double>(ReductionOp::Sum,1,"sum_double",sizes);
+  ::anpi::benchmark::show();
+
+  compareReduction<double>(ReductionOp::Dot,2,"dot_double",sizes);
+  ::anpi::benchmark::show();
+
+  compareReduction<float>(ReductionOp::Sum,1,"sum_float",sizes);
+  compareReduction<double>(ReductionOp::Max,1,"max_double",sizes);
+  ::anpi::benchmark::show();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,136 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ */
+
+
+#include <boost/test/unit_test.hpp>
+
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+/**
+ * Batched root finders against a loop of the scalar ones
+ */
+#include "benchmarkFramework.hpp"
+#include "RootBatch.hpp"
+#include "RootBrent.hpp"
+
+BOOST_AUTO_TEST_SUITE( RootBatch )
+
+/// Equations x³ + x - p[i] = 0 evaluated on blocks
+template<typename T>
+struct cubicBlock {
+  const T* _p;
+  inline void operator()(const T* x,T* fx,
+                         const size_t first,const size_t count) const {
+    const T* p = _p + first;
+    for (size_t k=0;k<count;++k) {
+      fx[k] = x[k]*x[k]*x[k] + x[k] - p[k];
+    }
+  }
+};
+
+/// Solves per second, the size is the number of equations
+struct solves {
+  inline size_t operator()(const size_t size) const { return size; }
+};
+
+/**
+ * Solve size equations, in batches or one by one.  The scalar loop uses
+ * rootBrent for all methods: rootBisection stops on the relative change
+ * of the estimate and would not reach the same tolerance.
+ */
+template<typename T>
+class benchRootBatch {
+protected:
+  /// Method of the batches, or scalar loop if not batched
+  anpi::BatchRoot _method;
+  bool _batched;
+
+  /// Parameters, brackets and roots
+  std::vector<T> _p,_xl,_xu,_roots;
+public:
+  /// Construct
+  benchRootBatch(const anpi::BatchRoot method,const bool batched)
+    : _method(method),_batched(batched) {}
+
+  /// Prepare the evaluation of given size
+  void prepare(const size_t size) {
+    _p.resize(size);
+    _xl.assign(size,T(-3));
+    _xu.assign(size,T(3));
+    _roots.resize(size);
+    for (size_t i=0;i<size;++i) {
+      _p[i] = T(10)*std::sin(T(i));
+    }
+  }
+
+  /// Evaluate the solves
+  inline void eval() {
+    const T eps = std::sqrt(std::numeric_limits<T>::epsilon());
+    if (_batched) {
+      const cubicBlock<T> f = { _p.data() };
+      anpi::rootBatch(f,_xl.data(),_xu.data(),_roots.data(),
+                      _roots.size(),eps,_method);
+      return;
+    }
+    for (size_t i=0;i<_roots.size();++i) {
+      const T p = _p[i];
+      auto f = [p](const T x) { return x*x*x + x - p; };
+      _roots[i] = anpi::rootBrent(f,_xl[i],_xu[i],eps);
+    }
+  }
+};
+
+/// Measure one solver and plot its rate
+template<typename T>
+void measureRootBatch(const anpi::BatchRoot method,
+                      const bool batched,
+                      const std::string& tag,
+                      const std::string& color,
+                      const std::vector<size_t>& sizes) {
+  const size_t repetitions=5;
+  std::vector<anpi::benchmark::measurement> times,rates;
+  benchRootBatch<T> b(method,batched);
+  ANPI_BENCHMARK(sizes,repetitions,times,b);
+  ::anpi::benchmark::computeRates(times,solves(),rates,1.0e6);
+  ::anpi::benchmark::write(tag+".txt",rates);
+  ::anpi::benchmark::plotRange(rates,tag+" [Msolves/s]",color);
+}
+
+/// Scalar Brent loop against the three batched methods
+template<typename T>
+void compareRootBatch(const std::string& type,
+                      const std::vector<size_t>& sizes) {
+  measureRootBatch<T>(anpi::BatchRoot::Brent,false,
+                      "scalar_brent_"+type,"r",sizes);
+  measureRootBatch<T>(anpi::BatchRoot::Bisection,true,
+                      "batch_bisection_"+type,"g",sizes);
+  measureRootBatch<T>(anpi::BatchRoot::RegulaFalsi,true,
+                      "batch_regulafalsi_"+type,"m",sizes);
+  measureRootBatch<T>(anpi::BatchRoot::Brent,true,
+                      "batch_brent_"+type,"b",sizes);
+}
+
+BOOST_AUTO_TEST_CASE( Solves ) {
+
+  std::vector<size_t> sizes = {   1000,   3000,  10000,  30000,
+                                100000, 300000,1000000 };
+
+  compareRootBatch<double>("double",sizes);
+  ::anpi::benchmark::show();
+
+  compareRootBatch<float>("float",sizes);
+  ::anpi::benchmark::show();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
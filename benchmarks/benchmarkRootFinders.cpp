@@ -11,11 +11,18 @@
 #include <PlotPy.hpp>
 
 #include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+#include "benchmarkFramework.hpp"
 #include <RootSecant.hpp>
 #include <RootInterpolation.hpp>
 #include <RootBisection.hpp>
 #include <RootBrent.hpp>
 #include <RootNewtonRaphson.hpp>
+#include <RootHalley.hpp>
+#include <RootHouseholder.hpp>
+#include <RootOstrowski.hpp>
 
 /**
  *
@@ -199,6 +206,347 @@ namespace anpi {
             }
             bench::grafica(pMetodo, _error, _F1Llamadas,_F2Llamadas,_F3Llamadas);
         }
+
+        /// Bisection with the given callable
+        struct solveBisection {
+            template<typename T,class F>
+            inline T operator()(F& f,const T xl,const T xu,const T eps) const {
+                return anpi::rootBisection(f,xl,xu,eps);
+            }
+        };
+
+        /// Brent's method with the given callable
+        struct solveBrent {
+            template<typename T,class F>
+            inline T operator()(F& f,const T xl,const T xu,const T eps) const {
+                return anpi::rootBrent(f,xl,xu,eps);
+            }
+        };
+
+        /**
+         * Many solves of the same function, each one with a slightly
+         * different upper limit so that they cannot be merged.  The
+         * size is the number of solves per evaluation.
+         */
+        template<typename T,class F,class Solver>
+        class benchSolves {
+        protected:
+            F _f;
+            T _xl,_xu;
+            size_t _solves;
+            volatile T _result;
+        public:
+            benchSolves(const F& f,const T xl,const T xu)
+              : _f(f),_xl(xl),_xu(xu),_solves(0),_result(T(0)) {}
+
+            void prepare(const size_t size) { _solves=size; }
+
+            inline void eval() {
+                const Solver solver;
+                T s(0);
+                for (size_t i=0;i<_solves;++i) {
+                    s += solver(_f,_xl,_xu+T(i%8)/T(64),T(1.0e-5));
+                }
+                _result=s;
+            }
+        };
+
+        /// Average time of one solve in nanoseconds
+        template<typename T,class Solver,class F>
+        double nsPerSolve(const F& f,const T xl,const T xu) {
+            const size_t repetitions=10;
+            std::vector<size_t> sizes = { 20000 };
+            std::vector<anpi::benchmark::measurement> times;
+            benchSolves<T,F,Solver> b(f,xl,xu);
+            ANPI_BENCHMARK(sizes,repetitions,times,b);
+            return 1.0e9*times[0].average/double(times[0].size);
+        }
+
+        /// Compare a lambda, a function pointer and a std::function
+        template<typename T,class Solver,class L>
+        void compareCallables(const std::string& name,
+                              const L& lambda,
+                              T (*pointer)(const T),
+                              const T xl,
+                              const T xu) {
+            const std::function<T(T)> wrapped(pointer);
+            const double tl=nsPerSolve<T,Solver>(lambda,xl,xu);
+            const double tp=nsPerSolve<T,Solver>(pointer,xl,xu);
+            const double tf=nsPerSolve<T,Solver>(wrapped,xl,xu);
+            std::cout << name << " [ns/solve]: lambda " << tl
+                      << ", pointer " << tp
+                      << ", std::function " << tf << std::endl;
+        }
+
+        /// Callables of the three test functions with the given solver
+        template<typename T,class Solver>
+        void benchCallables(const std::string& method) {
+            compareCallables<T,Solver>(method+" t1",
+                                       [](const T x) { return t1<T>(x); },
+                                       t1<T>,T(0),T(2));
+            compareCallables<T,Solver>(method+" t2",
+                                       [](const T x) { return t2<T>(x); },
+                                       t2<T>,T(0),T(2));
+            compareCallables<T,Solver>(method+" t3",
+                                       [](const T x) { return t3<T>(x); },
+                                       t3<T>,T(0.5),T(1.5));
+        }
+
+        /// Test function 1 for any number type, and its derivative
+        struct problem1 {
+            template<typename U>
+            U operator()(const U& x) const {
+                using std::abs; using std::exp;
+                return abs(x)-exp(-x);
+            }
+            template<typename T>
+            T derivative(const T x) const {
+                return ((x < T(0)) ? T(-1) : T(1)) + std::exp(-x);
+            }
+        };
+
+        /// Test function 2 for any number type, and its derivative
+        struct problem2 {
+            template<typename U>
+            U operator()(const U& x) const {
+                using std::exp;
+                return exp(-x*x) - exp(-(x-3)*(x-3)/3);
+            }
+            template<typename T>
+            T derivative(const T x) const {
+                return -T(2)*x*std::exp(-x*x) +
+                    T(2)*(x-T(3))/T(3)*std::exp(-sqr(x-T(3))/T(3));
+            }
+        };
+
+        /// Test function 3 for any number type, and its derivative
+        struct problem3 {
+            template<typename U>
+            U operator()(const U& x) const {
+                using std::atan;
+                return x*x-atan(x);
+            }
+            template<typename T>
+            T derivative(const T x) const {
+                return T(2)*x - T(1)/(T(1)+x*x);
+            }
+        };
+
+        /// Counts the evaluations of a problem and of its derivative
+        template<class P>
+        struct countedProblem {
+            P _p;
+            mutable int _calls, _dcalls;
+            countedProblem() : _calls(0),_dcalls(0) {}
+            template<typename U>
+            U operator()(const U& x) const { ++_calls; return _p(x); }
+            template<typename T>
+            T derivative(const T x) const { ++_dcalls; return _p.derivative(x); }
+        };
+
+        /// Newton-Raphson with the forward difference derivative
+        struct newtonFD {
+            template<typename T,class P>
+            inline T operator()(const P& p,const T x0,const T eps) const {
+                return anpi::rootNewtonRaphson([&p](const T x) { return p(x); },
+                                               x0,eps);
+            }
+        };
+
+        /// Newton-Raphson with automatic differentiation
+        struct newtonAD {
+            template<typename T,class P>
+            inline T operator()(const P& p,const T x0,const T eps) const {
+                return anpi::rootNewtonRaphsonAD(p,x0,eps);
+            }
+        };
+
+        /// Newton-Raphson with the analytic derivative
+        struct newtonAnalytic {
+            template<typename T,class P>
+            inline T operator()(const P& p,const T x0,const T eps) const {
+                return anpi::rootNewtonRaphson(
+                    [&p](const T x) { return p(x); },
+                    [&p](const T x) { return p.template derivative<T>(x); },
+                    x0,eps);
+            }
+        };
+
+        /**
+         * Many Newton solves of the same problem, each one from a
+         * slightly different initial guess so that they cannot be merged.
+         */
+        template<typename T,class P,class Solver>
+        class benchNewton {
+        protected:
+            P _p;
+            T _x0,_eps;
+            size_t _solves;
+            volatile T _result;
+        public:
+            benchNewton(const T x0,const T eps)
+              : _x0(x0),_eps(eps),_solves(0),_result(T(0)) {}
+
+            void prepare(const size_t size) { _solves=size; }
+
+            inline void eval() {
+                const Solver solver;
+                T s(0);
+                for (size_t i=0;i<_solves;++i) {
+                    s += solver(_p,_x0+T(i%8)/T(256),_eps);
+                }
+                _result=s;
+            }
+        };
+
+        /// Evaluations and average time of one Newton solve
+        template<typename T,class P,class Solver>
+        void newtonCost(const std::string& name,const T x0,const T eps) {
+            countedProblem<P> counter;
+            const T root=Solver()(counter,x0,eps);
+
+            const size_t repetitions=10;
+            std::vector<size_t> sizes = { 20000 };
+            std::vector<anpi::benchmark::measurement> times;
+            benchNewton<T,P,Solver> b(x0,eps);
+            ANPI_BENCHMARK(sizes,repetitions,times,b);
+
+            std::cout << "  " << name << ": " << counter._calls << " f";
+            if (counter._dcalls > 0) {
+                std::cout << " + " << counter._dcalls << " f'";
+            }
+            std::cout << " evaluations, "
+                      << 1.0e9*times[0].average/double(times[0].size)
+                      << " ns/solve, |f(root)|=" << std::abs(P()(root))
+                      << std::endl;
+        }
+
+        /// Finite differences against exact derivatives on one problem
+        template<typename T,class P>
+        void compareDerivatives(const std::string& name,const T x0) {
+            const T tolerances[] = { T(1.0e-3), T(1.0e-6),
+                                     std::numeric_limits<T>::epsilon()*T(64) };
+            for (const T eps : tolerances) {
+                std::cout << name << ", eps=" << eps << std::endl;
+                newtonCost<T,P,newtonFD>("forward difference",x0,eps);
+                newtonCost<T,P,newtonAD>("automatic",x0,eps);
+                newtonCost<T,P,newtonAnalytic>("analytic",x0,eps);
+            }
+        }
+
+        /// Any scalar closed root finder on a problem of any number type
+        template<class Solver>
+        struct closedScalar {
+            template<typename T,class P>
+            inline T operator()(const P& p,const T xl,const T xu,const T eps) const {
+                auto f = [&p](const T x) { return p(x); };
+                return Solver()(f,xl,xu,eps);
+            }
+        };
+
+        /// Regula falsi with the given callable
+        struct solveInterpolation {
+            template<typename T,class F>
+            inline T operator()(F&& f,const T xl,const T xu,const T eps) const {
+                return anpi::rootInterpolation(f,xl,xu,eps);
+            }
+        };
+
+        /// The secant starts at both ends of the interval
+        struct solveSecant {
+            template<typename T,class F>
+            inline T operator()(F&& f,const T xl,const T xu,const T eps) const {
+                return anpi::rootSecant(f,xl,xu,eps);
+            }
+        };
+
+        /// Newton-Raphson starts at the upper end of the interval
+        struct solveNewton {
+            template<typename T,class F>
+            inline T operator()(F&& f,const T,const T xu,const T eps) const {
+                return anpi::rootNewtonRaphson(f,xu,eps);
+            }
+        };
+
+        /// Halley's method with automatic differentiation
+        struct solveHalley {
+            template<typename T,class P>
+            inline T operator()(const P& p,const T xl,const T xu,const T eps) const {
+                return anpi::rootHalley(p,xl,xu,eps);
+            }
+        };
+
+        /// Householder's third order method with automatic differentiation
+        struct solveHouseholder {
+            template<typename T,class P>
+            inline T operator()(const P& p,const T xl,const T xu,const T eps) const {
+                return anpi::rootHouseholder(p,xl,xu,eps);
+            }
+        };
+
+        /// Ostrowski's method with automatic differentiation
+        struct solveOstrowski {
+            template<typename T,class P>
+            inline T operator()(const P& p,const T xl,const T xu,const T eps) const {
+                return anpi::rootOstrowski(p,xl,xu,eps);
+            }
+        };
+
+        /**
+         * Evaluations against achieved error of a solver on the three
+         * test functions, for tolerances from 1e-1 down to 1e-7.  Each
+         * call of the function counts as one evaluation, also on nested
+         * duals where it gives the derivatives too.  The third function
+         * is solved in [0.5,2], as in [0,0.5] its root is at an end.
+         */
+        template<typename T,class Solver>
+        void benchOrders(const std::string& pMetodo) {
+            const T xl[] = { T(0), T(0), T(0.5) };
+            const T xu[] = { T(2), T(2), T(2) };
+            const T roots[] = { T(0.56714329040978387L),
+                                T(1.09807621135331594L),
+                                T(0.83360619440667600L) };
+
+            std::vector<T> _error, _F1Llamadas, _F2Llamadas, _F3Llamadas;
+            std::vector<T>* llamadas[] = { &_F1Llamadas, &_F2Llamadas, &_F3Llamadas };
+
+            std::cout << pMetodo << std::endl;
+            for (T eps=T(1)/T(10); eps>static_cast<T>(1.0e-7); eps/=T(10)) {
+                std::cout << "  eps=" << eps;
+                for (int i=0;i<3;++i) {
+                    countedProblem<problem1> c1;
+                    countedProblem<problem2> c2;
+                    countedProblem<problem3> c3;
+                    T sol(0);
+                    int calls=0;
+                    switch (i) {
+                    case 0: sol=Solver()(c1,xl[i],xu[i],eps); calls=c1._calls; break;
+                    case 1: sol=Solver()(c2,xl[i],xu[i],eps); calls=c2._calls; break;
+                    default: sol=Solver()(c3,xl[i],xu[i],eps); calls=c3._calls; break;
+                    }
+                    BOOST_CHECK(0 < calls);
+                    llamadas[i]->push_back(T(calls));
+                    std::cout << " | t" << i+1 << ": " << calls
+                              << " evaluations, error " << std::abs(sol-roots[i]);
+                }
+                std::cout << std::endl;
+                _error.push_back(eps*100);
+            }
+            bench::grafica(pMetodo, _error, _F1Llamadas,_F2Llamadas,_F3Llamadas);
+        }
+
+        /// The five classic methods and the higher order ones, side by side
+        template<typename T>
+        void compareOrders(const std::string& precision) {
+            benchOrders<T,closedScalar<solveBisection> >(precision+" Biseccion");
+            benchOrders<T,closedScalar<solveInterpolation> >(precision+" Interpolacion");
+            benchOrders<T,closedScalar<solveSecant> >(precision+" Secante");
+            benchOrders<T,closedScalar<solveNewton> >(precision+" Newton-Raphson");
+            benchOrders<T,closedScalar<solveBrent> >(precision+" Brent");
+            benchOrders<T,solveHalley>(precision+" Halley");
+            benchOrders<T,solveHouseholder>(precision+" Householder");
+            benchOrders<T,solveOstrowski>(precision+" Ostrowski");
+        }
     } // bench
 }  // anpi
 
@@ -235,4 +583,26 @@ BOOST_AUTO_TEST_SUITE( Bench )
         anpi::bench::benchTest<double>(anpi::rootBrent<double>, "Presicion doble Brent");
     }
 
+    BOOST_AUTO_TEST_CASE(HigherOrder)
+    {
+        anpi::bench::compareOrders<float>("Presicion simple");
+        anpi::bench::compareOrders<double>("Presicion doble");
+    }
+
+    BOOST_AUTO_TEST_CASE(Derivatives)
+    {
+        using namespace anpi::bench;
+        compareDerivatives<double,problem1>("Newton double t1",0.0);
+        compareDerivatives<double,problem2>("Newton double t2",2.0);
+        compareDerivatives<double,problem3>("Newton double t3",1.0);
+        compareDerivatives<float,problem3>("Newton float t3",1.0f);
+    }
+
+    BOOST_AUTO_TEST_CASE(Callables)
+    {
+        anpi::bench::benchCallables<double,anpi::bench::solveBisection>("Bisection double");
+        anpi::bench::benchCallables<double,anpi::bench::solveBrent>("Brent double");
+        anpi::bench::benchCallables<float,anpi::bench::solveBrent>("Brent float");
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -0,0 +1,118 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ */
+
+
+#include <boost/test/unit_test.hpp>
+
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+
+/**
+ * Scan of all roots in an interval against a serial scan-then-solve
+ */
+#include "benchmarkFramework.hpp"
+#include "RootScan.hpp"
+#include "RootBrent.hpp"
+
+BOOST_AUTO_TEST_SUITE( RootScan )
+
+/// Subintervals per unit length of the scanned interval
+static const size_t scanDensity = 64;
+
+/// Fast oscillation with a slow modulation
+struct oscillating {
+  inline double operator()(const double x) const {
+    return std::sin(50.0*x) + 0.25*std::cos(3.0*x);
+  }
+};
+
+/// Damped oscillation whose roots disappear at the end
+struct damped {
+  inline double operator()(const double x) const {
+    return std::exp(-0.002*x)*std::cos(20.0*x) - 0.2;
+  }
+};
+
+/// Samples per second, the size is the length of the interval [0,size]
+struct samples {
+  inline size_t operator()(const size_t size) const {
+    return size*scanDensity;
+  }
+};
+
+/// Find all roots in [0,size], with rootScan or serially
+template<class F,bool Parallel>
+class benchScan {
+protected:
+  F _f;
+  double _b;
+  std::vector<double> _roots;
+public:
+  /// Prepare the evaluation of given size
+  void prepare(const size_t size) { _b=double(size); }
+
+  /// Scan with a brent solve per sign change
+  inline void eval() {
+    const double eps=1.0e-10;
+    const size_t intervals=size_t(_b)*scanDensity;
+    if (Parallel) {
+      _roots=anpi::rootScan(_f,0.0,_b,eps,intervals);
+      return;
+    }
+    _roots.clear();
+    const double h=_b/double(intervals);
+    double xl=0.0, fl=_f(xl);
+    for (size_t i=1;i<=intervals;++i) {
+      const double xu=double(i)*h, fu=_f(xu);
+      if ((fl < 0.0) != (fu < 0.0)) {
+        _roots.push_back(anpi::rootBrent(_f,xl,xu,eps));
+      }
+      xl=xu;
+      fl=fu;
+    }
+  }
+};
+
+/// Serial scan against rootScan on the given function
+template<class F>
+void compareScan(const std::string& tag,const std::vector<size_t>& sizes) {
+  const size_t repetitions=10;
+  {
+    std::vector<anpi::benchmark::measurement> times,rates;
+    benchScan<F,false> b;
+    ANPI_BENCHMARK(sizes,repetitions,times,b);
+    ::anpi::benchmark::computeRates(times,samples(),rates,1.0e6);
+    ::anpi::benchmark::write(tag+"_serial.txt",rates);
+    ::anpi::benchmark::plotRange(rates,tag+" serial [Msamples/s]","r");
+  }
+  {
+    std::vector<anpi::benchmark::measurement> times,rates;
+    benchScan<F,true> b;
+    ANPI_BENCHMARK(sizes,repetitions,times,b);
+    ::anpi::benchmark::computeRates(times,samples(),rates,1.0e6);
+    ::anpi::benchmark::write(tag+"_scan.txt",rates);
+    ::anpi::benchmark::plotRange(rates,tag+" rootScan [Msamples/s]","b");
+  }
+}
+
+BOOST_AUTO_TEST_CASE( AllRoots ) {
+
+  std::vector<size_t> sizes = { 4, 16, 64, 256, 1024, 4096 };
+
+  compareScan<oscillating>("scan_oscillating",sizes);
+  ::anpi::benchmark::show();
+
+  compareScan<damped>("scan_damped",sizes);
+  ::anpi::benchmark::show();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,117 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ */
+
+
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <string>
+
+/**
+ * Throughput of the binary matrix files
+ */
+#include "benchmarkFramework.hpp"
+#include "Matrix.hpp"
+#include "MatrixIO.hpp"
+
+BOOST_AUTO_TEST_SUITE( Serialization )
+
+/// Bytes stored for a size x size matrix of T
+template<typename T>
+struct fileBytes {
+  inline size_t operator()(const size_t size) const {
+    return size*size*sizeof(T);
+  }
+};
+
+/// Common state of the file benchmarks
+template<typename T>
+class benchFile {
+protected:
+  /// Temporary file
+  std::string _path;
+
+  /// Saved and loaded matrices
+  anpi::Matrix<T> _a;
+  anpi::Matrix<T> _b;
+public:
+  /// Construct
+  benchFile(const size_t) {
+    namespace fs = boost::filesystem;
+    _path = (fs::temp_directory_path() /
+             fs::unique_path("anpi-bench-%%%%-%%%%.mat")).string();
+  }
+
+  /// Remove the temporary file
+  ~benchFile() {
+    boost::filesystem::remove(_path);
+  }
+
+  /// Prepare the evaluation of given size
+  void prepare(const size_t size) {
+    _a = anpi::Matrix<T>(size,size,T(1));
+    anpi::save(_path,_a);
+  }
+};
+
+/// Save a matrix
+template<typename T>
+class benchSave : public benchFile<T> {
+public:
+  /// Constructor
+  benchSave(const size_t n) : benchFile<T>(n) { }
+
+  // Evaluate save
+  inline void eval() {
+    anpi::save(this->_path,this->_a);
+  }
+};
+
+/// Load a matrix
+template<typename T>
+class benchLoad : public benchFile<T> {
+public:
+  /// Constructor
+  benchLoad(const size_t n) : benchFile<T>(n) { }
+
+  // Evaluate load
+  inline void eval() {
+    anpi::load(this->_path,this->_b);
+  }
+};
+
+BOOST_AUTO_TEST_CASE( SaveLoad ) {
+
+  std::vector<size_t> sizes = {  128,  256,  512, 1024, 2048, 4096 };
+
+  const size_t repetitions=10;
+  std::vector<anpi::benchmark::measurement> times,rates;
+
+  {
+    benchSave<float> bs(0);
+    ANPI_BENCHMARK(sizes,repetitions,times,bs);
+    ::anpi::benchmark::computeRates(times,fileBytes<float>(),rates);
+    ::anpi::benchmark::write("serialization_save_float.txt",rates);
+    ::anpi::benchmark::plotRange(rates,"save [GB/s]","r");
+  }
+
+  {
+    benchLoad<float> bl(0);
+    ANPI_BENCHMARK(sizes,repetitions,times,bl);
+    ::anpi::benchmark::computeRates(times,fileBytes<float>(),rates);
+    ::anpi::benchmark::write("serialization_load_float.txt",rates);
+    ::anpi::benchmark::plotRange(rates,"load [GB/s]","g");
+  }
+
+  ::anpi::benchmark::show();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
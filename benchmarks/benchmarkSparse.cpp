@@ -0,0 +1,154 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ */
+
+
+#include <boost/test/unit_test.hpp>
+
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+/**
+ * Sparse matrix-vector product
+ */
+#include "benchmarkFramework.hpp"
+#include "SparseMatrix.hpp"
+
+BOOST_AUTO_TEST_SUITE( Sparse )
+
+/// Bytes moved by one product of a size x size matrix with nnz per row
+template<typename T>
+struct spmvBytes {
+  size_t _nnz;
+  spmvBytes(const size_t nnz) : _nnz(nnz) {}
+  inline size_t operator()(const size_t size) const {
+    return size*_nnz*(sizeof(T)+sizeof(anpi::sparse_index)) // entries
+      + (size+1)*sizeof(size_t)                              // row pointers
+      + 2*size*sizeof(T);                                    // x and y
+  }
+};
+
+/// Sparse product with a given number of nonzeros per row
+template<typename T>
+class benchSpmv {
+protected:
+  /// Nonzeros per row
+  const size_t _nnz;
+
+  /// State of the benchmarked evaluation
+  anpi::SparseMatrix<T> _a;
+  std::vector<T> _x;
+  std::vector<T> _y;
+public:
+  /// Construct
+  benchSpmv(const size_t nnz) : _nnz(nnz) {}
+
+  /**
+   * Prepare the evaluation of given size.
+   *
+   * Half of the nonzeros of each row form a band around the diagonal,
+   * like a stencil, and the other half are scattered over the row.
+   */
+  void prepare(const size_t size) {
+    std::vector< anpi::Triplet<T> > entries;
+    entries.reserve(size*_nnz);
+    unsigned int seed = 1;
+    for (size_t r=0;r<size;++r) {
+      const size_t band = _nnz/2;
+      for (size_t j=0;j<band;++j) {
+        entries.push_back(anpi::Triplet<T>(r,(r+j)%size,T(1)));
+      }
+      for (size_t j=band;j<_nnz;++j) {
+        seed = seed*1103515245u + 12345u;
+        entries.push_back(anpi::Triplet<T>(r,(seed >> 4)%size,T(1)));
+      }
+    }
+    _a = anpi::SparseMatrix<T>(size,size,entries);
+    _x.assign(size,T(1));
+  }
+};
+
+/// Scalar rows
+template<typename T>
+class benchSpmvFallback : public benchSpmv<T> {
+public:
+  /// Constructor
+  benchSpmvFallback(const size_t nnz) : benchSpmv<T>(nnz) { }
+
+  // Evaluate the product
+  inline void eval() {
+    this->_y.resize(this->_a.rows());
+    anpi::fallback::spmv(this->_a.rows(),this->_a.rowPtr().data(),
+                         this->_a.colIndices().data(),
+                         this->_a.values().data(),
+                         this->_x.data(),this->_y.data());
+  }
+};
+
+/// Gathered SIMD rows
+template<typename T>
+class benchSpmvSIMD : public benchSpmv<T> {
+public:
+  /// Constructor
+  benchSpmvSIMD(const size_t nnz) : benchSpmv<T>(nnz) { }
+
+  // Evaluate the product
+  inline void eval() {
+    anpi::multiply(this->_a,this->_x,this->_y);
+  }
+};
+
+BOOST_AUTO_TEST_CASE( Product ) {
+
+  std::vector<size_t> sizes = {   1024,   4096,  16384,  65536,
+                                262144, 1048576 };
+
+  const size_t repetitions=10;
+  std::vector<anpi::benchmark::measurement> times,rates;
+
+  // 5-point and 27-point stencils, and a denser row
+  const size_t densities[] = { 5, 27, 100 };
+  const char* colors[][2] = { {"r","m"}, {"b","c"}, {"g","k"} };
+
+  for (size_t d=0;d<3;++d) {
+    const size_t nnz = densities[d];
+    const std::string tag = std::to_string(nnz);
+
+    {
+      benchSpmvFallback<double> bs(nnz);
+      ANPI_BENCHMARK(sizes,repetitions,times,bs);
+      ::anpi::benchmark::computeRates(times,spmvBytes<double>(nnz),rates);
+      ::anpi::benchmark::write("spmv_double_"+tag+"_fb.txt",rates);
+      ::anpi::benchmark::plotRange(rates,"SpMV (double) "+tag+
+                                   " nnz/row fallback [GB/s]",colors[d][0]);
+    }
+
+    {
+      benchSpmvSIMD<double> bs(nnz);
+      ANPI_BENCHMARK(sizes,repetitions,times,bs);
+      ::anpi::benchmark::computeRates(times,spmvBytes<double>(nnz),rates);
+      ::anpi::benchmark::write("spmv_double_"+tag+"_simd.txt",rates);
+      ::anpi::benchmark::plotRange(rates,"SpMV (double) "+tag+
+                                   " nnz/row simd [GB/s]",colors[d][1]);
+    }
+  }
+
+  {
+    benchSpmvSIMD<float> bs(27);
+    ANPI_BENCHMARK(sizes,repetitions,times,bs);
+    ::anpi::benchmark::computeRates(times,spmvBytes<float>(27),rates);
+    ::anpi::benchmark::write("spmv_float_27_simd.txt",rates);
+    ::anpi::benchmark::plotRange(rates,"SpMV (float) 27 nnz/row simd [GB/s]","y");
+  }
+
+  ::anpi::benchmark::show();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -16,7 +16,12 @@
 
 namespace anpi {
 
-# if defined __AVX512F__
+  /*
+   * On x86-64 the SIMD kernels may choose AVX-512 at run time (see
+   * CpuFeatures.hpp), so the buffers are aligned for the widest registers
+   * independently of the compilation flags.
+   */
+# if defined __AVX512F__ || defined __x86_64__
   static const size_t DefaultAlignment = 64;
 # elif defined __AVX2__
   static const size_t DefaultAlignment = 32;
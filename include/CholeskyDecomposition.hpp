@@ -0,0 +1,227 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date  : 07.01.2018
+ */
+
+#ifndef ANPI_CHOLESKY_DECOMPOSITION_HPP
+#define ANPI_CHOLESKY_DECOMPOSITION_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "Exception.hpp"
+#include "Matrix.hpp"
+
+namespace anpi {
+
+  /*
+   * Cholesky decomposition A = L*L^T of symmetric positive definite
+   * matrices.
+   *
+   * Only the lower triangle of A is read.  The factor L is returned as
+   * a full matrix with zeros above the diagonal.
+   */
+
+  namespace bits {
+    /**
+     * Unblocked Cholesky decomposition of the block L(k:k+kb,k:k+kb),
+     * which holds the lower triangle of the updated A11.
+     *
+     * @throw anpi::Exception if the block is not positive definite
+     */
+    template<typename T,class Alloc>
+    void choleskyDiagonal(Matrix<T,Alloc>& L,
+                          const size_t k,
+                          const size_t kb) {
+      const size_t kend = k+kb;
+      for (size_t j=k;j<kend;++j) {
+        const T* rowj = L[j];
+        T d = rowj[j];
+        for (size_t p=k;p<j;++p) {
+          d -= rowj[p]*rowj[p];
+        }
+        if (!(d > T(0))) {
+          throw Exception("Cholesky decomposition of a matrix "
+                          "not positive definite");
+        }
+        const T ljj = std::sqrt(d);
+        L(j,j) = ljj;
+        const T inv = T(1)/ljj;
+
+        for (size_t i=j+1;i<kend;++i) {
+          T* rowi = L[i];
+          T s = rowi[j];
+          for (size_t p=k;p<j;++p) {
+            s -= rowi[p]*rowj[p];
+          }
+          rowi[j] = s*inv;
+        }
+      }
+    }
+
+    /// Zero the entries above the diagonal
+    template<typename T,class Alloc>
+    void clearUpper(Matrix<T,Alloc>& L) {
+      for (size_t i=0;i<L.rows();++i) {
+        std::fill(L[i]+i+1,L[i]+L.cols(),T(0));
+      }
+    }
+  } // namespace bits
+
+  /**
+   * Unblocked Cholesky decomposition, kept as reference for the blocked
+   * version cholesky() below.
+   *
+   * @param A symmetric positive definite matrix
+   * @param L lower triangular factor
+   *
+   * @throw anpi::Exception if A is not square or not positive definite
+   */
+  template<typename T,class Alloc>
+  void choleskyUnblocked(const Matrix<T,Alloc>& A,
+                         Matrix<T,Alloc>& L) {
+    if (A.rows() != A.cols()) {
+      throw Exception("Cholesky decomposition requires a square matrix");
+    }
+    L = A;
+    bits::choleskyDiagonal(L,0,A.rows());
+    bits::clearUpper(L);
+  }
+
+  /**
+   * Blocked right-looking Cholesky decomposition.
+   *
+   * The columns are processed in panels of blockSize columns.  The
+   * diagonal block of each panel is factorized with the unblocked
+   * algorithm, the block L21 below it is solved against L11^T, and the
+   * lower triangle of the trailing submatrix receives the symmetric
+   * update A22 = A22 - L21*L21^T.  That update is split in block rows,
+   * each one reaching just up to the diagonal, and runs through the
+   * (SIMD) matrix product kernel.
+   *
+   * @param A symmetric positive definite matrix
+   * @param L lower triangular factor
+   * @param blockSize number of columns per panel
+   *
+   * @throw anpi::Exception if A is not square or not positive definite
+   */
+  template<typename T,class Alloc>
+  void cholesky(const Matrix<T,Alloc>& A,
+                Matrix<T,Alloc>& L,
+                const size_t blockSize=64) {
+    if (A.rows() != A.cols()) {
+      throw Exception("Cholesky decomposition requires a square matrix");
+    }
+
+    const size_t n = A.rows();
+    const size_t nb = std::max(blockSize,size_t(1));
+    L = A;
+
+    // L21^T, as right operand of the trailing update
+    Matrix<T,Alloc> L21t;
+
+    for (size_t k=0;k<n;k+=nb) {
+      const size_t kb = std::min(nb,n-k);
+      const size_t kend = k+kb;
+
+      bits::choleskyDiagonal(L,k,kb);
+
+      if (kend == n) {
+        break;
+      }
+      const size_t rest = n-kend;
+
+      // L21 = A21 * L11^-T, solving each row against L11
+      for (size_t i=kend;i<n;++i) {
+        T* rowi = L[i];
+        for (size_t j=k;j<kend;++j) {
+          const T* rowj = L[j];
+          T s = rowi[j];
+          for (size_t p=k;p<j;++p) {
+            s -= rowi[p]*rowj[p];
+          }
+          rowi[j] = s/rowj[j];
+        }
+      }
+
+      L21t.allocate(kb,rest);
+      L21t.view().fillTransposed(L.block(kend,k,rest,kb));
+
+      // lower triangle of A22 = A22 - L21*L21^T, by block rows
+      for (size_t r=kend;r<n;r+=nb) {
+        const size_t rb = std::min(nb,n-r);
+        const size_t width = r+rb-kend;
+        aimpl::multiplyAdd(T(-1),
+                           ConstMatrixView<T>(L.block(r,k,rb,kb)),
+                           ConstMatrixView<T>(L21t.block(0,0,kb,width)),
+                           L.block(r,kend,rb,width));
+      }
+    }
+
+    bits::clearUpper(L);
+  }
+
+  /**
+   * Solve L*L^T*x = b with the factor of cholesky()
+   *
+   * @param L lower triangular factor
+   * @param b right-hand side
+   * @param x solution
+   */
+  template<typename T,class Alloc>
+  void choleskySubstitute(const Matrix<T,Alloc>& L,
+                          const std::vector<T>& b,
+                          std::vector<T>& x) {
+    const size_t n = L.rows();
+    if (b.size() != n) {
+      throw Exception("Right-hand side does not match the Cholesky factor");
+    }
+
+    std::vector<T> y(b);
+
+    // forward substitution with L
+    for (size_t i=0;i<n;++i) {
+      const T* row = L[i];
+      T sum = y[i];
+      for (size_t j=0;j<i;++j) {
+        sum -= row[j]*y[j];
+      }
+      y[i] = sum/row[i];
+    }
+
+    // back substitution with L^T, by columns of L^T (rows of L)
+    for (size_t i=n;i-- > 0;) {
+      const T* row = L[i];
+      y[i] /= row[i];
+      const T yi = y[i];
+      for (size_t j=0;j<i;++j) {
+        y[j] -= row[j]*yi;
+      }
+    }
+
+    x.swap(y);
+  }
+
+  /**
+   * Solve the symmetric positive definite system A*x = b
+   */
+  template<typename T,class Alloc>
+  void solveCholesky(const Matrix<T,Alloc>& A,
+                     std::vector<T>& x,
+                     const std::vector<T>& b) {
+    Matrix<T,Alloc> L;
+    cholesky(A,L);
+    choleskySubstitute(L,b,x);
+  }
+
+} // namespace anpi
+
+#endif
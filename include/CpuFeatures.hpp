@@ -0,0 +1,209 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @author Pablo Alvarado
+ * @date   15.12.2017
+ */
+
+#ifndef ANPI_CPU_FEATURES_HPP
+#define ANPI_CPU_FEATURES_HPP
+
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#  include <unistd.h>
+#endif
+
+#include "Intrinsics.hpp"
+
+namespace anpi {
+  namespace simd {
+
+    /**
+     * Instruction set levels of the SIMD kernels.
+     *
+     * The numeric values are the ANPI_SIMD_LEVEL of the kernels, so that
+     * a higher value means wider registers.
+     */
+    enum class Isa : int {
+      None   = 0, ///< Scalar fallback kernels only
+      SSE2   = 1, ///< 128-bit registers
+      AVX2   = 2, ///< 256-bit registers, with FMA
+      AVX512 = 3  ///< 512-bit registers (F, BW, DQ and VL subsets)
+    };
+
+    /// Name of an instruction set level, as accepted by ANPI_SIMD
+    inline const char* isaName(const Isa isa) {
+      switch (isa) {
+      case Isa::SSE2:   return "sse2";
+      case Isa::AVX2:   return "avx2";
+      case Isa::AVX512: return "avx512";
+      default:          return "none";
+      }
+    }
+
+    /**
+     * Parse the name of an instruction set level.
+     *
+     * @return false if the name is unknown, leaving isa untouched
+     */
+    inline bool parseIsa(const char* name,Isa& isa) {
+      const Isa all[] = { Isa::None, Isa::SSE2, Isa::AVX2, Isa::AVX512 };
+      for (size_t i=0;i<sizeof(all)/sizeof(all[0]);++i) {
+        if (std::strcmp(name,isaName(all[i]))==0) {
+          isa=all[i];
+          return true;
+        }
+      }
+      return false;
+    }
+
+    /**
+     * Widest instruction set level supported by both the running CPU
+     * and the compiled kernels.
+     *
+     * With runtime dispatch the CPU is queried through cpuid, which
+     * also verifies that the operating system saves the wide registers.
+     */
+    inline Isa detectIsa() {
+#ifdef ANPI_SIMD_DISPATCH
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx512f")  &&
+          __builtin_cpu_supports("avx512bw") &&
+          __builtin_cpu_supports("avx512dq") &&
+          __builtin_cpu_supports("avx512vl")) {
+        return Isa::AVX512;
+      }
+      if (__builtin_cpu_supports("avx2") &&
+          __builtin_cpu_supports("fma")) {
+        return Isa::AVX2;
+      }
+      if (__builtin_cpu_supports("sse2")) {
+        return Isa::SSE2;
+      }
+      return Isa::None;
+#else
+      return Isa(ANPI_SIMD_MAX_LEVEL);
+#endif
+    }
+
+    /**
+     * Instruction set level chosen at startup: the detected one, unless
+     * the environment variable ANPI_SIMD names a narrower one
+     * ("none", "sse2", "avx2" or "avx512").  Wider levels than the
+     * detected one are ignored, as they would crash.
+     */
+    inline Isa defaultIsa() {
+      const Isa detected = detectIsa();
+      Isa requested = detected;
+      const char* env = std::getenv("ANPI_SIMD");
+      if ( (env != 0) && parseIsa(env,requested) ) {
+        return std::min(requested,detected);
+      }
+      return detected;
+    }
+
+    /// Storage of the instruction set level in use
+    inline Isa& _isa() {
+      static Isa isa = defaultIsa();
+      return isa;
+    }
+
+    /// Instruction set level used by the SIMD kernels
+    inline Isa isa() { return _isa(); }
+
+    /**
+     * Change the instruction set level used by the SIMD kernels.
+     *
+     * The level is limited to the one supported by the CPU.  This is
+     * meant to be called at configuration time, when no kernel is
+     * running.
+     */
+    inline void setIsa(const Isa isa) {
+      _isa() = std::min(isa,detectIsa());
+    }
+
+    /// Last level cache size assumed if it cannot be detected
+    static const size_t DefaultCacheSize = size_t(8) << 20;
+
+    /// Streaming threshold that disables the streaming stores
+    static const size_t NoStreaming = std::numeric_limits<size_t>::max();
+
+    /**
+     * Size in bytes of the last level data cache of the running CPU.
+     *
+     * The size is queried from the C library where it is available
+     * (the deepest level reported), or DefaultCacheSize otherwise.
+     */
+    inline size_t detectCacheSize() {
+#if defined(_SC_LEVEL3_CACHE_SIZE) && defined(_SC_LEVEL2_CACHE_SIZE)
+      const long l3 = sysconf(_SC_LEVEL3_CACHE_SIZE);
+      if (l3 > 0) {
+        return size_t(l3);
+      }
+      const long l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+      if (l2 > 0) {
+        return size_t(l2);
+      }
+#endif
+      return DefaultCacheSize;
+    }
+
+    /**
+     * Output size in bytes from which the on-copy kernels write with
+     * non-temporal (streaming) stores: the size of the last level cache,
+     * unless the environment variable ANPI_STREAM_THRESHOLD gives another
+     * number of bytes.
+     */
+    inline size_t defaultStreamingThreshold() {
+      const char* env = std::getenv("ANPI_STREAM_THRESHOLD");
+      if (env != 0) {
+        char* end = 0;
+        const unsigned long long bytes = std::strtoull(env,&end,10);
+        if ( (end != env) && (*end == 0) ) {
+          return size_t(bytes);
+        }
+      }
+      return detectCacheSize();
+    }
+
+    /// Storage of the streaming threshold
+    inline size_t& _streamingThreshold() {
+      static size_t bytes = defaultStreamingThreshold();
+      return bytes;
+    }
+
+    /**
+     * Change the output size in bytes from which the on-copy kernels
+     * use streaming stores.  With 0 they are always used, and with
+     * NoStreaming never.
+     */
+    inline void setStreamingThreshold(const size_t bytes) {
+      _streamingThreshold() = bytes;
+    }
+
+    /// Output size in bytes from which the streaming stores are used
+    inline size_t streamingThreshold() { return _streamingThreshold(); }
+
+    /**
+     * Check if an output of the given size must bypass the caches.
+     *
+     * Results much larger than the last level cache would be evicted
+     * before they are read again, and writing them through the cache
+     * first reads each line from memory (read for ownership) and evicts
+     * the operands.
+     */
+    inline bool streaming(const size_t bytes) {
+      return bytes >= streamingThreshold();
+    }
+
+  } // namespace simd
+} // namespace anpi
+
+#endif
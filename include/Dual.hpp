@@ -0,0 +1,275 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date  : 10.02.2018
+ */
+
+#include <cmath>
+#include <type_traits>
+
+#ifndef ANPI_DUAL_HPP
+#define ANPI_DUAL_HPP
+
+namespace anpi {
+
+  /**
+   * Dual number v + d·ε with ε² = 0, for forward automatic
+   * differentiation.
+   *
+   * Evaluating a function f on Dual<T>(x,1) gives f(x) as value and
+   * f'(x) as derivative, exact up to rounding, in a single pass.  The
+   * function must be written for any number type, e.g. as a function
+   * template or a functor with a template operator(), and call the
+   * math functions unqualified so that the overloads below are found:
+   *
+   * \code
+   * struct f {
+   *   template<typename U>
+   *   U operator()(const U& x) const { using std::exp; return x*exp(-x); }
+   * };
+   * \endcode
+   *
+   * Duals nest: Dual< Dual<T> >(Dual<T>(x,1),Dual<T>(1,0)) carries the
+   * second derivative in derivative().derivative().
+   */
+  template<typename T>
+  class Dual {
+    T _v;  ///< value
+    T _d;  ///< derivative
+  public:
+    typedef T value_type;
+
+    /// Construct a constant, or a variable with derivative 1
+    Dual(const T& value=T(),const T& derivative=T())
+      : _v(value),_d(derivative) {}
+
+    /// Construct a constant from a number, also for nested duals
+    template<typename S,
+             typename std::enable_if<std::is_arithmetic<S>::value,
+                                     int>::type=0>
+    Dual(const S& value) : _v(value),_d() {}
+
+    /// Value of the function
+    inline const T& value() const { return _v; }
+
+    /// Derivative of the function
+    inline const T& derivative() const { return _d; }
+
+    inline Dual& operator+=(const Dual& b) { _v+=b._v; _d+=b._d; return *this; }
+    inline Dual& operator-=(const Dual& b) { _v-=b._v; _d-=b._d; return *this; }
+    inline Dual& operator*=(const Dual& b) {
+      _d=_d*b._v + _v*b._d;
+      _v*=b._v;
+      return *this;
+    }
+    inline Dual& operator/=(const Dual& b) {
+      _v/=b._v;
+      _d=(_d - _v*b._d)/b._v;
+      return *this;
+    }
+  };
+
+  template<typename T>
+  inline Dual<T> operator-(const Dual<T>& a) {
+    return Dual<T>(-a.value(),-a.derivative());
+  }
+  template<typename T>
+  inline Dual<T> operator+(const Dual<T>& a) { return a; }
+
+  /*
+   * Arithmetic.  The scalar operands are of the non-deduced value_type,
+   * so that constants like 2 or 0.5 convert to it.
+   */
+
+  template<typename T>
+  inline Dual<T> operator+(Dual<T> a,const Dual<T>& b) { return a+=b; }
+  template<typename T>
+  inline Dual<T> operator+(Dual<T> a,const typename Dual<T>::value_type& b) {
+    return a+=Dual<T>(b);
+  }
+  template<typename T>
+  inline Dual<T> operator+(const typename Dual<T>::value_type& a,Dual<T> b) {
+    return b+=Dual<T>(a);
+  }
+
+  template<typename T>
+  inline Dual<T> operator-(Dual<T> a,const Dual<T>& b) { return a-=b; }
+  template<typename T>
+  inline Dual<T> operator-(Dual<T> a,const typename Dual<T>::value_type& b) {
+    return a-=Dual<T>(b);
+  }
+  template<typename T>
+  inline Dual<T> operator-(const typename Dual<T>::value_type& a,
+                           const Dual<T>& b) {
+    return Dual<T>(a)-=b;
+  }
+
+  template<typename T>
+  inline Dual<T> operator*(Dual<T> a,const Dual<T>& b) { return a*=b; }
+  template<typename T>
+  inline Dual<T> operator*(const Dual<T>& a,
+                           const typename Dual<T>::value_type& b) {
+    return Dual<T>(a.value()*b,a.derivative()*b);
+  }
+  template<typename T>
+  inline Dual<T> operator*(const typename Dual<T>::value_type& a,
+                           const Dual<T>& b) {
+    return Dual<T>(a*b.value(),a*b.derivative());
+  }
+
+  template<typename T>
+  inline Dual<T> operator/(Dual<T> a,const Dual<T>& b) { return a/=b; }
+  template<typename T>
+  inline Dual<T> operator/(const Dual<T>& a,
+                           const typename Dual<T>::value_type& b) {
+    return Dual<T>(a.value()/b,a.derivative()/b);
+  }
+  template<typename T>
+  inline Dual<T> operator/(const typename Dual<T>::value_type& a,
+                           const Dual<T>& b) {
+    return Dual<T>(a)/=b;
+  }
+
+  /*
+   * Comparisons, on the values only
+   */
+
+#define ANPI_DUAL_COMPARISON(OP)                                          \
+  template<typename T>                                                    \
+  inline bool operator OP(const Dual<T>& a,const Dual<T>& b) {            \
+    return a.value() OP b.value();                                        \
+  }                                                                       \
+  template<typename T>                                                    \
+  inline bool operator OP(const Dual<T>& a,                               \
+                          const typename Dual<T>::value_type& b) {        \
+    return a.value() OP b;                                                \
+  }                                                                       \
+  template<typename T>                                                    \
+  inline bool operator OP(const typename Dual<T>::value_type& a,          \
+                          const Dual<T>& b) {                             \
+    return a OP b.value();                                                \
+  }
+
+  ANPI_DUAL_COMPARISON(<)
+  ANPI_DUAL_COMPARISON(<=)
+  ANPI_DUAL_COMPARISON(>)
+  ANPI_DUAL_COMPARISON(>=)
+  ANPI_DUAL_COMPARISON(==)
+  ANPI_DUAL_COMPARISON(!=)
+
+#undef ANPI_DUAL_COMPARISON
+
+  /*
+   * Math functions: f(v + d·ε) = f(v) + f'(v)·d·ε.  The calls on the
+   * values are unqualified, so that nested duals find these overloads.
+   */
+
+  /// |a|; at 0, the derivative of a (from the right)
+  template<typename T>
+  inline Dual<T> abs(const Dual<T>& a) {
+    return (a.value() < T(0)) ? -a : a;
+  }
+
+  template<typename T>
+  inline Dual<T> sqrt(const Dual<T>& a) {
+    using std::sqrt;
+    const T s = sqrt(a.value());
+    return Dual<T>(s,a.derivative()/(T(2)*s));
+  }
+
+  template<typename T>
+  inline Dual<T> exp(const Dual<T>& a) {
+    using std::exp;
+    const T e = exp(a.value());
+    return Dual<T>(e,e*a.derivative());
+  }
+
+  template<typename T>
+  inline Dual<T> log(const Dual<T>& a) {
+    using std::log;
+    return Dual<T>(log(a.value()),a.derivative()/a.value());
+  }
+
+  template<typename T>
+  inline Dual<T> pow(const Dual<T>& a,const typename Dual<T>::value_type& p) {
+    using std::pow;
+    return Dual<T>(pow(a.value(),p),
+                   p*pow(a.value(),p-T(1))*a.derivative());
+  }
+
+  template<typename T>
+  inline Dual<T> pow(const typename Dual<T>::value_type& a,const Dual<T>& p) {
+    using std::log;
+    return exp(log(a)*p);
+  }
+
+  template<typename T>
+  inline Dual<T> pow(const Dual<T>& a,const Dual<T>& p) {
+    return exp(log(a)*p);
+  }
+
+  template<typename T>
+  inline Dual<T> sin(const Dual<T>& a) {
+    using std::sin; using std::cos;
+    return Dual<T>(sin(a.value()),cos(a.value())*a.derivative());
+  }
+
+  template<typename T>
+  inline Dual<T> cos(const Dual<T>& a) {
+    using std::sin; using std::cos;
+    return Dual<T>(cos(a.value()),-sin(a.value())*a.derivative());
+  }
+
+  template<typename T>
+  inline Dual<T> tan(const Dual<T>& a) {
+    using std::tan;
+    const T t = tan(a.value());
+    return Dual<T>(t,(T(1)+t*t)*a.derivative());
+  }
+
+  template<typename T>
+  inline Dual<T> asin(const Dual<T>& a) {
+    using std::asin; using std::sqrt;
+    return Dual<T>(asin(a.value()),
+                   a.derivative()/sqrt(T(1)-a.value()*a.value()));
+  }
+
+  template<typename T>
+  inline Dual<T> acos(const Dual<T>& a) {
+    using std::acos; using std::sqrt;
+    return Dual<T>(acos(a.value()),
+                   -a.derivative()/sqrt(T(1)-a.value()*a.value()));
+  }
+
+  template<typename T>
+  inline Dual<T> atan(const Dual<T>& a) {
+    using std::atan;
+    return Dual<T>(atan(a.value()),
+                   a.derivative()/(T(1)+a.value()*a.value()));
+  }
+
+  template<typename T>
+  inline Dual<T> sinh(const Dual<T>& a) {
+    using std::sinh; using std::cosh;
+    return Dual<T>(sinh(a.value()),cosh(a.value())*a.derivative());
+  }
+
+  template<typename T>
+  inline Dual<T> cosh(const Dual<T>& a) {
+    using std::sinh; using std::cosh;
+    return Dual<T>(cosh(a.value()),sinh(a.value())*a.derivative());
+  }
+
+  template<typename T>
+  inline Dual<T> tanh(const Dual<T>& a) {
+    using std::tanh;
+    const T t = tanh(a.value());
+    return Dual<T>(t,(T(1)-t*t)*a.derivative());
+  }
+}
+
+#endif
@@ -0,0 +1,502 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date  : 13.01.2018
+ */
+
+#ifndef ANPI_FIXED_MATRIX_HPP
+#define ANPI_FIXED_MATRIX_HPP
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <initializer_list>
+#include <string>
+#include <utility>
+
+#include "Exception.hpp"
+#include "Matrix.hpp"
+#include "MatrixView.hpp"
+
+namespace anpi {
+
+  namespace bits {
+    /**
+     * Call fn(I) for I in [I0,N), expanded at compile time.
+     *
+     * With the calls inlined every index is a constant, so the loops
+     * of the fixed matrix operations leave no loop control behind.
+     */
+    template<size_t I0,size_t N>
+    struct unroll {
+      template<class Fn>
+      static inline void apply(Fn& fn) {
+        fn(I0);
+        unroll<I0+1,N>::apply(fn);
+      }
+    };
+
+    template<size_t N>
+    struct unroll<N,N> {
+      template<class Fn>
+      static inline void apply(Fn&) {}
+    };
+
+    /**
+     * Alignment of the entries of a fixed matrix of the given bytes.
+     *
+     * This is the largest power of two dividing the size, so that arrays
+     * of fixed matrices have no gaps, and at most 16 bytes: in C++11 the
+     * operator new, and hence std::vector, guarantees no larger one.
+     */
+    template<typename T,size_t Bytes>
+    struct fixed_alignment {
+      static constexpr size_t lowbit = Bytes & (~Bytes + 1);
+      static constexpr size_t value =
+        (lowbit > 16) ? 16 : ((lowbit < alignof(T)) ? alignof(T) : lowbit);
+    };
+  } // namespace bits
+
+  /**
+   * Matrix with dimensions fixed at compile time.
+   *
+   * The entries are stored row-major inside the object, without any
+   * heap allocation nor padding.  It is meant for the many small
+   * matrices of inner loops (2x2, 3x3 and 4x4 Jacobians, rotations,
+   * etc.), whose operations are fully unrolled.
+   *
+   * It interoperates with anpi::Matrix through views:
+   *
+   * \code
+   * anpi::FixedMatrix<double,3,3> f(m.block(0,0,3,3)); // copy a block
+   * anpi::Matrix<double> d(f.view());                    // and back
+   * \endcode
+   */
+  template<typename T,size_t R,size_t C>
+  class FixedMatrix {
+  public:
+    typedef T value_type;
+
+    /// Number of rows
+    static constexpr size_t Rows = R;
+
+    /// Number of columns
+    static constexpr size_t Cols = C;
+
+    /// Number of entries
+    static constexpr size_t Entries = R*C;
+
+  private:
+    /// The entries
+    alignas(bits::fixed_alignment<T,sizeof(T)*R*C>::value) T _data[R*C];
+
+  public:
+    /// Uninitialized matrix
+    FixedMatrix() = default;
+
+    /// All entries with the given value
+    explicit FixedMatrix(const T val) {
+      fill(val);
+    }
+
+    /**
+     * Construct from nested lists of rows:
+     *
+     * \code
+     * anpi::FixedMatrix<float,2,2> m = { {1,2}, {3,4} };
+     * \endcode
+     */
+    FixedMatrix(std::initializer_list< std::initializer_list<T> > lst) {
+      assert(lst.size() == R);
+      size_t r=0;
+      for (const auto& row : lst) {
+        assert(row.size() == C);
+        size_t c=0;
+        for (const T& v : row) {
+          _data[r*C+c++] = v;
+        }
+        ++r;
+      }
+    }
+
+    /**
+     * Copy the entries of a view, for instance of a block of a Matrix
+     *
+     * @throw anpi::Exception if the view has other dimensions
+     */
+    explicit FixedMatrix(const ConstMatrixView<T>& v) {
+      if ( (v.rows() != R) || (v.cols() != C) ) {
+        throw Exception("View does not match the fixed matrix size");
+      }
+      for (size_t r=0;r<R;++r) {
+        for (size_t c=0;c<C;++c) {
+          _data[r*C+c] = v(r,c);
+        }
+      }
+    }
+
+    /**
+     * Copy the entries of a Matrix
+     *
+     * @throw anpi::Exception if the matrix has other dimensions
+     */
+    template<class Alloc>
+    explicit FixedMatrix(const Matrix<T,Alloc>& m)
+      : FixedMatrix(ConstMatrixView<T>(m)) {}
+
+    /// Identity matrix
+    static FixedMatrix identity() {
+      FixedMatrix m(T(0));
+      for (size_t i=0;i<R && i<C;++i) {
+        m._data[i*C+i] = T(1);
+      }
+      return m;
+    }
+
+    /// Number of rows
+    static constexpr size_t rows() { return R; }
+
+    /// Number of columns
+    static constexpr size_t cols() { return C; }
+
+    /// Pointer to the first entry
+    inline T* data() { return _data; }
+
+    /// Pointer to the first entry
+    inline const T* data() const { return _data; }
+
+    /// Pointer to the first entry of a row
+    inline T* operator[](const size_t row) { return _data+row*C; }
+
+    /// Pointer to the first entry of a row
+    inline const T* operator[](const size_t row) const {
+      return _data+row*C;
+    }
+
+    /// Entry at (row,col)
+    inline T& operator()(const size_t row,const size_t col) {
+      return _data[row*C+col];
+    }
+
+    /// Entry at (row,col)
+    inline const T& operator()(const size_t row,const size_t col) const {
+      return _data[row*C+col];
+    }
+
+    /// Set all entries to the given value
+    inline void fill(const T val) {
+      auto fn = [&](size_t i) { _data[i] = val; };
+      bits::unroll<0,R*C>::apply(fn);
+    }
+
+    /// View of all entries, to use the Matrix kernels
+    inline MatrixView<T> view() {
+      return MatrixView<T>(_data,R,C,C);
+    }
+
+    /// View of all entries, to use the Matrix kernels
+    inline ConstMatrixView<T> view() const {
+      return ConstMatrixView<T>(_data,R,C,C);
+    }
+
+    /// In-place addition
+    inline FixedMatrix& operator+=(const FixedMatrix& b) {
+      auto fn = [&](size_t i) { _data[i] += b._data[i]; };
+      bits::unroll<0,R*C>::apply(fn);
+      return *this;
+    }
+
+    /// In-place subtraction
+    inline FixedMatrix& operator-=(const FixedMatrix& b) {
+      auto fn = [&](size_t i) { _data[i] -= b._data[i]; };
+      bits::unroll<0,R*C>::apply(fn);
+      return *this;
+    }
+
+    /// In-place scaling
+    inline FixedMatrix& operator*=(const T alpha) {
+      auto fn = [&](size_t i) { _data[i] *= alpha; };
+      bits::unroll<0,R*C>::apply(fn);
+      return *this;
+    }
+
+    /// Equality of all entries
+    inline bool operator==(const FixedMatrix& b) const {
+      bool eq = true;
+      auto fn = [&](size_t i) { eq = eq && (_data[i] == b._data[i]); };
+      bits::unroll<0,R*C>::apply(fn);
+      return eq;
+    }
+
+    /// Inequality of any entry
+    inline bool operator!=(const FixedMatrix& b) const {
+      return !(*this == b);
+    }
+  };
+
+  /// Sum of two fixed matrices
+  template<typename T,size_t R,size_t C>
+  inline FixedMatrix<T,R,C> operator+(const FixedMatrix<T,R,C>& a,
+                                      const FixedMatrix<T,R,C>& b) {
+    FixedMatrix<T,R,C> c;
+    auto fn = [&](size_t i) { c.data()[i] = a.data()[i] + b.data()[i]; };
+    bits::unroll<0,R*C>::apply(fn);
+    return c;
+  }
+
+  /// Difference of two fixed matrices
+  template<typename T,size_t R,size_t C>
+  inline FixedMatrix<T,R,C> operator-(const FixedMatrix<T,R,C>& a,
+                                      const FixedMatrix<T,R,C>& b) {
+    FixedMatrix<T,R,C> c;
+    auto fn = [&](size_t i) { c.data()[i] = a.data()[i] - b.data()[i]; };
+    bits::unroll<0,R*C>::apply(fn);
+    return c;
+  }
+
+  /// Product with a scalar
+  template<typename T,size_t R,size_t C>
+  inline FixedMatrix<T,R,C> operator*(const T alpha,
+                                      const FixedMatrix<T,R,C>& a) {
+    FixedMatrix<T,R,C> c(a);
+    return c *= alpha;
+  }
+
+  /// Matrix product
+  template<typename T,size_t R,size_t K,size_t C>
+  inline FixedMatrix<T,R,C> operator*(const FixedMatrix<T,R,K>& a,
+                                      const FixedMatrix<T,K,C>& b) {
+    FixedMatrix<T,R,C> c;
+    auto entry = [&](size_t i) {
+      const size_t r = i/C;
+      const size_t col = i%C;
+      T sum = T(0);
+      auto term = [&](size_t k) { sum += a(r,k)*b(k,col); };
+      bits::unroll<0,K>::apply(term);
+      c.data()[i] = sum;
+    };
+    bits::unroll<0,R*C>::apply(entry);
+    return c;
+  }
+
+  /// Transposed matrix
+  template<typename T,size_t R,size_t C>
+  inline FixedMatrix<T,C,R> transpose(const FixedMatrix<T,R,C>& a) {
+    FixedMatrix<T,C,R> t;
+    auto fn = [&](size_t i) { t(i%C,i/C) = a.data()[i]; };
+    bits::unroll<0,R*C>::apply(fn);
+    return t;
+  }
+
+  /**
+   * @name Determinants
+   *
+   * Closed forms up to 4x4, Gaussian elimination with partial pivoting
+   * beyond.
+   */
+  //@{
+  template<typename T>
+  inline T determinant(const FixedMatrix<T,1,1>& a) {
+    return a(0,0);
+  }
+
+  template<typename T>
+  inline T determinant(const FixedMatrix<T,2,2>& a) {
+    return a(0,0)*a(1,1) - a(0,1)*a(1,0);
+  }
+
+  template<typename T>
+  inline T determinant(const FixedMatrix<T,3,3>& a) {
+    return a(0,0)*(a(1,1)*a(2,2) - a(1,2)*a(2,1))
+         - a(0,1)*(a(1,0)*a(2,2) - a(1,2)*a(2,0))
+         + a(0,2)*(a(1,0)*a(2,1) - a(1,1)*a(2,0));
+  }
+
+  template<typename T>
+  inline T determinant(const FixedMatrix<T,4,4>& a) {
+    // 2x2 minors of the two lower rows
+    const T s0 = a(2,0)*a(3,1) - a(2,1)*a(3,0);
+    const T s1 = a(2,0)*a(3,2) - a(2,2)*a(3,0);
+    const T s2 = a(2,0)*a(3,3) - a(2,3)*a(3,0);
+    const T s3 = a(2,1)*a(3,2) - a(2,2)*a(3,1);
+    const T s4 = a(2,1)*a(3,3) - a(2,3)*a(3,1);
+    const T s5 = a(2,2)*a(3,3) - a(2,3)*a(3,2);
+
+    return a(0,0)*(a(1,1)*s5 - a(1,2)*s4 + a(1,3)*s3)
+         - a(0,1)*(a(1,0)*s5 - a(1,2)*s2 + a(1,3)*s1)
+         + a(0,2)*(a(1,0)*s4 - a(1,1)*s2 + a(1,3)*s0)
+         - a(0,3)*(a(1,0)*s3 - a(1,1)*s1 + a(1,2)*s0);
+  }
+
+  template<typename T,size_t N>
+  T determinant(FixedMatrix<T,N,N> a) {
+    T det = T(1);
+    for (size_t j=0;j<N;++j) {
+      size_t p = j;
+      for (size_t i=j+1;i<N;++i) {
+        if (std::abs(a(i,j)) > std::abs(a(p,j))) {
+          p = i;
+        }
+      }
+      if (a(p,j) == T(0)) {
+        return T(0);
+      }
+      if (p != j) {
+        for (size_t c=0;c<N;++c) {
+          std::swap(a(p,c),a(j,c));
+        }
+        det = -det;
+      }
+      det *= a(j,j);
+      for (size_t i=j+1;i<N;++i) {
+        const T f = a(i,j)/a(j,j);
+        for (size_t c=j+1;c<N;++c) {
+          a(i,c) -= f*a(j,c);
+        }
+      }
+    }
+    return det;
+  }
+  //@}
+
+  namespace bits {
+    /// Throw if the determinant of a matrix to invert is zero
+    template<typename T>
+    inline void checkInvertible(const T det) {
+      if (det == T(0)) {
+        throw Exception("Inverse of a singular matrix");
+      }
+    }
+  } // namespace bits
+
+  /**
+   * @name Inverses
+   *
+   * Adjugate formulas up to 4x4, Gauss-Jordan elimination beyond.
+   *
+   * @throw anpi::Exception if the matrix is singular
+   */
+  //@{
+  template<typename T>
+  inline FixedMatrix<T,1,1> inverse(const FixedMatrix<T,1,1>& a) {
+    bits::checkInvertible(a(0,0));
+    return FixedMatrix<T,1,1>(T(1)/a(0,0));
+  }
+
+  template<typename T>
+  inline FixedMatrix<T,2,2> inverse(const FixedMatrix<T,2,2>& a) {
+    const T det = determinant(a);
+    bits::checkInvertible(det);
+    const T id = T(1)/det;
+    return FixedMatrix<T,2,2>{ {  a(1,1)*id, -a(0,1)*id },
+                               { -a(1,0)*id,  a(0,0)*id } };
+  }
+
+  template<typename T>
+  inline FixedMatrix<T,3,3> inverse(const FixedMatrix<T,3,3>& a) {
+    // cofactors of the first row give the determinant for free
+    const T c00 = a(1,1)*a(2,2) - a(1,2)*a(2,1);
+    const T c01 = a(1,2)*a(2,0) - a(1,0)*a(2,2);
+    const T c02 = a(1,0)*a(2,1) - a(1,1)*a(2,0);
+    const T det = a(0,0)*c00 + a(0,1)*c01 + a(0,2)*c02;
+    bits::checkInvertible(det);
+    const T id = T(1)/det;
+
+    FixedMatrix<T,3,3> b;
+    b(0,0) = c00*id;
+    b(1,0) = c01*id;
+    b(2,0) = c02*id;
+    b(0,1) = (a(0,2)*a(2,1) - a(0,1)*a(2,2))*id;
+    b(1,1) = (a(0,0)*a(2,2) - a(0,2)*a(2,0))*id;
+    b(2,1) = (a(0,1)*a(2,0) - a(0,0)*a(2,1))*id;
+    b(0,2) = (a(0,1)*a(1,2) - a(0,2)*a(1,1))*id;
+    b(1,2) = (a(0,2)*a(1,0) - a(0,0)*a(1,2))*id;
+    b(2,2) = (a(0,0)*a(1,1) - a(0,1)*a(1,0))*id;
+    return b;
+  }
+
+  template<typename T>
+  inline FixedMatrix<T,4,4> inverse(const FixedMatrix<T,4,4>& a) {
+    // 2x2 minors of the upper (s) and lower (c) row pairs
+    const T s0 = a(0,0)*a(1,1) - a(1,0)*a(0,1);
+    const T s1 = a(0,0)*a(1,2) - a(1,0)*a(0,2);
+    const T s2 = a(0,0)*a(1,3) - a(1,0)*a(0,3);
+    const T s3 = a(0,1)*a(1,2) - a(1,1)*a(0,2);
+    const T s4 = a(0,1)*a(1,3) - a(1,1)*a(0,3);
+    const T s5 = a(0,2)*a(1,3) - a(1,2)*a(0,3);
+
+    const T c5 = a(2,2)*a(3,3) - a(3,2)*a(2,3);
+    const T c4 = a(2,1)*a(3,3) - a(3,1)*a(2,3);
+    const T c3 = a(2,1)*a(3,2) - a(3,1)*a(2,2);
+    const T c2 = a(2,0)*a(3,3) - a(3,0)*a(2,3);
+    const T c1 = a(2,0)*a(3,2) - a(3,0)*a(2,2);
+    const T c0 = a(2,0)*a(3,1) - a(3,0)*a(2,1);
+
+    const T det = s0*c5 - s1*c4 + s2*c3 + s3*c2 - s4*c1 + s5*c0;
+    bits::checkInvertible(det);
+    const T id = T(1)/det;
+
+    FixedMatrix<T,4,4> b;
+    b(0,0) = ( a(1,1)*c5 - a(1,2)*c4 + a(1,3)*c3)*id;
+    b(0,1) = (-a(0,1)*c5 + a(0,2)*c4 - a(0,3)*c3)*id;
+    b(0,2) = ( a(3,1)*s5 - a(3,2)*s4 + a(3,3)*s3)*id;
+    b(0,3) = (-a(2,1)*s5 + a(2,2)*s4 - a(2,3)*s3)*id;
+
+    b(1,0) = (-a(1,0)*c5 + a(1,2)*c2 - a(1,3)*c1)*id;
+    b(1,1) = ( a(0,0)*c5 - a(0,2)*c2 + a(0,3)*c1)*id;
+    b(1,2) = (-a(3,0)*s5 + a(3,2)*s2 - a(3,3)*s1)*id;
+    b(1,3) = ( a(2,0)*s5 - a(2,2)*s2 + a(2,3)*s1)*id;
+
+    b(2,0) = ( a(1,0)*c4 - a(1,1)*c2 + a(1,3)*c0)*id;
+    b(2,1) = (-a(0,0)*c4 + a(0,1)*c2 - a(0,3)*c0)*id;
+    b(2,2) = ( a(3,0)*s4 - a(3,1)*s2 + a(3,3)*s0)*id;
+    b(2,3) = (-a(2,0)*s4 + a(2,1)*s2 - a(2,3)*s0)*id;
+
+    b(3,0) = (-a(1,0)*c3 + a(1,1)*c1 - a(1,2)*c0)*id;
+    b(3,1) = ( a(0,0)*c3 - a(0,1)*c1 + a(0,2)*c0)*id;
+    b(3,2) = (-a(3,0)*s3 + a(3,1)*s1 - a(3,2)*s0)*id;
+    b(3,3) = ( a(2,0)*s3 - a(2,1)*s1 + a(2,2)*s0)*id;
+    return b;
+  }
+
+  template<typename T,size_t N>
+  FixedMatrix<T,N,N> inverse(FixedMatrix<T,N,N> a) {
+    FixedMatrix<T,N,N> b = FixedMatrix<T,N,N>::identity();
+    for (size_t j=0;j<N;++j) {
+      size_t p = j;
+      for (size_t i=j+1;i<N;++i) {
+        if (std::abs(a(i,j)) > std::abs(a(p,j))) {
+          p = i;
+        }
+      }
+      bits::checkInvertible(a(p,j));
+      for (size_t c=0;c<N;++c) {
+        std::swap(a(p,c),a(j,c));
+        std::swap(b(p,c),b(j,c));
+      }
+      const T id = T(1)/a(j,j);
+      for (size_t c=0;c<N;++c) {
+        a(j,c) *= id;
+        b(j,c) *= id;
+      }
+      for (size_t i=0;i<N;++i) {
+        if (i != j) {
+          const T f = a(i,j);
+          for (size_t c=0;c<N;++c) {
+            a(i,c) -= f*a(j,c);
+            b(i,c) -= f*b(j,c);
+          }
+        }
+      }
+    }
+    return b;
+  }
+  //@}
+
+} // namespace anpi
+
+#endif
@@ -0,0 +1,211 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @author Pablo Alvarado
+ * @date   15.12.2017
+ */
+
+#ifndef ANPI_HUGE_PAGE_ALLOCATOR_HPP
+#define ANPI_HUGE_PAGE_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#include <sys/mman.h>
+
+#include <boost/align/aligned_alloc.hpp>
+
+#include "Allocator.hpp"
+
+namespace anpi {
+
+  /**
+   * Kind of memory obtained by the huge_page_allocator
+   */
+  enum class HugePageMode {
+    Heap,        ///< Small buffer taken from the aligned heap
+    Normal,      ///< Mapping with the normal page size
+    Transparent, ///< Mapping marked for transparent huge pages
+    Explicit     ///< Mapping of reserved huge pages (MAP_HUGETLB)
+  };
+
+  /// Name of a huge page mode
+  inline const char* hugePageModeName(const HugePageMode mode) {
+    switch (mode) {
+    case HugePageMode::Normal:      return "normal pages";
+    case HugePageMode::Transparent: return "transparent huge pages";
+    case HugePageMode::Explicit:    return "explicit huge pages";
+    default:                        return "heap";
+    }
+  }
+
+  /// Size of the huge pages assumed by the huge_page_allocator
+  static const size_t HugePageSize = size_t(2)*1024*1024;
+
+  /// Mode of the last allocation of the calling thread
+  inline HugePageMode& _lastHugePageMode() {
+    static thread_local HugePageMode mode = HugePageMode::Heap;
+    return mode;
+  }
+
+  /// Mode obtained by the last huge_page_allocator allocation of this thread
+  inline HugePageMode lastHugePageMode() {
+    return _lastHugePageMode();
+  }
+
+  // Flag selecting HugePageSize for MAP_HUGETLB mappings
+#if defined(MAP_HUGE_2MB)
+#  define ANPI_MAP_HUGE_2MB MAP_HUGE_2MB
+#elif defined(MAP_HUGE_SHIFT)
+#  define ANPI_MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+
+  /**
+   * Reserve the given bytes (a multiple of HugePageSize) in huge pages.
+   *
+   * Reserved huge pages (MAP_HUGETLB) of HugePageSize are tried first.
+   * The size is requested explicitly, since the default one of the
+   * system may be larger (e.g. 1 GiB), which would not match the
+   * length later released with munmap().  Where the page size cannot
+   * be requested, or if the system has no such pages reserved, a
+   * normal mapping aligned to HugePageSize is marked with
+   * MADV_HUGEPAGE, for the kernel to back it with transparent huge
+   * pages.  If that also fails, the normal mapping is kept.
+   *
+   * @return 0 if not even a normal mapping could be created
+   */
+  inline void* hugePageMap(const size_t bytes,HugePageMode& mode) {
+#if defined(MAP_HUGETLB) && defined(ANPI_MAP_HUGE_2MB)
+    void* explicitPages = ::mmap(0,bytes,PROT_READ | PROT_WRITE,
+                                 MAP_PRIVATE | MAP_ANONYMOUS |
+                                 MAP_HUGETLB | ANPI_MAP_HUGE_2MB,
+                                 -1,0);
+    if (explicitPages != MAP_FAILED) {
+      mode = HugePageMode::Explicit;
+      return explicitPages;
+    }
+#endif
+
+    // over-allocate to cut an aligned range out of the mapping
+    const size_t total = bytes + HugePageSize;
+    void* raw = ::mmap(0,total,PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS,-1,0);
+    if (raw == MAP_FAILED) {
+      return 0;
+    }
+
+    const std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(raw);
+    const std::uintptr_t start =
+      (begin + HugePageSize - 1) & ~std::uintptr_t(HugePageSize - 1);
+    const size_t head = start - begin;
+    const size_t tail = total - head - bytes;
+    if (head) ::munmap(raw,head);
+    if (tail) ::munmap(reinterpret_cast<void*>(start + bytes),tail);
+
+    void* p = reinterpret_cast<void*>(start);
+    mode = HugePageMode::Normal;
+#ifdef MADV_HUGEPAGE
+    if (::madvise(p,bytes,MADV_HUGEPAGE) == 0) {
+      mode = HugePageMode::Transparent;
+    }
+#endif
+    return p;
+  }
+
+  /**
+   * Allocator backing large buffers with huge pages.
+   *
+   * Large matrices traversed by the SIMD kernels touch far more 4 KiB
+   * pages than the TLB can cover, so each new page costs a page walk.
+   * With 2 MiB pages the TLB covers 512 times more memory.
+   *
+   * Buffers of at least `threshold` bytes are rounded up to a multiple
+   * of HugePageSize and mapped with hugePageMap(); smaller ones are
+   * taken from the aligned heap, as with aligned_row_allocator.  The
+   * mode actually obtained is reported by lastHugePageMode().
+   */
+  template<class T, std::size_t Align=DefaultAlignment>
+  class huge_page_allocator {
+  public:
+    typedef T         value_type;
+    typedef T*        pointer;
+    typedef const T*  const_pointer;
+    typedef size_t    size_type;
+    typedef ptrdiff_t difference_type;
+
+    /// Change the stored type
+    template<class U>
+    struct rebind {
+      typedef huge_page_allocator<U, Align> other;
+    };
+
+    /// Type to identify this as a row-aligned allocator
+    typedef std::true_type row_aligned;
+
+    /// Smallest buffer in bytes backed by huge pages
+    static constexpr size_t threshold = HugePageSize;
+
+    huge_page_allocator() noexcept {}
+
+    /// Copy from another stored type
+    template<class U>
+    huge_page_allocator(const huge_page_allocator<U,Align>&) noexcept {}
+
+    /// Bytes actually mapped for n entries
+    static inline size_t mappedBytes(const size_t n) {
+      return ( (n*sizeof(T) + HugePageSize - 1)/HugePageSize )*HugePageSize;
+    }
+
+    /// Reserve n entries
+    T* allocate(const size_t n) {
+      const size_t bytes = n*sizeof(T);
+      void* p = 0;
+      if (bytes < threshold) {
+        p = boost::alignment::aligned_alloc(Align,bytes);
+        _lastHugePageMode() = HugePageMode::Heap;
+      } else {
+        p = hugePageMap(mappedBytes(n),_lastHugePageMode());
+      }
+      if (p == 0) {
+        throw std::bad_alloc();
+      }
+      return static_cast<T*>(p);
+    }
+
+    /// Release the n entries at p
+    void deallocate(T* p,const size_t n) noexcept {
+      if (p) {
+        if (n*sizeof(T) < threshold) {
+          boost::alignment::aligned_free(p);
+        } else {
+          ::munmap(p,mappedBytes(n));
+        }
+      }
+    }
+  };
+
+  template<class T,class U,std::size_t Align>
+  inline bool operator==(const huge_page_allocator<T,Align>&,
+                         const huge_page_allocator<U,Align>&) noexcept {
+    return true;
+  }
+
+  template<class T,class U,std::size_t Align>
+  inline bool operator!=(const huge_page_allocator<T,Align>&,
+                         const huge_page_allocator<U,Align>&) noexcept {
+    return false;
+  }
+
+  // Specialization for the huge_page_allocator
+  template<typename T, std::size_t A>
+  struct is_aligned_alloc< anpi::huge_page_allocator<T,A> > {
+    static const bool value = true;
+  };
+
+} // namespace anpi
+
+#endif
@@ -11,7 +11,9 @@
 #ifndef ANPI_INTRINSICS_HPP
 #define ANPI_INTRINSICS_HPP
 
+#include <complex>
 #include <cstdint>
+#include <type_traits>
 
 /*
  * Include the proper intrinsics headers for the current architecture
@@ -39,6 +41,33 @@
 #  endif
 #endif
 
+/*
+ * With GCC on x86-64 the SIMD kernels are compiled for several
+ * instruction sets in the same binary, and the best one supported by
+ * the running CPU is chosen at run time (see CpuFeatures.hpp).  Other
+ * compilers use only the instruction set enabled by their flags.
+ */
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__)
+#  define ANPI_SIMD_DISPATCH
+#endif
+
+/*
+ * Widest instruction set level of the compiled kernels: 0 (none),
+ * 1 (SSE2), 2 (AVX2+FMA) or 3 (AVX-512 F/BW/DQ/VL)
+ */
+#if defined ANPI_SIMD_DISPATCH
+#  define ANPI_SIMD_MAX_LEVEL 3
+#elif defined __AVX512F__  && defined __AVX512BW__ && \
+      defined __AVX512DQ__ && defined __AVX512VL__
+#  define ANPI_SIMD_MAX_LEVEL 3
+#elif defined __AVX2__ && defined __FMA__
+#  define ANPI_SIMD_MAX_LEVEL 2
+#elif defined __SSE2__
+#  define ANPI_SIMD_MAX_LEVEL 1
+#else
+#  define ANPI_SIMD_MAX_LEVEL 0
+#endif
+
 template <typename T>
 struct is_simd_type {
   static constexpr bool value =
@@ -54,8 +83,19 @@ struct is_simd_type {
     std::is_same<T,std::uint8_t>::value;
 };
 
+/**
+ * Complex types whose interleaved real and imaginary parts are processed
+ * as lanes of the registers of the real type
+ */
+template <typename T>
+struct is_simd_complex {
+  static constexpr bool value =
+    std::is_same<T,std::complex<double> >::value ||
+    std::is_same<T,std::complex<float> >::value;
+};
+
 
-#ifdef __AVX512F__
+#if defined __AVX512F__ || defined ANPI_SIMD_DISPATCH
 template<typename T> struct avx512_traits { };
 template<> struct avx512_traits<double> { typedef __m512d reg_type; };
 template<> struct avx512_traits<float> { typedef __m512 reg_type; };
@@ -67,9 +107,15 @@ template<> struct avx512_traits<int16_t> { typedef __m512i reg_type; };
 template<> struct avx512_traits<uint16_t> { typedef __m512i reg_type; };
 template<> struct avx512_traits<int8_t> { typedef __m512i reg_type; };
 template<> struct avx512_traits<uint8_t> { typedef __m512i reg_type; };
+template<> struct avx512_traits<std::complex<double> > {
+  typedef __m512d reg_type;
+};
+template<> struct avx512_traits<std::complex<float> > {
+  typedef __m512 reg_type;
+};
 #endif
 
-#ifdef __AVX__
+#if defined __AVX__ || defined ANPI_SIMD_DISPATCH
 template<typename T> struct avx_traits { };
 template<> struct avx_traits<double> { typedef __m256d reg_type; };
 template<> struct avx_traits<float> { typedef __m256 reg_type; };
@@ -81,6 +127,12 @@ template<> struct avx_traits<int16_t> { typedef __m256i reg_type; };
 template<> struct avx_traits<uint16_t> { typedef __m256i reg_type; };
 template<> struct avx_traits<int8_t> { typedef __m256i reg_type; };
 template<> struct avx_traits<uint8_t> { typedef __m256i reg_type; };
+template<> struct avx_traits<std::complex<double> > {
+  typedef __m256d reg_type;
+};
+template<> struct avx_traits<std::complex<float> > {
+  typedef __m256 reg_type;
+};
 #endif
 
 #ifdef __SSE2__
@@ -95,6 +147,12 @@ template<> struct sse2_traits<int16_t> { typedef __m128i reg_type; };
 template<> struct sse2_traits<uint16_t> { typedef __m128i reg_type; };
 template<> struct sse2_traits<int8_t> { typedef __m128i reg_type; };
 template<> struct sse2_traits<uint8_t> { typedef __m128i reg_type; };
+template<> struct sse2_traits<std::complex<double> > {
+  typedef __m128d reg_type;
+};
+template<> struct sse2_traits<std::complex<float> > {
+  typedef __m128 reg_type;
+};
 #endif
   
   
@@ -0,0 +1,393 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date  : 11.01.2018
+ */
+
+#ifndef ANPI_ITERATIVE_SOLVERS_HPP
+#define ANPI_ITERATIVE_SOLVERS_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "Exception.hpp"
+#include "Matrix.hpp"
+#include "SparseMatrix.hpp"
+
+namespace anpi {
+
+  /*
+   * Iterative solvers of linear systems A*x = b.
+   *
+   * All solvers accept a dense Matrix or a SparseMatrix as operator A.
+   * On input x holds the initial guess (if its size does not match, the
+   * iteration starts from zero), and on output the solution.  They stop
+   * as soon as the residual satisfies |b - A*x| <= eps*|b|, and return
+   * the number of iterations performed.  The work vectors are allocated
+   * once, before the first iteration.
+   *
+   * @throw anpi::Exception if the tolerance is not reached within the
+   *        given maximum number of iterations (x then holds the last
+   *        iterate) or if the method breaks down.
+   */
+
+  namespace bits {
+    /// View of a vector as one matrix row
+    template<typename T>
+    inline ConstMatrixView<T> rowView(const std::vector<T>& v) {
+      return ConstMatrixView<T>(v.data(),1,v.size(),v.size());
+    }
+
+    /// View of a vector as one matrix row
+    template<typename T>
+    inline MatrixView<T> rowView(std::vector<T>& v) {
+      return MatrixView<T>(v.data(),1,v.size(),v.size());
+    }
+
+    /// Dot product of two vectors
+    template<typename T>
+    inline T dot(const std::vector<T>& a,const std::vector<T>& b) {
+      return aimpl::dot(a.data(),b.data(),a.size());
+    }
+
+    /// y = alpha*x + y
+    template<typename T>
+    inline void axpy(const T alpha,
+                     const std::vector<T>& x,
+                     std::vector<T>& y) {
+      aimpl::axpy(alpha,rowView(x),rowView(y));
+    }
+
+    /// z = alpha*x + y
+    template<typename T>
+    inline void axpy(const T alpha,
+                     const std::vector<T>& x,
+                     const std::vector<T>& y,
+                     std::vector<T>& z) {
+      aimpl::axpy(alpha,rowView(x),rowView(y),rowView(z));
+    }
+
+    /// Euclidean norm
+    template<typename T>
+    inline T norm(const std::vector<T>& a) {
+      return std::sqrt(dot(a,a));
+    }
+
+    /// y = A*x with a dense matrix
+    template<typename T,class Alloc>
+    inline void apply(const Matrix<T,Alloc>& A,
+                      const std::vector<T>& x,
+                      std::vector<T>& y) {
+      const size_t n = A.cols();
+      parallel::forChunks(A.rows(),16,A.rows()*n,
+                          [&](size_t begin,size_t end) {
+        for (size_t i=begin;i<end;++i) {
+          y[i] = aimpl::dot(A[i],x.data(),n);
+        }
+      });
+    }
+
+    /// y = A*x with a sparse matrix
+    template<typename T>
+    inline void apply(const SparseMatrix<T>& A,
+                      const std::vector<T>& x,
+                      std::vector<T>& y) {
+      multiply(A,x,y);
+    }
+
+    /// Row i of the dense A times x
+    template<typename T,class Alloc>
+    inline T rowDot(const Matrix<T,Alloc>& A,
+                    const size_t i,
+                    const std::vector<T>& x) {
+      return aimpl::dot(A[i],x.data(),A.cols());
+    }
+
+    /// Row i of the sparse A times x
+    template<typename T>
+    inline T rowDot(const SparseMatrix<T>& A,
+                    const size_t i,
+                    const std::vector<T>& x) {
+      const size_t* rowPtr = A.rowPtr().data();
+      const sparse_index* cols = A.colIndices().data();
+      const T* vals = A.values().data();
+      T sum = T(0);
+      for (size_t k=rowPtr[i];k<rowPtr[i+1];++k) {
+        sum += vals[k]*x[cols[k]];
+      }
+      return sum;
+    }
+
+    /**
+     * Diagonal of A
+     *
+     * @throw anpi::Exception if an entry of the diagonal is zero
+     */
+    template<class M,typename T>
+    inline void diagonal(const M& A,std::vector<T>& d) {
+      d.resize(A.rows());
+      for (size_t i=0;i<A.rows();++i) {
+        d[i] = A(i,i);
+        if (d[i] == T(0)) {
+          throw Exception("Zero on the diagonal of the system");
+        }
+      }
+    }
+
+    /**
+     * Check the sizes, initialize x and the residual r = b - A*x.
+     *
+     * @return the norm of b
+     */
+    template<class M,typename T>
+    inline T prepare(const M& A,
+                     const std::vector<T>& b,
+                     std::vector<T>& x,
+                     std::vector<T>& r) {
+      if ( (A.rows() != A.cols()) || (b.size() != A.rows()) ) {
+        throw Exception("System matrix must be square and match b");
+      }
+      if (x.size() != b.size()) {
+        x.assign(b.size(),T(0));
+      }
+      r.resize(b.size());
+      apply(A,x,r);
+      axpy(T(-1),r,b,r);
+      return norm(b);
+    }
+  } // namespace bits
+
+  /**
+   * Conjugate gradients, for symmetric positive definite matrices.
+   *
+   * @param A system matrix, dense or sparse
+   * @param b right-hand side
+   * @param x initial guess on input and solution on output
+   * @param eps relative tolerance of the residual
+   * @param maxIterations maximum number of iterations
+   *
+   * @return number of iterations
+   */
+  template<class M,typename T>
+  size_t solveCG(const M& A,
+                 const std::vector<T>& b,
+                 std::vector<T>& x,
+                 const T eps=std::sqrt(std::numeric_limits<T>::epsilon()),
+                 const size_t maxIterations=1000) {
+    std::vector<T> r,p,Ap(b.size());
+    const T tol = eps*bits::prepare(A,b,x,r);
+
+    T rr = bits::dot(r,r);
+    if (std::sqrt(rr) <= tol) {
+      return 0;
+    }
+    p = r;
+
+    for (size_t it=1;it<=maxIterations;++it) {
+      bits::apply(A,p,Ap);
+      const T pAp = bits::dot(p,Ap);
+      if (pAp == T(0)) {
+        throw Exception("CG breakdown");
+      }
+      const T alpha = rr/pAp;
+      bits::axpy(alpha,p,x);
+      bits::axpy(-alpha,Ap,r);
+
+      const T rrNew = bits::dot(r,r);
+      if (std::sqrt(rrNew) <= tol) {
+        return it;
+      }
+      // p = r + beta*p
+      bits::axpy(rrNew/rr,p,r,p);
+      rr = rrNew;
+    }
+
+    throw Exception("CG did not converge");
+  }
+
+  /**
+   * Biconjugate gradient stabilized method, for general matrices.
+   *
+   * @param A system matrix, dense or sparse
+   * @param b right-hand side
+   * @param x initial guess on input and solution on output
+   * @param eps relative tolerance of the residual
+   * @param maxIterations maximum number of iterations
+   *
+   * @return number of iterations
+   */
+  template<class M,typename T>
+  size_t solveBiCGSTAB(const M& A,
+                       const std::vector<T>& b,
+                       std::vector<T>& x,
+                       const T eps=std::sqrt(std::numeric_limits<T>::epsilon()),
+                       const size_t maxIterations=1000) {
+    const size_t n = b.size();
+    std::vector<T> r,rhat,p(n,T(0)),v(n,T(0)),s(n),t(n);
+    const T tol = eps*bits::prepare(A,b,x,r);
+
+    if (bits::norm(r) <= tol) {
+      return 0;
+    }
+    rhat = r;
+
+    T rho = T(1), alpha = T(1), omega = T(1);
+    for (size_t it=1;it<=maxIterations;++it) {
+      const T rhoNew = bits::dot(rhat,r);
+      if ( (rhoNew == T(0)) || (omega == T(0)) ) {
+        throw Exception("BiCGSTAB breakdown");
+      }
+      const T beta = (rhoNew/rho)*(alpha/omega);
+      rho = rhoNew;
+
+      // p = r + beta*(p - omega*v)
+      bits::axpy(-omega,v,p);
+      bits::axpy(beta,p,r,p);
+
+      bits::apply(A,p,v);
+      const T rv = bits::dot(rhat,v);
+      if (rv == T(0)) {
+        throw Exception("BiCGSTAB breakdown");
+      }
+      alpha = rho/rv;
+
+      // s = r - alpha*v
+      bits::axpy(-alpha,v,r,s);
+      if (bits::norm(s) <= tol) {
+        bits::axpy(alpha,p,x);
+        return it;
+      }
+
+      bits::apply(A,s,t);
+      const T tt = bits::dot(t,t);
+      omega = (tt != T(0)) ? bits::dot(t,s)/tt : T(0);
+
+      // x = x + alpha*p + omega*s
+      bits::axpy(alpha,p,x);
+      bits::axpy(omega,s,x);
+
+      // r = s - omega*t
+      bits::axpy(-omega,t,s,r);
+      if (bits::norm(r) <= tol) {
+        return it;
+      }
+    }
+
+    throw Exception("BiCGSTAB did not converge");
+  }
+
+  /**
+   * Jacobi iteration, for diagonally dominant matrices.
+   *
+   * All rows are updated from the previous iterate, so that each sweep
+   * is distributed among the threads.
+   *
+   * @param A system matrix, dense or sparse
+   * @param b right-hand side
+   * @param x initial guess on input and solution on output
+   * @param eps relative tolerance of the residual
+   * @param maxIterations maximum number of iterations
+   *
+   * @return number of iterations
+   */
+  template<class M,typename T>
+  size_t solveJacobi(const M& A,
+                     const std::vector<T>& b,
+                     std::vector<T>& x,
+                     const T eps=std::sqrt(std::numeric_limits<T>::epsilon()),
+                     const size_t maxIterations=10000) {
+    std::vector<T> r,d;
+    const T tol = eps*bits::prepare(A,b,x,r);
+    bits::diagonal(A,d);
+
+    for (size_t it=0;it<maxIterations;++it) {
+      if (bits::norm(r) <= tol) {
+        return it;
+      }
+      // x = x + D^-1 r
+      for (size_t i=0;i<b.size();++i) {
+        x[i] += r[i]/d[i];
+      }
+      bits::apply(A,x,r);
+      bits::axpy(T(-1),r,b,r);
+    }
+    if (bits::norm(r) <= tol) {
+      return maxIterations;
+    }
+
+    throw Exception("Jacobi did not converge");
+  }
+
+  /**
+   * Successive over-relaxation, for symmetric positive definite or
+   * diagonally dominant matrices.
+   *
+   * Each sweep updates the rows in order, x_i += omega*r_i/a_ii, where
+   * r_i uses the entries of x already updated in the same sweep.  Those
+   * r_i are not the residual of the final x, so the convergence test
+   * computes b - A*x after each sweep, at the cost of one more product.
+   *
+   * @param A system matrix, dense or sparse
+   * @param b right-hand side
+   * @param x initial guess on input and solution on output
+   * @param omega relaxation factor in (0,2); 1 is Gauss-Seidel
+   * @param eps relative tolerance of the residual
+   * @param maxIterations maximum number of sweeps
+   *
+   * @return number of sweeps
+   */
+  template<class M,typename T>
+  size_t solveSOR(const M& A,
+                  const std::vector<T>& b,
+                  std::vector<T>& x,
+                  const T omega,
+                  const T eps=std::sqrt(std::numeric_limits<T>::epsilon()),
+                  const size_t maxIterations=10000) {
+    if ( !(omega > T(0)) || !(omega < T(2)) ) {
+      throw Exception("SOR relaxation factor must lie in (0,2)");
+    }
+    std::vector<T> r,d;
+    const T tol = eps*bits::prepare(A,b,x,r);
+    bits::diagonal(A,d);
+
+    if (bits::norm(r) <= tol) {
+      return 0;
+    }
+
+    const size_t n = b.size();
+    for (size_t it=1;it<=maxIterations;++it) {
+      for (size_t i=0;i<n;++i) {
+        x[i] += omega*(b[i] - bits::rowDot(A,i,x))/d[i];
+      }
+      bits::apply(A,x,r);
+      bits::axpy(T(-1),r,b,r);
+      if (bits::norm(r) <= tol) {
+        return it;
+      }
+    }
+
+    throw Exception("SOR did not converge");
+  }
+
+  /**
+   * Gauss-Seidel iteration: SOR with omega = 1
+   */
+  template<class M,typename T>
+  size_t solveGaussSeidel(const M& A,
+                          const std::vector<T>& b,
+                          std::vector<T>& x,
+                          const T eps=std::sqrt(std::numeric_limits<T>::epsilon()),
+                          const size_t maxIterations=10000) {
+    return solveSOR(A,b,x,T(1),eps,maxIterations);
+  }
+
+} // namespace anpi
+
+#endif
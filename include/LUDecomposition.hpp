@@ -0,0 +1,420 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date  : 05.01.2018
+ */
+
+#ifndef ANPI_LU_DECOMPOSITION_HPP
+#define ANPI_LU_DECOMPOSITION_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "Exception.hpp"
+#include "Matrix.hpp"
+
+namespace anpi {
+
+  /*
+   * LU decomposition with partial pivoting.
+   *
+   * All functions compute P*A = L*U, where L is unit lower triangular
+   * and U upper triangular.  Both are packed in one single matrix LU:
+   * U in the upper triangle including the diagonal, and L below it
+   * (its unit diagonal is not stored).  The permutation P is given as
+   * a vector permut, such that row i of P*A is row permut[i] of A.
+   */
+
+  namespace bits {
+    /// Swap the effective entries of two rows
+    template<typename T,class Alloc>
+    inline void swapRows(Matrix<T,Alloc>& m,const size_t r1,const size_t r2) {
+      if (r1 != r2) {
+        std::swap_ranges(m[r1],m[r1]+m.cols(),m[r2]);
+      }
+    }
+
+    /// Row with the largest magnitude in column col, from row begin on
+    template<typename T,class Alloc>
+    inline size_t pivotRow(const Matrix<T,Alloc>& m,
+                           const size_t begin,
+                           const size_t col) {
+      size_t p = begin;
+      T best = std::abs(m(begin,col));
+      for (size_t i=begin+1;i<m.rows();++i) {
+        const T val = std::abs(m(i,col));
+        if (val > best) {
+          best = val;
+          p = i;
+        }
+      }
+      return p;
+    }
+
+    /**
+     * Factorize the panel LU(k:n,k:k+kb), swapping whole rows.
+     *
+     * Only the columns of the panel are updated; the rest of the rows
+     * is just permuted.
+     *
+     * @throw anpi::Exception if the matrix is singular
+     */
+    template<typename T,class Alloc>
+    void luPanel(Matrix<T,Alloc>& LU,
+                 std::vector<size_t>& permut,
+                 const size_t k,
+                 const size_t kb) {
+      const size_t n = LU.rows();
+      const size_t kend = k+kb;
+
+      for (size_t j=k;j<kend;++j) {
+        const size_t p = pivotRow(LU,j,j);
+        if (LU(p,j) == T(0)) {
+          throw Exception("LU decomposition of a singular matrix");
+        }
+        swapRows(LU,p,j);
+        std::swap(permut[p],permut[j]);
+
+        const T inv = T(1)/LU(j,j);
+        const T* urow = LU[j];
+        for (size_t i=j+1;i<n;++i) {
+          T* row = LU[i];
+          const T lij = (row[j] *= inv);
+          for (size_t c=j+1;c<kend;++c) {
+            row[c] -= lij*urow[c];
+          }
+        }
+      }
+    }
+  } // namespace bits
+
+  /**
+   * Unblocked LU decomposition with partial pivoting.
+   *
+   * Plain row-by-row elimination, kept as reference for the blocked
+   * version lu() below.
+   *
+   * @param A square matrix to decompose
+   * @param LU packed factors L and U
+   * @param permut row permutation
+   *
+   * @throw anpi::Exception if A is not square or singular
+   */
+  template<typename T,class Alloc>
+  void luUnblocked(const Matrix<T,Alloc>& A,
+                   Matrix<T,Alloc>& LU,
+                   std::vector<size_t>& permut) {
+    if (A.rows() != A.cols()) {
+      throw Exception("LU decomposition requires a square matrix");
+    }
+
+    const size_t n = A.rows();
+    LU = A;
+    permut.resize(n);
+    for (size_t i=0;i<n;++i) {
+      permut[i]=i;
+    }
+
+    for (size_t j=0;j<n;++j) {
+      const size_t p = bits::pivotRow(LU,j,j);
+      if (LU(p,j) == T(0)) {
+        throw Exception("LU decomposition of a singular matrix");
+      }
+      bits::swapRows(LU,p,j);
+      std::swap(permut[p],permut[j]);
+
+      const T inv = T(1)/LU(j,j);
+      const T* urow = LU[j];
+      for (size_t i=j+1;i<n;++i) {
+        T* row = LU[i];
+        const T lij = (row[j] *= inv);
+        for (size_t c=j+1;c<n;++c) {
+          row[c] -= lij*urow[c];
+        }
+      }
+    }
+  }
+
+  /**
+   * Blocked right-looking LU decomposition with partial pivoting.
+   *
+   * The columns are processed in panels of blockSize columns.  Each
+   * panel is factorized with the unblocked algorithm, then the block
+   * row U12 to its right is solved with the unit triangle L11, and the
+   * trailing submatrix receives the rank-blockSize update
+   * A22 = A22 - L21*U12, which runs through the (SIMD) matrix product
+   * kernel and carries nearly all the floating point operations.
+   *
+   * @param A square matrix to decompose
+   * @param LU packed factors L and U
+   * @param permut row permutation
+   * @param blockSize number of columns per panel
+   *
+   * @throw anpi::Exception if A is not square or singular
+   */
+  template<typename T,class Alloc>
+  void lu(const Matrix<T,Alloc>& A,
+          Matrix<T,Alloc>& LU,
+          std::vector<size_t>& permut,
+          const size_t blockSize=64) {
+    if (A.rows() != A.cols()) {
+      throw Exception("LU decomposition requires a square matrix");
+    }
+
+    const size_t n = A.rows();
+    const size_t nb = std::max(blockSize,size_t(1));
+    LU = A;
+    permut.resize(n);
+    for (size_t i=0;i<n;++i) {
+      permut[i]=i;
+    }
+
+    for (size_t k=0;k<n;k+=nb) {
+      const size_t kb = std::min(nb,n-k);
+      const size_t kend = k+kb;
+
+      bits::luPanel(LU,permut,k,kb);
+
+      if (kend == n) {
+        break;
+      }
+      const size_t rest = n-kend;
+
+      // U12 = L11^-1 A12, one row axpy per entry of L11
+      for (size_t j=k;j<kend;++j) {
+        const ConstMatrixView<T> urow = LU.block(j,kend,1,rest);
+        for (size_t i=j+1;i<kend;++i) {
+          aimpl::axpy(-LU(i,j),urow,LU.block(i,kend,1,rest));
+        }
+      }
+
+      // A22 = A22 - L21*U12
+      aimpl::multiplyAdd(T(-1),
+                         ConstMatrixView<T>(LU.block(kend,k,rest,kb)),
+                         ConstMatrixView<T>(LU.block(k,kend,kb,rest)),
+                         LU.block(kend,kend,rest,rest));
+    }
+  }
+
+  /**
+   * Extract the factors L and U from the packed LU matrix
+   */
+  template<typename T,class Alloc>
+  void unpack(const Matrix<T,Alloc>& LU,
+              Matrix<T,Alloc>& L,
+              Matrix<T,Alloc>& U) {
+    const size_t n = LU.rows();
+    L = Matrix<T,Alloc>(n,n,T(0));
+    U = Matrix<T,Alloc>(n,n,T(0));
+    for (size_t i=0;i<n;++i) {
+      for (size_t j=0;j<i;++j) {
+        L(i,j) = LU(i,j);
+      }
+      L(i,i) = T(1);
+      for (size_t j=i;j<n;++j) {
+        U(i,j) = LU(i,j);
+      }
+    }
+  }
+
+  /**
+   * Solve L*U*x = P*b, with the packed factors of lu().
+   *
+   * @param LU packed factors L and U
+   * @param permut row permutation
+   * @param b right-hand side
+   * @param x solution (may be the same vector as b)
+   */
+  template<typename T,class Alloc>
+  void luSubstitute(const Matrix<T,Alloc>& LU,
+                    const std::vector<size_t>& permut,
+                    const std::vector<T>& b,
+                    std::vector<T>& x) {
+    const size_t n = LU.rows();
+    if ( (b.size() != n) || (permut.size() != n) ) {
+      throw Exception("Right-hand side does not match the LU factors");
+    }
+
+    std::vector<T> y(n);
+    for (size_t i=0;i<n;++i) {
+      y[i] = b[permut[i]];
+    }
+
+    // forward substitution with the unit triangle L
+    for (size_t i=1;i<n;++i) {
+      const T* row = LU[i];
+      T sum = y[i];
+      for (size_t j=0;j<i;++j) {
+        sum -= row[j]*y[j];
+      }
+      y[i] = sum;
+    }
+
+    // back substitution with U
+    for (size_t i=n;i-- > 0;) {
+      const T* row = LU[i];
+      T sum = y[i];
+      for (size_t j=i+1;j<n;++j) {
+        sum -= row[j]*y[j];
+      }
+      y[i] = sum/row[i];
+    }
+
+    x.swap(y);
+  }
+
+  /**
+   * Solve L*U*X = P*B for many right-hand sides at once.
+   *
+   * Each column of B is one right-hand side.  Both substitutions work
+   * on whole rows of X, so that the updates are axpy operations of
+   * B.cols() entries.
+   *
+   * @param LU packed factors L and U
+   * @param permut row permutation
+   * @param B right-hand sides
+   * @param X solutions (must not be B)
+   */
+  template<typename T,class Alloc>
+  void luSubstitute(const Matrix<T,Alloc>& LU,
+                    const std::vector<size_t>& permut,
+                    const Matrix<T,Alloc>& B,
+                    Matrix<T,Alloc>& X) {
+    const size_t n = LU.rows();
+    if ( (B.rows() != n) || (permut.size() != n) ) {
+      throw Exception("Right-hand sides do not match the LU factors");
+    }
+    assert(&B != &X);
+
+    const size_t m = B.cols();
+    X.allocate(n,m);
+    for (size_t i=0;i<n;++i) {
+      std::copy(B[permut[i]],B[permut[i]]+m,X[i]);
+    }
+
+    // forward substitution with the unit triangle L
+    for (size_t j=0;j<n;++j) {
+      const ConstMatrixView<T> xj = X.block(j,0,1,m);
+      for (size_t i=j+1;i<n;++i) {
+        aimpl::axpy(-LU(i,j),xj,X.block(i,0,1,m));
+      }
+    }
+
+    // back substitution with U
+    for (size_t j=n;j-- > 0;) {
+      aimpl::scale(X.block(j,0,1,m),T(1)/LU(j,j));
+      const ConstMatrixView<T> xj = X.block(j,0,1,m);
+      for (size_t i=0;i<j;++i) {
+        aimpl::axpy(-LU(i,j),xj,X.block(i,0,1,m));
+      }
+    }
+  }
+
+  /**
+   * Solve the system A*x = b using the blocked LU decomposition
+   */
+  template<typename T,class Alloc>
+  void solveLU(const Matrix<T,Alloc>& A,
+               std::vector<T>& x,
+               const std::vector<T>& b) {
+    Matrix<T,Alloc> LU;
+    std::vector<size_t> permut;
+    lu(A,LU,permut);
+    luSubstitute(LU,permut,b,x);
+  }
+
+  /**
+   * Reusable LU factorization.
+   *
+   * The factors of a matrix are computed once with factorize(), and
+   * then used to solve for as many right-hand sides as required.  The
+   * storage is kept among factorizations of matrices of the same size.
+   */
+  template<typename T,class Alloc=anpi::aligned_row_allocator<T> >
+  class LUDecomposition {
+  public:
+    /// Matrix type of the factors
+    typedef Matrix<T,Alloc> matrix_type;
+
+  private:
+    /// Packed factors
+    matrix_type _lu;
+
+    /// Row permutation
+    std::vector<size_t> _permut;
+
+    /// Panel width of the blocked algorithm
+    size_t _blockSize;
+
+  public:
+    /// Construct, with the panel width of the blocked algorithm
+    explicit LUDecomposition(const size_t blockSize=64)
+      : _blockSize(blockSize) {}
+
+    /// Construct and factorize A
+    explicit LUDecomposition(const matrix_type& A,
+                             const size_t blockSize=64)
+      : _blockSize(blockSize) {
+      factorize(A);
+    }
+
+    /// Factorize A, replacing the previous factors
+    void factorize(const matrix_type& A) {
+      ::anpi::lu(A,_lu,_permut,_blockSize);
+    }
+
+    /// Solve A*x = b
+    void solve(const std::vector<T>& b,std::vector<T>& x) const {
+      luSubstitute(_lu,_permut,b,x);
+    }
+
+    /// Solve A*X = B, with one right-hand side per column of B
+    void solve(const matrix_type& B,matrix_type& X) const {
+      luSubstitute(_lu,_permut,B,X);
+    }
+
+    /// Determinant of the factorized matrix
+    T determinant() const {
+      const size_t n = _lu.rows();
+      T det = T(1);
+      for (size_t i=0;i<n;++i) {
+        det *= _lu(i,i);
+      }
+
+      // sign of the permutation, counting its cycles
+      std::vector<bool> seen(n,false);
+      for (size_t i=0;i<n;++i) {
+        if (!seen[i]) {
+          size_t len = 0;
+          for (size_t j=i;!seen[j];j=_permut[j]) {
+            seen[j] = true;
+            ++len;
+          }
+          if ((len % 2) == 0) {
+            det = -det;
+          }
+        }
+      }
+      return det;
+    }
+
+    /// Packed factors L and U
+    inline const matrix_type& lu() const { return _lu; }
+
+    /// Row permutation: row i of P*A is row permutation()[i] of A
+    inline const std::vector<size_t>& permutation() const { return _permut; }
+
+    /// Panel width of the blocked algorithm
+    inline size_t blockSize() const { return _blockSize; }
+  };
+
+} // namespace anpi
+
+#endif
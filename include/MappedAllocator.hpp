@@ -0,0 +1,373 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @author Pablo Alvarado
+ * @date   15.12.2017
+ */
+
+#ifndef ANPI_MAPPED_ALLOCATOR_HPP
+#define ANPI_MAPPED_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "Allocator.hpp"
+#include "Exception.hpp"
+#include "Matrix.hpp"
+#include "bits/MatrixFileHeader.hpp"
+
+namespace anpi {
+
+  /**
+   * How a matrix file is mapped into memory
+   */
+  enum class MapMode {
+    ReadOnly,  ///< Existing file, mapped as a const matrix
+    ReadWrite, ///< Existing file, modifications are written back
+    Create     ///< New (or truncated) file, modifications are written back
+  };
+
+  /**
+   * Expected access pattern of a mapped matrix, forwarded to madvise()
+   */
+  enum class MapAdvice {
+    Normal,     ///< No particular pattern
+    Sequential, ///< Streaming access: aggressive read-ahead, early release
+    Random,     ///< Scattered access: no read-ahead
+    WillNeed    ///< Start reading the whole matrix in the background
+  };
+
+  /**
+   * Give the kernel a hint about the access pattern of the given range
+   */
+  inline void mappedAdvise(void* base,const size_t bytes,const MapAdvice advice) {
+    int flag = MADV_NORMAL;
+    switch (advice) {
+    case MapAdvice::Sequential: flag = MADV_SEQUENTIAL; break;
+    case MapAdvice::Random:     flag = MADV_RANDOM;     break;
+    case MapAdvice::WillNeed:   flag = MADV_WILLNEED;   break;
+    default: break;
+    }
+    // only a hint: failures are ignored
+    ::madvise(base,bytes,flag);
+  }
+
+  /**
+   * Allocator placing the matrix entries in memory mappings.
+   *
+   * By default the allocator reserves anonymous mappings.  An allocator
+   * created with a file request maps that file instead, once: the first
+   * allocation returns the entries stored in the file, and further
+   * allocations (for instance after resizing the matrix) fall back to
+   * anonymous memory.  Matrices with file-backed storage are usually
+   * obtained with createMapped(), openMapped() and openMappedReadOnly()
+   * below.
+   *
+   * Every mapping reserves header_bytes in front of the entries, which
+   * in files hold the matrix_file_header (see bits/MatrixFileHeader.hpp).
+   * Hence, any instance can release memory reserved by any other one,
+   * and all instances compare equal.
+   *
+   * Like aligned_row_allocator, the rows are padded to the alignment,
+   * which must be a divisor of the page size.
+   */
+  template<class T, std::size_t Align=DefaultAlignment>
+  class mapped_allocator {
+  public:
+    typedef T         value_type;
+    typedef T*        pointer;
+    typedef const T*  const_pointer;
+    typedef size_t    size_type;
+    typedef ptrdiff_t difference_type;
+
+    /// Change the stored type
+    template<class U>
+    struct rebind {
+      typedef mapped_allocator<U, Align> other;
+    };
+
+    /// Type to identify this as a row-aligned allocator
+    typedef std::true_type row_aligned;
+
+    /// Bytes in front of the entries of each mapping
+    static constexpr size_t header_bytes = matrixFileOffset(Align);
+
+    /// Pending request to map a file
+    struct request {
+      std::string path;
+      MapMode     mode;
+      MapAdvice   advice;
+      /// Number of rows of a created file
+      size_t      rows;
+      /// Number of columns of a created file
+      size_t      cols;
+      /// The file has not been mapped yet
+      bool        pending;
+    };
+
+  private:
+    /// Request shared among the copies of this allocator
+    std::shared_ptr<request> _request;
+
+  public:
+    /// Allocator of anonymous mappings
+    mapped_allocator() noexcept {}
+
+    /// Allocator that maps the given file at its first allocation
+    mapped_allocator(const std::string& path,
+                     const MapMode mode,
+                     const MapAdvice advice=MapAdvice::Normal,
+                     const size_t rows=0,
+                     const size_t cols=0)
+      : _request(std::make_shared<request>()) {
+      _request->path    = path;
+      _request->mode    = mode;
+      _request->advice  = advice;
+      _request->rows    = rows;
+      _request->cols    = cols;
+      _request->pending = true;
+    }
+
+    /// Copy from another stored type
+    template<class U>
+    mapped_allocator(const mapped_allocator<U,Align>&) noexcept {}
+
+    /// Reserve n entries
+    T* allocate(const size_t n) {
+      if (_request && _request->pending) {
+        _request->pending = false;
+        return _mapFile(n);
+      }
+
+      const size_t bytes = header_bytes + n*sizeof(T);
+      void* base = ::mmap(0,bytes,PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS,-1,0);
+      if (base == MAP_FAILED) {
+        throw std::bad_alloc();
+      }
+      return _entries(base);
+    }
+
+    /// Release the n entries at p, writing them back if file-backed
+    void deallocate(T* p,const size_t n) noexcept {
+      if (p) {
+        ::munmap(reinterpret_cast<char*>(p) - header_bytes,
+                 header_bytes + n*sizeof(T));
+      }
+    }
+
+  private:
+    /// Entries of the mapping starting at base
+    static T* _entries(void* base) {
+      return reinterpret_cast<T*>(static_cast<char*>(base) + header_bytes);
+    }
+
+    /// Map the requested file, holding n entries
+    T* _mapFile(const size_t n) {
+      const request& r = *_request;
+      const size_t bytes = header_bytes + n*sizeof(T);
+
+      const int flags =
+        (r.mode == MapMode::ReadOnly)  ? O_RDONLY :
+        (r.mode == MapMode::ReadWrite) ? O_RDWR   :
+        (O_RDWR | O_CREAT | O_TRUNC);
+
+      const int fd = ::open(r.path.c_str(),flags,0644);
+      if (fd < 0) {
+        throw Exception("Cannot open matrix file " + r.path);
+      }
+
+      if (r.mode == MapMode::Create) {
+        if (::ftruncate(fd,static_cast<off_t>(bytes)) != 0) {
+          ::close(fd);
+          throw Exception("Cannot resize matrix file " + r.path);
+        }
+      } else {
+        struct stat st;
+        if ( (::fstat(fd,&st) != 0) ||
+             (static_cast<size_t>(st.st_size) != bytes) ) {
+          ::close(fd);
+          throw Exception("Unexpected size of matrix file " + r.path);
+        }
+      }
+
+      const int prot = (r.mode == MapMode::ReadOnly)
+        ? PROT_READ
+        : (PROT_READ | PROT_WRITE);
+      void* base = ::mmap(0,bytes,prot,MAP_SHARED,fd,0);
+      // the mapping keeps its own reference to the file
+      ::close(fd);
+
+      if (base == MAP_FAILED) {
+        throw Exception("Cannot map matrix file " + r.path);
+      }
+
+      if (r.mode == MapMode::Create) {
+        *static_cast<matrix_file_header*>(base) =
+          makeMatrixFileHeader<T>(r.rows,r.cols,
+                                  (r.rows != 0) ? n/r.rows : 0,
+                                  Align);
+      }
+
+      mappedAdvise(base,bytes,r.advice);
+
+      return _entries(base);
+    }
+  };
+
+  /// All mapped allocators can release each other's memory
+  template<class T,class U,std::size_t Align>
+  inline bool operator==(const mapped_allocator<T,Align>&,
+                         const mapped_allocator<U,Align>&) noexcept {
+    return true;
+  }
+
+  template<class T,class U,std::size_t Align>
+  inline bool operator!=(const mapped_allocator<T,Align>&,
+                         const mapped_allocator<U,Align>&) noexcept {
+    return false;
+  }
+
+  // Specialization for the mapped_allocator
+  template<typename T, std::size_t A>
+  struct is_aligned_alloc< anpi::mapped_allocator<T,A> > {
+    static const bool value = true;
+  };
+
+  /**
+   * Create a file holding a rows x cols matrix and map it read-write.
+   *
+   * The entries are not initialized (the file is zero filled).  All
+   * changes to the matrix are written back to the file, at the latest
+   * when the matrix is destroyed.
+   */
+  template<typename T,std::size_t Align=DefaultAlignment>
+  Matrix<T,mapped_allocator<T,Align> >
+  createMapped(const std::string& path,
+               const size_t rows,
+               const size_t cols,
+               const MapAdvice advice=MapAdvice::Normal) {
+    if ( (rows == 0) || (cols == 0) ) {
+      throw Exception("Matrix files cannot be empty");
+    }
+    mapped_allocator<T,Align> alloc(path,MapMode::Create,advice,rows,cols);
+    return Matrix<T,mapped_allocator<T,Align> >(rows,cols,
+                                                DoNotInitialize,alloc);
+  }
+
+  /**
+   * Map an existing matrix file with the given mode, after checking that
+   * its header matches the layout of the matrix.  Used by openMapped()
+   * and openMappedReadOnly().
+   */
+  template<typename T,std::size_t Align>
+  Matrix<T,mapped_allocator<T,Align> >
+  _openMapped(const std::string& path,
+              const MapMode mode,
+              const MapAdvice advice) {
+    const matrix_file_header h = readMatrixFileHeader(path);
+    checkMatrixFileType<T>(h,path);
+    // row stride the matrix will use, as computed by Matrix::allocate()
+    const size_t dcols = ( (h.cols*sizeof(T) + Align - 1)/Align )*
+                         Align/sizeof(T);
+    if ( (h.alignment != Align) ||
+         (h.offset != mapped_allocator<T,Align>::header_bytes) ||
+         (h.dcols != dcols) ) {
+      throw Exception("Incompatible layout of matrix file " + path);
+    }
+
+    mapped_allocator<T,Align> alloc(path,mode,advice);
+    Matrix<T,mapped_allocator<T,Align> > m(h.rows,h.cols,
+                                           DoNotInitialize,alloc);
+    assert(m.dcols() == h.dcols);
+    return m;
+  }
+
+  /**
+   * Map an existing matrix file for reading and writing.
+   *
+   * This takes constant time: only the header is read, and the entries
+   * are loaded on demand as they are accessed.  All changes to the
+   * matrix are written back to the file.  Files that must not be
+   * modified are mapped with openMappedReadOnly().
+   *
+   * @throw anpi::Exception if the file was written for a different
+   *        element type, alignment or row stride, or if mode is not
+   *        MapMode::ReadWrite
+   */
+  template<typename T,std::size_t Align=DefaultAlignment>
+  Matrix<T,mapped_allocator<T,Align> >
+  openMapped(const std::string& path,
+             const MapMode mode=MapMode::ReadWrite,
+             const MapAdvice advice=MapAdvice::Normal) {
+    if (mode == MapMode::Create) {
+      throw Exception("openMapped cannot create files, use createMapped");
+    }
+    if (mode == MapMode::ReadOnly) {
+      throw Exception("openMapped cannot map files read-only, "
+                      "use openMappedReadOnly");
+    }
+    return _openMapped<T,Align>(path,mode,advice);
+  }
+
+  /**
+   * Map an existing matrix file read-only.
+   *
+   * As openMapped(), but the pages are mapped without write access, so
+   * the matrix is returned const: writing to it would crash.  It can be
+   * used as operand of any operation without copying the entries.
+   *
+   * @throw anpi::Exception if the file was written for a different
+   *        element type, alignment or row stride
+   */
+  template<typename T,std::size_t Align=DefaultAlignment>
+  const Matrix<T,mapped_allocator<T,Align> >
+  openMappedReadOnly(const std::string& path,
+                     const MapAdvice advice=MapAdvice::Normal) {
+    return _openMapped<T,Align>(path,MapMode::ReadOnly,advice);
+  }
+
+  /**
+   * Change the access pattern hint of a mapped matrix
+   */
+  template<typename T,std::size_t Align>
+  inline void advise(const Matrix<T,mapped_allocator<T,Align> >& m,
+                     const MapAdvice advice) {
+    if (m.data()) {
+      mappedAdvise(const_cast<char*>(reinterpret_cast<const char*>(m.data()))
+                   - mapped_allocator<T,Align>::header_bytes,
+                   mapped_allocator<T,Align>::header_bytes +
+                   m.rows()*m.dcols()*sizeof(T),
+                   advice);
+    }
+  }
+
+  /**
+   * Write the modifications of a file-backed matrix to the disk now
+   */
+  template<typename T,std::size_t Align>
+  inline void sync(const Matrix<T,mapped_allocator<T,Align> >& m) {
+    if (m.data()) {
+      ::msync(const_cast<char*>(reinterpret_cast<const char*>(m.data()))
+              - mapped_allocator<T,Align>::header_bytes,
+              mapped_allocator<T,Align>::header_bytes +
+              m.rows()*m.dcols()*sizeof(T),
+              MS_SYNC);
+    }
+  }
+
+} // namespace anpi
+
+#endif
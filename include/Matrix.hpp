@@ -12,6 +12,7 @@
 #define ANPI_MATRIX_HPP
 
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <cassert>
 #include <memory>
@@ -20,6 +21,7 @@
 
 #include <AnpiConfig.hpp>
 #include <Allocator.hpp>
+#include <MatrixView.hpp>
 
 #include <typeinfo>
 
@@ -31,6 +33,10 @@ namespace anpi
   enum InitializationType {
     DoNotInitialize
   };
+
+  // Lazily evaluated expressions, see bits/MatrixExpression.hpp
+  template<class E,typename T,class Alloc>
+  class MatrixExpression;
   
   /**
    * Row-major matrix class.
@@ -162,6 +168,23 @@ namespace anpi
     Matrix(std::initializer_list< std::initializer_list<value_type> > _lst);
     Matrix(std::initializer_list< std::initializer_list<value_type> > _lst,
            const allocator_type& _a);
+
+    /**
+     * Construct a matrix evaluating the given expression
+     *
+     * This allows to compute in one single pass
+     *
+     * \code
+     * anpi::Matrix<float> e = a + b - c + d;
+     * \endcode
+     */
+    template<class E>
+    Matrix(const MatrixExpression<E,T,Alloc>& _expr);
+
+    /**
+     * Construct a matrix with a deep copy of the viewed entries
+     */
+    explicit Matrix(const ConstMatrixView<T>& _view);
     
     //@}
 
@@ -176,17 +199,27 @@ namespace anpi
      */
     Matrix<T,Alloc>& operator=(Matrix<T,Alloc>&& other);
 
+    /**
+     * Evaluate the given expression into this matrix
+     */
+    template<class E>
+    Matrix<T,Alloc>& operator=(const MatrixExpression<E,T,Alloc>& _expr);
+
     /**
      * Compare two matrices for equality
      *
-     * This is slow, as all componentes are elementwise compared
+     * The entries are compared bitwise with the SIMD kernels, which
+     * return at the first difference.  Hence, a NaN equals a NaN with
+     * the same bits, and the zeros of different sign differ; use
+     * allclose() to compare floating point values.  The padding is
+     * ignored.
      */
     bool operator==(const Matrix<T,Alloc>& other) const;
 
     /**
-     * Compare two matrices for equality
+     * Compare two matrices for inequality
      *
-     * This is slow, as all componentes are elementwise compared
+     * @see operator==
      */
     bool operator!=(const Matrix<T,Alloc>& other) const;
     
@@ -299,9 +332,74 @@ namespace anpi
     /**
      * Extract one particular column
      *
-     * This method has to copy the column, and hence it is relatively slow
+     * This method has to copy the column, and hence it is relatively slow.
+     * Use columnView() to access the column without copying.
      */
     inline std::vector<value_type> column(const size_t col) const;
+
+    /**
+     * @name Views
+     *
+     * Non-owning windows into the entries of this matrix, valid as long
+     * as the matrix is not reallocated (see MatrixView.hpp)
+     */
+    //@{
+
+    /// View of the whole matrix
+    inline MatrixView<T> view() {
+      return MatrixView<T>(data(),rows(),cols(),dcols());
+    }
+
+    /// Read-only view of the whole matrix
+    inline ConstMatrixView<T> view() const {
+      return ConstMatrixView<T>(data(),rows(),cols(),dcols());
+    }
+
+    /// Block of _rows x _cols entries with the upper-left corner at (row,col)
+    inline MatrixView<T> block(const size_t row,const size_t col,
+                               const size_t _rows,const size_t _cols) {
+      return view().block(row,col,_rows,_cols);
+    }
+
+    /// Read-only block of _rows x _cols entries at (row,col)
+    inline ConstMatrixView<T> block(const size_t row,const size_t col,
+                                    const size_t _rows,
+                                    const size_t _cols) const {
+      return view().block(row,col,_rows,_cols);
+    }
+
+    /// Rows in the interval [begin,end)
+    inline MatrixView<T> rowRange(const size_t begin,const size_t end) {
+      return view().rowRange(begin,end);
+    }
+
+    /// Read-only rows in the interval [begin,end)
+    inline ConstMatrixView<T> rowRange(const size_t begin,
+                                       const size_t end) const {
+      return view().rowRange(begin,end);
+    }
+
+    /// Columns in the interval [begin,end)
+    inline MatrixView<T> colRange(const size_t begin,const size_t end) {
+      return view().colRange(begin,end);
+    }
+
+    /// Read-only columns in the interval [begin,end)
+    inline ConstMatrixView<T> colRange(const size_t begin,
+                                       const size_t end) const {
+      return view().colRange(begin,end);
+    }
+
+    /// One column, as a strided rows x 1 view
+    inline MatrixView<T> columnView(const size_t col) {
+      return view().column(col);
+    }
+
+    /// One read-only column, as a strided rows x 1 view
+    inline ConstMatrixView<T> columnView(const size_t col) const {
+      return view().column(col);
+    }
+    //@}
     
     /**
      * @name Arithmetic operators
@@ -313,6 +411,14 @@ namespace anpi
 
     /// Subtract another matrix to this one, and leave the result in here
     Matrix& operator-=(const Matrix& other);
+
+    /// Sum an expression to this matrix, in one single pass
+    template<class E>
+    Matrix& operator+=(const MatrixExpression<E,T,Alloc>& _expr);
+
+    /// Subtract an expression to this matrix, in one single pass
+    template<class E>
+    Matrix& operator-=(const MatrixExpression<E,T,Alloc>& _expr);
     
     //@}
 
@@ -339,13 +445,51 @@ namespace anpi
 
 
   // External arithmetic operators
+
+  // operator+ and operator- build lazy expressions, and are declared
+  // in bits/MatrixExpression.hpp
+
   template<typename T,class Alloc>
-  Matrix<T,Alloc> operator+(const Matrix<T,Alloc>& a,
+  Matrix<T,Alloc> operator*(const Matrix<T,Alloc>& a,
                             const Matrix<T,Alloc>& b);
 
+  /**
+   * Whether |a(i,j)-b(i,j)| <= atol + rtol*|b(i,j)| for all entries.
+   *
+   * Equal entries, including infinities, are always close; an
+   * infinite b(i,j) is close only to itself, and NaN is never close
+   * to anything.  Matrices of different sizes are not
+   * close.  The test stops at the first entry out of tolerance.
+   *
+   * @param a first matrix
+   * @param b reference matrix, which scales the relative tolerance
+   * @param rtol relative tolerance
+   * @param atol absolute tolerance
+   * @param parallel split large matrices among threads (see Parallel.hpp)
+   */
+  template<typename T,class Alloc>
+  bool allclose(const Matrix<T,Alloc>& a,
+                const Matrix<T,Alloc>& b,
+                const T rtol=T(1.0e-5),
+                const T atol=T(1.0e-8),
+                const bool parallel=true);
+
+  /**
+   * Largest distance between corresponding entries, in units in the
+   * last place (ULP), i.e. the number of representable values between
+   * them.  Both zeros are at distance 0.
+   *
+   * A NaN entry, or matrices of different sizes, give the largest
+   * std::uint64_t, and stop the search immediately.
+   *
+   * @param a first matrix
+   * @param b second matrix
+   * @param parallel split large matrices among threads (see Parallel.hpp)
+   */
   template<typename T,class Alloc>
-  Matrix<T,Alloc> operator-(const Matrix<T,Alloc>& a,
-                            const Matrix<T,Alloc>& b);
+  std::uint64_t maxUlpDistance(const Matrix<T,Alloc>& a,
+                               const Matrix<T,Alloc>& b,
+                               const bool parallel=true);
   
 } // namespace ANPI
 
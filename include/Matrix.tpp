@@ -9,10 +9,55 @@
  */
 
 #include "bits/MatrixArithmetic.hpp"
+#include "bits/MatrixProduct.hpp"
+#include "bits/MatrixExpression.hpp"
+#include "bits/SimdDispatch.hpp"
+
+#include <atomic>
+#include <limits>
+#include <type_traits>
 
 namespace anpi
 {
 
+  namespace bits {
+    /**
+     * Whether test(rowA,rowB,cols) holds for all rows of a and b, which
+     * must have the same size.  With split, large matrices are
+     * distributed among the threads.
+     *
+     * Without padding in both matrices all rows are tested at once.  In
+     * parallel, the threads stop testing as soon as one row fails.
+     */
+    template<typename T,class Alloc,class Test>
+    bool allRows(const Matrix<T,Alloc>& a,
+                 const Matrix<T,Alloc>& b,
+                 const bool split,
+                 Test test) {
+      const size_t rows = a.rows();
+      const size_t cols = a.cols();
+      const size_t work = split ? rows*a.dcols() : 0;
+
+      if ( (parallel::threadsFor(work) <= 1) &&
+           (a.dcols() == cols) && (b.dcols() == cols) ) {
+        return test(a.data(),b.data(),rows*cols);
+      }
+
+      std::atomic<bool> ok(true);
+      parallel::forChunks(rows,1,work,[&](size_t begin,size_t end) {
+        for (size_t r=begin;r<end;++r) {
+          if (!ok.load(std::memory_order_relaxed)) {
+            return;
+          }
+          if (!test(a[r],b[r],cols)) {
+            ok.store(false,std::memory_order_relaxed);
+          }
+        }
+      });
+      return ok.load();
+    }
+  } // namespace bits
+
   // -------------------------------------------
   // Implementation of Matrix::_Matrix_impl
   // -------------------------------------------
@@ -166,6 +211,19 @@ namespace anpi
     : _impl(std::move(_a)) { }
 
   
+  template<typename T,class Alloc>
+  template<class E>
+  Matrix<T,Alloc>::Matrix(const MatrixExpression<E,T,Alloc>& _expr)
+    : Matrix(_expr.rows(),_expr.cols(),DoNotInitialize) {
+    ::anpi::aimpl::evaluate(_expr,*this);
+  }
+
+  template<typename T,class Alloc>
+  Matrix<T,Alloc>::Matrix(const ConstMatrixView<T>& _view)
+    : Matrix(_view.rows(),_view.cols(),DoNotInitialize) {
+    this->view().fill(_view);
+  }
+
   template<typename T,class Alloc>
   Matrix<T,Alloc>::~Matrix() noexcept {
     _deallocate();
@@ -187,6 +245,14 @@ namespace anpi
     return *this;
   }
   
+  template<typename T,class Alloc>
+  template<class E>
+  Matrix<T,Alloc>&
+  Matrix<T,Alloc>::operator=(const MatrixExpression<E,T,Alloc>& _expr) {
+    ::anpi::aimpl::evaluate(_expr,*this);
+    return *this;
+  }
+
   template<typename T,class Alloc>
   bool Matrix<T,Alloc>::operator==(const Matrix<T,Alloc>& other) const {
     if (&other==this) return true; // alias detection
@@ -195,21 +261,12 @@ namespace anpi
     if ((other.rows() != this->rows()) ||
         (other.cols() != this->cols())) return false;
 
-    // check the content with pointers
-    if (this->_impl._dcols == this->_impl._cols)
-      return (memcmp(this->_impl._data,
-                     other._impl._data,
-                     this->_impl.tentries()*sizeof(T))==0);
-
-    // we have to compare row by row, becase the padding may differ
-    for (size_t i=0;i<this->_impl._rows;++i) {
-      if (memcmp(this->operator[](i),
-                 other[i],
-                 this->_impl._cols*sizeof(T))!=0) {
-        return false;
-      }
-    }
-    return true;
+    // compare the bits with the SIMD kernels, row by row if the
+    // padding may differ
+    return bits::allRows(*this,other,false,
+                         [](const T* a,const T* b,const size_t n) {
+                           return ::anpi::aimpl::sameBits(a,b,n);
+                         });
   }
 
   template<typename T,class Alloc>
@@ -399,25 +456,74 @@ namespace anpi
   }
 
   template<typename T,class Alloc>
-  Matrix<T,Alloc> operator+(const Matrix<T,Alloc>& a,
-                            const Matrix<T,Alloc>& b) {
+  template<class E>
+  Matrix<T,Alloc>&
+  Matrix<T,Alloc>::operator+=(const MatrixExpression<E,T,Alloc>& _expr) {
 
-    assert( (a.rows()==b.rows()) && (a.cols()==b.cols()) );    
+    typedef expr::Leaf<T,Alloc> leaf;
+    typedef expr::Binary<leaf,E,simd::add_op<T>,T,Alloc> node;
 
-    Matrix<T,Alloc> c(a.rows(),a.cols(),anpi::DoNotInitialize);
-    ::anpi::aimpl::add(a,b,c);
-    return c;
+    ::anpi::aimpl::evaluate(node(leaf(*this),_expr.derived()),*this);
+
+    return *this;
+  }
+
+  template<typename T,class Alloc>
+  template<class E>
+  Matrix<T,Alloc>&
+  Matrix<T,Alloc>::operator-=(const MatrixExpression<E,T,Alloc>& _expr) {
+
+    typedef expr::Leaf<T,Alloc> leaf;
+    typedef expr::Binary<leaf,E,simd::sub_op<T>,T,Alloc> node;
+
+    ::anpi::aimpl::evaluate(node(leaf(*this),_expr.derived()),*this);
+
+    return *this;
   }
 
   template<typename T,class Alloc>
-  Matrix<T,Alloc> operator-(const Matrix<T,Alloc>& a,
+  Matrix<T,Alloc> operator*(const Matrix<T,Alloc>& a,
                             const Matrix<T,Alloc>& b) {
-    
-    assert( (a.rows()==b.rows()) && (a.cols()==b.cols()) );
-    
-    Matrix<T,Alloc> c(a.rows(),a.cols(),anpi::DoNotInitialize);
-    ::anpi::aimpl::subtract(a,b,c);
+
+    assert( a.cols()==b.rows() );
+
+    Matrix<T,Alloc> c;
+    ::anpi::aimpl::multiply(a,b,c);
     return c;
   }
   
+  template<typename T,class Alloc>
+  bool allclose(const Matrix<T,Alloc>& a,
+                const Matrix<T,Alloc>& b,
+                const T rtol,
+                const T atol,
+                const bool parallel) {
+    if ((a.rows() != b.rows()) || (a.cols() != b.cols())) return false;
+
+    return bits::allRows(a,b,parallel,
+                         [rtol,atol](const T* ra,const T* rb,const size_t n) {
+                           return ::anpi::aimpl::allclose(ra,rb,n,rtol,atol);
+                         });
+  }
+
+  template<typename T,class Alloc>
+  std::uint64_t maxUlpDistance(const Matrix<T,Alloc>& a,
+                               const Matrix<T,Alloc>& b,
+                               const bool parallel) {
+    const std::uint64_t inf = std::numeric_limits<std::uint64_t>::max();
+    if ((a.rows() != b.rows()) || (a.cols() != b.cols())) return inf;
+
+    // the largest distance so far, shared by all threads
+    std::atomic<std::uint64_t> dist(0);
+    bits::allRows(a,b,parallel,
+                  [&dist,inf](const T* ra,const T* rb,const size_t n) {
+                    const std::uint64_t d = ::anpi::aimpl::maxUlp(ra,rb,n);
+                    std::uint64_t prev = dist.load(std::memory_order_relaxed);
+                    while ( (d > prev) &&
+                            !dist.compare_exchange_weak(prev,d) ) {}
+                    return d != inf;
+                  });
+    return dist.load();
+  }
+
 } // namespace ANPI
@@ -0,0 +1,176 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date  : 28.12.2017
+ */
+
+#ifndef ANPI_MATRIX_IO_HPP
+#define ANPI_MATRIX_IO_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+#include "Allocator.hpp"
+#include "Exception.hpp"
+#include "Matrix.hpp"
+#include "bits/MatrixFileHeader.hpp"
+
+namespace anpi {
+
+  /*
+   * Binary matrix files.
+   *
+   * A file holds a matrix_file_header, padding up to a multiple of the
+   * alignment, and then the rows x dcols entries exactly as the Matrix
+   * stores them, row padding included.  The layout is the one used by
+   * the mapped_allocator, so a file saved from a row-aligned matrix can
+   * also be opened with openMapped() or openMappedReadOnly() without any
+   * copy.
+   */
+
+  namespace bits {
+    /// Write all bytes of the given buffers, resuming partial and
+    /// interrupted writes
+    inline bool writeAll(const int fd,struct iovec* iov,int count) {
+      while (count > 0) {
+        const ssize_t done = ::writev(fd,iov,count);
+        if (done < 0) {
+          if (errno == EINTR) {
+            continue;
+          }
+          return false;
+        }
+        size_t left = static_cast<size_t>(done);
+        while ( (count > 0) && (left >= iov->iov_len) ) {
+          left -= iov->iov_len;
+          ++iov;
+          --count;
+        }
+        if (count > 0) {
+          iov->iov_base = static_cast<char*>(iov->iov_base) + left;
+          iov->iov_len -= left;
+        }
+      }
+      return true;
+    }
+
+    /// Read size bytes at the given file offset, resuming partial and
+    /// interrupted reads
+    inline bool readAll(const int fd,void* buffer,size_t size,off_t offset) {
+      char* ptr = static_cast<char*>(buffer);
+      while (size > 0) {
+        const ssize_t done = ::pread(fd,ptr,size,offset);
+        if ( (done < 0) && (errno == EINTR) ) {
+          continue;
+        }
+        if (done <= 0) {
+          return false;
+        }
+        ptr    += done;
+        size   -= static_cast<size_t>(done);
+        offset += done;
+      }
+      return true;
+    }
+  } // namespace bits
+
+  /**
+   * Save the matrix m into the given file.
+   *
+   * The header and all entries are written with one single writev().
+   *
+   * @throw anpi::Exception if the file cannot be written
+   */
+  template<typename T,class Alloc>
+  void save(const std::string& path,const Matrix<T,Alloc>& m) {
+    static_assert(element_type<T>::value != ElementType::Unknown,
+                  "Only matrices of arithmetic or complex types can be saved");
+
+    const size_t alignment = extract_alignment<Alloc>::value;
+    matrix_file_header h =
+      makeMatrixFileHeader<T>(m.rows(),m.cols(),m.dcols(),alignment);
+
+    // zero padding between the header and the entries
+    std::vector<char> head(h.offset,0);
+    std::memcpy(head.data(),&h,sizeof(h));
+
+    struct iovec iov[2];
+    iov[0].iov_base = head.data();
+    iov[0].iov_len  = head.size();
+    iov[1].iov_base = const_cast<T*>(m.data());
+    iov[1].iov_len  = m.rows()*m.dcols()*sizeof(T);
+
+    const int fd = ::open(path.c_str(),O_WRONLY | O_CREAT | O_TRUNC,0644);
+    if (fd < 0) {
+      throw Exception("Cannot create matrix file " + path);
+    }
+    const bool ok = bits::writeAll(fd,iov,(iov[1].iov_len > 0) ? 2 : 1);
+    if ( (::close(fd) != 0) || !ok ) {
+      throw Exception("Cannot write matrix file " + path);
+    }
+  }
+
+  /**
+   * Load the matrix m from the given file.
+   *
+   * The matrix is reallocated with its own allocator.  If the file was
+   * saved with the same row padding, the entries are read directly into
+   * the matrix with one single read; otherwise they are read into a
+   * temporary buffer and copied row by row.
+   *
+   * @throw anpi::Exception if the file cannot be read, holds another
+   *        element type, or its header does not match its size
+   */
+  template<typename T,class Alloc>
+  void load(const std::string& path,Matrix<T,Alloc>& m) {
+    static_assert(element_type<T>::value != ElementType::Unknown,
+                  "Only matrices of arithmetic or complex types can be loaded");
+
+    const int fd = ::open(path.c_str(),O_RDONLY);
+    if (fd < 0) {
+      throw Exception("Cannot open matrix file " + path);
+    }
+
+    bool ok = true;
+    try {
+      // the header is validated against the file size before allocating
+      const matrix_file_header h = readMatrixFileHeader(fd,path);
+      checkMatrixFileType<T>(h,path);
+
+      m.allocate(h.rows,h.cols);
+      const size_t bytes = h.rows*h.dcols*sizeof(T);
+
+      if (m.dcols() == h.dcols) {
+        ok = bits::readAll(fd,m.data(),bytes,h.offset);
+      } else {
+        std::vector<T> buffer(h.rows*h.dcols);
+        ok = bits::readAll(fd,buffer.data(),bytes,h.offset);
+        for (size_t r=0;ok && (r<h.rows);++r) {
+          std::memcpy(m[r],buffer.data()+r*h.dcols,h.cols*sizeof(T));
+        }
+      }
+    } catch (...) {
+      ::close(fd);
+      throw;
+    }
+    ::close(fd);
+
+    if (!ok) {
+      throw Exception("Cannot read matrix file " + path);
+    }
+  }
+
+} // namespace anpi
+
+#endif
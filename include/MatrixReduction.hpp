@@ -0,0 +1,352 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date  : 15.01.2018
+ */
+
+#ifndef ANPI_MATRIX_REDUCTION_HPP
+#define ANPI_MATRIX_REDUCTION_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Exception.hpp"
+#include "Matrix.hpp"
+
+namespace anpi {
+
+  /*
+   * Reductions over all entries of a matrix.
+   *
+   * The padding of the rows is skipped.  The entries are processed in
+   * contiguous segments (whole rows, or fixed-size pieces of matrices
+   * without padding), each one reduced by the SIMD kernels with several
+   * independent accumulators.  With parallel, large matrices distribute
+   * the segments among the threads (see Parallel.hpp); the partial
+   * results of the segments are then combined in a fixed order, so the
+   * result does not depend on the number of threads.
+   */
+
+  /// Accumulation of the sums
+  enum class Summation {
+    Plain,    ///< Vector accumulators, fastest
+    Pairwise, ///< Recursive halving, error grows with log(n)
+    Kahan     ///< Compensated, error independent of n
+  };
+
+  namespace bits {
+    /// Entries in each segment of a matrix without padding
+    static const size_t SegmentLength = 4096;
+
+    /// Entries summed directly at the leaves of the pairwise summation
+    static const size_t PairwiseBlock = 256;
+
+    /// Contiguous pieces covering the entries of a matrix, without padding
+    struct segments {
+      size_t count;  ///< number of segments
+      size_t stride; ///< distance between the starts of segments
+      size_t length; ///< entries per segment, the last one may be shorter
+      size_t total;  ///< end of the last segment
+      size_t dcols;  ///< row stride of the matrix
+
+      template<typename T,class Alloc>
+      explicit segments(const Matrix<T,Alloc>& a) : dcols(a.dcols()) {
+        if (a.dcols() == a.cols()) {
+          stride = length = SegmentLength;
+          total  = a.rows()*a.cols();
+          count  = (total + length - 1)/length;
+        } else {
+          stride = a.dcols();
+          length = a.cols();
+          total  = a.rows()*a.dcols();
+          count  = a.rows();
+        }
+      }
+
+      /// Offset of the first entry of segment s
+      inline size_t offset(const size_t s) const { return s*stride; }
+
+      /// Number of entries of segment s
+      inline size_t size(const size_t s) const {
+        return std::min(length,total-s*stride);
+      }
+
+      /// Row and column of entry i of segment s
+      inline std::pair<size_t,size_t> position(const size_t s,
+                                               const size_t i) const {
+        const size_t flat = offset(s)+i;
+        return std::make_pair(flat/dcols,flat%dcols);
+      }
+    };
+
+    /// part[s] = fn(offset(s),size(s)) for all segments
+    template<typename R,class Fn>
+    void partials(const segments& seg,
+                  const bool split,
+                  std::vector<R>& part,
+                  Fn fn) {
+      part.resize(seg.count);
+      parallel::forChunks(seg.count,1,split ? seg.total : 0,
+                          [&](size_t begin,size_t end) {
+        for (size_t s=begin;s<end;++s) {
+          part[s] = fn(seg.offset(s),seg.size(s));
+        }
+      });
+    }
+
+    /// Pairwise sum of fn(begin,n) over blocks of at most block entries
+    template<typename T,class Fn>
+    T pairwise(const size_t begin,const size_t n,const size_t block,Fn fn) {
+      if (n <= block) {
+        return fn(begin,n);
+      }
+      const size_t half = ((n/2 + block - 1)/block)*block;
+      return pairwise<T>(begin,half,block,fn) +
+             pairwise<T>(begin+half,n-half,block,fn);
+    }
+
+    /**
+     * Sum over all segments, with plain(offset,n) and kahan(offset,n)
+     * the uncompensated and compensated kernels of one segment.
+     */
+    template<typename T,class Plain,class Kahan>
+    T accumulate(const segments& seg,
+                 const Summation mode,
+                 const bool split,
+                 Plain plain,
+                 Kahan kahan) {
+      std::vector<T> part;
+      switch (mode) {
+      case Summation::Kahan:
+        partials(seg,split,part,kahan);
+        return ::anpi::fallback::sumKahan(part.data(),part.size());
+      case Summation::Pairwise:
+        partials(seg,split,part,[&](size_t offset,size_t n) {
+            return pairwise<T>(offset,n,PairwiseBlock,plain);
+          });
+        return pairwise<T>(0,part.size(),8,[&](size_t begin,size_t n) {
+            return ::anpi::fallback::sum(part.data()+begin,n);
+          });
+      default:
+        partials(seg,split,part,plain);
+        return ::anpi::fallback::sum(part.data(),part.size());
+      }
+    }
+
+    /**
+     * Position of the first entry equal to the extremum m of the segments.
+     * Segments holding only NaN report a sentinel as partial that matches
+     * no entry; they are skipped, and (0,0) is returned if nothing matches.
+     */
+    template<typename T,class Alloc>
+    std::pair<size_t,size_t> locate(const Matrix<T,Alloc>& a,
+                                    const segments& seg,
+                                    const std::vector<T>& part,
+                                    const T m) {
+      for (size_t s=0;s<seg.count;++s) {
+        if (part[s] == m) {
+          const T* p = a.data()+seg.offset(s);
+          const size_t i = size_t(std::find(p,p+seg.size(s),m) - p);
+          if (i < seg.size(s)) {
+            return seg.position(s,i);
+          }
+        }
+      }
+      return std::make_pair(size_t(0),size_t(0));
+    }
+  } // namespace bits
+
+  /**
+   * Sum of all entries
+   *
+   * @param a matrix
+   * @param mode accumulation of the sum
+   * @param parallel split large matrices among threads
+   */
+  template<typename T,class Alloc>
+  T sum(const Matrix<T,Alloc>& a,
+        const Summation mode=Summation::Plain,
+        const bool parallel=true) {
+    const T* p = a.data();
+    return bits::accumulate<T>(bits::segments(a),mode,parallel,
+      [p](size_t offset,size_t n) { return aimpl::sum(p+offset,n); },
+      [p](size_t offset,size_t n) { return aimpl::sumKahan(p+offset,n); });
+  }
+
+  /**
+   * Sum of the absolute values of all entries
+   *
+   * @param a matrix
+   * @param mode accumulation of the sum
+   * @param parallel split large matrices among threads
+   */
+  template<typename T,class Alloc>
+  T sumAbs(const Matrix<T,Alloc>& a,
+           const Summation mode=Summation::Plain,
+           const bool parallel=true) {
+    const T* p = a.data();
+    return bits::accumulate<T>(bits::segments(a),mode,parallel,
+      [p](size_t offset,size_t n) { return aimpl::sumAbs(p+offset,n); },
+      [p](size_t offset,size_t n) { return aimpl::sumAbsKahan(p+offset,n); });
+  }
+
+  /**
+   * Sum of the products of corresponding entries (Frobenius inner
+   * product)
+   *
+   * @param a first matrix
+   * @param b second matrix
+   * @param mode accumulation of the sum
+   * @param parallel split large matrices among threads
+   *
+   * @throw anpi::Exception if the sizes differ
+   */
+  template<typename T,class Alloc>
+  T dot(const Matrix<T,Alloc>& a,
+        const Matrix<T,Alloc>& b,
+        const Summation mode=Summation::Plain,
+        const bool parallel=true) {
+    if ( (a.rows() != b.rows()) || (a.cols() != b.cols()) ) {
+      throw Exception("Matrices of the dot product must have the same size");
+    }
+    // same type and size imply the same padding
+    const T* pa = a.data();
+    const T* pb = b.data();
+    return bits::accumulate<T>(bits::segments(a),mode,parallel,
+      [pa,pb](size_t offset,size_t n) {
+        return aimpl::dot(pa+offset,pb+offset,n);
+      },
+      [pa,pb](size_t offset,size_t n) {
+        return aimpl::dotKahan(pa+offset,pb+offset,n);
+      });
+  }
+
+  /**
+   * Frobenius norm, the square root of the sum of squares of all
+   * entries
+   *
+   * @param a matrix
+   * @param mode accumulation of the sum of squares
+   * @param parallel split large matrices among threads
+   */
+  template<typename T,class Alloc>
+  T normFrobenius(const Matrix<T,Alloc>& a,
+                  const Summation mode=Summation::Plain,
+                  const bool parallel=true) {
+    return T(std::sqrt(dot(a,a,mode,parallel)));
+  }
+
+  /**
+   * Largest absolute value of all entries, ignoring NaN
+   *
+   * @param a matrix
+   * @param parallel split large matrices among threads
+   */
+  template<typename T,class Alloc>
+  T maxAbs(const Matrix<T,Alloc>& a,const bool parallel=true) {
+    const T* p = a.data();
+    std::vector<T> part;
+    bits::partials(bits::segments(a),parallel,part,
+                   [p](size_t offset,size_t n) {
+                     return aimpl::maxAbs(p+offset,n);
+                   });
+    return ::anpi::fallback::maxAbs(part.data(),part.size());
+  }
+
+  /**
+   * Largest entry, ignoring NaN.  Without entries other than NaN the
+   * result is -infinity (the lowest value for integer types).
+   *
+   * @param a matrix
+   * @param parallel split large matrices among threads
+   */
+  template<typename T,class Alloc>
+  T max(const Matrix<T,Alloc>& a,const bool parallel=true) {
+    const T* p = a.data();
+    std::vector<T> part;
+    bits::partials(bits::segments(a),parallel,part,
+                   [p](size_t offset,size_t n) {
+                     return aimpl::max(p+offset,n);
+                   });
+    return ::anpi::fallback::max(part.data(),part.size());
+  }
+
+  /**
+   * Smallest entry, ignoring NaN.  Without entries other than NaN the
+   * result is infinity (the largest value for integer types).
+   *
+   * @param a matrix
+   * @param parallel split large matrices among threads
+   */
+  template<typename T,class Alloc>
+  T min(const Matrix<T,Alloc>& a,const bool parallel=true) {
+    const T* p = a.data();
+    std::vector<T> part;
+    bits::partials(bits::segments(a),parallel,part,
+                   [p](size_t offset,size_t n) {
+                     return aimpl::min(p+offset,n);
+                   });
+    return ::anpi::fallback::min(part.data(),part.size());
+  }
+
+  /**
+   * Row and column of the first largest entry (in row-major order),
+   * ignoring NaN.  If all entries are NaN, (0,0) is returned.
+   *
+   * @param a matrix
+   * @param parallel split large matrices among threads
+   *
+   * @throw anpi::Exception if the matrix is empty
+   */
+  template<typename T,class Alloc>
+  std::pair<size_t,size_t> argmax(const Matrix<T,Alloc>& a,
+                                  const bool parallel=true) {
+    if (a.entries() == 0) {
+      throw Exception("Position of the maximum of an empty matrix");
+    }
+    const T* p = a.data();
+    const bits::segments seg(a);
+    std::vector<T> part;
+    bits::partials(seg,parallel,part,[p](size_t offset,size_t n) {
+        return aimpl::max(p+offset,n);
+      });
+    return bits::locate(a,seg,part,
+                        ::anpi::fallback::max(part.data(),part.size()));
+  }
+
+  /**
+   * Row and column of the first smallest entry (in row-major order),
+   * ignoring NaN.  If all entries are NaN, (0,0) is returned.
+   *
+   * @param a matrix
+   * @param parallel split large matrices among threads
+   *
+   * @throw anpi::Exception if the matrix is empty
+   */
+  template<typename T,class Alloc>
+  std::pair<size_t,size_t> argmin(const Matrix<T,Alloc>& a,
+                                  const bool parallel=true) {
+    if (a.entries() == 0) {
+      throw Exception("Position of the minimum of an empty matrix");
+    }
+    const T* p = a.data();
+    const bits::segments seg(a);
+    std::vector<T> part;
+    bits::partials(seg,parallel,part,[p](size_t offset,size_t n) {
+        return aimpl::min(p+offset,n);
+      });
+    return bits::locate(a,seg,part,
+                        ::anpi::fallback::min(part.data(),part.size()));
+  }
+
+} // namespace anpi
+
+#endif
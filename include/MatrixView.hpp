@@ -0,0 +1,260 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date  : 28.12.2017
+ */
+
+#ifndef ANPI_MATRIX_VIEW_HPP
+#define ANPI_MATRIX_VIEW_HPP
+
+#include <cstddef>
+#include <cassert>
+#include <algorithm>
+
+namespace anpi
+{
+  template<typename T,class Alloc>
+  class Matrix;
+
+  /**
+   * Read-only window into the entries of a row-major matrix.
+   *
+   * A view does not own its entries: it just holds a pointer to the
+   * first one, the number of rows and columns, and the stride, which is
+   * the distance (in entries) between the beginnings of two consecutive
+   * rows.  Hence, a block, a range of rows or columns, or a single column
+   * of a Matrix can be accessed without copying anything.  For instance,
+   * the column c of the matrix m is the view with one column and the
+   * stride m.dcols(), starting at m[0]+c.
+   *
+   * The view is only valid as long as the viewed matrix is not
+   * destroyed or reallocated.
+   */
+  template<typename T>
+  class ConstMatrixView {
+  public:
+    typedef T value_type;
+
+  protected:
+    /// First entry
+    const T* _data;
+
+    /// Number of rows
+    size_t _rows;
+
+    /// Number of columns
+    size_t _cols;
+
+    /// Distance in entries between consecutive rows
+    size_t _stride;
+
+  public:
+    /// Empty view
+    ConstMatrixView() : _data(0),_rows(0),_cols(0),_stride(0) {}
+
+    /// View rows x cols entries starting at data
+    ConstMatrixView(const T* data,
+                    const size_t rows,
+                    const size_t cols,
+                    const size_t stride)
+      : _data(data),_rows(rows),_cols(cols),_stride(stride) {
+      assert( (rows<2) || (stride>=cols) );
+    }
+
+    /// View of the whole matrix m
+    template<class Alloc>
+    ConstMatrixView(const Matrix<T,Alloc>& m)
+      : _data(m.data()),_rows(m.rows()),_cols(m.cols()),_stride(m.dcols()) {}
+
+    /// Number of rows
+    inline size_t rows() const { return _rows; }
+
+    /// Number of columns
+    inline size_t cols() const { return _cols; }
+
+    /// Distance in entries between the beginnings of consecutive rows
+    inline size_t stride() const { return _stride; }
+
+    /// Total number of entries (rows x cols)
+    inline size_t entries() const { return _rows*_cols; }
+
+    /// Check if the view is empty (zero rows or columns)
+    inline bool empty() const { return (_rows==0) || (_cols==0); }
+
+    /// Pointer to the first entry
+    inline const T* data() const { return _data; }
+
+    /// Return read-only pointer to a given row
+    inline const T* operator[](const size_t row) const {
+      return _data + row*_stride;
+    }
+
+    /// Return const reference to the element at the r row and c column
+    inline const T& operator()(const size_t row,const size_t col) const {
+      return _data[row*_stride + col];
+    }
+
+    /**
+     * @name Slicing
+     *
+     * All slices share the entries of this view
+     */
+    //@{
+
+    /// Block of rows x cols entries with the upper-left corner at (row,col)
+    inline ConstMatrixView block(const size_t row,const size_t col,
+                                 const size_t rows,const size_t cols) const {
+      assert( (row+rows<=_rows) && (col+cols<=_cols) );
+      return ConstMatrixView(_data+row*_stride+col,rows,cols,_stride);
+    }
+
+    /// Rows in the interval [begin,end)
+    inline ConstMatrixView rowRange(const size_t begin,
+                                    const size_t end) const {
+      return block(begin,0,end-begin,_cols);
+    }
+
+    /// Columns in the interval [begin,end)
+    inline ConstMatrixView colRange(const size_t begin,
+                                    const size_t end) const {
+      return block(0,begin,_rows,end-begin);
+    }
+
+    /// One row, as a 1 x cols view
+    inline ConstMatrixView row(const size_t r) const {
+      return block(r,0,1,_cols);
+    }
+
+    /// One column, as a rows x 1 view strided by the row distance
+    inline ConstMatrixView column(const size_t c) const {
+      return block(0,c,_rows,1);
+    }
+    //@}
+  };
+
+  /**
+   * Read-writable window into the entries of a row-major matrix.
+   *
+   * Like a pointer, a const MatrixView still allows to modify the viewed
+   * entries: the constness refers to the view itself.  A MatrixView can
+   * be used wherever a ConstMatrixView is expected.
+   */
+  template<typename T>
+  class MatrixView : public ConstMatrixView<T> {
+  public:
+    typedef T value_type;
+
+    /// Empty view
+    MatrixView() : ConstMatrixView<T>() {}
+
+    /// View rows x cols entries starting at data
+    MatrixView(T* data,
+               const size_t rows,
+               const size_t cols,
+               const size_t stride)
+      : ConstMatrixView<T>(data,rows,cols,stride) {}
+
+    /// View of the whole matrix m
+    template<class Alloc>
+    MatrixView(Matrix<T,Alloc>& m)
+      : ConstMatrixView<T>(m) {}
+
+    /// Pointer to the first entry
+    inline T* data() const { return const_cast<T*>(this->_data); }
+
+    /// Return pointer to a given row
+    inline T* operator[](const size_t row) const {
+      return data() + row*this->_stride;
+    }
+
+    /// Return reference to the element at the r row and c column
+    inline T& operator()(const size_t row,const size_t col) const {
+      return data()[row*this->_stride + col];
+    }
+
+    /**
+     * Fill all viewed entries with the given value
+     */
+    void fill(const T val) const {
+      for (size_t r=0;r<this->_rows;++r) {
+        T* here = (*this)[r];
+        std::fill(here,here+this->_cols,val);
+      }
+    }
+
+    /**
+     * Copy the entries of another view of the same size into this one
+     */
+    void fill(const ConstMatrixView<T>& other) const {
+      assert( (other.rows()==this->_rows) && (other.cols()==this->_cols) );
+      for (size_t r=0;r<this->_rows;++r) {
+        std::copy(other[r],other[r]+this->_cols,(*this)[r]);
+      }
+    }
+
+    /**
+     * Copy the transpose of another view into this one
+     *
+     * The entries are copied in small square tiles, so that neither the
+     * reads nor the writes stride through the whole matrix.
+     */
+    void fillTransposed(const ConstMatrixView<T>& other) const {
+      assert( (other.cols()==this->_rows) && (other.rows()==this->_cols) );
+      const size_t tile = 16;
+      for (size_t r0=0;r0<this->_rows;r0+=tile) {
+        const size_t r1 = std::min(r0+tile,this->_rows);
+        for (size_t c0=0;c0<this->_cols;c0+=tile) {
+          const size_t c1 = std::min(c0+tile,this->_cols);
+          for (size_t c=c0;c<c1;++c) {
+            const T* src = other[c];
+            for (size_t r=r0;r<r1;++r) {
+              (*this)(r,c) = src[r];
+            }
+          }
+        }
+      }
+    }
+
+    /**
+     * @name Slicing
+     *
+     * All slices share the entries of this view
+     */
+    //@{
+
+    /// Block of rows x cols entries with the upper-left corner at (row,col)
+    inline MatrixView block(const size_t row,const size_t col,
+                            const size_t rows,const size_t cols) const {
+      assert( (row+rows<=this->_rows) && (col+cols<=this->_cols) );
+      return MatrixView(data()+row*this->_stride+col,rows,cols,this->_stride);
+    }
+
+    /// Rows in the interval [begin,end)
+    inline MatrixView rowRange(const size_t begin,const size_t end) const {
+      return block(begin,0,end-begin,this->_cols);
+    }
+
+    /// Columns in the interval [begin,end)
+    inline MatrixView colRange(const size_t begin,const size_t end) const {
+      return block(0,begin,this->_rows,end-begin);
+    }
+
+    /// One row, as a 1 x cols view
+    inline MatrixView row(const size_t r) const {
+      return block(r,0,1,this->_cols);
+    }
+
+    /// One column, as a rows x 1 view strided by the row distance
+    inline MatrixView column(const size_t c) const {
+      return block(0,c,this->_rows,1);
+    }
+    //@}
+  };
+
+} // namespace anpi
+
+#endif
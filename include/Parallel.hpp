@@ -0,0 +1,118 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @author Pablo Alvarado
+ * @date   15.12.2017
+ */
+
+#ifndef ANPI_PARALLEL_HPP
+#define ANPI_PARALLEL_HPP
+
+#include <cstddef>
+#include <algorithm>
+
+#ifdef _OPENMP
+#  include <omp.h>
+#endif
+
+namespace anpi {
+  namespace parallel {
+
+    /// Size in bytes of a cache line, used to avoid false sharing
+    static const size_t CacheLine = 64;
+
+    /// Default minimum number of entries to split a kernel among threads
+    static const size_t DefaultThreshold = 1u << 16;
+
+    /// Storage of the requested number of threads (0 means automatic)
+    inline size_t& _threads() {
+      static size_t n = 0;
+      return n;
+    }
+
+    /// Storage of the minimum number of entries to go parallel
+    inline size_t& _threshold() {
+      static size_t n = DefaultThreshold;
+      return n;
+    }
+
+    /**
+     * Set the number of threads used by the matrix kernels.
+     *
+     * With 0 the number of threads is chosen by OpenMP (usually the
+     * number of cores, or OMP_NUM_THREADS).  With 1 all kernels run
+     * serially.
+     */
+    inline void setThreads(const size_t n) { _threads() = n; }
+
+    /**
+     * Number of threads used by the matrix kernels above the threshold
+     */
+    inline size_t threads() {
+#ifdef _OPENMP
+      return (_threads() == 0) ? size_t(omp_get_max_threads()) : _threads();
+#else
+      return 1;
+#endif
+    }
+
+    /**
+     * Set the minimum number of matrix entries (including padding) for
+     * which the kernels are split among threads.  Below this size the
+     * cost of waking up the threads exceeds the gain.
+     */
+    inline void setThreshold(const size_t entries) { _threshold() = entries; }
+
+    /// Minimum number of entries for which the kernels go parallel
+    inline size_t threshold() { return _threshold(); }
+
+    /// Number of threads to use for a kernel over the given entries
+    inline size_t threadsFor(const size_t entries) {
+      return (entries < threshold()) ? 1 : threads();
+    }
+
+    /**
+     * Call fn(begin,end) on contiguous ranges covering [0,n), one range
+     * per thread.  All range limits except n are multiples of grain, so
+     * that a kernel working on rows can use the row length as grain and
+     * each thread gets whole, padded rows.
+     *
+     * @param n     number of units to process
+     * @param grain granularity of the range limits
+     * @param work  number of entries touched, compared to the threshold
+     * @param fn    callable with signature void(size_t,size_t)
+     */
+    template<class Fn>
+    inline void forChunks(const size_t n,
+                          const size_t grain,
+                          const size_t work,
+                          Fn fn) {
+      const size_t units = (n + grain - 1)/grain;
+      const size_t nt    = std::min(threadsFor(work),units);
+
+      if (nt <= 1) {
+        fn(size_t(0),n);
+        return;
+      }
+
+#ifdef _OPENMP
+#     pragma omp parallel num_threads(int(nt))
+      {
+        const size_t t  = size_t(omp_get_thread_num());
+        const size_t tn = size_t(omp_get_num_threads());
+        const size_t ub = (units*t)/tn;
+        const size_t ue = (units*(t+1))/tn;
+        fn(std::min(n,ub*grain),std::min(n,ue*grain));
+      }
+#else
+      fn(size_t(0),n);
+#endif
+    }
+
+  } // namespace parallel
+} // namespace anpi
+
+#endif
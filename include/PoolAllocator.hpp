@@ -0,0 +1,296 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @author Pablo Alvarado
+ * @date   15.12.2017
+ */
+
+#ifndef ANPI_POOL_ALLOCATOR_HPP
+#define ANPI_POOL_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <new>
+
+#include <boost/align/aligned_alloc.hpp>
+
+#include "Allocator.hpp"
+
+namespace anpi {
+
+  /**
+   * Thread-local cache of aligned buffers, sorted in size classes.
+   *
+   * The byte sizes are rounded up to a class of the form 2^e*(1+k/4),
+   * with k in 0..3, so that at most a quarter of each buffer is wasted.
+   * Released buffers are kept in a singly linked list per class, stored
+   * in the buffers themselves, and are handed out again to the next
+   * request of the same class.  Each thread owns one cache per
+   * alignment, so no locking is required.
+   *
+   * The cache holds at most max_cached buffers per class, and at most
+   * max_cached_bytes in total: buffers that do not fit go straight back
+   * to the heap, so large matrices are never retained by idle threads.
+   */
+  template<std::size_t Align>
+  class pool_cache {
+  public:
+    /// Smallest class size in bytes
+    static constexpr size_t min_bytes = (Align < 64) ? 64 : Align;
+
+    /// Largest number of cached buffers per class
+    static constexpr size_t max_cached = 4;
+
+    /// Largest number of bytes cached by each thread
+    static constexpr size_t max_cached_bytes = size_t(64)*1024*1024;
+
+    /// Number of size classes (up to 2^(min_exp+classes/4) bytes)
+    static constexpr size_t classes = 4*48;
+
+    /// Statistics of one thread's cache
+    struct statistics {
+      /// Requests served from the cache
+      size_t hits;
+      /// Requests served by the heap
+      size_t misses;
+      /// Buffers currently held in the cache
+      size_t cached;
+      /// Bytes currently held in the cache
+      size_t bytes;
+    };
+
+  private:
+    /// Header of a free buffer
+    struct node {
+      node* next;
+    };
+
+    /// Free buffers of each class
+    node*  _free[classes];
+
+    /// Number of buffers in each list
+    size_t _count[classes];
+
+    /// Current statistics
+    statistics _stats;
+
+    pool_cache() : _stats() {
+      for (size_t i=0;i<classes;++i) {
+        _free[i]=0;
+        _count[i]=0;
+      }
+    }
+
+    ~pool_cache() {
+      trim();
+      _finished() = true;
+    }
+
+    /**
+     * Flag set when the cache of this thread has been destroyed.
+     *
+     * Matrices with static storage may be released after the thread
+     * local objects at exit; their buffers go straight to the heap.
+     */
+    static bool& _finished() {
+      static thread_local bool finished = false;
+      return finished;
+    }
+
+    /// Position of the most significant bit
+    static inline size_t _log2(size_t v) {
+      size_t e=0;
+      while (v>>=1) ++e;
+      return e;
+    }
+
+  public:
+    /// The cache of the calling thread
+    static pool_cache& local() {
+      static thread_local pool_cache cache;
+      return cache;
+    }
+
+    /**
+     * Size class of a request of the given bytes.
+     *
+     * @param bytes requested size
+     * @param classBytes size of the buffers of the class
+     * @return index of the class, or classes if the size is too large
+     */
+    static inline size_t sizeClass(const size_t bytes,size_t& classBytes) {
+      if (bytes <= min_bytes) {
+        classBytes = min_bytes;
+        return 0;
+      }
+      const size_t emin = _log2(min_bytes);
+      size_t e    = _log2(bytes);
+      size_t base = size_t(1) << e;
+      size_t step = base >> 2;
+      size_t k    = (bytes-base + step-1)/step;
+      if (k==4) {
+        ++e;
+        base <<= 1;
+        step <<= 1;
+        k=0;
+      }
+      classBytes = base + k*step;
+      const size_t idx = 4*(e-emin) + k;
+      return (idx < classes) ? idx : classes;
+    }
+
+    /// Reserve at least the given bytes, aligned to Align
+    void* allocate(const size_t bytes) {
+      size_t classBytes;
+      const size_t idx = sizeClass(bytes,classBytes);
+
+      if ( (idx < classes) && (_free[idx] != 0) ) {
+        node* n = _free[idx];
+        _free[idx] = n->next;
+        --_count[idx];
+        --_stats.cached;
+        _stats.bytes -= classBytes;
+        ++_stats.hits;
+        return n;
+      }
+
+      ++_stats.misses;
+      void* p = boost::alignment::aligned_alloc(Align,classBytes);
+      if (p == 0) {
+        throw std::bad_alloc();
+      }
+      return p;
+    }
+
+    /// Give back a buffer reserved with allocate(bytes)
+    void deallocate(void* p,const size_t bytes) noexcept {
+      size_t classBytes;
+      const size_t idx = sizeClass(bytes,classBytes);
+
+      if ( (idx < classes) && (_count[idx] < max_cached) &&
+           (classBytes <= max_cached_bytes - _stats.bytes) ) {
+        node* n = static_cast<node*>(p);
+        n->next = _free[idx];
+        _free[idx] = n;
+        ++_count[idx];
+        ++_stats.cached;
+        _stats.bytes += classBytes;
+        return;
+      }
+
+      boost::alignment::aligned_free(p);
+    }
+
+    /// Release all cached buffers to the heap
+    void trim() noexcept {
+      for (size_t i=0;i<classes;++i) {
+        while (_free[i] != 0) {
+          node* n = _free[i];
+          _free[i] = n->next;
+          boost::alignment::aligned_free(n);
+        }
+        _count[i]=0;
+      }
+      _stats.cached=0;
+      _stats.bytes=0;
+    }
+
+    /// Statistics of this cache
+    const statistics& stats() const { return _stats; }
+
+    /// Reserve bytes from the cache of the calling thread
+    static void* acquire(const size_t bytes) {
+      if (_finished()) {
+        size_t classBytes;
+        sizeClass(bytes,classBytes);
+        void* p = boost::alignment::aligned_alloc(Align,classBytes);
+        if (p == 0) {
+          throw std::bad_alloc();
+        }
+        return p;
+      }
+      return local().allocate(bytes);
+    }
+
+    /// Release bytes into the cache of the calling thread
+    static void release(void* p,const size_t bytes) noexcept {
+      if (_finished()) {
+        boost::alignment::aligned_free(p);
+      } else {
+        local().deallocate(p,bytes);
+      }
+    }
+  };
+
+  /**
+   * Allocator recycling buffers through a thread-local pool_cache.
+   *
+   * It is meant for matrices created and destroyed in loops, such as
+   * temporaries, where the general purpose heap would otherwise be hit
+   * at each iteration.  Like aligned_row_allocator, the buffer and each
+   * row are aligned to Align, so the SIMD kernels treat both alike.
+   *
+   * A buffer may be released by another thread than the one that
+   * reserved it: it then joins the cache of the releasing thread.
+   */
+  template<class T, std::size_t Align=DefaultAlignment>
+  class pool_allocator {
+  public:
+    typedef T         value_type;
+    typedef T*        pointer;
+    typedef const T*  const_pointer;
+    typedef size_t    size_type;
+    typedef ptrdiff_t difference_type;
+
+    /// Change the stored type
+    template<class U>
+    struct rebind {
+      typedef pool_allocator<U, Align> other;
+    };
+
+    /// Type to identify this as a row-aligned allocator
+    typedef std::true_type row_aligned;
+
+    pool_allocator() noexcept {}
+
+    /// Copy from another stored type
+    template<class U>
+    pool_allocator(const pool_allocator<U,Align>&) noexcept {}
+
+    /// Reserve n entries
+    T* allocate(const size_t n) {
+      return static_cast<T*>(pool_cache<Align>::acquire(n*sizeof(T)));
+    }
+
+    /// Release the n entries at p into the cache of this thread
+    void deallocate(T* p,const size_t n) noexcept {
+      if (p) {
+        pool_cache<Align>::release(p,n*sizeof(T));
+      }
+    }
+  };
+
+  /// All pool allocators share the thread caches
+  template<class T,class U,std::size_t Align>
+  inline bool operator==(const pool_allocator<T,Align>&,
+                         const pool_allocator<U,Align>&) noexcept {
+    return true;
+  }
+
+  template<class T,class U,std::size_t Align>
+  inline bool operator!=(const pool_allocator<T,Align>&,
+                         const pool_allocator<U,Align>&) noexcept {
+    return false;
+  }
+
+  // Specialization for the pool_allocator
+  template<typename T, std::size_t A>
+  struct is_aligned_alloc< anpi::pool_allocator<T,A> > {
+    static const bool value = true;
+  };
+
+} // namespace anpi
+
+#endif
@@ -0,0 +1,361 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date  : 07.01.2018
+ */
+
+#ifndef ANPI_QR_DECOMPOSITION_HPP
+#define ANPI_QR_DECOMPOSITION_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "Exception.hpp"
+#include "Matrix.hpp"
+
+namespace anpi {
+
+  /*
+   * Householder QR decomposition A = Q*R of m x n matrices with m >= n.
+   *
+   * Q is the product H_0*H_1*...*H_{n-1} of the Householder reflectors
+   * H_j = I - tau_j*v_j*v_j^T, where v_j has j zeros, a one, and then
+   * the entries stored below the diagonal of column j.  The packed
+   * matrix QR holds R in its upper triangle and the vectors v_j below
+   * it; the scalars tau_j are returned separately.
+   */
+
+  namespace bits {
+    /**
+     * Factorize the columns [k,kend) of QR with Householder reflectors,
+     * applying each one to the rest of those columns only.
+     */
+    template<typename T,class Alloc>
+    void qrPanel(Matrix<T,Alloc>& QR,
+                 std::vector<T>& tau,
+                 const size_t k,
+                 const size_t kend) {
+      const size_t m = QR.rows();
+      std::vector<T> w(kend);
+
+      for (size_t j=k;j<kend;++j) {
+        // reflector annihilating QR(j+1:m,j)
+        T xnorm2 = T(0);
+        for (size_t i=j+1;i<m;++i) {
+          xnorm2 += QR(i,j)*QR(i,j);
+        }
+        const T alpha = QR(j,j);
+        if (xnorm2 == T(0)) {
+          tau[j] = T(0);
+          continue;
+        }
+        const T norm = std::sqrt(alpha*alpha+xnorm2);
+        const T beta = (alpha >= T(0)) ? -norm : norm;
+        tau[j] = (beta-alpha)/beta;
+        const T inv = T(1)/(alpha-beta);
+        for (size_t i=j+1;i<m;++i) {
+          QR(i,j) *= inv;
+        }
+        QR(j,j) = beta;
+
+        // w^T = v^T * QR(j:m,j+1:kend), traversing rows
+        const T* rowj = QR[j];
+        for (size_t c=j+1;c<kend;++c) {
+          w[c] = rowj[c];
+        }
+        for (size_t i=j+1;i<m;++i) {
+          const T* row = QR[i];
+          const T vi = row[j];
+          for (size_t c=j+1;c<kend;++c) {
+            w[c] += vi*row[c];
+          }
+        }
+
+        // QR(j:m,j+1:kend) -= tau * v * w^T
+        const T t = tau[j];
+        T* urow = QR[j];
+        for (size_t c=j+1;c<kend;++c) {
+          urow[c] -= t*w[c];
+        }
+        for (size_t i=j+1;i<m;++i) {
+          T* row = QR[i];
+          const T tvi = t*row[j];
+          for (size_t c=j+1;c<kend;++c) {
+            row[c] -= tvi*w[c];
+          }
+        }
+      }
+    }
+
+    /**
+     * Upper triangular factor T of the compact WY representation
+     * H_k*...*H_{k+kb-1} = I - V*T*V^T, with V the explicit
+     * (m-k) x kb matrix of the reflectors.
+     */
+    template<typename T,class Alloc>
+    void qrTriangularFactor(const Matrix<T,Alloc>& V,
+                            const std::vector<T>& tau,
+                            const size_t k,
+                            Matrix<T,Alloc>& Tf) {
+      const size_t rows = V.rows();
+      const size_t kb = V.cols();
+      Tf.allocate(kb,kb);
+      Tf.fill(T(0));
+
+      std::vector<T> z(kb);
+      for (size_t i=0;i<kb;++i) {
+        const T ti = tau[k+i];
+        Tf(i,i) = ti;
+
+        // z = V(:,0:i)^T * v_i
+        std::fill(z.begin(),z.begin()+i,T(0));
+        for (size_t r=i;r<rows;++r) {
+          const T* row = V[r];
+          const T vi = row[i];
+          for (size_t p=0;p<i;++p) {
+            z[p] += row[p]*vi;
+          }
+        }
+
+        // T(0:i,i) = -tau_i * T(0:i,0:i) * z
+        for (size_t p=0;p<i;++p) {
+          T s = T(0);
+          for (size_t q=p;q<i;++q) {
+            s += Tf(p,q)*z[q];
+          }
+          Tf(p,i) = -ti*s;
+        }
+      }
+    }
+  } // namespace bits
+
+  /**
+   * Unblocked Householder QR decomposition, kept as reference for the
+   * blocked version qr() below.
+   *
+   * @param A matrix to decompose, with at least as many rows as columns
+   * @param QR packed factors
+   * @param tau scalars of the reflectors
+   *
+   * @throw anpi::Exception if A has more columns than rows
+   */
+  template<typename T,class Alloc>
+  void qrUnblocked(const Matrix<T,Alloc>& A,
+                   Matrix<T,Alloc>& QR,
+                   std::vector<T>& tau) {
+    if (A.rows() < A.cols()) {
+      throw Exception("QR decomposition requires rows >= cols");
+    }
+    QR = A;
+    tau.resize(A.cols());
+    bits::qrPanel(QR,tau,0,A.cols());
+  }
+
+  /**
+   * Blocked Householder QR decomposition.
+   *
+   * The columns are processed in panels of blockSize columns.  After
+   * factorizing a panel with the unblocked algorithm, its reflectors
+   * are aggregated into the compact WY form I - V*T*V^T, and applied
+   * to the trailing columns C with three matrix products:
+   * W = V^T*C, W = T^T*W and C = C - V*W, all of them through the
+   * (SIMD) matrix product kernel.
+   *
+   * @param A matrix to decompose, with at least as many rows as columns
+   * @param QR packed factors
+   * @param tau scalars of the reflectors
+   * @param blockSize number of columns per panel
+   *
+   * @throw anpi::Exception if A has more columns than rows
+   */
+  template<typename T,class Alloc>
+  void qr(const Matrix<T,Alloc>& A,
+          Matrix<T,Alloc>& QR,
+          std::vector<T>& tau,
+          const size_t blockSize=32) {
+    if (A.rows() < A.cols()) {
+      throw Exception("QR decomposition requires rows >= cols");
+    }
+
+    const size_t m = A.rows();
+    const size_t n = A.cols();
+    const size_t nb = std::max(blockSize,size_t(1));
+    QR = A;
+    tau.resize(n);
+
+    Matrix<T,Alloc> V,Vt,Tf,Tt,W,TW;
+
+    for (size_t k=0;k<n;k+=nb) {
+      const size_t kb = std::min(nb,n-k);
+      const size_t kend = k+kb;
+
+      bits::qrPanel(QR,tau,k,kend);
+
+      if (kend == n) {
+        break;
+      }
+      const size_t rows = m-k;
+      const size_t rest = n-kend;
+
+      // explicit reflectors, with the unit diagonal and zeros above
+      V.allocate(rows,kb);
+      for (size_t r=0;r<rows;++r) {
+        T* row = V[r];
+        const T* src = QR[k+r];
+        for (size_t c=0;c<kb;++c) {
+          row[c] = (c<r) ? src[k+c] : ((c==r) ? T(1) : T(0));
+        }
+      }
+      Vt.allocate(kb,rows);
+      Vt.view().fillTransposed(V.view());
+
+      bits::qrTriangularFactor(V,tau,k,Tf);
+      Tt.allocate(kb,kb);
+      Tt.view().fillTransposed(Tf.view());
+
+      const MatrixView<T> C = QR.block(k,kend,rows,rest);
+
+      // W = V^T*C
+      W.allocate(kb,rest);
+      W.fill(T(0));
+      aimpl::multiplyAdd(T(1),Vt.view(),ConstMatrixView<T>(C),W.view());
+
+      // W = T^T*W
+      TW.allocate(kb,rest);
+      TW.fill(T(0));
+      aimpl::multiplyAdd(T(1),Tt.view(),W.view(),TW.view());
+
+      // C = C - V*W
+      aimpl::multiplyAdd(T(-1),V.view(),TW.view(),C);
+    }
+  }
+
+  /**
+   * Extract the upper triangular n x n factor R
+   */
+  template<typename T,class Alloc>
+  void unpackR(const Matrix<T,Alloc>& QR,
+               Matrix<T,Alloc>& R) {
+    const size_t n = QR.cols();
+    R = Matrix<T,Alloc>(n,n,T(0));
+    for (size_t i=0;i<n;++i) {
+      std::copy(QR[i]+i,QR[i]+n,R[i]+i);
+    }
+  }
+
+  /**
+   * Form the m x n matrix Q with orthonormal columns, such that
+   * A = Q*R
+   */
+  template<typename T,class Alloc>
+  void unpackQ(const Matrix<T,Alloc>& QR,
+               const std::vector<T>& tau,
+               Matrix<T,Alloc>& Q) {
+    const size_t m = QR.rows();
+    const size_t n = QR.cols();
+    Q = Matrix<T,Alloc>(m,n,T(0));
+    for (size_t i=0;i<n;++i) {
+      Q(i,i) = T(1);
+    }
+
+    // Q = H_0*(H_1*(...*(H_{n-1}*I)))
+    std::vector<T> w(n);
+    for (size_t j=n;j-- > 0;) {
+      const T t = tau[j];
+      if (t == T(0)) {
+        continue;
+      }
+      const T* qj = Q[j];
+      std::copy(qj+j,qj+n,w.begin()+j);
+      for (size_t i=j+1;i<m;++i) {
+        const T vi = QR(i,j);
+        const T* row = Q[i];
+        for (size_t c=j;c<n;++c) {
+          w[c] += vi*row[c];
+        }
+      }
+      T* rowj = Q[j];
+      for (size_t c=j;c<n;++c) {
+        rowj[c] -= t*w[c];
+      }
+      for (size_t i=j+1;i<m;++i) {
+        const T tvi = t*QR(i,j);
+        T* row = Q[i];
+        for (size_t c=j;c<n;++c) {
+          row[c] -= tvi*w[c];
+        }
+      }
+    }
+  }
+
+  /**
+   * Least squares solution x minimizing |A*x-b|, with the factors of
+   * qr(): R*x = (Q^T*b)(0:n)
+   *
+   * @throw anpi::Exception if R is singular
+   */
+  template<typename T,class Alloc>
+  void qrSubstitute(const Matrix<T,Alloc>& QR,
+                    const std::vector<T>& tau,
+                    const std::vector<T>& b,
+                    std::vector<T>& x) {
+    const size_t m = QR.rows();
+    const size_t n = QR.cols();
+    if (b.size() != m) {
+      throw Exception("Right-hand side does not match the QR factors");
+    }
+
+    // y = Q^T*b = H_{n-1}*...*H_0*b
+    std::vector<T> y(b);
+    for (size_t j=0;j<n;++j) {
+      T s = y[j];
+      for (size_t i=j+1;i<m;++i) {
+        s += QR(i,j)*y[i];
+      }
+      s *= tau[j];
+      y[j] -= s;
+      for (size_t i=j+1;i<m;++i) {
+        y[i] -= s*QR(i,j);
+      }
+    }
+
+    // back substitution with R
+    for (size_t i=n;i-- > 0;) {
+      const T* row = QR[i];
+      if (row[i] == T(0)) {
+        throw Exception("Least squares problem with singular R");
+      }
+      T sum = y[i];
+      for (size_t j=i+1;j<n;++j) {
+        sum -= row[j]*y[j];
+      }
+      y[i] = sum/row[i];
+    }
+
+    y.resize(n);
+    x.swap(y);
+  }
+
+  /**
+   * Least squares solution of the overdetermined system A*x = b
+   */
+  template<typename T,class Alloc>
+  void solveQR(const Matrix<T,Alloc>& A,
+               std::vector<T>& x,
+               const std::vector<T>& b) {
+    Matrix<T,Alloc> QR;
+    std::vector<T> tau;
+    qr(A,QR,tau);
+    qrSubstitute(QR,tau,b,x);
+  }
+
+} // namespace anpi
+
+#endif
@@ -0,0 +1,124 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date  : 10.02.2018
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "Exception.hpp"
+#include "Matrix.hpp"
+
+#ifndef ANPI_ROOT_BATCH_HPP
+#define ANPI_ROOT_BATCH_HPP
+
+namespace anpi {
+
+    /**
+     * Find the roots of n independent equations f_i(x)=0, each one
+     * looked for in its own interval [xl[i],xu[i]].
+     *
+     * The equations are solved in blocks of bits::BatchBlock, each
+     * equation in one SIMD lane: every iteration computes the next
+     * estimates of the whole block, evaluates them with a single call to
+     * funct, and updates the brackets.  The lanes that converge are
+     * frozen until the whole block is done.  Large batches split the
+     * blocks among threads (see Parallel.hpp), so funct may be called
+     * concurrently.
+     *
+     * @param funct a callable of the form
+     *              "void funct(const T* x,T* fx,size_t first,size_t count)"
+     *              that stores in fx[k] the value of equation first+k at
+     *              x[k], for k in [0,count).  Both arrays are aligned to
+     *              64 bytes, so that funct can evaluate them with SIMD.
+     * @param xl lower interval limits
+     * @param xu upper interval limits
+     * @param roots the n roots found, NaN where the interval is
+     *              reversed, both ends have the same sign, or the method
+     *              did not converge
+     * @param n number of equations
+     * @param eps absolute tolerance of the roots
+     * @param method method applied to all equations
+     */
+    template<typename T,class F>
+    void rootBatch(F&& funct,
+                   const T* xl,
+                   const T* xu,
+                   T* roots,
+                   const size_t n,
+                   const T eps,
+                   const BatchRoot method=BatchRoot::Brent) {
+
+      const size_t block  = bits::BatchBlock;
+      const size_t blocks = (n + block - 1)/block;
+
+      // each equation takes a few dozen evaluations
+      parallel::forChunks(blocks,1,n*std::numeric_limits<T>::digits,
+                          [&](const size_t begin,const size_t end) {
+        for (size_t b=begin;b<end;++b) {
+          const size_t first = b*block;
+          const size_t count = std::min(block,n-first);
+          aimpl::batchRoots(method,funct,xl+first,xu+first,roots+first,
+                            first,count,eps);
+        }
+      });
+    }
+
+    /**
+     * Find the roots of independent equations, one per entry of the
+     * matrices of interval limits.
+     *
+     * The equations are numbered row by row, i.e. entry (r,c) is
+     * equation r*cols+c.  Any shape works, such as single rows or
+     * columns.
+     *
+     * @param funct a callable as in the array version
+     * @param xl lower interval limits
+     * @param xu upper interval limits
+     * @param roots matrix with the roots, of the same size as xl
+     * @param eps absolute tolerance of the roots
+     * @param method method applied to all equations
+     *
+     * @throws anpi::Exception if xl and xu have different sizes
+     */
+    template<typename T,class Alloc,class F>
+    void rootBatch(F&& funct,
+                   const Matrix<T,Alloc>& xl,
+                   const Matrix<T,Alloc>& xu,
+                   Matrix<T,Alloc>& roots,
+                   const T eps,
+                   const BatchRoot method=BatchRoot::Brent) {
+
+      if ( (xl.rows() != xu.rows()) || (xl.cols() != xu.cols()) ) {
+        throw anpi::Exception("Interval limits must have the same size");
+      }
+
+      roots.allocate(xl.rows(),xl.cols());
+      if (xl.dcols() == xl.cols()) {
+        rootBatch(funct,xl.data(),xu.data(),roots.data(),xl.entries(),
+                  eps,method);
+        return;
+      }
+
+      // gather the padded rows into contiguous lanes
+      const size_t cols = xl.cols();
+      std::vector<T> l(xl.entries()),u(xl.entries()),r(xl.entries());
+      for (size_t i=0;i<xl.rows();++i) {
+        std::copy(xl[i],xl[i]+cols,l.data()+i*cols);
+        std::copy(xu[i],xu[i]+cols,u.data()+i*cols);
+      }
+      rootBatch(funct,l.data(),u.data(),r.data(),r.size(),eps,method);
+      for (size_t i=0;i<xl.rows();++i) {
+        std::copy(r.data()+i*cols,r.data()+(i+1)*cols,roots[i]);
+      }
+    }
+}
+
+#endif
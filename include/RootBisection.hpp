@@ -25,7 +25,8 @@ namespace anpi {
      * Find the roots of the function funct looking for it in the
      * interval [xl,xu], using the bisection method.
      *
-     * @param funct a std::function of the form "T funct(T x)"
+     * @param funct any callable of the form "T funct(T x)", called
+     *              directly so that it can be inlined
      * @param xl lower interval limit
      * @param xu upper interval limit
      *
@@ -34,8 +35,8 @@ namespace anpi {
      * @throws anpi::Exception if inteval is reversed or both extremes
      *         have same sign.
      */
-    template<typename T>
-    T rootBisection(const std::function<T(T)>& funct, //puntero a función
+    template<typename T,class F>
+    T rootBisection(F&& funct, //función o functor
                     T xl, //límite inferior de intervalo
                     T xu, //límite superior de intervalo
                     const T eps) {
@@ -77,5 +78,14 @@ namespace anpi {
         return xr;
     }
 
+    /**
+     * Bisection with the function wrapped in a std::function, for code
+     * that needs the solver as a single function (see the overload above).
+     */
+    template<typename T>
+    T rootBisection(const std::function<T(T)>& funct,T xl,T xu,const T eps) {
+        return rootBisection<T,const std::function<T(T)>&>(funct,xl,xu,eps);
+    }
+
 }
 #endif
\ No newline at end of file
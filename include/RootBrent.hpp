@@ -26,7 +26,8 @@ namespace anpi {
      * Find the roots of the function funct looking for it in the
      * interval [xl,xu], using the Brent's method.
      *
-     * @param funct a std::function of the form "T funct(T x)"
+     * @param funct any callable of the form "T funct(T x)", called
+     *              directly so that it can be inlined
      * @param xl lower interval limit
      * @param xu upper interval limit
      *
@@ -39,8 +40,8 @@ namespace anpi {
     int sgn(T val) {
       return (T(0) < val) - (val < T(0));
     }
-    template<typename T>
-    T rootBrent(const std::function<T(T)>& funct,T xl,T xu,const T eps) {
+    template<typename T,class F>
+    T rootBrent(F&& funct,T xl,T xu,const T eps) {
 
 
 
@@ -109,6 +110,15 @@ namespace anpi {
       // Return NaN if no root was found
       return std::numeric_limits<T>::quiet_NaN();
     }
+
+    /**
+     * Brent's method with the function wrapped in a std::function, for code
+     * that needs the solver as a single function (see the overload above).
+     */
+    template<typename T>
+    T rootBrent(const std::function<T(T)>& funct,T xl,T xu,const T eps) {
+      return rootBrent<T,const std::function<T(T)>&>(funct,xl,xu,eps);
+    }
 }
 
 
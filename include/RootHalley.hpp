@@ -0,0 +1,100 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date  : 10.02.2018
+ */
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include "Exception.hpp"
+#include "bits/RootSafeguard.hpp"
+
+#ifndef ANPI_ROOT_HALLEY_HPP
+#define ANPI_ROOT_HALLEY_HPP
+
+namespace anpi {
+
+    namespace bits {
+
+        /// Halley step x - 2ff'/(2f'² - ff''), of cubic convergence
+        struct halleyStep {
+            template<typename T>
+            inline T operator()(const T x,const derivatives<T>& d,
+                                const bracket<T>&) const {
+                return x - T(2)*d.f*d.d1/(T(2)*d.d1*d.d1 - d.f*d.d2);
+            }
+        };
+
+        /// f, f' and f'' from user callables
+        template<typename T,class F,class D1,class D2>
+        struct halleyDerivatives {
+            F& funct;
+            D1& deriv;
+            D2& deriv2;
+            inline derivatives<T> operator()(const T x) const {
+                const derivatives<T> r = { funct(x),deriv(x),deriv2(x),T(0) };
+                return r;
+            }
+        };
+    }
+
+    /**
+     * Find the roots of the function funct looking for it in the
+     * interval [xl,xu], using Halley's method safeguarded by bisection.
+     *
+     * The first and second derivatives are computed by forward automatic
+     * differentiation, with one evaluation of funct on nested duals per
+     * iteration (see Dual.hpp).  Convergence is cubic near simple roots.
+     *
+     * @param funct callable accepting and returning Dual< Dual<T> >,
+     *              such as a functor with a template operator()
+     * @param xl lower interval limit
+     * @param xu upper interval limit
+     *
+     * @return root found, or NaN if none could be found.
+     *
+     * @throws anpi::Exception if inteval is reversed or both extremes
+     *         have same sign.
+     */
+    template<typename T,class F>
+    T rootHalley(F&& funct,T xl,T xu,const T eps) {
+        bits::dualEvaluator<T,2,typename std::remove_reference<F>::type>
+            eval = { funct };
+        bits::halleyStep step;
+        return bits::safeguardedRoot(eval,step,xl,xu,eps);
+    }
+
+    /**
+     * Halley's method with the derivatives given by the user.
+     *
+     * @param funct any callable of the form "T funct(T x)"
+     * @param deriv any callable of the form "T deriv(T x)" returning f'
+     * @param deriv2 any callable of the form "T deriv2(T x)" returning f''
+     * @param xl lower interval limit
+     * @param xu upper interval limit
+     *
+     * @return root found, or NaN if none could be found.
+     *
+     * @throws anpi::Exception if inteval is reversed or both extremes
+     *         have same sign.
+     */
+    template<typename T,class F,class D1,class D2>
+    T rootHalley(F&& funct,D1&& deriv,D2&& deriv2,T xl,T xu,const T eps) {
+        bits::halleyDerivatives<T,
+                                typename std::remove_reference<F>::type,
+                                typename std::remove_reference<D1>::type,
+                                typename std::remove_reference<D2>::type>
+            eval = { funct,deriv,deriv2 };
+        bits::halleyStep step;
+        return bits::safeguardedRoot(eval,step,xl,xu,eps);
+    }
+
+}
+
+#endif
@@ -0,0 +1,117 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date  : 10.02.2018
+ */
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include "Exception.hpp"
+#include "bits/RootSafeguard.hpp"
+
+#ifndef ANPI_ROOT_HOUSEHOLDER_HPP
+#define ANPI_ROOT_HOUSEHOLDER_HPP
+
+namespace anpi {
+
+    namespace bits {
+
+        /**
+         * Householder step of order 3, x + 3 (1/f)''/(1/f)''', of quartic
+         * convergence:
+         *
+         *   x - f (6f'² - 3ff'') / (6f'³ - 6ff'f'' + f²f''')
+         */
+        struct householderStep {
+            template<typename T>
+            inline T operator()(const T x,const derivatives<T>& d,
+                                const bracket<T>&) const {
+                const T f = d.f, f1 = d.d1, f2 = d.d2, f3 = d.d3;
+                return x - f*(T(6)*f1*f1 - T(3)*f*f2)/
+                    (T(6)*f1*f1*f1 - T(6)*f*f1*f2 + f*f*f3);
+            }
+        };
+
+        /// f, f', f'' and f''' from user callables
+        template<typename T,class F,class D1,class D2,class D3>
+        struct householderDerivatives {
+            F& funct;
+            D1& deriv;
+            D2& deriv2;
+            D3& deriv3;
+            inline derivatives<T> operator()(const T x) const {
+                const derivatives<T> r =
+                    { funct(x),deriv(x),deriv2(x),deriv3(x) };
+                return r;
+            }
+        };
+    }
+
+    /**
+     * Find the roots of the function funct looking for it in the
+     * interval [xl,xu], using Householder's method of order 3,
+     * safeguarded by bisection.
+     *
+     * The first three derivatives are computed by forward automatic
+     * differentiation, with one evaluation of funct on three nested duals
+     * per iteration (see Dual.hpp).  Convergence is quartic near simple
+     * roots, which pays off when funct is expensive compared to the
+     * eightfold arithmetic of the nested duals.
+     *
+     * @param funct callable accepting and returning
+     *              Dual< Dual< Dual<T> > >, such as a functor with a
+     *              template operator()
+     * @param xl lower interval limit
+     * @param xu upper interval limit
+     *
+     * @return root found, or NaN if none could be found.
+     *
+     * @throws anpi::Exception if inteval is reversed or both extremes
+     *         have same sign.
+     */
+    template<typename T,class F>
+    T rootHouseholder(F&& funct,T xl,T xu,const T eps) {
+        bits::dualEvaluator<T,3,typename std::remove_reference<F>::type>
+            eval = { funct };
+        bits::householderStep step;
+        return bits::safeguardedRoot(eval,step,xl,xu,eps);
+    }
+
+    /**
+     * Householder's method of order 3 with the derivatives given by the
+     * user.
+     *
+     * @param funct any callable of the form "T funct(T x)"
+     * @param deriv any callable of the form "T deriv(T x)" returning f'
+     * @param deriv2 any callable of the form "T deriv2(T x)" returning f''
+     * @param deriv3 any callable of the form "T deriv3(T x)" returning f'''
+     * @param xl lower interval limit
+     * @param xu upper interval limit
+     *
+     * @return root found, or NaN if none could be found.
+     *
+     * @throws anpi::Exception if inteval is reversed or both extremes
+     *         have same sign.
+     */
+    template<typename T,class F,class D1,class D2,class D3>
+    T rootHouseholder(F&& funct,D1&& deriv,D2&& deriv2,D3&& deriv3,
+                      T xl,T xu,const T eps) {
+        bits::householderDerivatives<T,
+                                     typename std::remove_reference<F>::type,
+                                     typename std::remove_reference<D1>::type,
+                                     typename std::remove_reference<D2>::type,
+                                     typename std::remove_reference<D3>::type>
+            eval = { funct,deriv,deriv2,deriv3 };
+        bits::householderStep step;
+        return bits::safeguardedRoot(eval,step,xl,xu,eps);
+    }
+
+}
+
+#endif
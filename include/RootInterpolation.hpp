@@ -24,7 +24,8 @@ namespace anpi {
      * Find the roots of the function funct looking for it in the
      * interval [xl,xu], by means of the interpolation method.
      *
-     * @param funct a functor of the form "T funct(T x)"
+     * @param funct any callable of the form "T funct(T x)", called
+     *              directly so that it can be inlined
      * @param xl lower interval limit
      * @param xu upper interval limit
      *
@@ -33,8 +34,8 @@ namespace anpi {
      * @throws anpi::Exception if inteval is reversed or both extremes
      *         have same sign.
      */
-    template<typename T>
-    T rootInterpolation(const std::function<T(T)>& funct,T xl,T xu,const T eps) {
+    template<typename T,class F>
+    T rootInterpolation(F&& funct,T xl,T xu,const T eps) {
 
         T xr=xl;    //hay que iniciar con algo válido
         T fl = funct(xl);
@@ -81,5 +82,14 @@ namespace anpi {
         }
         return std::numeric_limits<T>::quiet_NaN();
     }
+
+    /**
+     * Interpolation with the function wrapped in a std::function, for code
+     * that needs the solver as a single function (see the overload above).
+     */
+    template<typename T>
+    T rootInterpolation(const std::function<T(T)>& funct,T xl,T xu,const T eps) {
+        return rootInterpolation<T,const std::function<T(T)>&>(funct,xl,xu,eps);
+    }
 }
 #endif
\ No newline at end of file
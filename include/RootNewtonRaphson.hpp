@@ -13,6 +13,7 @@
 #include <functional>
 
 #include "Exception.hpp"
+#include "Dual.hpp"
 
 #ifndef ANPI_NEWTON_RAPHSON_HPP
 #define ANPI_NEWTON_RAPHSON_HPP
@@ -23,12 +24,12 @@ namespace anpi {
      * by means of forward aproximation
      *
      *
-     * @param funct a functor of the form "T funct(T x)"
+     * @param funct any callable of the form "T funct(T x)"
      * @param value
      * @return evalueted derivate aproximation
      */
-    template<typename T>
-    T primeraDerivada(const std::function<T(T)>& funct, T x,T eps) {
+    template<typename T,class F>
+    T primeraDerivada(F&& funct, T x,T eps) {
         const T h = std::abs(eps) / T(2);
         return ((funct(x+h) - funct(x))/h);
     }
@@ -37,7 +38,8 @@ namespace anpi {
      * Find the roots of the function funct looking by means of the
      * Newton-Raphson method
      *
-     * @param funct a functor of the form "T funct(T x)"
+     * @param funct any callable of the form "T funct(T x)", called
+     *              directly so that it can be inlined
      * @param xi initial root guess
      *
      * @return root found, or NaN if none could be found.
@@ -45,8 +47,8 @@ namespace anpi {
      * @throws anpi::Exception if inteval is reversed or both extremes
      *         have same sign.
      */
-    template<typename T>
-    T rootNewtonRaphson(const std::function<T(T)>& funct,T xi,const T eps) {
+    template<typename T,class F>
+    T rootNewtonRaphson(F&& funct,T xi,const T eps) {
 
         int const MAX_ITERATIONS = 20;
 
@@ -54,7 +56,7 @@ namespace anpi {
         T dx;
 
         for(int i = 0; i < MAX_ITERATIONS; i++) {
-            dx = ((funct(x))/(primeraDerivada(funct,x,eps)));
+            dx = ((funct(x))/(primeraDerivada<T>(funct,x,eps)));
             x = x - dx;
             if(std::abs(dx) < eps) {
                 return x;
@@ -65,6 +67,87 @@ namespace anpi {
         return std::numeric_limits<T>::quiet_NaN();
     }
 
+    /**
+     * Find the roots of the function funct by means of the Newton-Raphson
+     * method, with the analytic derivative given by the user.
+     *
+     * Each iteration evaluates funct and deriv once, instead of the
+     * three evaluations of funct of the finite difference version.
+     *
+     * @param funct any callable of the form "T funct(T x)"
+     * @param deriv any callable of the form "T deriv(T x)" returning the
+     *              derivative of funct
+     * @param xi initial root guess
+     *
+     * @return root found, or NaN if none could be found.
+     */
+    template<typename T,class F,class D>
+    T rootNewtonRaphson(F&& funct,D&& deriv,T xi,const T eps) {
+
+        int const MAX_ITERATIONS = 20;
+
+        T x = xi;
+        T dx;
+
+        for(int i = 0; i < MAX_ITERATIONS; i++) {
+            dx = funct(x)/deriv(x);
+            x = x - dx;
+            if(std::abs(dx) < eps) {
+                return x;
+            }
+        }
+
+        // Return NaN if no root was found
+        return std::numeric_limits<T>::quiet_NaN();
+    }
+
+    /**
+     * Find the roots of the function funct by means of the Newton-Raphson
+     * method, with the derivative computed by forward automatic
+     * differentiation.
+     *
+     * funct is evaluated once per iteration on a Dual<T>, which yields
+     * f(x) and the exact f'(x) together (see Dual.hpp).  Unlike the
+     * finite difference, the derivative does not depend on eps, so the
+     * convergence stays quadratic at tight tolerances.
+     *
+     * @param funct callable accepting and returning Dual<T>, such as a
+     *              function template instantiated for Dual<T> or a
+     *              functor with a template operator()
+     * @param xi initial root guess
+     *
+     * @return root found, or NaN if none could be found.
+     */
+    template<typename T,class F>
+    T rootNewtonRaphsonAD(F&& funct,T xi,const T eps) {
+
+        int const MAX_ITERATIONS = 20;
+
+        T x = xi;
+        T dx;
+
+        for(int i = 0; i < MAX_ITERATIONS; i++) {
+            const Dual<T> f = funct(Dual<T>(x,T(1)));
+            dx = f.value()/f.derivative();
+            x = x - dx;
+            if(std::abs(dx) < eps) {
+                return x;
+            }
+        }
+
+        // Return NaN if no root was found
+        return std::numeric_limits<T>::quiet_NaN();
+    }
+
+    /**
+     * Newton-Raphson with the function wrapped in a std::function, for code
+     * that needs the solver as a single function (see the overload above).
+     */
+    template<typename T>
+    T rootNewtonRaphson(const std::function<T(T)>& funct,T xi,const T eps) {
+        return rootNewtonRaphson<T,const std::function<T(T)>&>(funct,xi,eps);
+    }
+
 }
 
 #endif
\ No newline at end of file
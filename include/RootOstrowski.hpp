@@ -0,0 +1,120 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date  : 10.02.2018
+ */
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include "Exception.hpp"
+#include "bits/RootSafeguard.hpp"
+
+#ifndef ANPI_ROOT_OSTROWSKI_HPP
+#define ANPI_ROOT_OSTROWSKI_HPP
+
+namespace anpi {
+
+    namespace bits {
+
+        /**
+         * Ostrowski step, of quartic convergence: a Newton step to y,
+         * and a second step with f(y) and the same derivative f'(x),
+         *
+         *   y - f(y)/f'(x) · f(x)/(f(x) - 2f(y))
+         *
+         * If the Newton step leaves the bracket (a,b), or rounds to one
+         * of its ends, it is returned as is for the safeguard to handle.
+         * Otherwise f(y) also shrinks the bracket, which keeps the
+         * evaluation useful even if the safeguard rejects the step.
+         */
+        template<class F>
+        struct ostrowskiStep {
+            F& funct;
+            template<typename T>
+            inline T operator()(const T x,const derivatives<T>& d,
+                                bracket<T>& br) const {
+                const T y = x - d.f/d.d1;
+                if (!(br.a < y && y < br.b)) {
+                    return y;
+                }
+                const T fy = funct(y);
+                br.shrink(y,fy);
+                if (fy == T(0)) {
+                    return y;
+                }
+                return y - fy/d.d1*d.f/(d.f - T(2)*fy);
+            }
+        };
+
+        /// f and f' from user callables
+        template<typename T,class F,class D1>
+        struct ostrowskiDerivatives {
+            F& funct;
+            D1& deriv;
+            inline derivatives<T> operator()(const T x) const {
+                const derivatives<T> r = { funct(x),deriv(x),T(0),T(0) };
+                return r;
+            }
+        };
+    }
+
+    /**
+     * Find the roots of the function funct looking for it in the
+     * interval [xl,xu], using Ostrowski's method safeguarded by
+     * bisection.
+     *
+     * Each iteration evaluates f and f' at x, the latter by forward
+     * automatic differentiation (see Dual.hpp), and f alone at the
+     * Newton step y.  Convergence is quartic with only first
+     * derivatives.
+     *
+     * @param funct callable accepting and returning both T and Dual<T>,
+     *              such as a functor with a template operator()
+     * @param xl lower interval limit
+     * @param xu upper interval limit
+     *
+     * @return root found, or NaN if none could be found.
+     *
+     * @throws anpi::Exception if inteval is reversed or both extremes
+     *         have same sign.
+     */
+    template<typename T,class F>
+    T rootOstrowski(F&& funct,T xl,T xu,const T eps) {
+        typedef typename std::remove_reference<F>::type function_type;
+        bits::dualEvaluator<T,1,function_type> eval = { funct };
+        bits::ostrowskiStep<function_type> step = { funct };
+        return bits::safeguardedRoot(eval,step,xl,xu,eps);
+    }
+
+    /**
+     * Ostrowski's method with the derivative given by the user.
+     *
+     * @param funct any callable of the form "T funct(T x)"
+     * @param deriv any callable of the form "T deriv(T x)" returning f'
+     * @param xl lower interval limit
+     * @param xu upper interval limit
+     *
+     * @return root found, or NaN if none could be found.
+     *
+     * @throws anpi::Exception if inteval is reversed or both extremes
+     *         have same sign.
+     */
+    template<typename T,class F,class D1>
+    T rootOstrowski(F&& funct,D1&& deriv,T xl,T xu,const T eps) {
+        typedef typename std::remove_reference<F>::type function_type;
+        bits::ostrowskiDerivatives<T,function_type,
+                                   typename std::remove_reference<D1>::type>
+            eval = { funct,deriv };
+        bits::ostrowskiStep<function_type> step = { funct };
+        return bits::safeguardedRoot(eval,step,xl,xu,eps);
+    }
+
+}
+
+#endif
@@ -0,0 +1,285 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date  : 10.02.2018
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "Exception.hpp"
+#include "Parallel.hpp"
+#include "RootBatch.hpp"
+
+#ifndef ANPI_ROOT_SCAN_HPP
+#define ANPI_ROOT_SCAN_HPP
+
+namespace anpi {
+
+  namespace bits {
+
+    /// Scalar callable evaluated on the blocks of rootBatch
+    template<typename T,class F>
+    struct scanBlock {
+      F& funct;
+      inline void operator()(const T* x,T* fx,
+                             const size_t,const size_t count) const {
+        for (size_t k=0;k<count;++k) {
+          fx[k]=funct(x[k]);
+        }
+      }
+    };
+
+    /// Single point evaluation of a block callable of rootBatch
+    template<typename T,class F>
+    struct scanPoint {
+      F& funct;
+      inline T operator()(const T x) const {
+        alignas(64) T xb[1] = { x };
+        alignas(64) T fb[1];
+        funct(xb,fb,0,1);
+        return fb[0];
+      }
+    };
+
+    /// Possible touching root, i.e. a minimum of |f| at a grid point
+    template<typename T>
+    struct scanTangent {
+      T xl,xu;  ///< neighbour grid points
+      T fm;     ///< value at the grid point
+      T curv;   ///< |f''|/2 of the parabola through the three samples
+      T root;   ///< root found, or NaN
+      T split;  ///< point where f changed sign, or NaN
+    };
+
+    /**
+     * Golden section search of the minimum of |f| in the interval of
+     * the tangent t, down to a width of a quarter of the tolerance.  The
+     * minimum is accepted as a root if it is below curv*tol², i.e. if
+     * the parabola fitted at the grid would touch zero when displaced by
+     * tol.  The tolerance is eps, but not below sqrt(epsilon)*|x|, the
+     * best that a minimization can resolve.  If some evaluation has the
+     * opposite sign of the grid point, the search stops there, as the
+     * interval then has two simple roots around that point.
+     */
+    template<typename T,class F>
+    void refineTangent(F& funct,scanTangent<T>& t,const T eps) {
+      const T nan   = std::numeric_limits<T>::quiet_NaN();
+      const T ratio = T(0.5)*(std::sqrt(T(5)) - T(1));
+      const T small = std::sqrt(std::numeric_limits<T>::epsilon());
+      const bool positive = t.fm > T(0);
+
+      T a=t.xl, b=t.xu;
+      T c=b-ratio*(b-a), d=a+ratio*(b-a);
+      T fc=funct(c), fd=funct(d);
+      T tol=eps;
+      t.root=nan;
+      t.split=nan;
+      for (int i=4*std::numeric_limits<T>::digits;i>0;--i) {
+        if ((fc > T(0)) != positive && fc != T(0)) {
+          t.split=c;
+          return;
+        }
+        if ((fd > T(0)) != positive && fd != T(0)) {
+          t.split=d;
+          return;
+        }
+        tol=std::max(eps,small*std::abs(c));
+        if (T(4)*(b-a) <= tol) {
+          break;
+        }
+        if (std::abs(fc) < std::abs(fd)) {
+          b=d; d=c; fd=fc;
+          c=b-ratio*(b-a);
+          fc=funct(c);
+        } else {
+          a=c; c=d; fc=fd;
+          d=a+ratio*(b-a);
+          fd=funct(d);
+        }
+      }
+      const T x  = (std::abs(fc) < std::abs(fd)) ? c : d;
+      const T fx = std::min(std::abs(fc),std::abs(fd));
+      if (fx <= t.curv*tol*tol) {
+        t.root=x;
+      }
+    }
+  } // namespace bits
+
+  /**
+   * Find all roots of the function evaluated by the block callable funct
+   * in the interval [a,b].
+   *
+   * The interval is split in the given number of subintervals, and the
+   * function is sampled at their limits in blocks of bits::BatchBlock
+   * points, distributing the blocks among threads.  Each sign change
+   * brackets a root, and all brackets are refined together with
+   * rootBatch.  Local minima of |f| without sign change may be touching
+   * roots like the one of x² at 0: if the parabola through the three
+   * samples around them falls below half the sampled |f|, they are
+   * refined with a golden section search, which evaluates one point at
+   * a time.  It either reaches a minimum of |f| near zero, or finds a
+   * sign change and with it two close roots.
+   *
+   * Roots closer than a subinterval to another one without a sign change
+   * between them may be missed, so the number of subintervals must
+   * resolve the oscillations of the function.
+   *
+   * @param funct a callable of the form
+   *              "void funct(const T* x,T* fx,size_t first,size_t count)"
+   *              as the one of rootBatch, but storing in fx[k] the value
+   *              of the same function f at x[k] for all k in [0,count),
+   *              so that first can be ignored.  Both arrays are aligned
+   *              to 64 bytes, so that funct can evaluate them with SIMD.
+   *              It is called from several threads at the same time.
+   * @param a lower interval limit
+   * @param b upper interval limit
+   * @param eps absolute tolerance of the roots
+   * @param intervals number of subintervals of the sampling grid
+   *
+   * @return the roots in increasing order, without repetitions closer
+   *         than eps
+   *
+   * @throws anpi::Exception if the interval is reversed or not finite,
+   *         or if no subintervals are given
+   */
+  template<typename T,class F>
+  std::vector<T> rootScanBatch(F&& funct,
+                               const T a,
+                               const T b,
+                               const T eps,
+                               const size_t intervals=1024) {
+
+    if (!(a <= b) || !std::isfinite(a) || !std::isfinite(b)) {
+      throw anpi::Exception("Invalid scan interval");
+    }
+    if (intervals == 0) {
+      throw anpi::Exception("At least one subinterval is required");
+    }
+
+    // sample the grid in aligned blocks, each point computed from its index
+    const size_t n = intervals+1;
+    const size_t block  = bits::BatchBlock;
+    const size_t blocks = (n + block - 1)/block;
+    const T h = (b-a)/T(intervals);
+    std::vector<T> x(n),fx(n);
+    parallel::forChunks(blocks,1,64*n,[&](const size_t begin,const size_t end) {
+      alignas(64) T xb[bits::BatchBlock];
+      alignas(64) T fb[bits::BatchBlock];
+      for (size_t k=begin;k<end;++k) {
+        const size_t first = k*block;
+        const size_t count = std::min(block,n-first);
+        for (size_t i=0;i<count;++i) {
+          xb[i] = (first+i+1 == n) ? b : a + T(first+i)*h;
+        }
+        funct(static_cast<const T*>(xb),static_cast<T*>(fb),first,count);
+        std::copy(xb,xb+count,x.begin()+first);
+        std::copy(fb,fb+count,fx.begin()+first);
+      }
+    });
+
+    // exact zeros, sign changes, and minima of |f| away from the ends
+    // where the parabola through the three samples at least halves |f|
+    std::vector<T> roots,xl,xu;
+    std::vector< bits::scanTangent<T> > tangents;
+    for (size_t i=0;i<n;++i) {
+      if (fx[i] == T(0)) {
+        roots.push_back(x[i]);
+      } else if ( (i+1<n) && ((fx[i] < T(0)) != (fx[i+1] < T(0))) &&
+                  (fx[i+1] != T(0)) ) {
+        xl.push_back(x[i]);
+        xu.push_back(x[i+1]);
+      } else if ( (i>0) && (i+1<n) &&
+                  ((fx[i] < T(0)) == (fx[i-1] < T(0))) &&
+                  ((fx[i] < T(0)) == (fx[i+1] < T(0))) &&
+                  (fx[i-1] != T(0)) && (fx[i+1] != T(0)) &&
+                  (std::abs(fx[i]) < std::abs(fx[i-1])) &&
+                  (std::abs(fx[i]) <= std::abs(fx[i+1])) ) {
+        const T fl=std::abs(fx[i-1]), fm=std::abs(fx[i]), fu=std::abs(fx[i+1]);
+        const T curv=T(0.5)*(fl+fu)-fm, slope=T(0.5)*(fu-fl);
+        if (fm - slope*slope/(T(4)*curv) <= T(0.5)*fm) {
+          const bits::scanTangent<T> t =
+            { x[i-1],x[i+1],fx[i],curv/(h*h),T(0),T(0) };
+          tangents.push_back(t);
+        }
+      }
+    }
+
+    // each golden section search takes a few dozen evaluations
+    const bits::scanPoint<T,typename std::remove_reference<F>::type> point
+      = { funct };
+    parallel::forChunks(tangents.size(),1,
+                        64*tangents.size()*std::numeric_limits<T>::digits,
+                        [&](const size_t begin,const size_t end) {
+      for (size_t i=begin;i<end;++i) {
+        bits::refineTangent(point,tangents[i],eps);
+      }
+    });
+    for (const bits::scanTangent<T>& t : tangents) {
+      if (!std::isnan(t.root)) {
+        roots.push_back(t.root);
+      } else if (!std::isnan(t.split)) {
+        xl.push_back(t.xl);
+        xu.push_back(t.split);
+        xl.push_back(t.split);
+        xu.push_back(t.xu);
+      }
+    }
+
+    std::vector<T> refined(xl.size());
+    rootBatch(funct,xl.data(),xu.data(),refined.data(),refined.size(),
+              eps,BatchRoot::Brent);
+    for (const T r : refined) {
+      if (!std::isnan(r)) {
+        roots.push_back(r);
+      }
+    }
+
+    std::sort(roots.begin(),roots.end());
+    roots.erase(std::unique(roots.begin(),roots.end(),
+                            [eps](const T l,const T r) { return r-l < eps; }),
+                roots.end());
+    return roots;
+  }
+
+  /**
+   * Find all roots of the function funct in the interval [a,b].
+   *
+   * This is rootScanBatch() with a scalar function, evaluated point by
+   * point on the blocks of the grid and of the refinements.  Functions
+   * that can evaluate many points at once with SIMD should be given to
+   * rootScanBatch() instead.
+   *
+   * @param funct any callable of the form "T funct(T x)".  It is called
+   *              from several threads at the same time.
+   * @param a lower interval limit
+   * @param b upper interval limit
+   * @param eps absolute tolerance of the roots
+   * @param intervals number of subintervals of the sampling grid
+   *
+   * @return the roots in increasing order, without repetitions closer
+   *         than eps
+   *
+   * @throws anpi::Exception as rootScanBatch()
+   */
+  template<typename T,class F>
+  std::vector<T> rootScan(F&& funct,
+                          const T a,
+                          const T b,
+                          const T eps,
+                          const size_t intervals=1024) {
+    const bits::scanBlock<T,typename std::remove_reference<F>::type> block
+      = { funct };
+    return rootScanBatch(block,a,b,eps,intervals);
+  }
+}
+
+#endif
@@ -23,14 +23,15 @@ namespace anpi {
    * Find a root of the function funct looking for it starting at xi
    * by means of the secant method.
    *
-   * @param funct a functor of the form "T funct(T x)"
+   * @param funct any callable of the form "T funct(T x)", called
+   *              directly so that it can be inlined
    * @param xi initial position
    * @param xii second initial position 
    *
    * @return root found, or NaN if no root could be found
    */
-  template<typename T>
-  T rootSecant(const std::function<T(T)>& funct,T xi,T xii,const T eps) {
+  template<typename T,class F>
+  T rootSecant(F&& funct,T xi,T xii,const T eps) {
       T fl,f,dx,swap,xl,rts;
       fl=funct(xi);
       f=funct(xii);
@@ -61,6 +62,15 @@ namespace anpi {
     return std::numeric_limits<T>::quiet_NaN();
   }
 
+  /**
+   * Secant method with the function wrapped in a std::function, for code
+   * that needs the solver as a single function (see the overload above).
+   */
+  template<typename T>
+  T rootSecant(const std::function<T(T)>& funct,T xi,T xii,const T eps) {
+    return rootSecant<T,const std::function<T(T)>&>(funct,xi,xii,eps);
+  }
+
 }
   
 #endif
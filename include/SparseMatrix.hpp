@@ -0,0 +1,243 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date  : 09.01.2018
+ */
+
+#ifndef ANPI_SPARSE_MATRIX_HPP
+#define ANPI_SPARSE_MATRIX_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Exception.hpp"
+#include "Matrix.hpp"
+
+namespace anpi {
+
+  /**
+   * One entry (row,col,value) of a sparse matrix under construction
+   */
+  template<typename T>
+  struct Triplet {
+    size_t row;
+    size_t col;
+    T      value;
+
+    Triplet() : row(0),col(0),value(T(0)) {}
+    Triplet(const size_t r,const size_t c,const T v)
+      : row(r),col(c),value(v) {}
+  };
+
+  /**
+   * Sparse matrix in compressed sparse row (CSR) format.
+   *
+   * The nonzeros are stored row after row, each row sorted by column:
+   * row r holds values()[rowPtr()[r]:rowPtr()[r+1]], in the columns
+   * colIndices()[rowPtr()[r]:rowPtr()[r+1]].  The column indices are
+   * 32 bit integers, which halves their memory traffic and is what the
+   * SIMD gather instructions take.
+   */
+  template<typename T>
+  class SparseMatrix {
+  public:
+    typedef T value_type;
+
+  private:
+    /// Number of rows
+    size_t _rows;
+
+    /// Number of columns
+    size_t _cols;
+
+    /// Index of the first nonzero of each row, plus the total count
+    std::vector<size_t> _rowPtr;
+
+    /// Column of each nonzero
+    std::vector<sparse_index> _colIdx;
+
+    /// Value of each nonzero
+    std::vector<T> _vals;
+
+    /// Check that the columns can be addressed with sparse_index
+    void _checkCols() const {
+      if (_cols > size_t(std::numeric_limits<sparse_index>::max())) {
+        throw Exception("Too many columns for a sparse matrix");
+      }
+    }
+
+  public:
+    /// Empty matrix
+    SparseMatrix() : _rows(0),_cols(0),_rowPtr(1,0) {}
+
+    /**
+     * Construct from a list of entries, in any order.
+     *
+     * The values of repeated positions are added, as usual when
+     * assembling finite element matrices.  Zero values are kept.
+     *
+     * @throw anpi::Exception if an entry lies outside the matrix
+     */
+    SparseMatrix(const size_t rows,
+                 const size_t cols,
+                 const std::vector< Triplet<T> >& entries)
+      : _rows(rows),_cols(cols),_rowPtr(rows+1,0) {
+      _checkCols();
+
+      // counting sort by rows
+      for (const Triplet<T>& e : entries) {
+        if ( (e.row >= rows) || (e.col >= cols) ) {
+          throw Exception("Sparse matrix entry out of range");
+        }
+        ++_rowPtr[e.row+1];
+      }
+      for (size_t r=0;r<rows;++r) {
+        _rowPtr[r+1] += _rowPtr[r];
+      }
+
+      std::vector< std::pair<sparse_index,T> > sorted(entries.size());
+      {
+        std::vector<size_t> next(_rowPtr.begin(),_rowPtr.end()-1);
+        for (const Triplet<T>& e : entries) {
+          sorted[next[e.row]++] =
+            std::make_pair(sparse_index(e.col),e.value);
+        }
+      }
+
+      // sort each row by columns, merging repeated positions
+      _colIdx.reserve(entries.size());
+      _vals.reserve(entries.size());
+      size_t begin = 0;
+      for (size_t r=0;r<rows;++r) {
+        const size_t end = _rowPtr[r+1];
+        std::sort(sorted.begin()+begin,sorted.begin()+end,
+                  [](const std::pair<sparse_index,T>& a,
+                     const std::pair<sparse_index,T>& b) {
+                    return a.first < b.first;
+                  });
+        _rowPtr[r] = _vals.size();
+        for (size_t k=begin;k<end;++k) {
+          if ( (k>begin) && (sorted[k].first == _colIdx.back()) ) {
+            _vals.back() += sorted[k].second;
+          } else {
+            _colIdx.push_back(sorted[k].first);
+            _vals.push_back(sorted[k].second);
+          }
+        }
+        begin = end;
+      }
+      _rowPtr[rows] = _vals.size();
+    }
+
+    /**
+     * Construct from a dense matrix, keeping its nonzero entries
+     */
+    template<class Alloc>
+    explicit SparseMatrix(const Matrix<T,Alloc>& dense)
+      : _rows(dense.rows()),_cols(dense.cols()),_rowPtr(dense.rows()+1,0) {
+      _checkCols();
+      for (size_t r=0;r<_rows;++r) {
+        const T* row = dense[r];
+        for (size_t c=0;c<_cols;++c) {
+          if (row[c] != T(0)) {
+            _colIdx.push_back(sparse_index(c));
+            _vals.push_back(row[c]);
+          }
+        }
+        _rowPtr[r+1] = _vals.size();
+      }
+    }
+
+    /// Number of rows
+    inline size_t rows() const { return _rows; }
+
+    /// Number of columns
+    inline size_t cols() const { return _cols; }
+
+    /// Number of stored entries
+    inline size_t nonZeros() const { return _vals.size(); }
+
+    /// Index of the first nonzero of each row, plus the total count
+    inline const std::vector<size_t>& rowPtr() const { return _rowPtr; }
+
+    /// Column of each stored entry
+    inline const std::vector<sparse_index>& colIndices() const {
+      return _colIdx;
+    }
+
+    /// Value of each stored entry
+    inline const std::vector<T>& values() const { return _vals; }
+
+    /// Value of each stored entry, to modify without changing the pattern
+    inline std::vector<T>& values() { return _vals; }
+
+    /// Entry at (row,col), zero if not stored
+    T operator()(const size_t row,const size_t col) const {
+      assert( (row<_rows) && (col<_cols) );
+      const sparse_index* begin = _colIdx.data()+_rowPtr[row];
+      const sparse_index* end   = _colIdx.data()+_rowPtr[row+1];
+      const sparse_index* it    =
+        std::lower_bound(begin,end,sparse_index(col));
+      return ( (it != end) && (*it == sparse_index(col)) )
+        ? _vals[it-_colIdx.data()]
+        : T(0);
+    }
+
+    /// Convert to the dense matrix m
+    template<class Alloc>
+    void toDense(Matrix<T,Alloc>& m) const {
+      m.allocate(_rows,_cols);
+      m.fill(T(0));
+      for (size_t r=0;r<_rows;++r) {
+        T* row = m[r];
+        for (size_t k=_rowPtr[r];k<_rowPtr[r+1];++k) {
+          row[_colIdx[k]] = _vals[k];
+        }
+      }
+    }
+  };
+
+  /**
+   * Sparse matrix-vector product y = A*x.
+   *
+   * The rows are distributed among the threads, and each row is
+   * evaluated with the SIMD gather kernels when available.
+   *
+   * @throw anpi::Exception if the size of x does not match
+   */
+  template<typename T>
+  void multiply(const SparseMatrix<T>& A,
+                const std::vector<T>& x,
+                std::vector<T>& y) {
+    if (x.size() != A.cols()) {
+      throw Exception("Vector does not match the sparse matrix");
+    }
+    assert(&x != &y);
+    y.resize(A.rows());
+    if (A.rows() > 0) {
+      aimpl::spmv(A.rows(),A.rowPtr().data(),A.colIndices().data(),
+                  A.values().data(),x.data(),y.data());
+    }
+  }
+
+  /// Sparse matrix-vector product
+  template<typename T>
+  std::vector<T> operator*(const SparseMatrix<T>& A,
+                           const std::vector<T>& x) {
+    std::vector<T> y;
+    multiply(A,x,y);
+    return y;
+  }
+
+} // namespace anpi
+
+#endif
@@ -0,0 +1,441 @@
+/*
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date:   10.02.2018
+ */
+
+/*
+ * Batched root finders on the lanes of lane_ops<T>.
+ *
+ * Up to BatchBlock independent equations are solved together.  The
+ * state of each equation lives in one lane of the arrays of a
+ * batch_state, and each step updates whole registers of lanes.  The
+ * lanes that already converged are frozen by masks, and the iterations
+ * end when all lanes are done.  The function is called once per
+ * iteration with the new estimates of all lanes.
+ *
+ * The convergence tolerance of a lane at x is 2*epsilon*|x| + eps/2,
+ * with epsilon the machine epsilon of T, so that a requested eps below
+ * the resolution of the numbers still converges.
+ *
+ * Like SimdRegisters.hpp, this file has no include guards: it is
+ * included in the fallback namespace with single lanes (see
+ * BatchRoots.hpp), and once per instruction set with the registers of
+ * that set (see SimdBatchRoots.hpp).
+ */
+
+    /// State of a block of equations, one lane each
+    template<typename T>
+    struct batch_state {
+      static constexpr size_t size = ::anpi::bits::BatchBlock;
+      alignas(64) T a[size];    ///< lower end, or contrapoint in Brent
+      alignas(64) T b[size];    ///< upper end, or best estimate in Brent
+      alignas(64) T c[size];    ///< newest point other than b in Brent
+      alignas(64) T fa[size];
+      alignas(64) T fb[size];
+      alignas(64) T fc[size];
+      alignas(64) T x[size];    ///< estimates passed to the function
+      alignas(64) T fx[size];
+      alignas(64) T w1[size];   ///< Illinois side, or last step in Brent
+      alignas(64) T w2[size];   ///< step before the last one in Brent
+      alignas(64) T root[size]; ///< result of the converged lanes
+      alignas(64) T done[size]; ///< 1 for finished lanes, 0 otherwise
+    };
+
+    /// Maximum number of iterations of the batched root finders
+    template<typename T>
+    inline int batchIterations() {
+      return 4*std::numeric_limits<T>::digits;
+    }
+
+    /// Lanes where a and b are both non-zero and of the same sign
+    template<typename T>
+    inline typename lane_ops<T>::mask_type
+    sameSigns(const typename lane_ops<T>::reg_type a,
+              const typename lane_ops<T>::reg_type b) {
+      typedef lane_ops<T> ops;
+      const typename ops::reg_type zero = ops::set1(T(0));
+      return ops::mor(ops::mand(ops::lt(a,zero),ops::lt(b,zero)),
+                      ops::mand(ops::lt(zero,a),ops::lt(zero,b)));
+    }
+
+    /// Lanes where a and b are both non-zero and of different signs
+    template<typename T>
+    inline typename lane_ops<T>::mask_type
+    oppositeSigns(const typename lane_ops<T>::reg_type a,
+                  const typename lane_ops<T>::reg_type b) {
+      typedef lane_ops<T> ops;
+      const typename ops::reg_type zero = ops::set1(T(0));
+      return ops::mor(ops::mand(ops::lt(a,zero),ops::lt(zero,b)),
+                      ops::mand(ops::lt(zero,a),ops::lt(b,zero)));
+    }
+
+    /**
+     * Load the count brackets, evaluate their ends, and finish the lanes
+     * with a root at one end, or with an invalid bracket (reversed, NaN,
+     * or without sign change), the latter with NaN.  The lanes after
+     * count, up to a whole register, start finished.
+     *
+     * @return false if no lane is left to iterate
+     */
+    template<typename T,class F>
+    inline bool batchStart(F& funct,
+                           const T* xl,
+                           const T* xu,
+                           const size_t first,
+                           const size_t count,
+                           batch_state<T>& s) {
+      typedef lane_ops<T> ops;
+      typedef typename ops::reg_type regType;
+      typedef typename ops::mask_type maskType;
+      const size_t lanes = ops::lanes;
+      const size_t end = ((count + lanes - 1)/lanes)*lanes;
+
+      for (size_t i=0;i<count;++i) {
+        s.a[i] = xl[i];
+        s.b[i] = xu[i];
+        s.done[i] = T(0);
+      }
+      for (size_t i=count;i<end;++i) {
+        s.a[i] = s.b[i] = s.fa[i] = s.fb[i] = s.x[i] = s.fx[i] = T(0);
+        s.done[i] = T(1);
+      }
+      funct(static_cast<const T*>(s.a),s.fa,first,count);
+      funct(static_cast<const T*>(s.b),s.fb,first,count);
+
+      const regType zero = ops::set1(T(0));
+      const regType one  = ops::set1(T(1));
+      const regType nan  = ops::set1(std::numeric_limits<T>::quiet_NaN());
+      bool open = false;
+      for (size_t i=0;i<end;i+=lanes) {
+        const regType a  = ops::load(s.a+i),  b  = ops::load(s.b+i);
+        const regType fa = ops::load(s.fa+i), fb = ops::load(s.fb+i);
+        const maskType za = ops::eq(fa,zero), zb = ops::eq(fb,zero);
+        const maskType valid =
+          ops::mand(ops::le(a,b),
+                    ops::mor(oppositeSigns<T>(fa,fb),ops::mor(za,zb)));
+        const maskType pad = ops::lt(zero,ops::load(s.done+i));
+        const maskType go  =
+          ops::mandn(ops::mandn(ops::mandn(valid,za),zb),pad);
+        const regType done = ops::select(go,zero,one);
+        ops::store(s.root+i,
+                   ops::select(ops::mand(valid,za),a,
+                               ops::select(ops::mand(valid,zb),b,nan)));
+        ops::store(s.done+i,done);
+        open = open || !ops::all(ops::lt(zero,done));
+      }
+      return open;
+    }
+
+    /// Copy the roots of the finished lanes, NaN for the others
+    template<typename T>
+    inline void batchFinish(const batch_state<T>& s,
+                            T* roots,
+                            const size_t count) {
+      for (size_t i=0;i<count;++i) {
+        roots[i] = (s.done[i] != T(0)) ? s.root[i]
+                                       : std::numeric_limits<T>::quiet_NaN();
+      }
+    }
+
+    /// Bisection of count <= BatchBlock brackets
+    template<typename T,class F>
+    inline void batchBisection(F& funct,
+                               const T* xl,
+                               const T* xu,
+                               T* roots,
+                               const size_t first,
+                               const size_t count,
+                               const T eps) {
+      typedef lane_ops<T> ops;
+      typedef typename ops::reg_type regType;
+      typedef typename ops::mask_type maskType;
+      const size_t lanes = ops::lanes;
+      const size_t end = ((count + lanes - 1)/lanes)*lanes;
+
+      batch_state<T> s;
+      if (batchStart(funct,xl,xu,first,count,s)) {
+        const regType zero = ops::set1(T(0)), one = ops::set1(T(1));
+        const regType half = ops::set1(T(0.5));
+        const regType rtol = ops::set1(T(2)*std::numeric_limits<T>::epsilon());
+        const regType atol = ops::set1(eps/T(2));
+
+        for (int it=batchIterations<T>();it>0;--it) {
+          bool open = false;
+          for (size_t i=0;i<end;i+=lanes) {
+            const regType a = ops::load(s.a+i), b = ops::load(s.b+i);
+            const regType d = ops::load(s.done+i);
+            const regType m = ops::mul(half,ops::add(a,b));
+            const regType tol = ops::add(ops::mul(rtol,ops::abs(m)),atol);
+            const maskType fin =
+              ops::mandn(ops::le(ops::sub(b,a),ops::add(tol,tol)),
+                         ops::lt(zero,d));
+            const regType done = ops::select(fin,one,d);
+            ops::store(s.root+i,ops::select(fin,m,ops::load(s.root+i)));
+            ops::store(s.done+i,done);
+            ops::store(s.x+i,m);
+            open = open || !ops::all(ops::lt(zero,done));
+          }
+          if (!open) {
+            break;
+          }
+
+          funct(static_cast<const T*>(s.x),s.fx,first,count);
+
+          for (size_t i=0;i<end;i+=lanes) {
+            const regType a  = ops::load(s.a+i),  b  = ops::load(s.b+i);
+            const regType fa = ops::load(s.fa+i);
+            const regType x  = ops::load(s.x+i),  fx = ops::load(s.fx+i);
+            const regType d  = ops::load(s.done+i);
+            const maskType active = ops::eq(d,zero);
+            const maskType hit = ops::mand(active,ops::eq(fx,zero));
+            // the root lies between x and b if f(x) has the sign of f(a)
+            const maskType right = ops::mand(active,sameSigns<T>(fx,fa));
+            const maskType left  = ops::mandn(ops::mandn(active,right),hit);
+            ops::store(s.a+i,ops::select(right,x,a));
+            ops::store(s.fa+i,ops::select(right,fx,fa));
+            ops::store(s.b+i,ops::select(left,x,b));
+            ops::store(s.root+i,ops::select(hit,x,ops::load(s.root+i)));
+            ops::store(s.done+i,ops::select(hit,one,d));
+          }
+        }
+      }
+      batchFinish(s,roots,count);
+    }
+
+    /**
+     * Regula falsi of count <= BatchBlock brackets.
+     *
+     * With the Illinois modification: if the same end is replaced twice
+     * in a row, the function value kept at the other end is halved, so
+     * that both ends approach the root.
+     */
+    template<typename T,class F>
+    inline void batchRegulaFalsi(F& funct,
+                                 const T* xl,
+                                 const T* xu,
+                                 T* roots,
+                                 const size_t first,
+                                 const size_t count,
+                                 const T eps) {
+      typedef lane_ops<T> ops;
+      typedef typename ops::reg_type regType;
+      typedef typename ops::mask_type maskType;
+      const size_t lanes = ops::lanes;
+      const size_t end = ((count + lanes - 1)/lanes)*lanes;
+
+      batch_state<T> s;
+      if (batchStart(funct,xl,xu,first,count,s)) {
+        const regType zero = ops::set1(T(0)), one = ops::set1(T(1));
+        const regType half = ops::set1(T(0.5));
+        const regType rtol = ops::set1(T(2)*std::numeric_limits<T>::epsilon());
+        const regType atol = ops::set1(eps/T(2));
+
+        // side of the last replaced end: -1 for a, 1 for b
+        for (size_t i=0;i<end;++i) {
+          s.w1[i] = T(0);
+        }
+
+        for (int it=batchIterations<T>();it>0;--it) {
+          bool open = false;
+          for (size_t i=0;i<end;i+=lanes) {
+            const regType a  = ops::load(s.a+i),  b  = ops::load(s.b+i);
+            const regType fa = ops::load(s.fa+i), fb = ops::load(s.fb+i);
+            const regType d  = ops::load(s.done+i);
+            const regType m = ops::mul(half,ops::add(a,b));
+            const regType tol = ops::add(ops::mul(rtol,ops::abs(m)),atol);
+            const maskType fin =
+              ops::mandn(ops::le(ops::sub(b,a),ops::add(tol,tol)),
+                         ops::lt(zero,d));
+            const regType done = ops::select(fin,one,d);
+            ops::store(s.root+i,ops::select(fin,m,ops::load(s.root+i)));
+            ops::store(s.done+i,done);
+
+            // false position, or the midpoint if rounding leaves the bracket
+            const regType r =
+              ops::sub(b,ops::div(ops::mul(fb,ops::sub(b,a)),ops::sub(fb,fa)));
+            const maskType inside = ops::mand(ops::lt(a,r),ops::lt(r,b));
+            ops::store(s.x+i,ops::select(ops::eq(done,zero),
+                                         ops::select(inside,r,m),b));
+            open = open || !ops::all(ops::lt(zero,done));
+          }
+          if (!open) {
+            break;
+          }
+
+          funct(static_cast<const T*>(s.x),s.fx,first,count);
+
+          const regType plus = ops::set1(T(1)), minus = ops::set1(T(-1));
+          for (size_t i=0;i<end;i+=lanes) {
+            const regType a  = ops::load(s.a+i),  b  = ops::load(s.b+i);
+            const regType fa = ops::load(s.fa+i), fb = ops::load(s.fb+i);
+            const regType x  = ops::load(s.x+i),  fx = ops::load(s.fx+i);
+            const regType side = ops::load(s.w1+i);
+            const regType d  = ops::load(s.done+i);
+            const maskType active = ops::eq(d,zero);
+            const maskType hit = ops::mand(active,ops::eq(fx,zero));
+            const maskType upper = ops::mand(active,sameSigns<T>(fx,fb));
+            const maskType lower = ops::mandn(ops::mandn(active,upper),hit);
+            const maskType halveA = ops::mand(upper,ops::eq(side,plus));
+            const maskType halveB = ops::mand(lower,ops::eq(side,minus));
+            ops::store(s.a+i,ops::select(lower,x,a));
+            ops::store(s.fa+i,ops::select(lower,fx,
+                                          ops::select(halveA,
+                                                      ops::mul(half,fa),fa)));
+            ops::store(s.b+i,ops::select(upper,x,b));
+            ops::store(s.fb+i,ops::select(upper,fx,
+                                          ops::select(halveB,
+                                                      ops::mul(half,fb),fb)));
+            ops::store(s.w1+i,ops::select(upper,plus,
+                                          ops::select(lower,minus,side)));
+            ops::store(s.root+i,ops::select(hit,x,ops::load(s.root+i)));
+            ops::store(s.done+i,ops::select(hit,one,d));
+          }
+        }
+      }
+      batchFinish(s,roots,count);
+    }
+
+    /**
+     * Brent's method on count <= BatchBlock brackets.
+     *
+     * Each lane keeps its best estimate b, a contrapoint a with the
+     * opposite sign, and the newest other evaluated point c.  The secant
+     * through b and c is taken if it falls between b and the midpoint of
+     * the bracket, and it is shorter than half the step before the last
+     * one; otherwise the lane bisects.  Steps are at least the
+     * tolerance, as in the scalar rootBrent.
+     */
+    template<typename T,class F>
+    inline void batchBrent(F& funct,
+                           const T* xl,
+                           const T* xu,
+                           T* roots,
+                           const size_t first,
+                           const size_t count,
+                           const T eps) {
+      typedef lane_ops<T> ops;
+      typedef typename ops::reg_type regType;
+      typedef typename ops::mask_type maskType;
+      const size_t lanes = ops::lanes;
+      const size_t end = ((count + lanes - 1)/lanes)*lanes;
+
+      batch_state<T> s;
+      if (batchStart(funct,xl,xu,first,count,s)) {
+        const regType zero = ops::set1(T(0)), one = ops::set1(T(1));
+        const regType half = ops::set1(T(0.5));
+        const regType rtol = ops::set1(T(2)*std::numeric_limits<T>::epsilon());
+        const regType atol = ops::set1(eps/T(2));
+        const regType inf  = ops::set1(std::numeric_limits<T>::infinity());
+
+        // b is the end with the smaller |f|, the first secant is through a
+        for (size_t i=0;i<end;i+=lanes) {
+          const regType a  = ops::load(s.a+i),  b  = ops::load(s.b+i);
+          const regType fa = ops::load(s.fa+i), fb = ops::load(s.fb+i);
+          const maskType swap = ops::lt(ops::abs(fa),ops::abs(fb));
+          ops::store(s.a+i,ops::select(swap,b,a));
+          ops::store(s.b+i,ops::select(swap,a,b));
+          ops::store(s.fa+i,ops::select(swap,fb,fa));
+          ops::store(s.fb+i,ops::select(swap,fa,fb));
+          ops::store(s.c+i,ops::select(swap,b,a));
+          ops::store(s.fc+i,ops::select(swap,fb,fa));
+          ops::store(s.w1+i,inf);
+          ops::store(s.w2+i,inf);
+        }
+
+        for (int it=batchIterations<T>();it>0;--it) {
+          bool open = false;
+          for (size_t i=0;i<end;i+=lanes) {
+            const regType a  = ops::load(s.a+i),  b  = ops::load(s.b+i);
+            const regType c  = ops::load(s.c+i);
+            const regType fb = ops::load(s.fb+i), fc = ops::load(s.fc+i);
+            const regType w1 = ops::load(s.w1+i), w2 = ops::load(s.w2+i);
+            const regType d  = ops::load(s.done+i);
+            const regType m = ops::mul(half,ops::add(a,b));
+            const regType width = ops::abs(ops::sub(b,a));
+            const regType tol = ops::add(ops::mul(rtol,ops::abs(b)),atol);
+            const maskType fin =
+              ops::mandn(ops::le(width,ops::add(tol,tol)),ops::lt(zero,d));
+            const regType done = ops::select(fin,one,d);
+            const maskType active = ops::eq(done,zero);
+            ops::store(s.root+i,ops::select(fin,b,ops::load(s.root+i)));
+            ops::store(s.done+i,done);
+
+            // secant, rejected if NaN, outside [b,m), or too slow
+            const regType r =
+              ops::sub(b,ops::div(ops::mul(fb,ops::sub(b,c)),ops::sub(fb,fc)));
+            const maskType take =
+              ops::mand(ops::le(ops::mul(ops::sub(r,b),ops::sub(r,m)),zero),
+                        ops::lt(ops::abs(ops::sub(r,b)),ops::mul(half,w2)));
+            regType x = ops::select(take,r,m);
+            x = ops::select(ops::lt(ops::abs(ops::sub(x,b)),tol),
+                            ops::select(ops::lt(m,b),
+                                        ops::sub(b,tol),ops::add(b,tol)),
+                            x);
+            ops::store(s.x+i,ops::select(active,x,b));
+            ops::store(s.w2+i,ops::select(active,w1,w2));
+            ops::store(s.w1+i,ops::select(active,ops::abs(ops::sub(x,b)),w1));
+            open = open || !ops::all(ops::lt(zero,done));
+          }
+          if (!open) {
+            break;
+          }
+
+          funct(static_cast<const T*>(s.x),s.fx,first,count);
+
+          for (size_t i=0;i<end;i+=lanes) {
+            const regType a  = ops::load(s.a+i),  b  = ops::load(s.b+i);
+            const regType c  = ops::load(s.c+i);
+            const regType fa = ops::load(s.fa+i), fb = ops::load(s.fb+i);
+            const regType fc = ops::load(s.fc+i);
+            const regType x  = ops::load(s.x+i),  fx = ops::load(s.fx+i);
+            const regType d  = ops::load(s.done+i);
+            const maskType active = ops::eq(d,zero);
+            const maskType hit  = ops::mand(active,ops::eq(fx,zero));
+            const maskType step = ops::mandn(active,hit);
+
+            // the old best becomes the contrapoint if f(x) has f(a)'s sign
+            const maskType keep = oppositeSigns<T>(fa,fx);
+            const regType na  = ops::select(keep,a,b);
+            const regType nfa = ops::select(keep,fa,fb);
+            const maskType swap = ops::lt(ops::abs(nfa),ops::abs(fx));
+            ops::store(s.a+i,ops::select(step,ops::select(swap,x,na),a));
+            ops::store(s.fa+i,ops::select(step,ops::select(swap,fx,nfa),fa));
+            ops::store(s.b+i,ops::select(step,ops::select(swap,na,x),b));
+            ops::store(s.fb+i,ops::select(step,ops::select(swap,nfa,fx),fb));
+            // the next secant goes through the two newest points
+            ops::store(s.c+i,ops::select(step,ops::select(swap,x,b),c));
+            ops::store(s.fc+i,ops::select(step,ops::select(swap,fx,fb),fc));
+            ops::store(s.root+i,ops::select(hit,x,ops::load(s.root+i)));
+            ops::store(s.done+i,ops::select(hit,one,d));
+          }
+        }
+      }
+      batchFinish(s,roots,count);
+    }
+
+    /// Roots of count <= BatchBlock equations with the given method
+    template<typename T,class F>
+    inline void batchRoots(const BatchRoot method,
+                           F& funct,
+                           const T* xl,
+                           const T* xu,
+                           T* roots,
+                           const size_t first,
+                           const size_t count,
+                           const T eps) {
+      switch (method) {
+      case BatchRoot::Bisection:
+        batchBisection(funct,xl,xu,roots,first,count,eps);
+        break;
+      case BatchRoot::RegulaFalsi:
+        batchRegulaFalsi(funct,xl,xu,roots,first,count,eps);
+        break;
+      default:
+        batchBrent(funct,xl,xu,roots,first,count,eps);
+      }
+    }
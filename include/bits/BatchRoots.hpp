@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date:   10.02.2018
+ */
+
+#ifndef ANPI_BATCH_ROOTS_HPP
+#define ANPI_BATCH_ROOTS_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+namespace anpi
+{
+  /// Methods of the batched root finders (see RootBatch.hpp)
+  enum class BatchRoot {
+    Bisection,   ///< Halves all brackets, one bit per iteration
+    RegulaFalsi, ///< False position, with the Illinois modification
+    Brent        ///< Secant steps safeguarded by bisection
+  };
+
+  namespace bits {
+    /// Equations solved together, sharing each call to the function
+    static const size_t BatchBlock = 256;
+  } // namespace bits
+
+  namespace fallback {
+    /**
+     * Lane primitives of the batched root finders with a single lane:
+     * the registers are plain values and the masks plain booleans.
+     */
+    template<typename T>
+    struct lane_ops {
+      typedef T    reg_type;
+      typedef bool mask_type;
+      static constexpr size_t lanes = 1;
+
+      static inline reg_type load(const T* p)               { return *p; }
+      static inline void store(T* p,const reg_type a)       { *p = a; }
+      static inline reg_type set1(const T v)                { return v; }
+      static inline reg_type add(const reg_type a,const reg_type b) {
+        return a+b;
+      }
+      static inline reg_type sub(const reg_type a,const reg_type b) {
+        return a-b;
+      }
+      static inline reg_type mul(const reg_type a,const reg_type b) {
+        return a*b;
+      }
+      static inline reg_type div(const reg_type a,const reg_type b) {
+        return a/b;
+      }
+      static inline reg_type abs(const reg_type a)    { return std::abs(a); }
+      static inline mask_type lt(const reg_type a,const reg_type b) {
+        return a < b;
+      }
+      static inline mask_type le(const reg_type a,const reg_type b) {
+        return a <= b;
+      }
+      static inline mask_type eq(const reg_type a,const reg_type b) {
+        return a == b;
+      }
+      static inline mask_type mand(const mask_type a,const mask_type b) {
+        return a && b;
+      }
+      static inline mask_type mor(const mask_type a,const mask_type b) {
+        return a || b;
+      }
+      /// a and not b
+      static inline mask_type mandn(const mask_type a,const mask_type b) {
+        return a && !b;
+      }
+      static inline bool all(const mask_type m)             { return m; }
+      /// m ? a : b
+      static inline reg_type select(const mask_type m,
+                                    const reg_type a,const reg_type b) {
+        return m ? a : b;
+      }
+    };
+
+#   include "BatchRootSteps.hpp"
+  } // namespace fallback
+} // namespace anpi
+
+#endif
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date:   14.01.2018
+ */
+
+#ifndef ANPI_COMPARISON_HPP
+#define ANPI_COMPARISON_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace anpi
+{
+  namespace bits {
+    /**
+     * Integer with the same bits as a floating point value, remapped so
+     * that consecutive representable values map to consecutive
+     * integers; both zeros map to 0.  The distance between two such
+     * integers is the number of units in the last place (ULP) between
+     * the values.
+     */
+    inline std::int64_t ulpOrder(const double v) {
+      std::int64_t i;
+      std::memcpy(&i,&v,sizeof(i));
+      return (i < 0) ? std::numeric_limits<std::int64_t>::min() - i : i;
+    }
+
+    /// Remapping of the bits of a float, see ulpOrder(double)
+    inline std::int32_t ulpOrder(const float v) {
+      std::int32_t i;
+      std::memcpy(&i,&v,sizeof(i));
+      return (i < 0) ? std::numeric_limits<std::int32_t>::min() - i : i;
+    }
+
+    /// Distance in ULP between two values, the maximum if any is NaN
+    template<typename T>
+    inline std::uint64_t ulpDistance(const T a,const T b) {
+      if (std::isnan(a) || std::isnan(b)) {
+        return std::numeric_limits<std::uint64_t>::max();
+      }
+      const auto ia = ulpOrder(a);
+      const auto ib = ulpOrder(b);
+      // the unsigned difference is exact even if the signed one overflows
+      return (ia > ib) ? std::uint64_t(ia) - std::uint64_t(ib)
+                       : std::uint64_t(ib) - std::uint64_t(ia);
+    }
+  } // namespace bits
+
+  namespace fallback {
+    /*
+     * Comparisons
+     *
+     * The kernels work on n contiguous entries, usually one matrix row,
+     * and return as soon as the answer is known.
+     */
+
+    /// Whether the n entries at a and b have the same bits
+    template<typename T>
+    inline bool sameBits(const T* a,const T* b,const size_t n) {
+      return std::memcmp(a,b,n*sizeof(T)) == 0;
+    }
+
+    /**
+     * Whether |a[i]-b[i]| <= atol + rtol*|b[i]| for all n entries.
+     *
+     * Equal values, including infinities of equal sign, are always
+     * close; an infinite b[i] is close only to itself, and NaN is
+     * never close to anything.
+     */
+    template<typename T>
+    inline bool allclose(const T* a,
+                         const T* b,
+                         const size_t n,
+                         const T rtol,
+                         const T atol) {
+      using std::abs;
+      typedef decltype(abs(*b)) mag_type;
+      const mag_type big = std::numeric_limits<mag_type>::max();
+      for (size_t i=0;i<n;++i) {
+        // an infinite b[i] makes the bound infinite: only equality counts
+        if ( !(a[i] == b[i]) &&
+             !(abs(b[i]) <= big &&
+               abs(a[i]-b[i]) <= atol + rtol*abs(b[i])) ) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    /**
+     * Largest distance in ULP between the n entries at a and b.
+     *
+     * Returns the largest std::uint64_t as soon as a NaN is found.
+     */
+    template<typename T>
+    inline std::uint64_t maxUlp(const T* a,const T* b,const size_t n) {
+      std::uint64_t d = 0;
+      for (size_t i=0;i<n;++i) {
+        const std::uint64_t di = bits::ulpDistance(a[i],b[i]);
+        if (di == std::numeric_limits<std::uint64_t>::max()) {
+          return di;
+        }
+        d = (di > d) ? di : d;
+      }
+      return d;
+    }
+  } // namespace fallback
+} // namespace anpi
+
+#endif
@@ -12,57 +12,133 @@
 #define ANPI_MATRIX_ARITHMETIC_HPP
 
 #include "Intrinsics.hpp"
+#include "Parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <complex>
 #include <type_traits>
 
 namespace anpi
 {
+  namespace bits {
+    /// Complex conjugate, without changing the type of real values
+    template<typename T>
+    inline T conjugate(const T& x) { return x; }
+
+    /// Complex conjugate
+    template<typename R>
+    inline std::complex<R> conjugate(const std::complex<R>& z) {
+      return std::conj(z);
+    }
+  } // namespace bits
+
   namespace fallback {
     /*
-     * Sum
+     * Generic elementwise loops.
+     *
+     * The operator op is called for each entry, including the padding.
+     * Large matrices are split among threads by rows (see Parallel.hpp).
      */
 
-    // Fallback implementation
-    
-    // In-copy implementation c=a+b
+    /// Granularity of the thread chunks, in entries
     template<typename T,class Alloc>
-    inline void add(const Matrix<T,Alloc>& a,
-                    const Matrix<T,Alloc>& b,
-                    Matrix<T,Alloc>& c) {
+    inline size_t grain(const size_t dcols) {
+      return extract_alignment<Alloc>::row_aligned
+        ? std::max<size_t>(1,dcols)
+        : std::max<size_t>(1,parallel::CacheLine/sizeof(T));
+    }
+
+    // On-copy implementation c=op(a)
+    template<typename T,class Alloc,class Op>
+    inline void unary(const Matrix<T,Alloc>& a,
+                      Matrix<T,Alloc>& c,
+                      const Op& op) {
+
+      const size_t tentries = a.rows()*a.dcols();
+      c.allocate(a.rows(),a.cols());
+
+      T* here       = c.data();
+      const T* aptr = a.data();
+
+      parallel::forChunks(tentries,grain<T,Alloc>(a.dcols()),tentries,
+                          [&](const size_t begin,const size_t end) {
+        for (size_t i=begin;i<end;++i) {
+          here[i] = op(aptr[i]);
+        }
+      });
+    }
+
+    // On-copy implementation c=op(a,b)
+    template<typename T,class Alloc,class Op>
+    inline void binary(const Matrix<T,Alloc>& a,
+                       const Matrix<T,Alloc>& b,
+                       Matrix<T,Alloc>& c,
+                       const Op& op) {
 
       assert( (a.rows() == b.rows()) &&
               (a.cols() == b.cols()) );
 
       const size_t tentries = a.rows()*a.dcols();
       c.allocate(a.rows(),a.cols());
-      
-      T* here        = c.data();
-      T *const end   = here + tentries;
+
+      T* here       = c.data();
       const T* aptr = a.data();
       const T* bptr = b.data();
 
-      for (;here!=end;) {
-        *here++ = *aptr++ + *bptr++;
-      }
+      parallel::forChunks(tentries,grain<T,Alloc>(a.dcols()),tentries,
+                          [&](const size_t begin,const size_t end) {
+        for (size_t i=begin;i<end;++i) {
+          here[i] = op(aptr[i],bptr[i]);
+        }
+      });
     }
 
-    // In-place implementation a = a+b
-    template<typename T,class Alloc>
-    inline void add(Matrix<T,Alloc>& a,
-                    const Matrix<T,Alloc>& b) {
+    // On-copy implementation d=op(a,b,c)
+    template<typename T,class Alloc,class Op>
+    inline void ternary(const Matrix<T,Alloc>& a,
+                        const Matrix<T,Alloc>& b,
+                        const Matrix<T,Alloc>& c,
+                        Matrix<T,Alloc>& d,
+                        const Op& op) {
 
-      assert( (a.rows() == b.rows()) &&
-              (a.cols() == b.cols()) );
+      assert( (a.rows() == b.rows()) && (a.cols() == b.cols()) &&
+              (a.rows() == c.rows()) && (a.cols() == c.cols()) );
 
       const size_t tentries = a.rows()*a.dcols();
-      
-      T* here        = a.data();
-      T *const end   = here + tentries;
-      
+      d.allocate(a.rows(),a.cols());
+
+      T* here       = d.data();
+      const T* aptr = a.data();
       const T* bptr = b.data();
+      const T* cptr = c.data();
 
-      for (;here!=end;) {
-        *here++ += *bptr++;
-      }
+      parallel::forChunks(tentries,grain<T,Alloc>(a.dcols()),tentries,
+                          [&](const size_t begin,const size_t end) {
+        for (size_t i=begin;i<end;++i) {
+          here[i] = op(aptr[i],bptr[i],cptr[i]);
+        }
+      });
+    }
+
+    /*
+     * Sum
+     */
+
+    // Fallback implementation
+    
+    // In-copy implementation c=a+b
+    template<typename T,class Alloc>
+    inline void add(const Matrix<T,Alloc>& a,
+                    const Matrix<T,Alloc>& b,
+                    Matrix<T,Alloc>& c) {
+      binary(a,b,c,[](const T x,const T y) { return x+y; });
+    }
+
+    // In-place implementation a = a+b
+    template<typename T,class Alloc>
+    inline void add(Matrix<T,Alloc>& a,
+                    const Matrix<T,Alloc>& b) {
+      add(a,b,a);
     }
 
 
@@ -77,326 +153,429 @@ namespace anpi
     inline void subtract(const Matrix<T,Alloc>& a,
                          const Matrix<T,Alloc>& b,
                          Matrix<T,Alloc>& c) {
+      binary(a,b,c,[](const T x,const T y) { return x-y; });
+    }
 
-      assert( (a.rows() == b.rows()) &&
-              (a.cols() == b.cols()) );
+    // In-place implementation a = a-b
+    template<typename T,class Alloc>
+    inline void subtract(Matrix<T,Alloc>& a,
+                         const Matrix<T,Alloc>& b) {
+      subtract(a,b,a);
+    }
 
-      const size_t tentries = a.rows()*a.dcols();
-      c.allocate(a.rows(),a.cols());
-      
-      T* here        = c.data();
-      T *const end   = here + tentries;
-      const T* aptr = a.data();
-      const T* bptr = b.data();
+    /*
+     * Elementwise (Hadamard) product
+     */
 
-      for (;here!=end;) {
-        *here++ = *aptr++ - *bptr++;
-      }
+    // On-copy implementation c=a.*b
+    template<typename T,class Alloc>
+    inline void hadamard(const Matrix<T,Alloc>& a,
+                         const Matrix<T,Alloc>& b,
+                         Matrix<T,Alloc>& c) {
+      binary(a,b,c,[](const T x,const T y) { return x*y; });
     }
 
-    // In-place implementation a = a-b
+    // In-place implementation a = a.*b
     template<typename T,class Alloc>
-    inline void subtract(Matrix<T,Alloc>& a,
+    inline void hadamard(Matrix<T,Alloc>& a,
                          const Matrix<T,Alloc>& b) {
+      hadamard(a,b,a);
+    }
+
+    /*
+     * Elementwise division
+     */
+
+    // On-copy implementation c=a./b
+    template<typename T,class Alloc>
+    inline void divide(const Matrix<T,Alloc>& a,
+                       const Matrix<T,Alloc>& b,
+                       Matrix<T,Alloc>& c) {
 
       assert( (a.rows() == b.rows()) &&
               (a.cols() == b.cols()) );
-      
-      const size_t tentries = a.rows()*a.dcols();
-      
-      T* here        = a.data();
-      T *const end   = here + tentries;
-      
-      const T* bptr = b.data();
 
-      for (;here!=end;) {
-        *here++ -= *bptr++;
-      }
-    }
+      c.allocate(a.rows(),a.cols());
 
-  } // namespace fallback
+      // the padding is skipped, as it may hold zeros (think of integers)
+      parallel::forChunks(a.rows(),1,a.rows()*a.dcols(),
+                          [&](const size_t begin,const size_t end) {
+        for (size_t i=begin;i<end;++i) {
+          T* here        = c[i];
+          T *const last  = here + a.cols();
+          const T* aptr = a[i];
+          const T* bptr = b[i];
 
+          for (;here!=last;) {
+            *here++ = *aptr++ / *bptr++;
+          }
+        }
+      });
+    }
+
+    // In-place implementation a = a./b
+    template<typename T,class Alloc>
+    inline void divide(Matrix<T,Alloc>& a,
+                       const Matrix<T,Alloc>& b) {
+      divide(a,b,a);
+    }
 
-  namespace simd
-  {
     /*
-     * Sum
+     * Scaling
      */
 
+    // On-copy implementation c=alpha*a
+    template<typename T,class Alloc>
+    inline void scale(const Matrix<T,Alloc>& a,
+                      const T alpha,
+                      Matrix<T,Alloc>& c) {
+      unary(a,c,[alpha](const T x) { return alpha*x; });
+    }
+
+    // In-place implementation a = alpha*a
+    template<typename T,class Alloc>
+    inline void scale(Matrix<T,Alloc>& a,
+                      const T alpha) {
+      scale(a,alpha,a);
+    }
+
     /*
-     * The following code exemplifies how to manually accelerate code using
-     * SIMD instructions.  However, for the simple element-wise algorithms
-     * like sum or subtraction, modern compilers can automatically vectorize
-     * the code, as the benchmarks show.
+     * Scaled sum (BLAS axpy)
      */
 
+    // On-copy implementation z=alpha*x+y
+    template<typename T,class Alloc>
+    inline void axpy(const T alpha,
+                     const Matrix<T,Alloc>& x,
+                     const Matrix<T,Alloc>& y,
+                     Matrix<T,Alloc>& z) {
+      binary(x,y,z,[alpha](const T u,const T v) { return alpha*u+v; });
+    }
 
-    /// We wrap the intrinsics methods to be polymorphic versions
-    template<typename T,class regType>
-    regType mm_add(regType,regType); // We don't implement this to cause, at
-                                     // least, a linker error if this version is
-                                     // used.
-    //{
-    // Generic function should never be called.
-    // If it is called, then some SIMD chaos is going on...
-    
-    // A way to cause a compile time error would be better
-    // throw std::bad_function_call();
-    // return regType();
-    //}
-    
-#ifdef __AVX512F__
-    template<>
-    inline __m512d __attribute__((__always_inline__))
-    mm_add<double>(__m512d a,__m512d b) {
-      return _mm512_add_pd(a,b);
-    }
-    template<>
-    inline __m512 __attribute__((__always_inline__))
-    mm_add<float>(__m512 a,__m512 b) {
-      return _mm512_add_ps(a,b);
-    }
-    template<>
-    inline __m512i __attribute__((__always_inline__))
-    mm_add<uint64_t>(__m512i a,__m512i b) {
-      return _mm512_add_epi64(a,b);
-    }
-    template<>
-    inline __m512i __attribute__((__always_inline__))
-    mm_add<int64_t>(__m512i a,__m512i b) {
-      return _mm512_add_epi64(a,b);
-    }
-    template<>
-    inline __m512i __attribute__((__always_inline__))
-    mm_add<uint32_t>(__m512i a,__m512i b) {
-      return _mm512_add_epi32(a,b);
-    }
-    template<>
-    inline __m512i __attribute__((__always_inline__))
-    mm_add<int32_t>(__m512i a,__m512i b) {
-      return _mm512_add_epi32(a,b);
-    }
-    template<>
-    inline __m512i __attribute__((__always_inline__))
-    mm_add<uint16_t>(__m512i a,__m512i b) {
-      return _mm512_add_epi16(a,b);
-    }
-    template<>
-    inline __m512i __attribute__((__always_inline__))
-    mm_add<int16_t>(__m512i a,__m512i b) {
-      return _mm512_add_epi16(a,b);
-    }
-    template<>
-    inline __m512i __attribute__((__always_inline__))
-    mm_add<uint8_t>(__m512i a,__m512i b) {
-      return _mm512_add_epi8(a,b);
-    }
-    template<>
-    inline __m512i __attribute__((__always_inline__))
-    mm_add<int8_t>(__m512i a,__m512i b) {
-      return _mm512_add_epi8(a,b);
-    }
-#elif defined __AVX__
-    template<>
-    inline __m256d __attribute__((__always_inline__))
-    mm_add<double>(__m256d a,__m256d b) {
-      return _mm256_add_pd(a,b);
-    }
-    template<>
-    inline __m256 __attribute__((__always_inline__))
-    mm_add<float>(__m256 a,__m256 b) {
-      return _mm256_add_ps(a,b);
-    }
-    template<>
-    inline __m256i __attribute__((__always_inline__))
-    mm_add<uint64_t>(__m256i a,__m256i b) {
-      return _mm256_add_epi64(a,b);
-    }
-    template<>
-    inline __m256i __attribute__((__always_inline__))
-    mm_add<int64_t>(__m256i a,__m256i b) {
-      return _mm256_add_epi64(a,b);
-    }
-    template<>
-    inline __m256i __attribute__((__always_inline__))
-    mm_add<uint32_t>(__m256i a,__m256i b) {
-      return _mm256_add_epi32(a,b);
-    }
-    template<>
-    inline __m256i __attribute__((__always_inline__))
-    mm_add<int32_t>(__m256i a,__m256i b) {
-      return _mm256_add_epi32(a,b);
-    }
-    template<>
-    inline __m256i __attribute__((__always_inline__))
-    mm_add<uint16_t>(__m256i a,__m256i b) {
-      return _mm256_add_epi16(a,b);
-    }
-    template<>
-    inline __m256i __attribute__((__always_inline__))
-    mm_add<int16_t>(__m256i a,__m256i b) {
-      return _mm256_add_epi16(a,b);
-    }
-    template<>
-    inline __m256i __attribute__((__always_inline__))
-    mm_add<uint8_t>(__m256i a,__m256i b) {
-      return _mm256_add_epi8(a,b);
-    }
-    template<>
-    inline __m256i __attribute__((__always_inline__))
-    mm_add<int8_t>(__m256i a,__m256i b) {
-      return _mm256_add_epi8(a,b);
-    }
-#elif  defined __SSE2__
-    template<>
-    inline __m128d __attribute__((__always_inline__))
-    mm_add<double>(__m128d a,__m128d b) {
-      return _mm_add_pd(a,b);
-    }
-    template<>
-    inline __m128 __attribute__((__always_inline__))
-    mm_add<float>(__m128 a,__m128 b) {
-      return _mm_add_ps(a,b);
-    }
-    template<>
-    inline __m128i __attribute__((__always_inline__))
-    mm_add<std::uint64_t>(__m128i a,__m128i b) {
-      return _mm_add_epi64(a,b);
-    }
-    template<>
-    inline __m128i __attribute__((__always_inline__))
-    mm_add<std::int64_t>(__m128i a,__m128i b) {
-      return _mm_add_epi64(a,b);
-    }
-    template<>
-    inline __m128i __attribute__((__always_inline__))
-    mm_add<std::uint32_t>(__m128i a,__m128i b) {
-      return _mm_add_epi32(a,b);
-    }
-    template<>
-    inline __m128i __attribute__((__always_inline__))
-    mm_add<std::int32_t>(__m128i a,__m128i b) {
-      return _mm_add_epi16(a,b);
-    }
-    template<>
-    inline __m128i __attribute__((__always_inline__))
-    mm_add<std::uint16_t>(__m128i a,__m128i b) {
-      return _mm_add_epi16(a,b);
-    }
-    template<>
-    inline __m128i __attribute__((__always_inline__))
-    mm_add<std::int16_t>(__m128i a,__m128i b) {
-      return _mm_add_epi32(a,b);
-    }
-    template<>
-    inline __m128i __attribute__((__always_inline__))
-    mm_add<std::uint8_t>(__m128i a,__m128i b) {
-      return _mm_add_epi16(a,b);
-    }
-    template<>
-    inline __m128i __attribute__((__always_inline__))
-    mm_add<std::int8_t>(__m128i a,__m128i b) {
-      return _mm_add_epi32(a,b);
+    // In-place implementation y = alpha*x+y
+    template<typename T,class Alloc>
+    inline void axpy(const T alpha,
+                     const Matrix<T,Alloc>& x,
+                     Matrix<T,Alloc>& y) {
+      axpy(alpha,x,y,y);
     }
-#endif
-    
-    // On-copy implementation c=a+b
-    template<typename T,class Alloc,typename regType>
-    inline void addSIMD(const Matrix<T,Alloc>& a, 
-                        const Matrix<T,Alloc>& b,
-                        Matrix<T,Alloc>& c) {
-
-      // This method is instantiated with unaligned allocators.  We
-      // allow the instantiation although externally this is never
-      // called unaligned
-      static_assert(!extract_alignment<Alloc>::aligned ||
-		    (extract_alignment<Alloc>::value >= sizeof(regType)),
-		    "Insufficient alignment for the registers used");
-      
-      const size_t tentries = a.rows()*a.dcols();
-      c.allocate(a.rows(),a.cols());
 
-      regType* here        = reinterpret_cast<regType*>(c.data());
-      const size_t  blocks = ( tentries*sizeof(T) + (sizeof(regType)-1) )/
-        sizeof(regType);
-      regType *const end   = here + blocks;
-      const regType* aptr  = reinterpret_cast<const regType*>(a.data());
-      const regType* bptr  = reinterpret_cast<const regType*>(b.data());
-      
-      for (;here!=end;) {
-        *here++ = mm_add<T>(*aptr++,*bptr++);
-      }
-      
+    /*
+     * Elementwise fused multiply-add
+     */
+
+    // On-copy implementation d=a.*b+c
+    template<typename T,class Alloc>
+    inline void fma(const Matrix<T,Alloc>& a,
+                    const Matrix<T,Alloc>& b,
+                    const Matrix<T,Alloc>& c,
+                    Matrix<T,Alloc>& d) {
+      ternary(a,b,c,d,[](const T x,const T y,const T z) { return x*y+z; });
     }
-       
-    // On-copy implementation c=a+b for SIMD-capable types
-    template<typename T,
-	     class Alloc,
-	     typename std::enable_if<is_simd_type<T>::value,int>::type=0>
-    inline void add(const Matrix<T,Alloc>& a,
+
+    // In-place implementation a = a.*b+c
+    template<typename T,class Alloc>
+    inline void fma(Matrix<T,Alloc>& a,
                     const Matrix<T,Alloc>& b,
-                    Matrix<T,Alloc>& c) {
+                    const Matrix<T,Alloc>& c) {
+      fma(a,b,c,a);
+    }
 
-      assert( (a.rows() == b.rows()) &&
-              (a.cols() == b.cols()) );
+    /*
+     * Elementwise loops on views.
+     *
+     * Views have no padding and their rows may start anywhere, so they
+     * are traversed row by row, splitting the rows among threads.  The
+     * destination must already have the size of the operands.
+     */
 
+    // On-copy implementation c=op(a)
+    template<typename T,class Op>
+    inline void unary(const ConstMatrixView<T>& a,
+                      const MatrixView<T>& c,
+                      const Op& op) {
+
+      assert( (a.rows() == c.rows()) &&
+              (a.cols() == c.cols()) );
+
+      const size_t cols = a.cols();
+      parallel::forChunks(a.rows(),1,a.entries(),
+                          [&](const size_t begin,const size_t end) {
+        for (size_t r=begin;r<end;++r) {
+          const T* aptr = a[r];
+          T* here       = c[r];
+          for (size_t j=0;j<cols;++j) {
+            here[j] = op(aptr[j]);
+          }
+        }
+      });
+    }
+
+    // On-copy implementation c=op(a,b)
+    template<typename T,class Op>
+    inline void binary(const ConstMatrixView<T>& a,
+                       const ConstMatrixView<T>& b,
+                       const MatrixView<T>& c,
+                       const Op& op) {
+
+      assert( (a.rows() == b.rows()) && (a.cols() == b.cols()) &&
+              (a.rows() == c.rows()) && (a.cols() == c.cols()) );
+
+      const size_t cols = a.cols();
+      parallel::forChunks(a.rows(),1,a.entries(),
+                          [&](const size_t begin,const size_t end) {
+        for (size_t r=begin;r<end;++r) {
+          const T* aptr = a[r];
+          const T* bptr = b[r];
+          T* here       = c[r];
+          for (size_t j=0;j<cols;++j) {
+            here[j] = op(aptr[j],bptr[j]);
+          }
+        }
+      });
+    }
+
+    // On-copy implementation d=op(a,b,c)
+    template<typename T,class Op>
+    inline void ternary(const ConstMatrixView<T>& a,
+                        const ConstMatrixView<T>& b,
+                        const ConstMatrixView<T>& c,
+                        const MatrixView<T>& d,
+                        const Op& op) {
+
+      assert( (a.rows() == b.rows()) && (a.cols() == b.cols()) &&
+              (a.rows() == c.rows()) && (a.cols() == c.cols()) &&
+              (a.rows() == d.rows()) && (a.cols() == d.cols()) );
+
+      const size_t cols = a.cols();
+      parallel::forChunks(a.rows(),1,a.entries(),
+                          [&](const size_t begin,const size_t end) {
+        for (size_t r=begin;r<end;++r) {
+          const T* aptr = a[r];
+          const T* bptr = b[r];
+          const T* cptr = c[r];
+          T* here       = d[r];
+          for (size_t j=0;j<cols;++j) {
+            here[j] = op(aptr[j],bptr[j],cptr[j]);
+          }
+        }
+      });
+    }
+
+    // On-copy implementation c=a+b on views
+    template<typename T>
+    inline void add(const ConstMatrixView<T>& a,
+                    const ConstMatrixView<T>& b,
+                    const MatrixView<T>& c) {
+      binary(a,b,c,[](const T x,const T y) { return x+y; });
+    }
+
+    // In-place implementation a = a+b on views
+    template<typename T>
+    inline void add(const MatrixView<T>& a,
+                    const ConstMatrixView<T>& b) {
+      add(a,b,a);
+    }
 
-      if (is_aligned_alloc<Alloc>::value) {        
-#ifdef __AVX512F__
-        addSIMD<T,Alloc,typename avx512_traits<T>::reg_type>(a,b,c);
-#elif  __AVX__
-        addSIMD<T,Alloc,typename avx_traits<T>::reg_type>(a,b,c);
-#elif  __SSE2__
-        addSIMD<T,Alloc,typename sse2_traits<T>::reg_type>(a,b,c);
-#else
-        ::anpi::fallback::add(a,b,c);
-#endif
-      } else { // allocator seems to be unaligned
-        ::anpi::fallback::add(a,b,c);
-      }
+    // On-copy implementation c=a-b on views
+    template<typename T>
+    inline void subtract(const ConstMatrixView<T>& a,
+                         const ConstMatrixView<T>& b,
+                         const MatrixView<T>& c) {
+      binary(a,b,c,[](const T x,const T y) { return x-y; });
     }
 
-    // Non-SIMD types such as complex
-    template<typename T,
-             class Alloc,
-             typename std::enable_if<!is_simd_type<T>::value,int>::type = 0>
-    inline void add(const Matrix<T,Alloc>& a,
-                    const Matrix<T,Alloc>& b,
-                    Matrix<T,Alloc>& c) {
-      
-      ::anpi::fallback::add(a,b,c);
+    // In-place implementation a = a-b on views
+    template<typename T>
+    inline void subtract(const MatrixView<T>& a,
+                         const ConstMatrixView<T>& b) {
+      subtract(a,b,a);
     }
 
-    // In-place implementation a = a+b
-    template<typename T,class Alloc>
-    inline void add(Matrix<T,Alloc>& a,
-                    const Matrix<T,Alloc>& b) {
+    // On-copy implementation c=a.*b on views
+    template<typename T>
+    inline void hadamard(const ConstMatrixView<T>& a,
+                         const ConstMatrixView<T>& b,
+                         const MatrixView<T>& c) {
+      binary(a,b,c,[](const T x,const T y) { return x*y; });
+    }
 
-      add(a,b,a);
+    // In-place implementation a = a.*b on views
+    template<typename T>
+    inline void hadamard(const MatrixView<T>& a,
+                         const ConstMatrixView<T>& b) {
+      hadamard(a,b,a);
+    }
+
+    // On-copy implementation c=a./b on views
+    template<typename T>
+    inline void divide(const ConstMatrixView<T>& a,
+                       const ConstMatrixView<T>& b,
+                       const MatrixView<T>& c) {
+      binary(a,b,c,[](const T x,const T y) { return x/y; });
+    }
+
+    // In-place implementation a = a./b on views
+    template<typename T>
+    inline void divide(const MatrixView<T>& a,
+                       const ConstMatrixView<T>& b) {
+      divide(a,b,a);
+    }
+
+    // On-copy implementation c=alpha*a on views
+    template<typename T>
+    inline void scale(const ConstMatrixView<T>& a,
+                      const T alpha,
+                      const MatrixView<T>& c) {
+      unary(a,c,[alpha](const T x) { return alpha*x; });
+    }
+
+    // In-place implementation a = alpha*a on views
+    template<typename T>
+    inline void scale(const MatrixView<T>& a,
+                      const T alpha) {
+      scale(a,alpha,a);
+    }
+
+    // On-copy implementation z=alpha*x+y on views
+    template<typename T>
+    inline void axpy(const T alpha,
+                     const ConstMatrixView<T>& x,
+                     const ConstMatrixView<T>& y,
+                     const MatrixView<T>& z) {
+      binary(x,y,z,[alpha](const T u,const T v) { return alpha*u+v; });
     }
 
+    // In-place implementation y = alpha*x+y on views
+    template<typename T>
+    inline void axpy(const T alpha,
+                     const ConstMatrixView<T>& x,
+                     const MatrixView<T>& y) {
+      axpy(alpha,x,y,y);
+    }
+
+    // On-copy implementation d=a.*b+c on views
+    template<typename T>
+    inline void fma(const ConstMatrixView<T>& a,
+                    const ConstMatrixView<T>& b,
+                    const ConstMatrixView<T>& c,
+                    const MatrixView<T>& d) {
+      ternary(a,b,c,d,[](const T x,const T y,const T z) { return x*y+z; });
+    }
+
+    // In-place implementation a = a.*b+c on views
+    template<typename T>
+    inline void fma(const MatrixView<T>& a,
+                    const ConstMatrixView<T>& b,
+                    const ConstMatrixView<T>& c) {
+      fma(a,b,c,a);
+    }
 
     /*
-     * Subtraction
+     * Complex conjugate and magnitude
      */
 
-    // Fall back implementations
-
-    // In-copy implementation c=a-b
+    // On-copy implementation c=conj(a)
     template<typename T,class Alloc>
-    inline void subtract(const Matrix<T,Alloc>& a,
-                         const Matrix<T,Alloc>& b,
-                         Matrix<T,Alloc>& c) {
-      ::anpi::fallback::subtract(a,b,c);
+    inline void conjugate(const Matrix<T,Alloc>& a,
+                          Matrix<T,Alloc>& c) {
+      unary(a,c,[](const T x) { return bits::conjugate(x); });
     }
 
-    // In-place implementation a = a-b
+    // In-place implementation a = conj(a)
     template<typename T,class Alloc>
-    inline void subtract(Matrix<T,Alloc>& a,
-                         const Matrix<T,Alloc>& b) {
+    inline void conjugate(Matrix<T,Alloc>& a) {
+      conjugate(a,a);
+    }
+
+    // Entrywise magnitude c=|a| of a complex matrix
+    template<typename R,class AllocA,class AllocC>
+    inline void magnitude(const Matrix<std::complex<R>,AllocA>& a,
+                          Matrix<R,AllocC>& c) {
+
+      c.allocate(a.rows(),a.cols());
 
-      ::anpi::fallback::subtract(a,b);
+      // the rows of a and c have different padding
+      parallel::forChunks(a.rows(),1,a.rows()*a.dcols(),
+                          [&](const size_t begin,const size_t end) {
+        for (size_t i=begin;i<end;++i) {
+          const std::complex<R>* aptr = a[i];
+          R* here = c[i];
+          for (size_t j=0;j<a.cols();++j) {
+            here[j] = std::abs(aptr[j]);
+          }
+        }
+      });
     }
+
+  } // namespace fallback
+
+
+  namespace simd
+  {
+    /*
+     * Lane-wise operators for the elementwise kernels.
+     *
+     * Each operator provides the scalar version through operator(), used
+     * by the fallback loops.  The register versions depend on the
+     * instruction set, and are provided by the overloads of apply() in
+     * SimdElementwise.hpp, together with op_traits<Op>::simd, which tells if
+     * they exist for T.
+     */
+
+    /// a+b
+    template<typename T>
+    struct add_op {
+      inline T operator()(const T a,const T b) const { return a+b; }
+    };
+
+    /// a-b
+    template<typename T>
+    struct sub_op {
+      inline T operator()(const T a,const T b) const { return a-b; }
+    };
+
+    /// a*b
+    template<typename T>
+    struct mul_op {
+      inline T operator()(const T a,const T b) const { return a*b; }
+    };
+
+    /// a/b
+    template<typename T>
+    struct div_op {
+      inline T operator()(const T a,const T b) const { return a/b; }
+    };
+
+    /// alpha*a
+    template<typename T>
+    struct scale_op {
+      const T alpha;
+      inline scale_op(const T _alpha) : alpha(_alpha) {}
+      inline T operator()(const T a) const { return alpha*a; }
+    };
+
+    /// y+alpha*x
+    template<typename T>
+    struct axpy_op {
+      const T alpha;
+      inline axpy_op(const T _alpha) : alpha(_alpha) {}
+      inline T operator()(const T y,const T x) const { return y+alpha*x; }
+    };
+
+    /// a*b+c
+    template<typename T>
+    struct fma_op {
+      inline T operator()(const T a,const T b,const T c) const {
+        return a*b+c;
+      }
+    };
+
+    /// conj(a), the identity for real types
+    template<typename T>
+    struct conj_op {
+      inline T operator()(const T a) const { return bits::conjugate(a); }
+    };
   } // namespace simd
 
 
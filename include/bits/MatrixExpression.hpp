@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date:   28.12.2017
+ */
+
+#ifndef ANPI_MATRIX_EXPRESSION_HPP
+#define ANPI_MATRIX_EXPRESSION_HPP
+
+#include "Intrinsics.hpp"
+#include <type_traits>
+
+namespace anpi
+{
+  /**
+   * Base class of all lazily evaluated matrix expressions.
+   *
+   * The sum or difference of matrices does not compute anything, but
+   * builds a small tree that refers to the operands.  The tree is
+   * evaluated in one single pass over the memory when it is assigned to
+   * a Matrix, used to construct one, or given to operator+= or
+   * operator-=.  Hence, a+b-c+d creates no temporary matrices.
+   *
+   * As the leaves hold references to the operand matrices, an expression
+   * must not outlive them: do not store it with auto.
+   */
+  template<class E,typename T,class Alloc>
+  class MatrixExpression {
+  public:
+    /// The concrete expression
+    inline const E& derived() const { return static_cast<const E&>(*this); }
+
+    /// Number of rows of the result
+    inline size_t rows() const { return derived().rows(); }
+
+    /// Number of columns of the result
+    inline size_t cols() const { return derived().cols(); }
+  };
+
+  namespace expr {
+
+    /**
+     * Leaf of an expression tree, which refers to an existing matrix
+     */
+    template<typename T,class Alloc>
+    class Leaf {
+      const Matrix<T,Alloc>& _m;
+    public:
+      explicit Leaf(const Matrix<T,Alloc>& m) : _m(m) {}
+
+      inline size_t rows()  const { return _m.rows(); }
+      inline size_t cols()  const { return _m.cols(); }
+      inline size_t dcols() const { return _m.dcols(); }
+
+      /// i-th entry of the buffer, including padding
+      inline T at(const size_t i) const { return _m.data()[i]; }
+
+      /// Buffer of the matrix, including padding
+      inline const T* data() const { return _m.data(); }
+    };
+
+    /**
+     * Interior node of an expression tree, applying the lane-wise
+     * operator Op to both subexpressions.
+     *
+     * Subexpressions are stored by value: they are cheap to copy, and
+     * in this way the temporary nodes of a chain are not referenced
+     * after they are destroyed.
+     */
+    template<class L,class R,class Op,typename T,class Alloc>
+    class Binary : public MatrixExpression<Binary<L,R,Op,T,Alloc>,T,Alloc> {
+      const L _l;
+      const R _r;
+      const Op _op;
+    public:
+      Binary(const L& l,const R& r) : _l(l),_r(r),_op() {
+        assert( (l.rows() == r.rows()) &&
+                (l.cols() == r.cols()) );
+      }
+
+      inline size_t rows()  const { return _l.rows(); }
+      inline size_t cols()  const { return _l.cols(); }
+      inline size_t dcols() const { return _l.dcols(); }
+
+      /// i-th entry of the result buffer
+      inline T at(const size_t i) const {
+        return _op(_l.at(i),_r.at(i));
+      }
+
+      /// Left subexpression
+      inline const L& left() const { return _l; }
+
+      /// Right subexpression
+      inline const R& right() const { return _r; }
+
+      /// Lane-wise operator applied to both subexpressions
+      inline const Op& op() const { return _op; }
+    };
+
+    /**
+     * Map the operands of an arithmetic operator to the type held in
+     * the expression tree.  Only matrices and expressions are valid.
+     */
+    template<class E>
+    struct operand {
+      static constexpr bool valid = false;
+    };
+
+    template<typename T,class Alloc>
+    struct operand< Matrix<T,Alloc> > {
+      static constexpr bool valid = true;
+      typedef T value_type;
+      typedef Alloc allocator_type;
+      typedef Leaf<T,Alloc> type;
+      static inline type wrap(const Matrix<T,Alloc>& m) { return type(m); }
+    };
+
+    template<class L,class R,class Op,typename T,class Alloc>
+    struct operand< Binary<L,R,Op,T,Alloc> > {
+      static constexpr bool valid = true;
+      typedef T value_type;
+      typedef Alloc allocator_type;
+      typedef Binary<L,R,Op,T,Alloc> type;
+      static inline const type& wrap(const type& e) { return e; }
+    };
+
+    /**
+     * Type of the node combining L and R with the operator Op.
+     *
+     * It is only defined if both operands are matrices or expressions
+     * with the same element type and allocator, so that the arithmetic
+     * operators are removed by SFINAE for any other type.
+     */
+    template<class L,class R,template<typename> class Op,
+             bool = operand<L>::valid && operand<R>::valid>
+    struct binary_result { };
+
+    template<class L,class R,template<typename> class Op>
+    struct binary_result<L,R,Op,true>
+      : public std::enable_if<
+          std::is_same<typename operand<L>::value_type,
+                       typename operand<R>::value_type>::value &&
+          std::is_same<typename operand<L>::allocator_type,
+                       typename operand<R>::allocator_type>::value,
+          Binary<typename operand<L>::type,
+                 typename operand<R>::type,
+                 Op<typename operand<L>::value_type>,
+                 typename operand<L>::value_type,
+                 typename operand<L>::allocator_type> > {
+    };
+
+  } // namespace expr
+
+  namespace fallback {
+    // Materialize the expression e into c
+    template<typename T,class Alloc,class E>
+    inline void evaluate(const MatrixExpression<E,T,Alloc>& e,
+                         Matrix<T,Alloc>& c) {
+
+      const E& ex = e.derived();
+      const size_t tentries = ex.rows()*ex.dcols();
+
+      // if c is a leaf of e, it already has the right size and is not
+      // reallocated.  Each entry is read before it is written.
+      c.allocate(ex.rows(),ex.cols());
+
+      T* here = c.data();
+      parallel::forChunks(tentries,grain<T,Alloc>(ex.dcols()),tentries,
+                          [&](const size_t begin,const size_t end) {
+        for (size_t i=begin;i<end;++i) {
+          here[i] = ex.at(i);
+        }
+      });
+    }
+  } // namespace fallback
+
+  /**
+   * Lazy sum of two matrices or matrix expressions
+   */
+  template<class L,class R>
+  inline typename expr::binary_result<L,R,simd::add_op>::type
+  operator+(const L& a,const R& b) {
+    typedef typename expr::binary_result<L,R,simd::add_op>::type node;
+    return node(expr::operand<L>::wrap(a),expr::operand<R>::wrap(b));
+  }
+
+  /**
+   * Lazy difference of two matrices or matrix expressions
+   */
+  template<class L,class R>
+  inline typename expr::binary_result<L,R,simd::sub_op>::type
+  operator-(const L& a,const R& b) {
+    typedef typename expr::binary_result<L,R,simd::sub_op>::type node;
+    return node(expr::operand<L>::wrap(a),expr::operand<R>::wrap(b));
+  }
+
+} // namespace anpi
+
+#endif
@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date:   28.12.2017
+ */
+
+#ifndef ANPI_MATRIX_FILE_HEADER_HPP
+#define ANPI_MATRIX_FILE_HEADER_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <complex>
+#include <limits>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "Exception.hpp"
+
+namespace anpi {
+
+  /**
+   * Tags of the element types stored in matrix files
+   */
+  enum class ElementType : std::uint32_t {
+    Unknown       =  0, ///< Any other trivially copyable type
+    Int8          =  1,
+    UInt8         =  2,
+    Int16         =  3,
+    UInt16        =  4,
+    Int32         =  5,
+    UInt32        =  6,
+    Int64         =  7,
+    UInt64        =  8,
+    Float         =  9,
+    Double        = 10,
+    ComplexFloat  = 11,
+    ComplexDouble = 12
+  };
+
+  /// Tag of the element type T
+  template<typename T>
+  struct element_type {
+    static constexpr ElementType value = ElementType::Unknown;
+  };
+
+# define ANPI_ELEMENT_TYPE(type,tag)                         \
+  template<>                                                 \
+  struct element_type<type> {                                \
+    static constexpr ElementType value = ElementType::tag;   \
+  };
+
+  ANPI_ELEMENT_TYPE(std::int8_t,Int8)
+  ANPI_ELEMENT_TYPE(std::uint8_t,UInt8)
+  ANPI_ELEMENT_TYPE(std::int16_t,Int16)
+  ANPI_ELEMENT_TYPE(std::uint16_t,UInt16)
+  ANPI_ELEMENT_TYPE(std::int32_t,Int32)
+  ANPI_ELEMENT_TYPE(std::uint32_t,UInt32)
+  ANPI_ELEMENT_TYPE(std::int64_t,Int64)
+  ANPI_ELEMENT_TYPE(std::uint64_t,UInt64)
+  ANPI_ELEMENT_TYPE(float,Float)
+  ANPI_ELEMENT_TYPE(double,Double)
+  ANPI_ELEMENT_TYPE(std::complex<float>,ComplexFloat)
+  ANPI_ELEMENT_TYPE(std::complex<double>,ComplexDouble)
+
+# undef ANPI_ELEMENT_TYPE
+
+  /**
+   * Header at the beginning of every matrix file.
+   *
+   * The entries follow the header at the byte offset stored in it, row
+   * by row and including the row padding, exactly as they are held in
+   * memory by the Matrix.  Hence, the file can be read with one single
+   * read() or mapped without any parsing.  The offset is a multiple of
+   * the alignment, so that mapped rows keep their alignment.
+   */
+  struct matrix_file_header {
+    /// "ANPIMAT" and a terminating zero
+    char          magic[8];
+    /// Version of the file layout
+    std::uint32_t version;
+    /// Size in bytes of one entry
+    std::uint32_t typeSize;
+    /// Number of rows
+    std::uint64_t rows;
+    /// Effective number of columns
+    std::uint64_t cols;
+    /// Number of columns including padding
+    std::uint64_t dcols;
+    /// Alignment of the rows in bytes
+    std::uint64_t alignment;
+    /// Byte offset of the first entry in the file
+    std::uint64_t offset;
+    /// Element type (an ElementType)
+    std::uint32_t typeTag;
+    /// Reserved for future versions
+    std::uint32_t reserved;
+  };
+
+  /// Magic string identifying the matrix files
+  static const char MatrixFileMagic[8] = { 'A','N','P','I','M','A','T','\0' };
+
+  /// Current version of the matrix file layout
+  static const std::uint32_t MatrixFileVersion = 1;
+
+  /// Byte offset of the entries in a file with the given alignment
+  constexpr size_t matrixFileOffset(const size_t alignment) {
+    return ( (sizeof(matrix_file_header) + alignment - 1)/alignment )
+      * alignment;
+  }
+
+  /// Header describing a matrix of T with the given layout
+  template<typename T>
+  inline matrix_file_header makeMatrixFileHeader(const size_t rows,
+                                                 const size_t cols,
+                                                 const size_t dcols,
+                                                 const size_t alignment) {
+    matrix_file_header h;
+    std::memcpy(h.magic,MatrixFileMagic,sizeof(MatrixFileMagic));
+    h.version   = MatrixFileVersion;
+    h.typeSize  = sizeof(T);
+    h.rows      = rows;
+    h.cols      = cols;
+    h.dcols     = dcols;
+    h.alignment = alignment;
+    h.offset    = matrixFileOffset(alignment);
+    h.typeTag   = static_cast<std::uint32_t>(element_type<T>::value);
+    h.reserved  = 0;
+    return h;
+  }
+
+  /**
+   * Check that a header describes entries of type T.
+   *
+   * @throw anpi::Exception if the element type differs
+   */
+  template<typename T>
+  inline void checkMatrixFileType(const matrix_file_header& h,
+                                  const std::string& path) {
+    if ( (h.typeSize != sizeof(T)) ||
+         (h.typeTag != static_cast<std::uint32_t>(element_type<T>::value)) ) {
+      throw Exception("Wrong element type in matrix file " + path);
+    }
+  }
+
+  /**
+   * Check that the entries described by a header fit in a file of the
+   * given size: the rows hold at least all columns, the entries start
+   * after the header, and their size neither overflows nor exceeds the
+   * file.
+   *
+   * @throw anpi::Exception if the layout is inconsistent
+   */
+  inline void checkMatrixFileLayout(const matrix_file_header& h,
+                                    const std::uint64_t fileSize,
+                                    const std::string& path) {
+    const std::uint64_t max = std::numeric_limits<std::uint64_t>::max();
+    const bool sizeOverflows =
+      ( (h.dcols != 0) && (h.rows > max/h.dcols) ) ||
+      ( (h.rows*h.dcols != 0) && (h.typeSize > max/(h.rows*h.dcols)) );
+
+    if ( (h.dcols < h.cols) ||
+         (h.offset < sizeof(h)) || (h.offset > fileSize) ||
+         sizeOverflows ||
+         (h.rows*h.dcols*h.typeSize > fileSize - h.offset) ||
+         (h.rows*h.dcols*h.typeSize > std::numeric_limits<size_t>::max()) ) {
+      throw Exception("Corrupt matrix file " + path);
+    }
+  }
+
+  /**
+   * Read the header of the matrix file open as fd.
+   *
+   * @throw anpi::Exception if the file cannot be read, is not a matrix
+   *        file of the current version, or is too short for the
+   *        entries described in its header
+   */
+  inline matrix_file_header readMatrixFileHeader(const int fd,
+                                                 const std::string& path) {
+    matrix_file_header h;
+    ssize_t got;
+    do {
+      got = ::pread(fd,&h,sizeof(h),0);
+    } while ( (got < 0) && (errno == EINTR) );
+
+    if ( (got != static_cast<ssize_t>(sizeof(h))) ||
+         (std::memcmp(h.magic,MatrixFileMagic,sizeof(MatrixFileMagic)) != 0) ) {
+      throw Exception("Not a matrix file: " + path);
+    }
+    if (h.version != MatrixFileVersion) {
+      throw Exception("Unsupported version of matrix file " + path);
+    }
+
+    struct stat st;
+    if (::fstat(fd,&st) != 0) {
+      throw Exception("Cannot read matrix file " + path);
+    }
+    checkMatrixFileLayout(h,static_cast<std::uint64_t>(st.st_size),path);
+    return h;
+  }
+
+  /**
+   * Read the header of a matrix file.
+   *
+   * @throw anpi::Exception as readMatrixFileHeader(fd,path), or if the
+   *        file cannot be opened
+   */
+  inline matrix_file_header readMatrixFileHeader(const std::string& path) {
+    const int fd = ::open(path.c_str(),O_RDONLY);
+    if (fd < 0) {
+      throw Exception("Cannot open matrix file " + path);
+    }
+    try {
+      const matrix_file_header h = readMatrixFileHeader(fd,path);
+      ::close(fd);
+      return h;
+    } catch (...) {
+      ::close(fd);
+      throw;
+    }
+  }
+
+} // namespace anpi
+
+#endif
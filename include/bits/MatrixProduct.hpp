@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date:   28.12.2017
+ */
+
+#ifndef ANPI_MATRIX_PRODUCT_HPP
+#define ANPI_MATRIX_PRODUCT_HPP
+
+#include "Intrinsics.hpp"
+#include <algorithm>
+#include <type_traits>
+
+namespace anpi
+{
+  namespace fallback {
+    /*
+     * Product
+     */
+
+    // Accumulating implementation c=c+alpha*a*b on views
+    //
+    // The view c must already have the size of the product and must not
+    // overlap with a or b.
+    template<typename T>
+    inline void multiplyAdd(const T alpha,
+                            const ConstMatrixView<T>& a,
+                            const ConstMatrixView<T>& b,
+                            const MatrixView<T>& c) {
+
+      assert( (a.cols() == b.rows()) &&
+              (c.rows() == a.rows()) && (c.cols() == b.cols()) );
+
+      const size_t m = a.rows();
+      const size_t n = b.cols();
+      const size_t k = a.cols();
+
+      // i-k-j order, to traverse the rows of b and c contiguously
+      for (size_t i=0;i<m;++i) {
+        T* crow = c[i];
+        const T* arow = a[i];
+        for (size_t p=0;p<k;++p) {
+          const T aip = alpha*arow[p];
+          const T* bptr = b[p];
+          T* here = crow;
+          T *const end = crow + n;
+          for (;here!=end;) {
+            *here++ += aip * *bptr++;
+          }
+        }
+      }
+    }
+
+    // On-copy implementation c=a*b on views
+    //
+    // The view c must already have the size of the product and must not
+    // overlap with a or b.
+    template<typename T>
+    inline void multiply(const ConstMatrixView<T>& a,
+                         const ConstMatrixView<T>& b,
+                         const MatrixView<T>& c) {
+      c.fill(T(0));
+      multiplyAdd(T(1),a,b,c);
+    }
+
+    // On-copy implementation c=a*b
+    template<typename T,class Alloc>
+    inline void multiply(const Matrix<T,Alloc>& a,
+                         const Matrix<T,Alloc>& b,
+                         Matrix<T,Alloc>& c) {
+
+      assert(a.cols() == b.rows());
+
+      // the result cannot be written over one of the operands
+      if ( (&c == &a) || (&c == &b) ) {
+        Matrix<T,Alloc> tmp;
+        multiply(a,b,tmp);
+        c.swap(tmp);
+        return;
+      }
+
+      c.allocate(a.rows(),b.cols());
+      multiply(a.view(),b.view(),c.view());
+    }
+  } // namespace fallback
+
+} // namespace anpi
+
+#endif
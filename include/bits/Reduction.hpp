@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date:   11.01.2018
+ */
+
+#ifndef ANPI_REDUCTION_HPP
+#define ANPI_REDUCTION_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+namespace anpi
+{
+  namespace bits {
+    /// Absolute value, also for unsigned types
+    template<typename T>
+    inline typename std::enable_if<std::is_unsigned<T>::value,T>::type
+    absValue(const T x) {
+      return x;
+    }
+
+    /// Absolute value, also for unsigned types
+    template<typename T>
+    inline typename std::enable_if<!std::is_unsigned<T>::value,T>::type
+    absValue(const T x) {
+      using std::abs;
+      return T(abs(x));
+    }
+
+    /// Smallest value of T, -infinity if available
+    template<typename T>
+    inline T lowestValue() {
+      return std::numeric_limits<T>::has_infinity
+        ? -std::numeric_limits<T>::infinity()
+        : std::numeric_limits<T>::lowest();
+    }
+
+    /// Largest value of T, infinity if available
+    template<typename T>
+    inline T highestValue() {
+      return std::numeric_limits<T>::has_infinity
+        ? std::numeric_limits<T>::infinity()
+        : std::numeric_limits<T>::max();
+    }
+
+    /**
+     * Kahan compensated accumulator.
+     *
+     * The compensation keeps the low order bits lost by each addition,
+     * so that the error of the sum does not grow with the number of
+     * terms.
+     */
+    template<typename T>
+    struct kahan {
+      T sum;
+      T comp;
+
+      kahan() : sum(T(0)),comp(T(0)) {}
+
+      inline void add(const T x) {
+        const T y = x - comp;
+        const T t = sum + y;
+        comp = (t - sum) - y;
+        sum = t;
+      }
+    };
+  } // namespace bits
+
+  namespace fallback {
+    /*
+     * Reductions
+     */
+
+    /// Dot product of the n entries at a and b
+    template<typename T>
+    inline T dot(const T* a,const T* b,const size_t n) {
+      T sum = T(0);
+      for (size_t i=0;i<n;++i) {
+        sum += a[i]*b[i];
+      }
+      return sum;
+    }
+
+    /// Sum of the n entries at a
+    template<typename T>
+    inline T sum(const T* a,const size_t n) {
+      T s = T(0);
+      for (size_t i=0;i<n;++i) {
+        s += a[i];
+      }
+      return s;
+    }
+
+    /// Sum of the absolute values of the n entries at a
+    template<typename T>
+    inline T sumAbs(const T* a,const size_t n) {
+      T s = T(0);
+      for (size_t i=0;i<n;++i) {
+        s += bits::absValue(a[i]);
+      }
+      return s;
+    }
+
+    /// Compensated sum of the n entries at a
+    template<typename T>
+    inline T sumKahan(const T* a,const size_t n) {
+      bits::kahan<T> k;
+      for (size_t i=0;i<n;++i) {
+        k.add(a[i]);
+      }
+      return k.sum;
+    }
+
+    /// Compensated sum of the absolute values of the n entries at a
+    template<typename T>
+    inline T sumAbsKahan(const T* a,const size_t n) {
+      bits::kahan<T> k;
+      for (size_t i=0;i<n;++i) {
+        k.add(bits::absValue(a[i]));
+      }
+      return k.sum;
+    }
+
+    /// Compensated dot product of the n entries at a and b
+    template<typename T>
+    inline T dotKahan(const T* a,const T* b,const size_t n) {
+      bits::kahan<T> k;
+      for (size_t i=0;i<n;++i) {
+        k.add(a[i]*b[i]);
+      }
+      return k.sum;
+    }
+
+    /**
+     * Largest of the n entries at a.
+     *
+     * NaN entries are ignored; without other entries the result is
+     * the lowest value of T (-infinity for floating point types).
+     */
+    template<typename T>
+    inline T max(const T* a,const size_t n) {
+      T m = bits::lowestValue<T>();
+      for (size_t i=0;i<n;++i) {
+        m = (a[i] > m) ? a[i] : m;
+      }
+      return m;
+    }
+
+    /// Smallest of the n entries at a, ignoring NaN (see max())
+    template<typename T>
+    inline T min(const T* a,const size_t n) {
+      T m = bits::highestValue<T>();
+      for (size_t i=0;i<n;++i) {
+        m = (a[i] < m) ? a[i] : m;
+      }
+      return m;
+    }
+
+    /// Largest absolute value of the n entries at a, ignoring NaN
+    template<typename T>
+    inline T maxAbs(const T* a,const size_t n) {
+      T m = T(0);
+      for (size_t i=0;i<n;++i) {
+        const T v = bits::absValue(a[i]);
+        m = (v > m) ? v : m;
+      }
+      return m;
+    }
+  } // namespace fallback
+} // namespace anpi
+
+#endif
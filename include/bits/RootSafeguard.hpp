@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date:   10.02.2018
+ */
+
+#ifndef ANPI_ROOT_SAFEGUARD_HPP
+#define ANPI_ROOT_SAFEGUARD_HPP
+
+#include <cmath>
+#include <limits>
+
+#include "Dual.hpp"
+#include "Exception.hpp"
+
+namespace anpi
+{
+  namespace bits {
+
+    /// Value of a function and of its first derivatives at one point
+    template<typename T>
+    struct derivatives {
+      T f;
+      T d1;
+      T d2;
+      T d3;
+    };
+
+    /**
+     * Value and first Order derivatives of funct by forward automatic
+     * differentiation, with one evaluation of funct on nested duals.
+     */
+    template<typename T,int Order>
+    struct dualDerivatives;
+
+    template<typename T>
+    struct dualDerivatives<T,1> {
+      template<class F>
+      static inline derivatives<T> eval(F& funct,const T x) {
+        const Dual<T> y = funct(Dual<T>(x,T(1)));
+        const derivatives<T> r = { y.value(),y.derivative(),T(0),T(0) };
+        return r;
+      }
+    };
+
+    template<typename T>
+    struct dualDerivatives<T,2> {
+      template<class F>
+      static inline derivatives<T> eval(F& funct,const T x) {
+        typedef Dual<T> D;
+        const Dual<D> y = funct(Dual<D>(D(x,T(1)),D(T(1))));
+        const derivatives<T> r = { y.value().value(),
+                                   y.derivative().value(),
+                                   y.derivative().derivative(),
+                                   T(0) };
+        return r;
+      }
+    };
+
+    template<typename T>
+    struct dualDerivatives<T,3> {
+      template<class F>
+      static inline derivatives<T> eval(F& funct,const T x) {
+        typedef Dual<T> D;
+        typedef Dual<D> DD;
+        const Dual<DD> y =
+          funct(Dual<DD>(DD(D(x,T(1)),D(T(1))),DD(D(T(1)))));
+        const derivatives<T> r = { y.value().value().value(),
+                                   y.derivative().value().value(),
+                                   y.derivative().derivative().value(),
+                                   y.derivative().derivative().derivative() };
+        return r;
+      }
+    };
+
+    /// Bracket [a,b] of a root, with the function values at its ends
+    template<typename T>
+    struct bracket {
+      T a,b;
+      T fa,fb;
+
+      /**
+       * Replace the end with the sign of fx by the inner point x, or
+       * collapse the bracket to x if it is a root.
+       */
+      inline void shrink(const T x,const T fx) {
+        if (fx == T(0)) {
+          a = b = x;
+          fa = fb = fx;
+        } else if ((fx < T(0)) == (fa < T(0))) {
+          a = x;
+          fa = fx;
+        } else {
+          b = x;
+          fb = fx;
+        }
+      }
+
+      /// End with the smaller |f|
+      inline T best() const {
+        return (std::abs(fa) < std::abs(fb)) ? a : b;
+      }
+    };
+
+    /// Callable giving f and its first Order derivatives by dualDerivatives
+    template<typename T,int Order,class F>
+    struct dualEvaluator {
+      F& funct;
+      inline derivatives<T> operator()(const T x) const {
+        return dualDerivatives<T,Order>::eval(funct,x);
+      }
+    };
+
+    /**
+     * Root of a function in the bracket [xl,xu] with the high order
+     * steps of next, safeguarded by bisection.
+     *
+     * The iteration starts at the end with the smaller |f|.  The step
+     * proposed by next(x,derivatives at x,bracket) is taken if it stays
+     * inside the current bracket and it is shorter than half the step
+     * before the last one, as in Brent's method; otherwise the bracket
+     * is bisected.  Steps are at least the tolerance, so that near the
+     * root the next point crosses it and the bracket closes.  Each new
+     * point is evaluated with eval and replaces the end of the bracket
+     * with its sign, so the bracket always contains the root.  Steps
+     * that evaluate f at intermediate points shrink the bracket with
+     * them too, so that these evaluations are not lost if the step is
+     * rejected.  The end with the smaller |f| is returned.
+     *
+     * @param eval callable "derivatives<T> eval(T x)"
+     * @param next callable "T next(T x,const derivatives<T>& d,
+     *             bracket<T>& br)" returning the next estimate, or NaN
+     *             if it has none
+     *
+     * @return root found, or NaN if none could be found.
+     *
+     * @throws anpi::Exception if inteval is reversed or both extremes
+     *         have same sign.
+     */
+    template<typename T,class E,class N>
+    T safeguardedRoot(E& eval,N& next,const T xl,const T xu,const T eps) {
+      const derivatives<T> da = eval(xl);
+      const derivatives<T> db = eval(xu);
+
+      if (xl>xu || da.f*db.f > T(0)) {
+        throw anpi::Exception("received invalid values");
+      }
+      if (da.f == T(0)) {
+        return xl;
+      }
+      if (db.f == T(0)) {
+        return xu;
+      }
+
+      bracket<T> br = { xl,xu,da.f,db.f };
+      T x = br.best();
+      derivatives<T> dx = (x == xl) ? da : db;
+
+      const T inf = std::numeric_limits<T>::infinity();
+      T last = inf, beforeLast = inf;
+      for (int i=2*std::numeric_limits<T>::digits;i>0;--i) {
+        const T tol = eps/T(2) +
+          T(2)*std::numeric_limits<T>::epsilon()*std::abs(x);
+        T xn = next(x,dx,br);
+        if (br.b-br.a < eps) {
+          // closed by the intermediate points of the step
+          return br.best();
+        }
+
+        const T m = br.a + (br.b-br.a)/T(2);
+        if (!(br.a <= xn && xn <= br.b) ||
+            !(std::abs(xn-x) < beforeLast/T(2))) {
+          xn = m;
+        } else if (std::abs(xn-x) < tol) {
+          // too short to be resolved: step past the root to close the
+          // bracket around it
+          xn = (x < m) ? x + tol : x - tol;
+          if (!(br.a < xn && xn < br.b)) {
+            xn = m;
+          }
+        }
+        beforeLast = last;
+        last = std::abs(xn-x);
+
+        x = xn;
+        dx = eval(x);
+        if (dx.f == T(0)) {
+          return x;
+        }
+        br.shrink(x,dx.f);
+        if (last < eps || br.b-br.a < eps) {
+          return br.best();
+        }
+      }
+
+      // Return NaN if no root was found
+      return std::numeric_limits<T>::quiet_NaN();
+    }
+
+  } // namespace bits
+} // namespace anpi
+
+#endif
@@ -0,0 +1,347 @@
+/*
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date:   10.02.2018
+ */
+
+/*
+ * Batched root finders for one instruction set.
+ *
+ * The lane primitives map to the registers of the instruction set, with
+ * the comparisons kept as AVX-512 mask registers or as full-width lane
+ * masks, and the steps of BatchRootSteps.hpp are compiled on top of them.
+ *
+ * Like SimdRegisters.hpp, this file has no include guards: SimdDispatch.hpp
+ * includes it once per instruction set.
+ */
+
+    /// Lane primitives of the batched root finders
+    template<typename T>
+    struct lane_ops;
+
+#if ANPI_SIMD_LEVEL == 3
+    template<>
+    struct lane_ops<double> {
+      typedef __m512d reg_type;
+      typedef __mmask8 mask_type;
+      static constexpr size_t lanes = 8;
+
+      static inline reg_type load(const double* p) {
+        return _mm512_loadu_pd(p);
+      }
+      static inline void store(double* p,const reg_type a) {
+        _mm512_storeu_pd(p,a);
+      }
+      static inline reg_type set1(const double v) { return _mm512_set1_pd(v); }
+      static inline reg_type add(const reg_type a,const reg_type b) {
+        return _mm512_add_pd(a,b);
+      }
+      static inline reg_type sub(const reg_type a,const reg_type b) {
+        return _mm512_sub_pd(a,b);
+      }
+      static inline reg_type mul(const reg_type a,const reg_type b) {
+        return _mm512_mul_pd(a,b);
+      }
+      static inline reg_type div(const reg_type a,const reg_type b) {
+        return _mm512_div_pd(a,b);
+      }
+      static inline reg_type abs(const reg_type a) { return _mm512_abs_pd(a); }
+      static inline mask_type lt(const reg_type a,const reg_type b) {
+        return _mm512_cmp_pd_mask(a,b,_CMP_LT_OQ);
+      }
+      static inline mask_type le(const reg_type a,const reg_type b) {
+        return _mm512_cmp_pd_mask(a,b,_CMP_LE_OQ);
+      }
+      static inline mask_type eq(const reg_type a,const reg_type b) {
+        return _mm512_cmp_pd_mask(a,b,_CMP_EQ_OQ);
+      }
+      static inline mask_type mand(const mask_type a,const mask_type b) {
+        return mask_type(a & b);
+      }
+      static inline mask_type mor(const mask_type a,const mask_type b) {
+        return mask_type(a | b);
+      }
+      static inline mask_type mandn(const mask_type a,const mask_type b) {
+        return mask_type(a & ~b);
+      }
+      static inline bool all(const mask_type m) { return m == 0xff; }
+      static inline reg_type select(const mask_type m,
+                                    const reg_type a,const reg_type b) {
+        return _mm512_mask_blend_pd(m,b,a);
+      }
+    };
+
+    template<>
+    struct lane_ops<float> {
+      typedef __m512 reg_type;
+      typedef __mmask16 mask_type;
+      static constexpr size_t lanes = 16;
+
+      static inline reg_type load(const float* p) {
+        return _mm512_loadu_ps(p);
+      }
+      static inline void store(float* p,const reg_type a) {
+        _mm512_storeu_ps(p,a);
+      }
+      static inline reg_type set1(const float v) { return _mm512_set1_ps(v); }
+      static inline reg_type add(const reg_type a,const reg_type b) {
+        return _mm512_add_ps(a,b);
+      }
+      static inline reg_type sub(const reg_type a,const reg_type b) {
+        return _mm512_sub_ps(a,b);
+      }
+      static inline reg_type mul(const reg_type a,const reg_type b) {
+        return _mm512_mul_ps(a,b);
+      }
+      static inline reg_type div(const reg_type a,const reg_type b) {
+        return _mm512_div_ps(a,b);
+      }
+      static inline reg_type abs(const reg_type a) { return _mm512_abs_ps(a); }
+      static inline mask_type lt(const reg_type a,const reg_type b) {
+        return _mm512_cmp_ps_mask(a,b,_CMP_LT_OQ);
+      }
+      static inline mask_type le(const reg_type a,const reg_type b) {
+        return _mm512_cmp_ps_mask(a,b,_CMP_LE_OQ);
+      }
+      static inline mask_type eq(const reg_type a,const reg_type b) {
+        return _mm512_cmp_ps_mask(a,b,_CMP_EQ_OQ);
+      }
+      static inline mask_type mand(const mask_type a,const mask_type b) {
+        return mask_type(a & b);
+      }
+      static inline mask_type mor(const mask_type a,const mask_type b) {
+        return mask_type(a | b);
+      }
+      static inline mask_type mandn(const mask_type a,const mask_type b) {
+        return mask_type(a & ~b);
+      }
+      static inline bool all(const mask_type m) { return m == 0xffff; }
+      static inline reg_type select(const mask_type m,
+                                    const reg_type a,const reg_type b) {
+        return _mm512_mask_blend_ps(m,b,a);
+      }
+    };
+#elif ANPI_SIMD_LEVEL == 2
+    template<>
+    struct lane_ops<double> {
+      typedef __m256d reg_type;
+      typedef __m256d mask_type;
+      static constexpr size_t lanes = 4;
+
+      static inline reg_type load(const double* p) {
+        return _mm256_loadu_pd(p);
+      }
+      static inline void store(double* p,const reg_type a) {
+        _mm256_storeu_pd(p,a);
+      }
+      static inline reg_type set1(const double v) { return _mm256_set1_pd(v); }
+      static inline reg_type add(const reg_type a,const reg_type b) {
+        return _mm256_add_pd(a,b);
+      }
+      static inline reg_type sub(const reg_type a,const reg_type b) {
+        return _mm256_sub_pd(a,b);
+      }
+      static inline reg_type mul(const reg_type a,const reg_type b) {
+        return _mm256_mul_pd(a,b);
+      }
+      static inline reg_type div(const reg_type a,const reg_type b) {
+        return _mm256_div_pd(a,b);
+      }
+      static inline reg_type abs(const reg_type a) {
+        return _mm256_andnot_pd(_mm256_set1_pd(-0.0),a);
+      }
+      static inline mask_type lt(const reg_type a,const reg_type b) {
+        return _mm256_cmp_pd(a,b,_CMP_LT_OQ);
+      }
+      static inline mask_type le(const reg_type a,const reg_type b) {
+        return _mm256_cmp_pd(a,b,_CMP_LE_OQ);
+      }
+      static inline mask_type eq(const reg_type a,const reg_type b) {
+        return _mm256_cmp_pd(a,b,_CMP_EQ_OQ);
+      }
+      static inline mask_type mand(const mask_type a,const mask_type b) {
+        return _mm256_and_pd(a,b);
+      }
+      static inline mask_type mor(const mask_type a,const mask_type b) {
+        return _mm256_or_pd(a,b);
+      }
+      static inline mask_type mandn(const mask_type a,const mask_type b) {
+        return _mm256_andnot_pd(b,a);
+      }
+      static inline bool all(const mask_type m) {
+        return _mm256_movemask_pd(m) == 0xf;
+      }
+      static inline reg_type select(const mask_type m,
+                                    const reg_type a,const reg_type b) {
+        return _mm256_blendv_pd(b,a,m);
+      }
+    };
+
+    template<>
+    struct lane_ops<float> {
+      typedef __m256 reg_type;
+      typedef __m256 mask_type;
+      static constexpr size_t lanes = 8;
+
+      static inline reg_type load(const float* p) {
+        return _mm256_loadu_ps(p);
+      }
+      static inline void store(float* p,const reg_type a) {
+        _mm256_storeu_ps(p,a);
+      }
+      static inline reg_type set1(const float v) { return _mm256_set1_ps(v); }
+      static inline reg_type add(const reg_type a,const reg_type b) {
+        return _mm256_add_ps(a,b);
+      }
+      static inline reg_type sub(const reg_type a,const reg_type b) {
+        return _mm256_sub_ps(a,b);
+      }
+      static inline reg_type mul(const reg_type a,const reg_type b) {
+        return _mm256_mul_ps(a,b);
+      }
+      static inline reg_type div(const reg_type a,const reg_type b) {
+        return _mm256_div_ps(a,b);
+      }
+      static inline reg_type abs(const reg_type a) {
+        return _mm256_andnot_ps(_mm256_set1_ps(-0.0f),a);
+      }
+      static inline mask_type lt(const reg_type a,const reg_type b) {
+        return _mm256_cmp_ps(a,b,_CMP_LT_OQ);
+      }
+      static inline mask_type le(const reg_type a,const reg_type b) {
+        return _mm256_cmp_ps(a,b,_CMP_LE_OQ);
+      }
+      static inline mask_type eq(const reg_type a,const reg_type b) {
+        return _mm256_cmp_ps(a,b,_CMP_EQ_OQ);
+      }
+      static inline mask_type mand(const mask_type a,const mask_type b) {
+        return _mm256_and_ps(a,b);
+      }
+      static inline mask_type mor(const mask_type a,const mask_type b) {
+        return _mm256_or_ps(a,b);
+      }
+      static inline mask_type mandn(const mask_type a,const mask_type b) {
+        return _mm256_andnot_ps(b,a);
+      }
+      static inline bool all(const mask_type m) {
+        return _mm256_movemask_ps(m) == 0xff;
+      }
+      static inline reg_type select(const mask_type m,
+                                    const reg_type a,const reg_type b) {
+        return _mm256_blendv_ps(b,a,m);
+      }
+    };
+#elif ANPI_SIMD_LEVEL == 1
+    template<>
+    struct lane_ops<double> {
+      typedef __m128d reg_type;
+      typedef __m128d mask_type;
+      static constexpr size_t lanes = 2;
+
+      static inline reg_type load(const double* p) { return _mm_loadu_pd(p); }
+      static inline void store(double* p,const reg_type a) {
+        _mm_storeu_pd(p,a);
+      }
+      static inline reg_type set1(const double v) { return _mm_set1_pd(v); }
+      static inline reg_type add(const reg_type a,const reg_type b) {
+        return _mm_add_pd(a,b);
+      }
+      static inline reg_type sub(const reg_type a,const reg_type b) {
+        return _mm_sub_pd(a,b);
+      }
+      static inline reg_type mul(const reg_type a,const reg_type b) {
+        return _mm_mul_pd(a,b);
+      }
+      static inline reg_type div(const reg_type a,const reg_type b) {
+        return _mm_div_pd(a,b);
+      }
+      static inline reg_type abs(const reg_type a) {
+        return _mm_andnot_pd(_mm_set1_pd(-0.0),a);
+      }
+      static inline mask_type lt(const reg_type a,const reg_type b) {
+        return _mm_cmplt_pd(a,b);
+      }
+      static inline mask_type le(const reg_type a,const reg_type b) {
+        return _mm_cmple_pd(a,b);
+      }
+      static inline mask_type eq(const reg_type a,const reg_type b) {
+        return _mm_cmpeq_pd(a,b);
+      }
+      static inline mask_type mand(const mask_type a,const mask_type b) {
+        return _mm_and_pd(a,b);
+      }
+      static inline mask_type mor(const mask_type a,const mask_type b) {
+        return _mm_or_pd(a,b);
+      }
+      static inline mask_type mandn(const mask_type a,const mask_type b) {
+        return _mm_andnot_pd(b,a);
+      }
+      static inline bool all(const mask_type m) {
+        return _mm_movemask_pd(m) == 0x3;
+      }
+      // SSE2 has no blendv
+      static inline reg_type select(const mask_type m,
+                                    const reg_type a,const reg_type b) {
+        return _mm_or_pd(_mm_and_pd(m,a),_mm_andnot_pd(m,b));
+      }
+    };
+
+    template<>
+    struct lane_ops<float> {
+      typedef __m128 reg_type;
+      typedef __m128 mask_type;
+      static constexpr size_t lanes = 4;
+
+      static inline reg_type load(const float* p) { return _mm_loadu_ps(p); }
+      static inline void store(float* p,const reg_type a) {
+        _mm_storeu_ps(p,a);
+      }
+      static inline reg_type set1(const float v) { return _mm_set1_ps(v); }
+      static inline reg_type add(const reg_type a,const reg_type b) {
+        return _mm_add_ps(a,b);
+      }
+      static inline reg_type sub(const reg_type a,const reg_type b) {
+        return _mm_sub_ps(a,b);
+      }
+      static inline reg_type mul(const reg_type a,const reg_type b) {
+        return _mm_mul_ps(a,b);
+      }
+      static inline reg_type div(const reg_type a,const reg_type b) {
+        return _mm_div_ps(a,b);
+      }
+      static inline reg_type abs(const reg_type a) {
+        return _mm_andnot_ps(_mm_set1_ps(-0.0f),a);
+      }
+      static inline mask_type lt(const reg_type a,const reg_type b) {
+        return _mm_cmplt_ps(a,b);
+      }
+      static inline mask_type le(const reg_type a,const reg_type b) {
+        return _mm_cmple_ps(a,b);
+      }
+      static inline mask_type eq(const reg_type a,const reg_type b) {
+        return _mm_cmpeq_ps(a,b);
+      }
+      static inline mask_type mand(const mask_type a,const mask_type b) {
+        return _mm_and_ps(a,b);
+      }
+      static inline mask_type mor(const mask_type a,const mask_type b) {
+        return _mm_or_ps(a,b);
+      }
+      static inline mask_type mandn(const mask_type a,const mask_type b) {
+        return _mm_andnot_ps(b,a);
+      }
+      static inline bool all(const mask_type m) {
+        return _mm_movemask_ps(m) == 0xf;
+      }
+      static inline reg_type select(const mask_type m,
+                                    const reg_type a,const reg_type b) {
+        return _mm_or_ps(_mm_and_ps(m,a),_mm_andnot_ps(m,b));
+      }
+    };
+#endif
+
+#   include "BatchRootSteps.hpp"
@@ -0,0 +1,456 @@
+/*
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date:   14.01.2018
+ */
+
+/*
+ * Comparison kernels for one instruction set.
+ *
+ * Like SimdRegisters.hpp, this file has no include guards: SimdDispatch.hpp
+ * includes it once per instruction set.
+ */
+
+    /*
+     * Comparisons
+     *
+     * The lanes of each comparison are collapsed into a bit mask (a
+     * movemask, or directly the AVX-512 mask register), and the masks of
+     * four registers are combined before testing them, so that the early
+     * exit costs one branch every four registers.  The bitwise equality
+     * of operator== compares the registers as integers, so it works on
+     * the raw bytes of any element type.  The distances in ULP
+     * are computed on the integer view of the registers, which needs the
+     * 64 bit comparisons of AVX2; SSE2 uses the scalar loop for them.
+     */
+
+    /// Comparison primitives on the registers of one floating point type
+    template<typename T>
+    struct cmp_ops;
+
+    /// Bitwise comparison of the raw bytes of one register
+    struct bit_ops {
+#if ANPI_SIMD_LEVEL == 3
+      static constexpr size_t bytes = 64;
+      static constexpr unsigned full = 0xffffu;
+      static inline unsigned eq(const char* a,const char* b) {
+        return _mm512_cmpeq_epi32_mask(_mm512_loadu_si512(a),
+                                       _mm512_loadu_si512(b));
+      }
+#elif ANPI_SIMD_LEVEL == 2
+      static constexpr size_t bytes = 32;
+      static constexpr unsigned full = 0xffffffffu;
+      static inline unsigned eq(const char* a,const char* b) {
+        const __m256i va =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+        const __m256i vb =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+        return unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi8(va,vb)));
+      }
+#elif ANPI_SIMD_LEVEL == 1
+      static constexpr size_t bytes = 16;
+      static constexpr unsigned full = 0xffffu;
+      static inline unsigned eq(const char* a,const char* b) {
+        const __m128i va =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+        const __m128i vb =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+        return unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(va,vb)));
+      }
+#endif
+    };
+
+#if ANPI_SIMD_LEVEL == 3
+    template<>
+    struct cmp_ops<double> {
+      typedef __m512d reg_type;
+      typedef __m512i int_type;
+      static constexpr size_t lanes = 8;
+      static constexpr unsigned full = 0xffu;
+
+      static inline reg_type load(const double* p) {
+        return _mm512_loadu_pd(p);
+      }
+      static inline reg_type set1(const double v) {
+        return _mm512_set1_pd(v);
+      }
+      static inline unsigned eq(const reg_type a,const reg_type b) {
+        return _mm512_cmp_pd_mask(a,b,_CMP_EQ_OQ);
+      }
+      static inline unsigned close(const reg_type a,const reg_type b,
+                                   const reg_type rtol,const reg_type atol) {
+        const reg_type ab = _mm512_abs_pd(b);
+        const reg_type d = _mm512_abs_pd(_mm512_sub_pd(a,b));
+        const reg_type t = _mm512_add_pd(atol,_mm512_mul_pd(rtol,ab));
+        // an infinite b makes t infinite: only equality counts there
+        const unsigned finite =
+          _mm512_cmp_pd_mask(ab,set1(std::numeric_limits<double>::infinity()),
+                             _CMP_LT_OQ);
+        return (_mm512_cmp_pd_mask(d,t,_CMP_LE_OQ) & finite) | eq(a,b);
+      }
+      static inline unsigned unordered(const reg_type a,const reg_type b) {
+        return _mm512_cmp_pd_mask(a,b,_CMP_UNORD_Q);
+      }
+      static inline int_type order(const reg_type a) {
+        const int_type i = _mm512_castpd_si512(a);
+        return _mm512_mask_sub_epi64(i,_mm512_movepi64_mask(i),
+                                     _mm512_set1_epi64(INT64_MIN),i);
+      }
+      // the masked forms avoid GCC's -Wmaybe-uninitialized in the headers
+      static inline int_type ulp(const reg_type a,const reg_type b) {
+        const int_type ia = order(a), ib = order(b);
+        return _mm512_sub_epi64(_mm512_maskz_max_epi64(0xff,ia,ib),
+                                _mm512_maskz_min_epi64(0xff,ia,ib));
+      }
+      static inline int_type izero() {
+        return _mm512_setzero_si512();
+      }
+      static inline int_type umax(const int_type a,const int_type b) {
+        return _mm512_maskz_max_epu64(0xff,a,b);
+      }
+      static inline std::uint64_t hmax(const int_type a) {
+        std::uint64_t buffer[lanes];
+        _mm512_storeu_si512(buffer,a);
+        return *std::max_element(buffer,buffer+lanes);
+      }
+    };
+
+    template<>
+    struct cmp_ops<float> {
+      typedef __m512  reg_type;
+      typedef __m512i int_type;
+      static constexpr size_t lanes = 16;
+      static constexpr unsigned full = 0xffffu;
+
+      static inline reg_type load(const float* p) {
+        return _mm512_loadu_ps(p);
+      }
+      static inline reg_type set1(const float v) {
+        return _mm512_set1_ps(v);
+      }
+      static inline unsigned eq(const reg_type a,const reg_type b) {
+        return _mm512_cmp_ps_mask(a,b,_CMP_EQ_OQ);
+      }
+      static inline unsigned close(const reg_type a,const reg_type b,
+                                   const reg_type rtol,const reg_type atol) {
+        const reg_type ab = _mm512_abs_ps(b);
+        const reg_type d = _mm512_abs_ps(_mm512_sub_ps(a,b));
+        const reg_type t = _mm512_add_ps(atol,_mm512_mul_ps(rtol,ab));
+        // an infinite b makes t infinite: only equality counts there
+        const unsigned finite =
+          _mm512_cmp_ps_mask(ab,set1(std::numeric_limits<float>::infinity()),
+                             _CMP_LT_OQ);
+        return (_mm512_cmp_ps_mask(d,t,_CMP_LE_OQ) & finite) | eq(a,b);
+      }
+      static inline unsigned unordered(const reg_type a,const reg_type b) {
+        return _mm512_cmp_ps_mask(a,b,_CMP_UNORD_Q);
+      }
+      static inline int_type order(const reg_type a) {
+        const int_type i = _mm512_castps_si512(a);
+        return _mm512_mask_sub_epi32(i,_mm512_movepi32_mask(i),
+                                     _mm512_set1_epi32(INT32_MIN),i);
+      }
+      static inline int_type ulp(const reg_type a,const reg_type b) {
+        const int_type ia = order(a), ib = order(b);
+        return _mm512_sub_epi32(_mm512_maskz_max_epi32(0xffff,ia,ib),
+                                _mm512_maskz_min_epi32(0xffff,ia,ib));
+      }
+      static inline int_type izero() {
+        return _mm512_setzero_si512();
+      }
+      static inline int_type umax(const int_type a,const int_type b) {
+        return _mm512_maskz_max_epu32(0xffff,a,b);
+      }
+      static inline std::uint64_t hmax(const int_type a) {
+        std::uint32_t buffer[lanes];
+        _mm512_storeu_si512(buffer,a);
+        return *std::max_element(buffer,buffer+lanes);
+      }
+    };
+#elif ANPI_SIMD_LEVEL == 2
+    template<>
+    struct cmp_ops<double> {
+      typedef __m256d reg_type;
+      typedef __m256i int_type;
+      static constexpr size_t lanes = 4;
+      static constexpr unsigned full = 0xfu;
+
+      static inline reg_type load(const double* p) {
+        return _mm256_loadu_pd(p);
+      }
+      static inline reg_type set1(const double v) {
+        return _mm256_set1_pd(v);
+      }
+      static inline reg_type abs(const reg_type a) {
+        return _mm256_andnot_pd(_mm256_set1_pd(-0.0),a);
+      }
+      static inline unsigned eq(const reg_type a,const reg_type b) {
+        return unsigned(_mm256_movemask_pd(_mm256_cmp_pd(a,b,_CMP_EQ_OQ)));
+      }
+      static inline unsigned close(const reg_type a,const reg_type b,
+                                   const reg_type rtol,const reg_type atol) {
+        const reg_type ab = abs(b);
+        const reg_type d = abs(_mm256_sub_pd(a,b));
+        const reg_type t = _mm256_add_pd(atol,_mm256_mul_pd(rtol,ab));
+        // an infinite b makes t infinite: only equality counts there
+        const reg_type finite =
+          _mm256_cmp_pd(ab,set1(std::numeric_limits<double>::infinity()),
+                        _CMP_LT_OQ);
+        return unsigned(_mm256_movemask_pd(
+                 _mm256_and_pd(_mm256_cmp_pd(d,t,_CMP_LE_OQ),finite)))
+          | eq(a,b);
+      }
+      static inline unsigned unordered(const reg_type a,const reg_type b) {
+        return unsigned(_mm256_movemask_pd(_mm256_cmp_pd(a,b,_CMP_UNORD_Q)));
+      }
+      static inline int_type order(const reg_type a) {
+        const int_type i = _mm256_castpd_si256(a);
+        const int_type neg = _mm256_cmpgt_epi64(_mm256_setzero_si256(),i);
+        return _mm256_blendv_epi8(i,
+                                  _mm256_sub_epi64(_mm256_set1_epi64x(INT64_MIN),
+                                                   i),
+                                  neg);
+      }
+      static inline int_type ulp(const reg_type a,const reg_type b) {
+        const int_type ia = order(a), ib = order(b);
+        const int_type gt = _mm256_cmpgt_epi64(ia,ib);
+        return _mm256_sub_epi64(_mm256_blendv_epi8(ib,ia,gt),
+                                _mm256_blendv_epi8(ia,ib,gt));
+      }
+      static inline int_type izero() {
+        return _mm256_setzero_si256();
+      }
+      static inline int_type umax(const int_type a,const int_type b) {
+        // unsigned comparison by flipping the sign bits
+        const int_type flip = _mm256_set1_epi64x(INT64_MIN);
+        const int_type gt = _mm256_cmpgt_epi64(_mm256_xor_si256(a,flip),
+                                               _mm256_xor_si256(b,flip));
+        return _mm256_blendv_epi8(b,a,gt);
+      }
+      static inline std::uint64_t hmax(const int_type a) {
+        std::uint64_t buffer[lanes];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(buffer),a);
+        return *std::max_element(buffer,buffer+lanes);
+      }
+    };
+
+    template<>
+    struct cmp_ops<float> {
+      typedef __m256  reg_type;
+      typedef __m256i int_type;
+      static constexpr size_t lanes = 8;
+      static constexpr unsigned full = 0xffu;
+
+      static inline reg_type load(const float* p) {
+        return _mm256_loadu_ps(p);
+      }
+      static inline reg_type set1(const float v) {
+        return _mm256_set1_ps(v);
+      }
+      static inline reg_type abs(const reg_type a) {
+        return _mm256_andnot_ps(_mm256_set1_ps(-0.0f),a);
+      }
+      static inline unsigned eq(const reg_type a,const reg_type b) {
+        return unsigned(_mm256_movemask_ps(_mm256_cmp_ps(a,b,_CMP_EQ_OQ)));
+      }
+      static inline unsigned close(const reg_type a,const reg_type b,
+                                   const reg_type rtol,const reg_type atol) {
+        const reg_type ab = abs(b);
+        const reg_type d = abs(_mm256_sub_ps(a,b));
+        const reg_type t = _mm256_add_ps(atol,_mm256_mul_ps(rtol,ab));
+        // an infinite b makes t infinite: only equality counts there
+        const reg_type finite =
+          _mm256_cmp_ps(ab,set1(std::numeric_limits<float>::infinity()),
+                        _CMP_LT_OQ);
+        return unsigned(_mm256_movemask_ps(
+                 _mm256_and_ps(_mm256_cmp_ps(d,t,_CMP_LE_OQ),finite)))
+          | eq(a,b);
+      }
+      static inline unsigned unordered(const reg_type a,const reg_type b) {
+        return unsigned(_mm256_movemask_ps(_mm256_cmp_ps(a,b,_CMP_UNORD_Q)));
+      }
+      static inline int_type order(const reg_type a) {
+        const int_type i = _mm256_castps_si256(a);
+        const int_type neg = _mm256_cmpgt_epi32(_mm256_setzero_si256(),i);
+        return _mm256_blendv_epi8(i,
+                                  _mm256_sub_epi32(_mm256_set1_epi32(INT32_MIN),
+                                                   i),
+                                  neg);
+      }
+      static inline int_type ulp(const reg_type a,const reg_type b) {
+        const int_type ia = order(a), ib = order(b);
+        return _mm256_sub_epi32(_mm256_max_epi32(ia,ib),
+                                _mm256_min_epi32(ia,ib));
+      }
+      static inline int_type izero() {
+        return _mm256_setzero_si256();
+      }
+      static inline int_type umax(const int_type a,const int_type b) {
+        return _mm256_max_epu32(a,b);
+      }
+      static inline std::uint64_t hmax(const int_type a) {
+        std::uint32_t buffer[lanes];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(buffer),a);
+        return *std::max_element(buffer,buffer+lanes);
+      }
+    };
+#elif ANPI_SIMD_LEVEL == 1
+    template<>
+    struct cmp_ops<double> {
+      typedef __m128d reg_type;
+      static constexpr size_t lanes = 2;
+      static constexpr unsigned full = 0x3u;
+
+      static inline reg_type load(const double* p) {
+        return _mm_loadu_pd(p);
+      }
+      static inline reg_type set1(const double v) {
+        return _mm_set1_pd(v);
+      }
+      static inline reg_type abs(const reg_type a) {
+        return _mm_andnot_pd(_mm_set1_pd(-0.0),a);
+      }
+      static inline unsigned eq(const reg_type a,const reg_type b) {
+        return unsigned(_mm_movemask_pd(_mm_cmpeq_pd(a,b)));
+      }
+      static inline unsigned close(const reg_type a,const reg_type b,
+                                   const reg_type rtol,const reg_type atol) {
+        const reg_type ab = abs(b);
+        const reg_type d = abs(_mm_sub_pd(a,b));
+        const reg_type t = _mm_add_pd(atol,_mm_mul_pd(rtol,ab));
+        // an infinite b makes t infinite: only equality counts there
+        const reg_type finite =
+          _mm_cmplt_pd(ab,set1(std::numeric_limits<double>::infinity()));
+        return unsigned(_mm_movemask_pd(_mm_and_pd(_mm_cmple_pd(d,t),
+                                                     finite)))
+          | eq(a,b);
+      }
+    };
+
+    template<>
+    struct cmp_ops<float> {
+      typedef __m128 reg_type;
+      static constexpr size_t lanes = 4;
+      static constexpr unsigned full = 0xfu;
+
+      static inline reg_type load(const float* p) {
+        return _mm_loadu_ps(p);
+      }
+      static inline reg_type set1(const float v) {
+        return _mm_set1_ps(v);
+      }
+      static inline reg_type abs(const reg_type a) {
+        return _mm_andnot_ps(_mm_set1_ps(-0.0f),a);
+      }
+      static inline unsigned eq(const reg_type a,const reg_type b) {
+        return unsigned(_mm_movemask_ps(_mm_cmpeq_ps(a,b)));
+      }
+      static inline unsigned close(const reg_type a,const reg_type b,
+                                   const reg_type rtol,const reg_type atol) {
+        const reg_type ab = abs(b);
+        const reg_type d = abs(_mm_sub_ps(a,b));
+        const reg_type t = _mm_add_ps(atol,_mm_mul_ps(rtol,ab));
+        // an infinite b makes t infinite: only equality counts there
+        const reg_type finite =
+          _mm_cmplt_ps(ab,set1(std::numeric_limits<float>::infinity()));
+        return unsigned(_mm_movemask_ps(_mm_and_ps(_mm_cmple_ps(d,t),
+                                                     finite)))
+          | eq(a,b);
+      }
+    };
+#endif
+
+    /// Whether the n entries at a and b have the same bits
+    template<typename T>
+    inline bool sameBits(const T* a,const T* b,const size_t n) {
+      typedef bit_ops ops;
+      const size_t lanes = ops::bytes;
+      const char* pa = reinterpret_cast<const char*>(a);
+      const char* pb = reinterpret_cast<const char*>(b);
+      const size_t bytes = n*sizeof(T);
+
+      size_t i=0;
+      for (;i+4*lanes<=bytes;i+=4*lanes) {
+        const unsigned m =
+          ops::eq(pa+i,pb+i)                 &
+          ops::eq(pa+i+lanes,pb+i+lanes)     &
+          ops::eq(pa+i+2*lanes,pb+i+2*lanes) &
+          ops::eq(pa+i+3*lanes,pb+i+3*lanes);
+        if (m != ops::full) {
+          return false;
+        }
+      }
+      for (;i+lanes<=bytes;i+=lanes) {
+        if (ops::eq(pa+i,pb+i) != ops::full) {
+          return false;
+        }
+      }
+      return std::memcmp(pa+i,pb+i,bytes-i) == 0;
+    }
+
+    /// Whether |a[i]-b[i]| <= atol + rtol*|b[i]| for all n entries
+    template<typename T>
+    inline bool allclose(const T* a,
+                         const T* b,
+                         const size_t n,
+                         const T rtol,
+                         const T atol) {
+      typedef cmp_ops<T> ops;
+      typedef typename ops::reg_type regType;
+      const size_t lanes = ops::lanes;
+      const regType vr = ops::set1(rtol);
+      const regType va = ops::set1(atol);
+
+      size_t i=0;
+      for (;i+4*lanes<=n;i+=4*lanes) {
+        const unsigned m =
+          ops::close(ops::load(a+i),ops::load(b+i),vr,va) &
+          ops::close(ops::load(a+i+lanes),ops::load(b+i+lanes),vr,va) &
+          ops::close(ops::load(a+i+2*lanes),ops::load(b+i+2*lanes),vr,va) &
+          ops::close(ops::load(a+i+3*lanes),ops::load(b+i+3*lanes),vr,va);
+        if (m != ops::full) {
+          return false;
+        }
+      }
+      for (;i+lanes<=n;i+=lanes) {
+        if (ops::close(ops::load(a+i),ops::load(b+i),vr,va) != ops::full) {
+          return false;
+        }
+      }
+      return ::anpi::fallback::allclose(a+i,b+i,n-i,rtol,atol);
+    }
+
+#if ANPI_SIMD_LEVEL >= 2
+    /// Largest distance in ULP between the n entries at a and b
+    template<typename T>
+    inline std::uint64_t maxUlp(const T* a,const T* b,const size_t n) {
+      typedef cmp_ops<T> ops;
+      typedef typename ops::reg_type regType;
+      typedef typename ops::int_type intType;
+      const size_t lanes = ops::lanes;
+
+      intType d0 = ops::izero(), d1 = d0;
+      size_t i=0;
+      for (;i+2*lanes<=n;i+=2*lanes) {
+        const regType a0 = ops::load(a+i),       b0 = ops::load(b+i);
+        const regType a1 = ops::load(a+i+lanes), b1 = ops::load(b+i+lanes);
+        if ((ops::unordered(a0,b0) | ops::unordered(a1,b1)) != 0u) {
+          return std::numeric_limits<std::uint64_t>::max();
+        }
+        d0 = ops::umax(d0,ops::ulp(a0,b0));
+        d1 = ops::umax(d1,ops::ulp(a1,b1));
+      }
+      const std::uint64_t d = ops::hmax(ops::umax(d0,d1));
+      return std::max(d,::anpi::fallback::maxUlp(a+i,b+i,n-i));
+    }
+#else
+    /// Largest distance in ULP between the n entries at a and b
+    template<typename T>
+    inline std::uint64_t maxUlp(const T* a,const T* b,const size_t n) {
+      return ::anpi::fallback::maxUlp(a,b,n);
+    }
+#endif
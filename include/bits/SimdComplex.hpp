@@ -0,0 +1,332 @@
+/*
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date:   18.01.2018
+ */
+
+/*
+ * Complex numbers in registers for one instruction set.
+ *
+ * std::complex<R> stores the real and imaginary parts interleaved, so a
+ * register of R holds half as many complex entries, with the real parts
+ * in the even lanes and the imaginary parts in the odd ones.  Sums and
+ * differences are those of the real lanes; the products and the
+ * magnitudes exchange the parts of each entry with shuffles.
+ *
+ * Like SimdRegisters.hpp, this file has no include guards: SimdDispatch.hpp
+ * includes it once per instruction set.
+ */
+
+    /// Unaligned loads and stores of complex entries as real lanes
+    template<typename R>
+    struct reg_io<std::complex<R>,false> {
+      typedef typename reg_traits<R>::reg_type reg_type;
+      static inline reg_type __attribute__((__always_inline__))
+      loadu(const std::complex<R>* p) {
+        return mm_loadu<R,reg_type>(reinterpret_cast<const R*>(p));
+      }
+      static inline void __attribute__((__always_inline__))
+      storeu(std::complex<R>* p,const reg_type a) {
+        mm_storeu<R,reg_type>(reinterpret_cast<R*>(p),a);
+      }
+    };
+
+    /// Partial registers of complex entries, twice as many real lanes
+    template<typename R,size_t Size>
+    struct reg_part<std::complex<R>,Size,false> {
+      static constexpr bool masked = reg_part<R>::masked;
+      typedef typename reg_traits<R>::reg_type reg_type;
+      static inline reg_type __attribute__((__always_inline__))
+      load(const std::complex<R>* p,const size_t n) {
+        return reg_part<R>::load(reinterpret_cast<const R*>(p),2*n);
+      }
+      static inline void __attribute__((__always_inline__))
+      store(std::complex<R>* p,const size_t n,const reg_type a) {
+        reg_part<R>::store(reinterpret_cast<R*>(p),2*n,a);
+      }
+    };
+
+    /*
+     * Register operations on interleaved complex entries:
+     *
+     * reg_cmul(a,b)  entrywise complex product
+     * reg_conj(a)    complex conjugate, flipping the sign of the odd lanes
+     * reg_cabs(a,b)  magnitudes of the entries of a followed by those of b,
+     *                as one register of real values
+     * reg_cabs_safe(a,b,lo,hi)
+     *                true if every lane of a and b is zero or has an
+     *                absolute value in [lo,hi]
+     *
+     * reg_cabs computes sqrt(re*re+im*im), without the rescaling of
+     * std::abs.  With lo and hi the square roots of the smallest normal
+     * and of half the largest value, the squares neither underflow nor
+     * overflow, and the result is within one ulp of std::abs.  NaN and
+     * infinite lanes fail reg_cabs_safe as well.
+     */
+
+#if ANPI_SIMD_LEVEL == 3
+    inline __m512d __attribute__((__always_inline__))
+    reg_cmul(const __m512d a,const __m512d b) {
+      // masked forms: the unmasked ones pass an undefined merge source
+      const __m512d bre = _mm512_maskz_movedup_pd(__mmask8(0xff),b);
+      const __m512d bim = _mm512_maskz_permute_pd(__mmask8(0xff),b,0xff);
+      const __m512d asw = _mm512_maskz_permute_pd(__mmask8(0xff),a,0x55);
+      return _mm512_fmaddsub_pd(a,bre,_mm512_mul_pd(asw,bim));
+    }
+    inline __m512 __attribute__((__always_inline__))
+    reg_cmul(const __m512 a,const __m512 b) {
+      const __m512 bre = _mm512_maskz_moveldup_ps(__mmask16(0xffff),b);
+      const __m512 bim = _mm512_maskz_movehdup_ps(__mmask16(0xffff),b);
+      const __m512 asw = _mm512_maskz_permute_ps(__mmask16(0xffff),a,0xb1);
+      return _mm512_fmaddsub_ps(a,bre,_mm512_mul_ps(asw,bim));
+    }
+    inline __m512d __attribute__((__always_inline__))
+    reg_conj(const __m512d a) {
+      return _mm512_mask_xor_pd(a,__mmask8(0xaa),a,_mm512_set1_pd(-0.0));
+    }
+    inline __m512 __attribute__((__always_inline__))
+    reg_conj(const __m512 a) {
+      return _mm512_mask_xor_ps(a,__mmask16(0xaaaa),a,_mm512_set1_ps(-0.0f));
+    }
+    inline __m512d __attribute__((__always_inline__))
+    reg_cabs(const __m512d a,const __m512d b) {
+      const __m512i even = _mm512_setr_epi64(0,2,4,6,8,10,12,14);
+      const __m512i odd  = _mm512_setr_epi64(1,3,5,7,9,11,13,15);
+      const __m512d sa = _mm512_mul_pd(a,a);
+      const __m512d sb = _mm512_mul_pd(b,b);
+      return _mm512_maskz_sqrt_pd(__mmask8(0xff),
+               _mm512_add_pd(_mm512_permutex2var_pd(sa,even,sb),
+                             _mm512_permutex2var_pd(sa,odd,sb)));
+    }
+    inline __m512 __attribute__((__always_inline__))
+    reg_cabs(const __m512 a,const __m512 b) {
+      const __m512i even = _mm512_setr_epi32( 0, 2, 4, 6, 8,10,12,14,
+                                             16,18,20,22,24,26,28,30);
+      const __m512i odd  = _mm512_setr_epi32( 1, 3, 5, 7, 9,11,13,15,
+                                             17,19,21,23,25,27,29,31);
+      const __m512 sa = _mm512_mul_ps(a,a);
+      const __m512 sb = _mm512_mul_ps(b,b);
+      return _mm512_maskz_sqrt_ps(__mmask16(0xffff),
+               _mm512_add_ps(_mm512_permutex2var_ps(sa,even,sb),
+                             _mm512_permutex2var_ps(sa,odd,sb)));
+    }
+    inline bool __attribute__((__always_inline__))
+    reg_cabs_safe(const __m512d a,const __m512d b,
+                  const __m512d lo,const __m512d hi) {
+      const __m512d zero = _mm512_setzero_pd();
+      const __m512d ma = _mm512_abs_pd(a), mb = _mm512_abs_pd(b);
+      const __mmask8 ka =
+        _mm512_cmp_pd_mask(ma,hi,_CMP_LE_OQ) &
+        (_mm512_cmp_pd_mask(ma,lo,_CMP_GE_OQ) |
+         _mm512_cmp_pd_mask(ma,zero,_CMP_EQ_OQ));
+      const __mmask8 kb =
+        _mm512_cmp_pd_mask(mb,hi,_CMP_LE_OQ) &
+        (_mm512_cmp_pd_mask(mb,lo,_CMP_GE_OQ) |
+         _mm512_cmp_pd_mask(mb,zero,_CMP_EQ_OQ));
+      return (ka & kb) == __mmask8(0xff);
+    }
+    inline bool __attribute__((__always_inline__))
+    reg_cabs_safe(const __m512 a,const __m512 b,
+                  const __m512 lo,const __m512 hi) {
+      const __m512 zero = _mm512_setzero_ps();
+      const __m512 ma = _mm512_abs_ps(a), mb = _mm512_abs_ps(b);
+      const __mmask16 ka =
+        _mm512_cmp_ps_mask(ma,hi,_CMP_LE_OQ) &
+        (_mm512_cmp_ps_mask(ma,lo,_CMP_GE_OQ) |
+         _mm512_cmp_ps_mask(ma,zero,_CMP_EQ_OQ));
+      const __mmask16 kb =
+        _mm512_cmp_ps_mask(mb,hi,_CMP_LE_OQ) &
+        (_mm512_cmp_ps_mask(mb,lo,_CMP_GE_OQ) |
+         _mm512_cmp_ps_mask(mb,zero,_CMP_EQ_OQ));
+      return (ka & kb) == __mmask16(0xffff);
+    }
+#elif ANPI_SIMD_LEVEL == 2
+    inline __m256d __attribute__((__always_inline__))
+    reg_cmul(const __m256d a,const __m256d b) {
+      const __m256d bre = _mm256_movedup_pd(b);
+      const __m256d bim = _mm256_permute_pd(b,0xf);
+      const __m256d asw = _mm256_permute_pd(a,0x5);
+      return _mm256_fmaddsub_pd(a,bre,_mm256_mul_pd(asw,bim));
+    }
+    inline __m256 __attribute__((__always_inline__))
+    reg_cmul(const __m256 a,const __m256 b) {
+      const __m256 bre = _mm256_moveldup_ps(b);
+      const __m256 bim = _mm256_movehdup_ps(b);
+      const __m256 asw = _mm256_permute_ps(a,0xb1);
+      return _mm256_fmaddsub_ps(a,bre,_mm256_mul_ps(asw,bim));
+    }
+    inline __m256d __attribute__((__always_inline__))
+    reg_conj(const __m256d a) {
+      return _mm256_xor_pd(a,_mm256_set_pd(-0.0,0.0,-0.0,0.0));
+    }
+    inline __m256 __attribute__((__always_inline__))
+    reg_conj(const __m256 a) {
+      return _mm256_xor_ps(a,_mm256_set_ps(-0.0f,0.0f,-0.0f,0.0f,
+                                           -0.0f,0.0f,-0.0f,0.0f));
+    }
+    inline __m256d __attribute__((__always_inline__))
+    reg_cabs(const __m256d a,const __m256d b) {
+      // hadd works within 128-bit halves: |a0| |b0| |a1| |b1|
+      const __m256d s = _mm256_hadd_pd(_mm256_mul_pd(a,a),_mm256_mul_pd(b,b));
+      return _mm256_sqrt_pd(_mm256_permute4x64_pd(s,0xd8));
+    }
+    inline __m256 __attribute__((__always_inline__))
+    reg_cabs(const __m256 a,const __m256 b) {
+      // pairs of magnitudes in the order a01 b01 a23 b23
+      const __m256 s = _mm256_hadd_ps(_mm256_mul_ps(a,a),_mm256_mul_ps(b,b));
+      return _mm256_sqrt_ps(_mm256_castpd_ps(
+               _mm256_permute4x64_pd(_mm256_castps_pd(s),0xd8)));
+    }
+    inline bool __attribute__((__always_inline__))
+    reg_cabs_safe(const __m256d a,const __m256d b,
+                  const __m256d lo,const __m256d hi) {
+      const __m256d sign = _mm256_set1_pd(-0.0), zero = _mm256_setzero_pd();
+      const __m256d ma = _mm256_andnot_pd(sign,a), mb = _mm256_andnot_pd(sign,b);
+      const __m256d ka = _mm256_and_pd(
+        _mm256_cmp_pd(ma,hi,_CMP_LE_OQ),
+        _mm256_or_pd(_mm256_cmp_pd(ma,lo,_CMP_GE_OQ),
+                     _mm256_cmp_pd(ma,zero,_CMP_EQ_OQ)));
+      const __m256d kb = _mm256_and_pd(
+        _mm256_cmp_pd(mb,hi,_CMP_LE_OQ),
+        _mm256_or_pd(_mm256_cmp_pd(mb,lo,_CMP_GE_OQ),
+                     _mm256_cmp_pd(mb,zero,_CMP_EQ_OQ)));
+      return _mm256_movemask_pd(_mm256_and_pd(ka,kb)) == 0xf;
+    }
+    inline bool __attribute__((__always_inline__))
+    reg_cabs_safe(const __m256 a,const __m256 b,
+                  const __m256 lo,const __m256 hi) {
+      const __m256 sign = _mm256_set1_ps(-0.0f), zero = _mm256_setzero_ps();
+      const __m256 ma = _mm256_andnot_ps(sign,a), mb = _mm256_andnot_ps(sign,b);
+      const __m256 ka = _mm256_and_ps(
+        _mm256_cmp_ps(ma,hi,_CMP_LE_OQ),
+        _mm256_or_ps(_mm256_cmp_ps(ma,lo,_CMP_GE_OQ),
+                     _mm256_cmp_ps(ma,zero,_CMP_EQ_OQ)));
+      const __m256 kb = _mm256_and_ps(
+        _mm256_cmp_ps(mb,hi,_CMP_LE_OQ),
+        _mm256_or_ps(_mm256_cmp_ps(mb,lo,_CMP_GE_OQ),
+                     _mm256_cmp_ps(mb,zero,_CMP_EQ_OQ)));
+      return _mm256_movemask_ps(_mm256_and_ps(ka,kb)) == 0xff;
+    }
+#elif ANPI_SIMD_LEVEL == 1
+    inline __m128d __attribute__((__always_inline__))
+    reg_cmul(const __m128d a,const __m128d b) {
+      const __m128d bre = _mm_unpacklo_pd(b,b);
+      const __m128d bim = _mm_unpackhi_pd(b,b);
+      const __m128d asw = _mm_shuffle_pd(a,a,1);
+      // SSE2 has no addsub: negate the products for the real lanes
+      return _mm_add_pd(_mm_mul_pd(a,bre),
+                        _mm_xor_pd(_mm_mul_pd(asw,bim),_mm_set_pd(0.0,-0.0)));
+    }
+    inline __m128 __attribute__((__always_inline__))
+    reg_cmul(const __m128 a,const __m128 b) {
+      const __m128 bre = _mm_shuffle_ps(b,b,_MM_SHUFFLE(2,2,0,0));
+      const __m128 bim = _mm_shuffle_ps(b,b,_MM_SHUFFLE(3,3,1,1));
+      const __m128 asw = _mm_shuffle_ps(a,a,_MM_SHUFFLE(2,3,0,1));
+      return _mm_add_ps(_mm_mul_ps(a,bre),
+                        _mm_xor_ps(_mm_mul_ps(asw,bim),
+                                   _mm_set_ps(0.0f,-0.0f,0.0f,-0.0f)));
+    }
+    inline __m128d __attribute__((__always_inline__))
+    reg_conj(const __m128d a) {
+      return _mm_xor_pd(a,_mm_set_pd(-0.0,0.0));
+    }
+    inline __m128 __attribute__((__always_inline__))
+    reg_conj(const __m128 a) {
+      return _mm_xor_ps(a,_mm_set_ps(-0.0f,0.0f,-0.0f,0.0f));
+    }
+    inline __m128d __attribute__((__always_inline__))
+    reg_cabs(const __m128d a,const __m128d b) {
+      const __m128d sa = _mm_mul_pd(a,a);
+      const __m128d sb = _mm_mul_pd(b,b);
+      return _mm_sqrt_pd(_mm_add_pd(_mm_unpacklo_pd(sa,sb),
+                                    _mm_unpackhi_pd(sa,sb)));
+    }
+    inline __m128 __attribute__((__always_inline__))
+    reg_cabs(const __m128 a,const __m128 b) {
+      const __m128 sa = _mm_mul_ps(a,a);
+      const __m128 sb = _mm_mul_ps(b,b);
+      return _mm_sqrt_ps(_mm_add_ps(_mm_shuffle_ps(sa,sb,_MM_SHUFFLE(2,0,2,0)),
+                                    _mm_shuffle_ps(sa,sb,_MM_SHUFFLE(3,1,3,1))));
+    }
+    inline bool __attribute__((__always_inline__))
+    reg_cabs_safe(const __m128d a,const __m128d b,
+                  const __m128d lo,const __m128d hi) {
+      const __m128d sign = _mm_set1_pd(-0.0), zero = _mm_setzero_pd();
+      const __m128d ma = _mm_andnot_pd(sign,a), mb = _mm_andnot_pd(sign,b);
+      const __m128d ka = _mm_and_pd(_mm_cmple_pd(ma,hi),
+                                    _mm_or_pd(_mm_cmpge_pd(ma,lo),
+                                              _mm_cmpeq_pd(ma,zero)));
+      const __m128d kb = _mm_and_pd(_mm_cmple_pd(mb,hi),
+                                    _mm_or_pd(_mm_cmpge_pd(mb,lo),
+                                              _mm_cmpeq_pd(mb,zero)));
+      return _mm_movemask_pd(_mm_and_pd(ka,kb)) == 0x3;
+    }
+    inline bool __attribute__((__always_inline__))
+    reg_cabs_safe(const __m128 a,const __m128 b,
+                  const __m128 lo,const __m128 hi) {
+      const __m128 sign = _mm_set1_ps(-0.0f), zero = _mm_setzero_ps();
+      const __m128 ma = _mm_andnot_ps(sign,a), mb = _mm_andnot_ps(sign,b);
+      const __m128 ka = _mm_and_ps(_mm_cmple_ps(ma,hi),
+                                   _mm_or_ps(_mm_cmpge_ps(ma,lo),
+                                             _mm_cmpeq_ps(ma,zero)));
+      const __m128 kb = _mm_and_ps(_mm_cmple_ps(mb,hi),
+                                   _mm_or_ps(_mm_cmpge_ps(mb,lo),
+                                             _mm_cmpeq_ps(mb,zero)));
+      return _mm_movemask_ps(_mm_and_ps(ka,kb)) == 0xf;
+    }
+#endif
+
+    /**
+     * Entrywise magnitude c=|a| of a complex matrix.
+     *
+     * Each row is processed separately, as the rows of a and c have
+     * different padding: two registers of complex entries give one
+     * register of magnitudes.  Registers with parts too large or too small
+     * for the unscaled formula, and the last entries of the row that do
+     * not fill them, are computed one by one with std::abs.
+     */
+    template<typename R,class AllocA,class AllocC>
+    inline void magnitude(const Matrix<std::complex<R>,AllocA>& a,
+                          Matrix<R,AllocC>& c) {
+
+      typedef reg_io<R> io;
+      typedef typename io::reg_type regType;
+      const size_t L     = sizeof(regType)/sizeof(R);
+      const size_t cols  = a.cols();
+      const size_t vcols = cols - cols%L;
+
+      // squares of parts in [lo,hi] are normal and their sum is finite
+      const int k = std::numeric_limits<R>::max_exponent/2 - 1;
+      const regType lo = mm_set1<R,regType>(std::ldexp(R(1),-k));
+      const regType hi = mm_set1<R,regType>(std::ldexp(R(1),k));
+
+      c.allocate(a.rows(),a.cols());
+
+      parallel::forChunks(a.rows(),1,a.rows()*a.dcols(),
+                          [&](const size_t begin,const size_t end) {
+        for (size_t r=begin;r<end;++r) {
+          const std::complex<R>* arow = a[r];
+          const R* aptr = reinterpret_cast<const R*>(arow);
+          R* here       = c[r];
+          size_t j=0;
+          for (;j<vcols;j+=L) {
+            const regType va = io::loadu(aptr+2*j);
+            const regType vb = io::loadu(aptr+2*j+L);
+            if (reg_cabs_safe(va,vb,lo,hi)) {
+              io::storeu(here+j,reg_cabs(va,vb));
+            } else {
+              for (size_t i=j;i<j+L;++i) {
+                here[i] = std::abs(arow[i]);
+              }
+            }
+          }
+          for (;j<cols;++j) {
+            here[j] = std::abs(arow[j]);
+          }
+        }
+      });
+    }
@@ -0,0 +1,1204 @@
+/*
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date:   28.12.2017
+ */
+
+#ifndef ANPI_SIMD_DISPATCH_HPP
+#define ANPI_SIMD_DISPATCH_HPP
+
+#include "Intrinsics.hpp"
+#include "CpuFeatures.hpp"
+#include "Parallel.hpp"
+#include "SparseProduct.hpp"
+#include "Reduction.hpp"
+#include "Comparison.hpp"
+#include "BatchRoots.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+/*
+ * SIMD kernels for each instruction set.
+ *
+ * The same kernel sources are compiled once per instruction set, each
+ * time in its own namespace (sse2, avx2 or avx512).  With runtime
+ * dispatch (see Intrinsics.hpp) the wider sets are compiled with
+ * "#pragma GCC target", so that the binary does not require them from
+ * the CPU unless it actually selects them.  Without runtime dispatch
+ * only the set enabled by the compiler flags is compiled.
+ */
+
+#if defined ANPI_SIMD_DISPATCH || (ANPI_SIMD_MAX_LEVEL == 1)
+#  define ANPI_SIMD_HAS_SSE2
+#  define ANPI_SIMD_LEVEL 1
+namespace anpi {
+  namespace simd {
+    namespace sse2 {
+#     include "SimdRegisters.hpp"
+#     include "SimdComplex.hpp"
+#     include "SimdElementwise.hpp"
+#     include "SimdProduct.hpp"
+#     include "SimdSparse.hpp"
+#     include "SimdReduction.hpp"
+#     include "SimdComparison.hpp"
+#     include "SimdBatchRoots.hpp"
+    } // namespace sse2
+  } // namespace simd
+} // namespace anpi
+#  undef ANPI_SIMD_LEVEL
+#endif
+
+#if defined ANPI_SIMD_DISPATCH || (ANPI_SIMD_MAX_LEVEL == 2)
+#  define ANPI_SIMD_HAS_AVX2
+#  define ANPI_SIMD_LEVEL 2
+#  ifdef ANPI_SIMD_DISPATCH
+#    pragma GCC push_options
+#    pragma GCC target("avx2,fma")
+#  endif
+namespace anpi {
+  namespace simd {
+    namespace avx2 {
+#     include "SimdRegisters.hpp"
+#     include "SimdComplex.hpp"
+#     include "SimdElementwise.hpp"
+#     include "SimdProduct.hpp"
+#     include "SimdSparse.hpp"
+#     include "SimdReduction.hpp"
+#     include "SimdComparison.hpp"
+#     include "SimdBatchRoots.hpp"
+    } // namespace avx2
+  } // namespace simd
+} // namespace anpi
+#  ifdef ANPI_SIMD_DISPATCH
+#    pragma GCC pop_options
+#  endif
+#  undef ANPI_SIMD_LEVEL
+#endif
+
+#if defined ANPI_SIMD_DISPATCH || (ANPI_SIMD_MAX_LEVEL == 3)
+#  define ANPI_SIMD_HAS_AVX512
+#  define ANPI_SIMD_LEVEL 3
+#  ifdef ANPI_SIMD_DISPATCH
+#    pragma GCC push_options
+#    pragma GCC target("avx2,fma,avx512f,avx512bw,avx512dq,avx512vl")
+#  endif
+namespace anpi {
+  namespace simd {
+    namespace avx512 {
+#     include "SimdRegisters.hpp"
+#     include "SimdComplex.hpp"
+#     include "SimdElementwise.hpp"
+#     include "SimdProduct.hpp"
+#     include "SimdSparse.hpp"
+#     include "SimdReduction.hpp"
+#     include "SimdComparison.hpp"
+#     include "SimdBatchRoots.hpp"
+    } // namespace avx512
+  } // namespace simd
+} // namespace anpi
+#  ifdef ANPI_SIMD_DISPATCH
+#    pragma GCC pop_options
+#  endif
+#  undef ANPI_SIMD_LEVEL
+#endif
+
+namespace anpi
+{
+  namespace simd
+  {
+    /**
+     * Widest instruction set usable with buffers of the allocator Alloc.
+     *
+     * With aligned allocators the elementwise kernels load whole registers
+     * from the padded buffers, so the registers cannot be wider than the
+     * alignment.  Buffers of unaligned allocators are processed with
+     * unaligned loads and partial registers at their ends, with any
+     * instruction set.
+     */
+    template<class Alloc>
+    inline Isa isaFor() {
+      const bool   aligned   = extract_alignment<Alloc>::aligned;
+      const size_t alignment = extract_alignment<Alloc>::value;
+
+      const Isa widest =
+        !aligned          ? Isa::AVX512 :
+        (alignment >= 64) ? Isa::AVX512 :
+        (alignment >= 32) ? Isa::AVX2   :
+        (alignment >= 16) ? Isa::SSE2   : Isa::None;
+
+      return std::min(isa(),widest);
+    }
+
+    // On-copy implementation c=op(a)
+    template<typename T,class Alloc,class Op>
+    inline void unary(const Matrix<T,Alloc>& a,
+                      Matrix<T,Alloc>& c,
+                      const Op& op) {
+      switch (isaFor<Alloc>()) {
+#ifdef ANPI_SIMD_HAS_AVX512
+      case Isa::AVX512: avx512::unary(a,c,op); break;
+#endif
+#ifdef ANPI_SIMD_HAS_AVX2
+      case Isa::AVX2:   avx2::unary(a,c,op);   break;
+#endif
+#ifdef ANPI_SIMD_HAS_SSE2
+      case Isa::SSE2:   sse2::unary(a,c,op);   break;
+#endif
+      default:          ::anpi::fallback::unary(a,c,op);
+      }
+    }
+
+    // On-copy implementation c=op(a,b)
+    template<typename T,class Alloc,class Op>
+    inline void binary(const Matrix<T,Alloc>& a,
+                       const Matrix<T,Alloc>& b,
+                       Matrix<T,Alloc>& c,
+                       const Op& op) {
+      switch (isaFor<Alloc>()) {
+#ifdef ANPI_SIMD_HAS_AVX512
+      case Isa::AVX512: avx512::binary(a,b,c,op); break;
+#endif
+#ifdef ANPI_SIMD_HAS_AVX2
+      case Isa::AVX2:   avx2::binary(a,b,c,op);   break;
+#endif
+#ifdef ANPI_SIMD_HAS_SSE2
+      case Isa::SSE2:   sse2::binary(a,b,c,op);   break;
+#endif
+      default:          ::anpi::fallback::binary(a,b,c,op);
+      }
+    }
+
+    // On-copy implementation d=op(a,b,c)
+    template<typename T,class Alloc,class Op>
+    inline void ternary(const Matrix<T,Alloc>& a,
+                        const Matrix<T,Alloc>& b,
+                        const Matrix<T,Alloc>& c,
+                        Matrix<T,Alloc>& d,
+                        const Op& op) {
+      switch (isaFor<Alloc>()) {
+#ifdef ANPI_SIMD_HAS_AVX512
+      case Isa::AVX512: avx512::ternary(a,b,c,d,op); break;
+#endif
+#ifdef ANPI_SIMD_HAS_AVX2
+      case Isa::AVX2:   avx2::ternary(a,b,c,d,op);   break;
+#endif
+#ifdef ANPI_SIMD_HAS_SSE2
+      case Isa::SSE2:   sse2::ternary(a,b,c,d,op);   break;
+#endif
+      default:          ::anpi::fallback::ternary(a,b,c,d,op);
+      }
+    }
+
+    // Materialize the expression e into c
+    template<typename T,class Alloc,class E>
+    inline void evaluate(const MatrixExpression<E,T,Alloc>& e,
+                         Matrix<T,Alloc>& c) {
+      switch (isaFor<Alloc>()) {
+#ifdef ANPI_SIMD_HAS_AVX512
+      case Isa::AVX512: avx512::evaluate(e,c); break;
+#endif
+#ifdef ANPI_SIMD_HAS_AVX2
+      case Isa::AVX2:   avx2::evaluate(e,c);   break;
+#endif
+#ifdef ANPI_SIMD_HAS_SSE2
+      case Isa::SSE2:   sse2::evaluate(e,c);   break;
+#endif
+      default:          ::anpi::fallback::evaluate(e,c);
+      }
+    }
+
+    /*
+     * Sum
+     */
+
+    // On-copy implementation c=a+b
+    template<typename T,class Alloc>
+    inline void add(const Matrix<T,Alloc>& a,
+                    const Matrix<T,Alloc>& b,
+                    Matrix<T,Alloc>& c) {
+
+      assert( (a.rows() == b.rows()) &&
+              (a.cols() == b.cols()) );
+
+      binary(a,b,c,add_op<T>());
+    }
+
+    // In-place implementation a = a+b
+    template<typename T,class Alloc>
+    inline void add(Matrix<T,Alloc>& a,
+                    const Matrix<T,Alloc>& b) {
+
+      add(a,b,a);
+    }
+
+
+    /*
+     * Subtraction
+     */
+
+    // On-copy implementation c=a-b
+    template<typename T,class Alloc>
+    inline void subtract(const Matrix<T,Alloc>& a,
+                         const Matrix<T,Alloc>& b,
+                         Matrix<T,Alloc>& c) {
+
+      assert( (a.rows() == b.rows()) &&
+              (a.cols() == b.cols()) );
+
+      binary(a,b,c,sub_op<T>());
+    }
+
+    // In-place implementation a = a-b
+    template<typename T,class Alloc>
+    inline void subtract(Matrix<T,Alloc>& a,
+                         const Matrix<T,Alloc>& b) {
+
+      subtract(a,b,a);
+    }
+
+
+    /*
+     * Elementwise (Hadamard) product
+     */
+
+    // On-copy implementation c=a.*b
+    template<typename T,class Alloc>
+    inline void hadamard(const Matrix<T,Alloc>& a,
+                         const Matrix<T,Alloc>& b,
+                         Matrix<T,Alloc>& c) {
+
+      assert( (a.rows() == b.rows()) &&
+              (a.cols() == b.cols()) );
+
+      binary(a,b,c,mul_op<T>());
+    }
+
+    // In-place implementation a = a.*b
+    template<typename T,class Alloc>
+    inline void hadamard(Matrix<T,Alloc>& a,
+                         const Matrix<T,Alloc>& b) {
+
+      hadamard(a,b,a);
+    }
+
+
+    /*
+     * Elementwise division
+     */
+
+    // On-copy implementation c=a./b
+    template<typename T,class Alloc>
+    inline void divide(const Matrix<T,Alloc>& a,
+                       const Matrix<T,Alloc>& b,
+                       Matrix<T,Alloc>& c) {
+
+      assert( (a.rows() == b.rows()) &&
+              (a.cols() == b.cols()) );
+
+      // integer lanes have no SIMD division, and the fallback must not
+      // divide by the (undefined) padding
+      if (is_simd_type<T>::value && std::is_floating_point<T>::value) {
+        binary(a,b,c,div_op<T>());
+      } else {
+        ::anpi::fallback::divide(a,b,c);
+      }
+    }
+
+    // In-place implementation a = a./b
+    template<typename T,class Alloc>
+    inline void divide(Matrix<T,Alloc>& a,
+                       const Matrix<T,Alloc>& b) {
+
+      divide(a,b,a);
+    }
+
+
+    /*
+     * Scaling
+     */
+
+    // On-copy implementation c=alpha*a
+    template<typename T,class Alloc>
+    inline void scale(const Matrix<T,Alloc>& a,
+                      const T alpha,
+                      Matrix<T,Alloc>& c) {
+
+      unary(a,c,scale_op<T>(alpha));
+    }
+
+    // In-place implementation a = alpha*a
+    template<typename T,class Alloc>
+    inline void scale(Matrix<T,Alloc>& a,
+                      const T alpha) {
+
+      scale(a,alpha,a);
+    }
+
+
+    /*
+     * Scaled sum (BLAS axpy)
+     */
+
+    // On-copy implementation z=alpha*x+y
+    template<typename T,class Alloc>
+    inline void axpy(const T alpha,
+                     const Matrix<T,Alloc>& x,
+                     const Matrix<T,Alloc>& y,
+                     Matrix<T,Alloc>& z) {
+
+      assert( (x.rows() == y.rows()) &&
+              (x.cols() == y.cols()) );
+
+      binary(y,x,z,axpy_op<T>(alpha));
+    }
+
+    // In-place implementation y = alpha*x+y
+    template<typename T,class Alloc>
+    inline void axpy(const T alpha,
+                     const Matrix<T,Alloc>& x,
+                     Matrix<T,Alloc>& y) {
+
+      axpy(alpha,x,y,y);
+    }
+
+
+    /*
+     * Elementwise fused multiply-add
+     */
+
+    // On-copy implementation d=a.*b+c
+    template<typename T,class Alloc>
+    inline void fma(const Matrix<T,Alloc>& a,
+                    const Matrix<T,Alloc>& b,
+                    const Matrix<T,Alloc>& c,
+                    Matrix<T,Alloc>& d) {
+
+      assert( (a.rows() == b.rows()) && (a.cols() == b.cols()) &&
+              (a.rows() == c.rows()) && (a.cols() == c.cols()) );
+
+      ternary(a,b,c,d,fma_op<T>());
+    }
+
+    // In-place implementation a = a.*b+c
+    template<typename T,class Alloc>
+    inline void fma(Matrix<T,Alloc>& a,
+                    const Matrix<T,Alloc>& b,
+                    const Matrix<T,Alloc>& c) {
+
+      fma(a,b,c,a);
+    }
+
+
+    /*
+     * Complex conjugate and magnitude
+     */
+
+    // On-copy implementation c=conj(a)
+    template<typename T,class Alloc>
+    inline void conjugate(const Matrix<T,Alloc>& a,
+                          Matrix<T,Alloc>& c) {
+      unary(a,c,conj_op<T>());
+    }
+
+    // In-place implementation a = conj(a)
+    template<typename T,class Alloc>
+    inline void conjugate(Matrix<T,Alloc>& a) {
+      conjugate(a,a);
+    }
+
+    // Entrywise magnitude c=|a| of a complex matrix
+    template<typename R,class AllocA,class AllocC>
+    inline typename std::enable_if<is_simd_complex<std::complex<R> >::value>::type
+    magnitude(const Matrix<std::complex<R>,AllocA>& a,
+              Matrix<R,AllocC>& c) {
+      // the kernels use unaligned loads and stores
+      switch (isa()) {
+#ifdef ANPI_SIMD_HAS_AVX512
+      case Isa::AVX512: avx512::magnitude(a,c); break;
+#endif
+#ifdef ANPI_SIMD_HAS_AVX2
+      case Isa::AVX2:   avx2::magnitude(a,c);   break;
+#endif
+#ifdef ANPI_SIMD_HAS_SSE2
+      case Isa::SSE2:   sse2::magnitude(a,c);   break;
+#endif
+      default:          ::anpi::fallback::magnitude(a,c);
+      }
+    }
+
+    // Entrywise magnitude of complex types without registers
+    template<typename R,class AllocA,class AllocC>
+    inline typename std::enable_if<!is_simd_complex<std::complex<R> >::value>::type
+    magnitude(const Matrix<std::complex<R>,AllocA>& a,
+              Matrix<R,AllocC>& c) {
+      ::anpi::fallback::magnitude(a,c);
+    }
+
+
+    /*
+     * Views
+     *
+     * The view kernels use unaligned loads and stores, so the instruction
+     * set does not depend on any allocator.
+     */
+
+    // On-copy implementation c=op(a) on views
+    template<typename T,class Op>
+    inline void unary(const ConstMatrixView<T>& a,
+                      const MatrixView<T>& c,
+                      const Op& op) {
+      switch (isa()) {
+#ifdef ANPI_SIMD_HAS_AVX512
+      case Isa::AVX512: avx512::unary(a,c,op); break;
+#endif
+#ifdef ANPI_SIMD_HAS_AVX2
+      case Isa::AVX2:   avx2::unary(a,c,op);   break;
+#endif
+#ifdef ANPI_SIMD_HAS_SSE2
+      case Isa::SSE2:   sse2::unary(a,c,op);   break;
+#endif
+      default:          ::anpi::fallback::unary(a,c,op);
+      }
+    }
+
+    // On-copy implementation c=op(a,b) on views
+    template<typename T,class Op>
+    inline void binary(const ConstMatrixView<T>& a,
+                       const ConstMatrixView<T>& b,
+                       const MatrixView<T>& c,
+                       const Op& op) {
+      switch (isa()) {
+#ifdef ANPI_SIMD_HAS_AVX512
+      case Isa::AVX512: avx512::binary(a,b,c,op); break;
+#endif
+#ifdef ANPI_SIMD_HAS_AVX2
+      case Isa::AVX2:   avx2::binary(a,b,c,op);   break;
+#endif
+#ifdef ANPI_SIMD_HAS_SSE2
+      case Isa::SSE2:   sse2::binary(a,b,c,op);   break;
+#endif
+      default:          ::anpi::fallback::binary(a,b,c,op);
+      }
+    }
+
+    // On-copy implementation d=op(a,b,c) on views
+    template<typename T,class Op>
+    inline void ternary(const ConstMatrixView<T>& a,
+                        const ConstMatrixView<T>& b,
+                        const ConstMatrixView<T>& c,
+                        const MatrixView<T>& d,
+                        const Op& op) {
+      switch (isa()) {
+#ifdef ANPI_SIMD_HAS_AVX512
+      case Isa::AVX512: avx512::ternary(a,b,c,d,op); break;
+#endif
+#ifdef ANPI_SIMD_HAS_AVX2
+      case Isa::AVX2:   avx2::ternary(a,b,c,d,op);   break;
+#endif
+#ifdef ANPI_SIMD_HAS_SSE2
+      case Isa::SSE2:   sse2::ternary(a,b,c,d,op);   break;
+#endif
+      default:          ::anpi::fallback::ternary(a,b,c,d,op);
+      }
+    }
+
+    // On-copy implementation c=a+b on views
+    template<typename T>
+    inline void add(const ConstMatrixView<T>& a,
+                    const ConstMatrixView<T>& b,
+                    const MatrixView<T>& c) {
+      binary(a,b,c,add_op<T>());
+    }
+
+    // In-place implementation a = a+b on views
+    template<typename T>
+    inline void add(const MatrixView<T>& a,
+                    const ConstMatrixView<T>& b) {
+      binary(a,b,a,add_op<T>());
+    }
+
+    // On-copy implementation c=a-b on views
+    template<typename T>
+    inline void subtract(const ConstMatrixView<T>& a,
+                         const ConstMatrixView<T>& b,
+                         const MatrixView<T>& c) {
+      binary(a,b,c,sub_op<T>());
+    }
+
+    // In-place implementation a = a-b on views
+    template<typename T>
+    inline void subtract(const MatrixView<T>& a,
+                         const ConstMatrixView<T>& b) {
+      binary(a,b,a,sub_op<T>());
+    }
+
+    // On-copy implementation c=a.*b on views
+    template<typename T>
+    inline void hadamard(const ConstMatrixView<T>& a,
+                         const ConstMatrixView<T>& b,
+                         const MatrixView<T>& c) {
+      binary(a,b,c,mul_op<T>());
+    }
+
+    // In-place implementation a = a.*b on views
+    template<typename T>
+    inline void hadamard(const MatrixView<T>& a,
+                         const ConstMatrixView<T>& b) {
+      binary(a,b,a,mul_op<T>());
+    }
+
+    // On-copy implementation c=a./b on views (views have no padding)
+    template<typename T>
+    inline void divide(const ConstMatrixView<T>& a,
+                       const ConstMatrixView<T>& b,
+                       const MatrixView<T>& c) {
+      binary(a,b,c,div_op<T>());
+    }
+
+    // In-place implementation a = a./b on views
+    template<typename T>
+    inline void divide(const MatrixView<T>& a,
+                       const ConstMatrixView<T>& b) {
+      binary(a,b,a,div_op<T>());
+    }
+
+    // On-copy implementation c=alpha*a on views
+    template<typename T>
+    inline void scale(const ConstMatrixView<T>& a,
+                      const T alpha,
+                      const MatrixView<T>& c) {
+      unary(a,c,scale_op<T>(alpha));
+    }
+
+    // In-place implementation a = alpha*a on views
+    template<typename T>
+    inline void scale(const MatrixView<T>& a,
+                      const T alpha) {
+      unary(a,a,scale_op<T>(alpha));
+    }
+
+    // On-copy implementation z=alpha*x+y on views
+    template<typename T>
+    inline void axpy(const T alpha,
+                     const ConstMatrixView<T>& x,
+                     const ConstMatrixView<T>& y,
+                     const MatrixView<T>& z) {
+      binary(y,x,z,axpy_op<T>(alpha));
+    }
+
+    // In-place implementation y = alpha*x+y on views
+    template<typename T>
+    inline void axpy(const T alpha,
+                     const ConstMatrixView<T>& x,
+                     const MatrixView<T>& y) {
+      binary(y,x,y,axpy_op<T>(alpha));
+    }
+
+    // On-copy implementation d=a.*b+c on views
+    template<typename T>
+    inline void fma(const ConstMatrixView<T>& a,
+                    const ConstMatrixView<T>& b,
+                    const ConstMatrixView<T>& c,
+                    const MatrixView<T>& d) {
+      ternary(a,b,c,d,fma_op<T>());
+    }
+
+    // In-place implementation a = a.*b+c on views
+    template<typename T>
+    inline void fma(const MatrixView<T>& a,
+                    const ConstMatrixView<T>& b,
+                    const ConstMatrixView<T>& c) {
+      ternary(a,b,c,a,fma_op<T>());
+    }
+
+
+    /*
+     * Product
+     */
+
+    // On-copy implementation c=a*b for floating point SIMD types
+    template<typename T,
+             class Alloc,
+             typename std::enable_if<is_simd_type<T>::value &&
+                                     std::is_floating_point<T>::value,
+                                     int>::type=0>
+    inline void multiply(const Matrix<T,Alloc>& a,
+                         const Matrix<T,Alloc>& b,
+                         Matrix<T,Alloc>& c) {
+
+      assert(a.cols() == b.rows());
+
+      // the result cannot be written over one of the operands
+      if ( (&c == &a) || (&c == &b) ) {
+        Matrix<T,Alloc> tmp;
+        multiply(a,b,tmp);
+        c.swap(tmp);
+        return;
+      }
+
+      // the operands are packed, so their alignment does not matter
+      switch (isa()) {
+#ifdef ANPI_SIMD_HAS_AVX512
+      case Isa::AVX512: avx512::multiply(a,b,c); break;
+#endif
+#ifdef ANPI_SIMD_HAS_AVX2
+      case Isa::AVX2:   avx2::multiply(a,b,c);   break;
+#endif
+#ifdef ANPI_SIMD_HAS_SSE2
+      case Isa::SSE2:   sse2::multiply(a,b,c);   break;
+#endif
+      default:          ::anpi::fallback::multiply(a,b,c);
+      }
+    }
+
+    // Integer and non-SIMD types such as complex
+    template<typename T,
+             class Alloc,
+             typename std::enable_if<!(is_simd_type<T>::value &&
+                                       std::is_floating_point<T>::value),
+                                     int>::type=0>
+    inline void multiply(const Matrix<T,Alloc>& a,
+                         const Matrix<T,Alloc>& b,
+                         Matrix<T,Alloc>& c) {
+
+      ::anpi::fallback::multiply(a,b,c);
+    }
+
+    /**
+     * On-copy implementation c=a*b on views of floating point SIMD types.
+     *
+     * The view c must have a.rows() x b.cols() entries and must not
+     * overlap a or b.
+     */
+    template<typename T,
+             typename std::enable_if<is_simd_type<T>::value &&
+                                     std::is_floating_point<T>::value,
+                                     int>::type=0>
+    inline void multiply(const ConstMatrixView<T>& a,
+                         const ConstMatrixView<T>& b,
+                         const MatrixView<T>& c) {
+
+      assert(a.cols() == b.rows());
+
+      switch (isa()) {
+#ifdef ANPI_SIMD_HAS_AVX512
+      case Isa::AVX512: avx512::multiply(a,b,c); break;
+#endif
+#ifdef ANPI_SIMD_HAS_AVX2
+      case Isa::AVX2:   avx2::multiply(a,b,c);   break;
+#endif
+#ifdef ANPI_SIMD_HAS_SSE2
+      case Isa::SSE2:   sse2::multiply(a,b,c);   break;
+#endif
+      default:          ::anpi::fallback::multiply(a,b,c);
+      }
+    }
+
+    // Views of integer and non-SIMD types such as complex
+    template<typename T,
+             typename std::enable_if<!(is_simd_type<T>::value &&
+                                       std::is_floating_point<T>::value),
+                                     int>::type=0>
+    inline void multiply(const ConstMatrixView<T>& a,
+                         const ConstMatrixView<T>& b,
+                         const MatrixView<T>& c) {
+
+      ::anpi::fallback::multiply(a,b,c);
+    }
+
+    /**
+     * Accumulating implementation c=c+alpha*a*b on views of floating
+     * point SIMD types.
+     *
+     * This is the update used by blocked algorithms.  The view c must
+     * have a.rows() x b.cols() entries and must not overlap a or b.
+     */
+    template<typename T,
+             typename std::enable_if<is_simd_type<T>::value &&
+                                     std::is_floating_point<T>::value,
+                                     int>::type=0>
+    inline void multiplyAdd(const T alpha,
+                            const ConstMatrixView<T>& a,
+                            const ConstMatrixView<T>& b,
+                            const MatrixView<T>& c) {
+
+      assert(a.cols() == b.rows());
+
+      switch (isa()) {
+#ifdef ANPI_SIMD_HAS_AVX512
+      case Isa::AVX512: avx512::multiplyAdd(alpha,a,b,c); break;
+#endif
+#ifdef ANPI_SIMD_HAS_AVX2
+      case Isa::AVX2:   avx2::multiplyAdd(alpha,a,b,c);   break;
+#endif
+#ifdef ANPI_SIMD_HAS_SSE2
+      case Isa::SSE2:   sse2::multiplyAdd(alpha,a,b,c);   break;
+#endif
+      default:          ::anpi::fallback::multiplyAdd(alpha,a,b,c);
+      }
+    }
+
+    // Views of integer and non-SIMD types such as complex
+    template<typename T,
+             typename std::enable_if<!(is_simd_type<T>::value &&
+                                       std::is_floating_point<T>::value),
+                                     int>::type=0>
+    inline void multiplyAdd(const T alpha,
+                            const ConstMatrixView<T>& a,
+                            const ConstMatrixView<T>& b,
+                            const MatrixView<T>& c) {
+
+      ::anpi::fallback::multiplyAdd(alpha,a,b,c);
+    }
+
+    /**
+     * y = A*x for a matrix A in compressed sparse row format, with
+     * floating point SIMD types.
+     *
+     * See fallback::spmv() in SparseProduct.hpp for the layout.
+     */
+    template<typename T,
+             typename std::enable_if<is_simd_type<T>::value &&
+                                     std::is_floating_point<T>::value,
+                                     int>::type=0>
+    inline void spmv(const size_t rows,
+                     const size_t* rowPtr,
+                     const sparse_index* cols,
+                     const T* vals,
+                     const T* x,
+                     T* y) {
+      switch (isa()) {
+#ifdef ANPI_SIMD_HAS_AVX512
+      case Isa::AVX512: avx512::spmv(rows,rowPtr,cols,vals,x,y); break;
+#endif
+#ifdef ANPI_SIMD_HAS_AVX2
+      case Isa::AVX2:   avx2::spmv(rows,rowPtr,cols,vals,x,y);   break;
+#endif
+#ifdef ANPI_SIMD_HAS_SSE2
+      case Isa::SSE2:   sse2::spmv(rows,rowPtr,cols,vals,x,y);   break;
+#endif
+      default:          ::anpi::fallback::spmv(rows,rowPtr,cols,vals,x,y);
+      }
+    }
+
+    // Integer and non-SIMD types such as complex
+    template<typename T,
+             typename std::enable_if<!(is_simd_type<T>::value &&
+                                       std::is_floating_point<T>::value),
+                                     int>::type=0>
+    inline void spmv(const size_t rows,
+                     const size_t* rowPtr,
+                     const sparse_index* cols,
+                     const T* vals,
+                     const T* x,
+                     T* y) {
+      ::anpi::fallback::spmv(rows,rowPtr,cols,vals,x,y);
+    }
+
+    /// Dot product of the n entries at a and b, for floating point types
+    template<typename T,
+             typename std::enable_if<is_simd_type<T>::value &&
+                                     std::is_floating_point<T>::value,
+                                     int>::type=0>
+    inline T dot(const T* a,const T* b,const size_t n) {
+      switch (isa()) {
+#ifdef ANPI_SIMD_HAS_AVX512
+      case Isa::AVX512: return avx512::dot(a,b,n);
+#endif
+#ifdef ANPI_SIMD_HAS_AVX2
+      case Isa::AVX2:   return avx2::dot(a,b,n);
+#endif
+#ifdef ANPI_SIMD_HAS_SSE2
+      case Isa::SSE2:   return sse2::dot(a,b,n);
+#endif
+      default:          return ::anpi::fallback::dot(a,b,n);
+      }
+    }
+
+    // Integer and non-SIMD types such as complex
+    template<typename T,
+             typename std::enable_if<!(is_simd_type<T>::value &&
+                                       std::is_floating_point<T>::value),
+                                     int>::type=0>
+    inline T dot(const T* a,const T* b,const size_t n) {
+      return ::anpi::fallback::dot(a,b,n);
+    }
+
+    /*
+     * Further reductions of n contiguous entries.  The *Kahan variants
+     * use compensated summation.
+     */
+
+    /// Compensated dot product of the n entries at a and b
+    template<typename T,
+             typename std::enable_if<is_simd_type<T>::value &&
+                                     std::is_floating_point<T>::value,
+                                     int>::type=0>
+    inline T dotKahan(const T* a,const T* b,const size_t n) {
+      switch (isa()) {
+#ifdef ANPI_SIMD_HAS_AVX512
+      case Isa::AVX512: return avx512::dotKahan(a,b,n);
+#endif
+#ifdef ANPI_SIMD_HAS_AVX2
+      case Isa::AVX2:   return avx2::dotKahan(a,b,n);
+#endif
+#ifdef ANPI_SIMD_HAS_SSE2
+      case Isa::SSE2:   return sse2::dotKahan(a,b,n);
+#endif
+      default:          return ::anpi::fallback::dotKahan(a,b,n);
+      }
+    }
+
+    // Integer and non-SIMD types such as complex
+    template<typename T,
+             typename std::enable_if<!(is_simd_type<T>::value &&
+                                       std::is_floating_point<T>::value),
+                                     int>::type=0>
+    inline T dotKahan(const T* a,const T* b,const size_t n) {
+      return ::anpi::fallback::dotKahan(a,b,n);
+    }
+
+    /// Sum of the n entries at a
+    template<typename T,
+             typename std::enable_if<is_simd_type<T>::value &&
+                                     std::is_floating_point<T>::value,
+                                     int>::type=0>
+    inline T sum(const T* a,const size_t n) {
+      switch (isa()) {
+#ifdef ANPI_SIMD_HAS_AVX512
+      case Isa::AVX512: return avx512::sum(a,n);
+#endif
+#ifdef ANPI_SIMD_HAS_AVX2
+      case Isa::AVX2:   return avx2::sum(a,n);
+#endif
+#ifdef ANPI_SIMD_HAS_SSE2
+      case Isa::SSE2:   return sse2::sum(a,n);
+#endif
+      default:          return ::anpi::fallback::sum(a,n);
+      }
+    }
+
+    // Integer and non-SIMD types such as complex
+    template<typename T,
+             typename std::enable_if<!(is_simd_type<T>::value &&
+                                       std::is_floating_point<T>::value),
+                                     int>::type=0>
+    inline T sum(const T* a,const size_t n) {
+      return ::anpi::fallback::sum(a,n);
+    }
+
+    /// Compensated sum of the n entries at a
+    template<typename T,
+             typename std::enable_if<is_simd_type<T>::value &&
+                                     std::is_floating_point<T>::value,
+                                     int>::type=0>
+    inline T sumKahan(const T* a,const size_t n) {
+      switch (isa()) {
+#ifdef ANPI_SIMD_HAS_AVX512
+      case Isa::AVX512: return avx512::sumKahan(a,n);
+#endif
+#ifdef ANPI_SIMD_HAS_AVX2
+      case Isa::AVX2:   return avx2::sumKahan(a,n);
+#endif
+#ifdef ANPI_SIMD_HAS_SSE2
+      case Isa::SSE2:   return sse2::sumKahan(a,n);
+#endif
+      default:          return ::anpi::fallback::sumKahan(a,n);
+      }
+    }
+
+    // Integer and non-SIMD types such as complex
+    template<typename T,
+             typename std::enable_if<!(is_simd_type<T>::value &&
+                                       std::is_floating_point<T>::value),
+                                     int>::type=0>
+    inline T sumKahan(const T* a,const size_t n) {
+      return ::anpi::fallback::sumKahan(a,n);
+    }
+
+    /// Sum of the absolute values of the n entries at a
+    template<typename T,
+             typename std::enable_if<is_simd_type<T>::value &&
+                                     std::is_floating_point<T>::value,
+                                     int>::type=0>
+    inline T sumAbs(const T* a,const size_t n) {
+      switch (isa()) {
+#ifdef ANPI_SIMD_HAS_AVX512
+      case Isa::AVX512: return avx512::sumAbs(a,n);
+#endif
+#ifdef ANPI_SIMD_HAS_AVX2
+      case Isa::AVX2:   return avx2::sumAbs(a,n);
+#endif
+#ifdef ANPI_SIMD_HAS_SSE2
+      case Isa::SSE2:   return sse2::sumAbs(a,n);
+#endif
+      default:          return ::anpi::fallback::sumAbs(a,n);
+      }
+    }
+
+    // Integer and non-SIMD types such as complex
+    template<typename T,
+             typename std::enable_if<!(is_simd_type<T>::value &&
+                                       std::is_floating_point<T>::value),
+                                     int>::type=0>
+    inline T sumAbs(const T* a,const size_t n) {
+      return ::anpi::fallback::sumAbs(a,n);
+    }
+
+    /// Compensated sum of the absolute values of the n entries at a
+    template<typename T,
+             typename std::enable_if<is_simd_type<T>::value &&
+                                     std::is_floating_point<T>::value,
+                                     int>::type=0>
+    inline T sumAbsKahan(const T* a,const size_t n) {
+      switch (isa()) {
+#ifdef ANPI_SIMD_HAS_AVX512
+      case Isa::AVX512: return avx512::sumAbsKahan(a,n);
+#endif
+#ifdef ANPI_SIMD_HAS_AVX2
+      case Isa::AVX2:   return avx2::sumAbsKahan(a,n);
+#endif
+#ifdef ANPI_SIMD_HAS_SSE2
+      case Isa::SSE2:   return sse2::sumAbsKahan(a,n);
+#endif
+      default:          return ::anpi::fallback::sumAbsKahan(a,n);
+      }
+    }
+
+    // Integer and non-SIMD types such as complex
+    template<typename T,
+             typename std::enable_if<!(is_simd_type<T>::value &&
+                                       std::is_floating_point<T>::value),
+                                     int>::type=0>
+    inline T sumAbsKahan(const T* a,const size_t n) {
+      return ::anpi::fallback::sumAbsKahan(a,n);
+    }
+
+    /// Largest of the n entries at a, ignoring NaN
+    template<typename T,
+             typename std::enable_if<is_simd_type<T>::value &&
+                                     std::is_floating_point<T>::value,
+                                     int>::type=0>
+    inline T max(const T* a,const size_t n) {
+      switch (isa()) {
+#ifdef ANPI_SIMD_HAS_AVX512
+      case Isa::AVX512: return avx512::max(a,n);
+#endif
+#ifdef ANPI_SIMD_HAS_AVX2
+      case Isa::AVX2:   return avx2::max(a,n);
+#endif
+#ifdef ANPI_SIMD_HAS_SSE2
+      case Isa::SSE2:   return sse2::max(a,n);
+#endif
+      default:          return ::anpi::fallback::max(a,n);
+      }
+    }
+
+    // Integer and non-SIMD types such as complex
+    template<typename T,
+             typename std::enable_if<!(is_simd_type<T>::value &&
+                                       std::is_floating_point<T>::value),
+                                     int>::type=0>
+    inline T max(const T* a,const size_t n) {
+      return ::anpi::fallback::max(a,n);
+    }
+
+    /// Smallest of the n entries at a, ignoring NaN
+    template<typename T,
+             typename std::enable_if<is_simd_type<T>::value &&
+                                     std::is_floating_point<T>::value,
+                                     int>::type=0>
+    inline T min(const T* a,const size_t n) {
+      switch (isa()) {
+#ifdef ANPI_SIMD_HAS_AVX512
+      case Isa::AVX512: return avx512::min(a,n);
+#endif
+#ifdef ANPI_SIMD_HAS_AVX2
+      case Isa::AVX2:   return avx2::min(a,n);
+#endif
+#ifdef ANPI_SIMD_HAS_SSE2
+      case Isa::SSE2:   return sse2::min(a,n);
+#endif
+      default:          return ::anpi::fallback::min(a,n);
+      }
+    }
+
+    // Integer and non-SIMD types such as complex
+    template<typename T,
+             typename std::enable_if<!(is_simd_type<T>::value &&
+                                       std::is_floating_point<T>::value),
+                                     int>::type=0>
+    inline T min(const T* a,const size_t n) {
+      return ::anpi::fallback::min(a,n);
+    }
+
+    /// Largest absolute value of the n entries at a, ignoring NaN
+    template<typename T,
+             typename std::enable_if<is_simd_type<T>::value &&
+                                     std::is_floating_point<T>::value,
+                                     int>::type=0>
+    inline T maxAbs(const T* a,const size_t n) {
+      switch (isa()) {
+#ifdef ANPI_SIMD_HAS_AVX512
+      case Isa::AVX512: return avx512::maxAbs(a,n);
+#endif
+#ifdef ANPI_SIMD_HAS_AVX2
+      case Isa::AVX2:   return avx2::maxAbs(a,n);
+#endif
+#ifdef ANPI_SIMD_HAS_SSE2
+      case Isa::SSE2:   return sse2::maxAbs(a,n);
+#endif
+      default:          return ::anpi::fallback::maxAbs(a,n);
+      }
+    }
+
+    // Integer and non-SIMD types such as complex
+    template<typename T,
+             typename std::enable_if<!(is_simd_type<T>::value &&
+                                       std::is_floating_point<T>::value),
+                                     int>::type=0>
+    inline T maxAbs(const T* a,const size_t n) {
+      return ::anpi::fallback::maxAbs(a,n);
+    }
+
+    /*
+     * Comparisons of n contiguous entries
+     */
+
+    /// Whether the n entries at a and b have the same bits, of any type
+    template<typename T>
+    inline bool sameBits(const T* a,const T* b,const size_t n) {
+      switch (isa()) {
+#ifdef ANPI_SIMD_HAS_AVX512
+      case Isa::AVX512: return avx512::sameBits(a,b,n);
+#endif
+#ifdef ANPI_SIMD_HAS_AVX2
+      case Isa::AVX2:   return avx2::sameBits(a,b,n);
+#endif
+#ifdef ANPI_SIMD_HAS_SSE2
+      case Isa::SSE2:   return sse2::sameBits(a,b,n);
+#endif
+      default:          return ::anpi::fallback::sameBits(a,b,n);
+      }
+    }
+
+    /// Whether |a[i]-b[i]| <= atol + rtol*|b[i]| for the n entries
+    template<typename T,
+             typename std::enable_if<is_simd_type<T>::value &&
+                                     std::is_floating_point<T>::value,
+                                     int>::type=0>
+    inline bool allclose(const T* a,
+                         const T* b,
+                         const size_t n,
+                         const T rtol,
+                         const T atol) {
+      switch (isa()) {
+#ifdef ANPI_SIMD_HAS_AVX512
+      case Isa::AVX512: return avx512::allclose(a,b,n,rtol,atol);
+#endif
+#ifdef ANPI_SIMD_HAS_AVX2
+      case Isa::AVX2:   return avx2::allclose(a,b,n,rtol,atol);
+#endif
+#ifdef ANPI_SIMD_HAS_SSE2
+      case Isa::SSE2:   return sse2::allclose(a,b,n,rtol,atol);
+#endif
+      default:          return ::anpi::fallback::allclose(a,b,n,rtol,atol);
+      }
+    }
+
+    // Integer and non-SIMD types such as complex
+    template<typename T,
+             typename std::enable_if<!(is_simd_type<T>::value &&
+                                       std::is_floating_point<T>::value),
+                                     int>::type=0>
+    inline bool allclose(const T* a,
+                         const T* b,
+                         const size_t n,
+                         const T rtol,
+                         const T atol) {
+      return ::anpi::fallback::allclose(a,b,n,rtol,atol);
+    }
+
+    /// Largest distance in ULP between the n entries at a and b
+    template<typename T,
+             typename std::enable_if<is_simd_type<T>::value &&
+                                     std::is_floating_point<T>::value,
+                                     int>::type=0>
+    inline std::uint64_t maxUlp(const T* a,const T* b,const size_t n) {
+      switch (isa()) {
+#ifdef ANPI_SIMD_HAS_AVX512
+      case Isa::AVX512: return avx512::maxUlp(a,b,n);
+#endif
+#ifdef ANPI_SIMD_HAS_AVX2
+      case Isa::AVX2:   return avx2::maxUlp(a,b,n);
+#endif
+#ifdef ANPI_SIMD_HAS_SSE2
+      case Isa::SSE2:   return sse2::maxUlp(a,b,n);
+#endif
+      default:          return ::anpi::fallback::maxUlp(a,b,n);
+      }
+    }
+
+
+    /// Roots of count <= BatchBlock equations (see RootBatch.hpp)
+    template<typename T,class F,
+             typename std::enable_if<is_simd_type<T>::value &&
+                                     std::is_floating_point<T>::value,
+                                     int>::type=0>
+    inline void batchRoots(const BatchRoot method,
+                           F& funct,
+                           const T* xl,
+                           const T* xu,
+                           T* roots,
+                           const size_t first,
+                           const size_t count,
+                           const T eps) {
+      switch (isa()) {
+#ifdef ANPI_SIMD_HAS_AVX512
+      case Isa::AVX512:
+        avx512::batchRoots(method,funct,xl,xu,roots,first,count,eps);
+        break;
+#endif
+#ifdef ANPI_SIMD_HAS_AVX2
+      case Isa::AVX2:
+        avx2::batchRoots(method,funct,xl,xu,roots,first,count,eps);
+        break;
+#endif
+#ifdef ANPI_SIMD_HAS_SSE2
+      case Isa::SSE2:
+        sse2::batchRoots(method,funct,xl,xu,roots,first,count,eps);
+        break;
+#endif
+      default:
+        ::anpi::fallback::batchRoots(method,funct,xl,xu,roots,first,count,eps);
+      }
+    }
+
+    // Other floating point types such as long double
+    template<typename T,class F,
+             typename std::enable_if<!(is_simd_type<T>::value &&
+                                       std::is_floating_point<T>::value),
+                                     int>::type=0>
+    inline void batchRoots(const BatchRoot method,
+                           F& funct,
+                           const T* xl,
+                           const T* xu,
+                           T* roots,
+                           const size_t first,
+                           const size_t count,
+                           const T eps) {
+      ::anpi::fallback::batchRoots(method,funct,xl,xu,roots,first,count,eps);
+    }
+
+  } // namespace simd
+} // namespace anpi
+
+#endif
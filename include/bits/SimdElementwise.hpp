@@ -0,0 +1,938 @@
+/*
+ * Copyright (C) 2017
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date:   28.12.2017
+ */
+
+/*
+ * Elementwise kernels and evaluation of matrix expressions for one
+ * instruction set.
+ *
+ * Like SimdRegisters.hpp, this file has no include guards: SimdDispatch.hpp
+ * includes it once per instruction set.
+ */
+
+    /*
+     * Register versions of the lane-wise operators.
+     *
+     * op_traits<Op>::simd tells if apply() can be instantiated for the
+     * operator Op with the registers of this instruction set.
+     */
+
+    template<class Op>
+    struct op_traits {
+      static constexpr bool simd = false;
+    };
+
+    template<typename T>
+    struct op_traits< add_op<T> > {
+      static constexpr bool simd = is_simd_type<T>::value;
+    };
+
+    template<typename T>
+    struct op_traits< sub_op<T> > {
+      static constexpr bool simd = is_simd_type<T>::value;
+    };
+
+    template<typename T>
+    struct op_traits< mul_op<T> > {
+      static constexpr bool simd = has_mm_mul<T>::value;
+    };
+
+    template<typename T>
+    struct op_traits< div_op<T> > {
+      static constexpr bool simd =
+        is_simd_type<T>::value && std::is_floating_point<T>::value;
+    };
+
+    template<typename T>
+    struct op_traits< scale_op<T> > {
+      static constexpr bool simd = has_mm_mul<T>::value;
+    };
+
+    template<typename T>
+    struct op_traits< axpy_op<T> > {
+      static constexpr bool simd = has_mm_mul<T>::value;
+    };
+
+    template<typename T>
+    struct op_traits< fma_op<T> > {
+      static constexpr bool simd = has_mm_mul<T>::value;
+    };
+
+    /*
+     * Complex entries are interleaved real and imaginary lanes of the
+     * registers of the real type (see SimdComplex.hpp).  Sums and
+     * differences are those of the lanes, the products and conjugates
+     * shuffle them.  Division, scaling and fma stay in the fallback.
+     */
+
+    template<typename R>
+    struct op_traits< add_op< std::complex<R> > > {
+      static constexpr bool simd = is_simd_complex< std::complex<R> >::value;
+    };
+
+    template<typename R>
+    struct op_traits< sub_op< std::complex<R> > > {
+      static constexpr bool simd = is_simd_complex< std::complex<R> >::value;
+    };
+
+    template<typename R>
+    struct op_traits< mul_op< std::complex<R> > > {
+      static constexpr bool simd = is_simd_complex< std::complex<R> >::value;
+    };
+
+    template<typename T>
+    struct op_traits< conj_op<T> > {
+      static constexpr bool simd = is_simd_complex<T>::value;
+    };
+
+    /// a+b
+    template<class regType,typename T>
+    inline regType apply(const add_op<T>&,
+                         const regType a,const regType b) {
+      return mm_add<T>(a,b);
+    }
+
+    /// a-b
+    template<class regType,typename T>
+    inline regType apply(const sub_op<T>&,
+                         const regType a,const regType b) {
+      return mm_sub<T>(a,b);
+    }
+
+    /// a*b
+    template<class regType,typename T>
+    inline regType apply(const mul_op<T>&,
+                         const regType a,const regType b) {
+      return mm_mul<T>(a,b);
+    }
+
+    /// a/b
+    template<class regType,typename T>
+    inline regType apply(const div_op<T>&,
+                         const regType a,const regType b) {
+      return mm_div<T>(a,b);
+    }
+
+    /// alpha*a
+    template<class regType,typename T>
+    inline regType apply(const scale_op<T>& op,
+                         const regType a) {
+      return mm_mul<T>(mm_set1<T,regType>(op.alpha),a);
+    }
+
+    /// y+alpha*x
+    template<class regType,typename T>
+    inline regType apply(const axpy_op<T>& op,
+                         const regType y,const regType x) {
+      return mm_fmadd<T>(mm_set1<T,regType>(op.alpha),x,y);
+    }
+
+    /// a*b+c
+    template<class regType,typename T>
+    inline regType apply(const fma_op<T>&,
+                         const regType a,const regType b,const regType c) {
+      return mm_fmadd<T>(a,b,c);
+    }
+
+    /// a+b of complex entries
+    template<class regType,typename R>
+    inline regType apply(const add_op< std::complex<R> >&,
+                         const regType a,const regType b) {
+      return mm_add<R>(a,b);
+    }
+
+    /// a-b of complex entries
+    template<class regType,typename R>
+    inline regType apply(const sub_op< std::complex<R> >&,
+                         const regType a,const regType b) {
+      return mm_sub<R>(a,b);
+    }
+
+    /// a*b of complex entries
+    template<class regType,typename R>
+    inline regType apply(const mul_op< std::complex<R> >&,
+                         const regType a,const regType b) {
+      return reg_cmul(a,b);
+    }
+
+    /// conj(a) of complex entries
+    template<class regType,typename T>
+    inline regType apply(const conj_op<T>&,
+                         const regType a) {
+      return reg_conj(a);
+    }
+
+    /*
+     * Elementwise kernel engine.
+     *
+     * With aligned allocators, which pad the rows (or the whole buffer)
+     * to the alignment, the kernels traverse the whole buffer, padding
+     * included, in blocks of one register.  For them the dispatcher
+     * never selects registers wider than the alignment.  Every other
+     * allocator uses the flat kernels below (unaryFlat(), binaryFlat(),
+     * ternaryFlat() and evaluateFlat()), which work with any register
+     * width: they cover the unaligned head and the tail of each chunk
+     * with masked partial registers (or scalar entries, for the types
+     * without masked loads), and the rest with unaligned loads and
+     * stores.
+     *
+     * Large matrices are split among threads by rows: with row-aligned
+     * allocators each thread receives whole padded rows, which start at
+     * aligned addresses, and otherwise the chunks are cache line multiples.
+     *
+     * Outputs larger than the streaming threshold (see CpuFeatures.hpp)
+     * are written with non-temporal stores, which need the aligned
+     * register blocks, so only the kernels of aligned allocators stream.
+     * Each thread fences its own stores before leaving its chunk.
+     * Outputs that are also operands, as in c+=a, keep the regular
+     * stores: their lines were just read into the cache, and streaming
+     * would evict them.
+     */
+
+    /// Granularity of the thread chunks, in registers
+    template<typename T,class Alloc,typename regType>
+    inline size_t grain(const size_t dcols) {
+      return extract_alignment<Alloc>::row_aligned
+        ? std::max<size_t>(1,(dcols*sizeof(T))/sizeof(regType))
+        : std::max<size_t>(1,parallel::CacheLine/sizeof(regType));
+    }
+
+    // On-copy implementation c=op(a)
+    template<typename T,class Alloc,typename regType,class Op>
+    inline void unarySIMD(const Matrix<T,Alloc>& a,
+                          Matrix<T,Alloc>& c,
+                          const Op& op) {
+
+      assert(extract_alignment<Alloc>::value >= sizeof(regType));
+
+      const size_t tentries = a.rows()*a.dcols();
+      c.allocate(a.rows(),a.cols());
+
+      regType* here        = reinterpret_cast<regType*>(c.data());
+      const size_t  blocks = ( tentries*sizeof(T) + (sizeof(regType)-1) )/
+        sizeof(regType);
+      const bool stream    = streaming(blocks*sizeof(regType)) &&
+                             (c.data() != a.data());
+      const regType* aptr  = reinterpret_cast<const regType*>(a.data());
+
+      parallel::forChunks(blocks,grain<T,Alloc,regType>(a.dcols()),tentries,
+                          [&](const size_t begin,const size_t end) {
+        if (stream) {
+          for (size_t i=begin;i<end;++i) {
+            mm_stream(here+i,apply<regType>(op,aptr[i]));
+          }
+          mm_sfence();
+        } else {
+          for (size_t i=begin;i<end;++i) {
+            here[i] = apply<regType>(op,aptr[i]);
+          }
+        }
+      });
+    }
+
+    // On-copy implementation c=op(a,b)
+    template<typename T,class Alloc,typename regType,class Op>
+    inline void binarySIMD(const Matrix<T,Alloc>& a,
+                           const Matrix<T,Alloc>& b,
+                           Matrix<T,Alloc>& c,
+                           const Op& op) {
+
+      assert(extract_alignment<Alloc>::value >= sizeof(regType));
+
+      const size_t tentries = a.rows()*a.dcols();
+      c.allocate(a.rows(),a.cols());
+
+      regType* here        = reinterpret_cast<regType*>(c.data());
+      const size_t  blocks = ( tentries*sizeof(T) + (sizeof(regType)-1) )/
+        sizeof(regType);
+      const bool stream    = streaming(blocks*sizeof(regType)) &&
+                             (c.data() != a.data()) && (c.data() != b.data());
+      const regType* aptr  = reinterpret_cast<const regType*>(a.data());
+      const regType* bptr  = reinterpret_cast<const regType*>(b.data());
+
+      parallel::forChunks(blocks,grain<T,Alloc,regType>(a.dcols()),tentries,
+                          [&](const size_t begin,const size_t end) {
+        if (stream) {
+          for (size_t i=begin;i<end;++i) {
+            mm_stream(here+i,apply<regType>(op,aptr[i],bptr[i]));
+          }
+          mm_sfence();
+        } else {
+          for (size_t i=begin;i<end;++i) {
+            here[i] = apply<regType>(op,aptr[i],bptr[i]);
+          }
+        }
+      });
+    }
+
+    // On-copy implementation d=op(a,b,c)
+    template<typename T,class Alloc,typename regType,class Op>
+    inline void ternarySIMD(const Matrix<T,Alloc>& a,
+                            const Matrix<T,Alloc>& b,
+                            const Matrix<T,Alloc>& c,
+                            Matrix<T,Alloc>& d,
+                            const Op& op) {
+
+      assert(extract_alignment<Alloc>::value >= sizeof(regType));
+
+      const size_t tentries = a.rows()*a.dcols();
+      d.allocate(a.rows(),a.cols());
+
+      regType* here        = reinterpret_cast<regType*>(d.data());
+      const size_t  blocks = ( tentries*sizeof(T) + (sizeof(regType)-1) )/
+        sizeof(regType);
+      const bool stream    = streaming(blocks*sizeof(regType)) &&
+                             (d.data() != a.data()) &&
+                             (d.data() != b.data()) && (d.data() != c.data());
+      const regType* aptr  = reinterpret_cast<const regType*>(a.data());
+      const regType* bptr  = reinterpret_cast<const regType*>(b.data());
+      const regType* cptr  = reinterpret_cast<const regType*>(c.data());
+
+      parallel::forChunks(blocks,grain<T,Alloc,regType>(a.dcols()),tentries,
+                          [&](const size_t begin,const size_t end) {
+        if (stream) {
+          for (size_t i=begin;i<end;++i) {
+            mm_stream(here+i,apply<regType>(op,aptr[i],bptr[i],cptr[i]));
+          }
+          mm_sfence();
+        } else {
+          for (size_t i=begin;i<end;++i) {
+            here[i] = apply<regType>(op,aptr[i],bptr[i],cptr[i]);
+          }
+        }
+      });
+    }
+
+    /*
+     * Elementwise kernels on buffers without alignment or padding.
+     *
+     * Allocators without alignment guarantees give buffers that may start
+     * anywhere and end right after the last entry.  Each thread chunk is
+     * processed as a partial register up to the first address of the
+     * result aligned to the register size (the head), whole registers
+     * with unaligned loads, and a partial register with the remaining
+     * entries (the tail).  The partial registers use masked loads and
+     * stores where the instruction set provides them for T (see reg_part),
+     * and the scalar operator otherwise, so that no byte outside of the
+     * buffers is accessed.
+     *
+     * The sources provide the registers or entries starting at a given
+     * offset of the buffers.
+     */
+
+    /// Source op(a)
+    template<typename T,class Op>
+    struct flat_unary {
+      const T* a;
+      const Op& op;
+
+      template<class regType>
+      inline regType reg(const size_t i) const {
+        return apply<regType>(op,reg_io<T>::loadu(a+i));
+      }
+      template<class regType>
+      inline regType part(const size_t i,const size_t n) const {
+        return apply<regType>(op,reg_part<T>::load(a+i,n));
+      }
+      inline T at(const size_t i) const { return op(a[i]); }
+    };
+
+    /// Source op(a,b)
+    template<typename T,class Op>
+    struct flat_binary {
+      const T* a;
+      const T* b;
+      const Op& op;
+
+      template<class regType>
+      inline regType reg(const size_t i) const {
+        return apply<regType>(op,
+                              reg_io<T>::loadu(a+i),
+                              reg_io<T>::loadu(b+i));
+      }
+      template<class regType>
+      inline regType part(const size_t i,const size_t n) const {
+        return apply<regType>(op,
+                              reg_part<T>::load(a+i,n),
+                              reg_part<T>::load(b+i,n));
+      }
+      inline T at(const size_t i) const { return op(a[i],b[i]); }
+    };
+
+    /// Source op(a,b,c)
+    template<typename T,class Op>
+    struct flat_ternary {
+      const T* a;
+      const T* b;
+      const T* c;
+      const Op& op;
+
+      template<class regType>
+      inline regType reg(const size_t i) const {
+        return apply<regType>(op,
+                              reg_io<T>::loadu(a+i),
+                              reg_io<T>::loadu(b+i),
+                              reg_io<T>::loadu(c+i));
+      }
+      template<class regType>
+      inline regType part(const size_t i,const size_t n) const {
+        return apply<regType>(op,
+                              reg_part<T>::load(a+i,n),
+                              reg_part<T>::load(b+i,n),
+                              reg_part<T>::load(c+i,n));
+      }
+      inline T at(const size_t i) const { return op(a[i],b[i],c[i]); }
+    };
+
+    /// Entries [i,i+n) of the source, with n smaller than a register
+    template<typename T,class Src>
+    inline void flatPart(T* here,const size_t i,const size_t n,
+                         const Src& src,std::true_type) {
+      typedef reg_part<T> part;
+      part::store(here+i,n,src.template part<typename part::reg_type>(i,n));
+    }
+
+    /// Entries [i,i+n) of the source, without masked registers for T
+    template<typename T,class Src>
+    inline void flatPart(T* here,const size_t i,const size_t n,
+                         const Src& src,std::false_type) {
+      for (size_t j=i;j<i+n;++j) {
+        here[j] = src.at(j);
+      }
+    }
+
+    /// Write the entries [begin,end) of the source into here
+    template<typename T,class Src>
+    inline void flatRange(T* here,
+                          const size_t begin,
+                          const size_t end,
+                          const Src& src) {
+      typedef reg_io<T> io;
+      typedef typename io::reg_type regType;
+      typedef std::integral_constant<bool,reg_part<T>::masked> masked;
+      const size_t L = sizeof(regType)/sizeof(T);
+
+      size_t i = begin;
+      const size_t misalign =
+        size_t(reinterpret_cast<std::uintptr_t>(here+i) % sizeof(regType));
+      if (misalign != 0) {
+        const size_t head =
+          std::min(end-i,(sizeof(regType)-misalign)/sizeof(T));
+        flatPart(here,i,head,src,masked());
+        i += head;
+      }
+      for (;i+L<=end;i+=L) {
+        io::storeu(here+i,src.template reg<regType>(i));
+      }
+      if (i<end) {
+        flatPart(here,i,end-i,src,masked());
+      }
+    }
+
+    // On-copy implementation c=op(a) on any buffer
+    template<typename T,class Alloc,class Op>
+    inline void unaryFlat(const Matrix<T,Alloc>& a,
+                          Matrix<T,Alloc>& c,
+                          const Op& op) {
+
+      const size_t tentries = a.rows()*a.dcols();
+      c.allocate(a.rows(),a.cols());
+
+      T* here = c.data();
+      const flat_unary<T,Op> src = { a.data(),op };
+
+      parallel::forChunks(tentries,::anpi::fallback::grain<T,Alloc>(a.dcols()),
+                          tentries,
+                          [&](const size_t begin,const size_t end) {
+        flatRange(here,begin,end,src);
+      });
+    }
+
+    // On-copy implementation c=op(a,b) on any buffer
+    template<typename T,class Alloc,class Op>
+    inline void binaryFlat(const Matrix<T,Alloc>& a,
+                           const Matrix<T,Alloc>& b,
+                           Matrix<T,Alloc>& c,
+                           const Op& op) {
+
+      const size_t tentries = a.rows()*a.dcols();
+      c.allocate(a.rows(),a.cols());
+
+      T* here = c.data();
+      const flat_binary<T,Op> src = { a.data(),b.data(),op };
+
+      parallel::forChunks(tentries,::anpi::fallback::grain<T,Alloc>(a.dcols()),
+                          tentries,
+                          [&](const size_t begin,const size_t end) {
+        flatRange(here,begin,end,src);
+      });
+    }
+
+    // On-copy implementation d=op(a,b,c) on any buffer
+    template<typename T,class Alloc,class Op>
+    inline void ternaryFlat(const Matrix<T,Alloc>& a,
+                            const Matrix<T,Alloc>& b,
+                            const Matrix<T,Alloc>& c,
+                            Matrix<T,Alloc>& d,
+                            const Op& op) {
+
+      const size_t tentries = a.rows()*a.dcols();
+      d.allocate(a.rows(),a.cols());
+
+      T* here = d.data();
+      const flat_ternary<T,Op> src = { a.data(),b.data(),c.data(),op };
+
+      parallel::forChunks(tentries,::anpi::fallback::grain<T,Alloc>(a.dcols()),
+                          tentries,
+                          [&](const size_t begin,const size_t end) {
+        flatRange(here,begin,end,src);
+      });
+    }
+
+    // Operator available in registers
+    template<typename T,class Alloc,class Op>
+    inline void unary(const Matrix<T,Alloc>& a,
+                      Matrix<T,Alloc>& c,
+                      const Op& op,
+                      std::true_type) {
+      if (is_aligned_alloc<Alloc>::value) {
+        unarySIMD<T,Alloc,typename reg_traits<T>::reg_type>(a,c,op);
+      } else { // allocator seems to be unaligned
+        unaryFlat(a,c,op);
+      }
+    }
+
+    // Operator not available in registers for T
+    template<typename T,class Alloc,class Op>
+    inline void unary(const Matrix<T,Alloc>& a,
+                      Matrix<T,Alloc>& c,
+                      const Op& op,
+                      std::false_type) {
+      ::anpi::fallback::unary(a,c,op);
+    }
+
+    // On-copy implementation c=op(a)
+    template<typename T,class Alloc,class Op>
+    inline void unary(const Matrix<T,Alloc>& a,
+                      Matrix<T,Alloc>& c,
+                      const Op& op) {
+      unary(a,c,op,std::integral_constant<bool,op_traits<Op>::simd>());
+    }
+
+    // Operator available in registers
+    template<typename T,class Alloc,class Op>
+    inline void binary(const Matrix<T,Alloc>& a,
+                       const Matrix<T,Alloc>& b,
+                       Matrix<T,Alloc>& c,
+                       const Op& op,
+                       std::true_type) {
+      if (is_aligned_alloc<Alloc>::value) {
+        binarySIMD<T,Alloc,typename reg_traits<T>::reg_type>(a,b,c,op);
+      } else { // allocator seems to be unaligned
+        binaryFlat(a,b,c,op);
+      }
+    }
+
+    // Operator not available in registers for T
+    template<typename T,class Alloc,class Op>
+    inline void binary(const Matrix<T,Alloc>& a,
+                       const Matrix<T,Alloc>& b,
+                       Matrix<T,Alloc>& c,
+                       const Op& op,
+                       std::false_type) {
+      ::anpi::fallback::binary(a,b,c,op);
+    }
+
+    // On-copy implementation c=op(a,b)
+    template<typename T,class Alloc,class Op>
+    inline void binary(const Matrix<T,Alloc>& a,
+                       const Matrix<T,Alloc>& b,
+                       Matrix<T,Alloc>& c,
+                       const Op& op) {
+      binary(a,b,c,op,std::integral_constant<bool,op_traits<Op>::simd>());
+    }
+
+    // Operator available in registers
+    template<typename T,class Alloc,class Op>
+    inline void ternary(const Matrix<T,Alloc>& a,
+                        const Matrix<T,Alloc>& b,
+                        const Matrix<T,Alloc>& c,
+                        Matrix<T,Alloc>& d,
+                        const Op& op,
+                        std::true_type) {
+      if (is_aligned_alloc<Alloc>::value) {
+        ternarySIMD<T,Alloc,typename reg_traits<T>::reg_type>(a,b,c,d,op);
+      } else { // allocator seems to be unaligned
+        ternaryFlat(a,b,c,d,op);
+      }
+    }
+
+    // Operator not available in registers for T
+    template<typename T,class Alloc,class Op>
+    inline void ternary(const Matrix<T,Alloc>& a,
+                        const Matrix<T,Alloc>& b,
+                        const Matrix<T,Alloc>& c,
+                        Matrix<T,Alloc>& d,
+                        const Op& op,
+                        std::false_type) {
+      ::anpi::fallback::ternary(a,b,c,d,op);
+    }
+
+    // On-copy implementation d=op(a,b,c)
+    template<typename T,class Alloc,class Op>
+    inline void ternary(const Matrix<T,Alloc>& a,
+                        const Matrix<T,Alloc>& b,
+                        const Matrix<T,Alloc>& c,
+                        Matrix<T,Alloc>& d,
+                        const Op& op) {
+      ternary(a,b,c,d,op,std::integral_constant<bool,op_traits<Op>::simd>());
+    }
+
+    /*
+     * Elementwise kernels on views.
+     *
+     * The rows of a view can start anywhere and have no padding, so each
+     * row is processed with unaligned loads and stores, and the last
+     * entries that do not fill a register with the scalar operator.
+     */
+
+    // On-copy implementation c=op(a), operator available in registers
+    template<typename T,class Op>
+    inline void unary(const ConstMatrixView<T>& a,
+                      const MatrixView<T>& c,
+                      const Op& op,
+                      std::true_type) {
+
+      typedef reg_io<T> io;
+      typedef typename io::reg_type regType;
+      const size_t L    = sizeof(regType)/sizeof(T);
+      const size_t cols = a.cols();
+      const size_t vcols = cols - cols%L;
+
+      parallel::forChunks(a.rows(),1,a.entries(),
+                          [&](const size_t begin,const size_t end) {
+        for (size_t r=begin;r<end;++r) {
+          const T* aptr = a[r];
+          T* here       = c[r];
+          size_t j=0;
+          for (;j<vcols;j+=L) {
+            io::storeu(here+j,apply<regType>(op,io::loadu(aptr+j)));
+          }
+          for (;j<cols;++j) {
+            here[j] = op(aptr[j]);
+          }
+        }
+      });
+    }
+
+    // Operator not available in registers for T
+    template<typename T,class Op>
+    inline void unary(const ConstMatrixView<T>& a,
+                      const MatrixView<T>& c,
+                      const Op& op,
+                      std::false_type) {
+      ::anpi::fallback::unary(a,c,op);
+    }
+
+    // On-copy implementation c=op(a) on views
+    template<typename T,class Op>
+    inline void unary(const ConstMatrixView<T>& a,
+                      const MatrixView<T>& c,
+                      const Op& op) {
+      assert( (a.rows() == c.rows()) &&
+              (a.cols() == c.cols()) );
+      unary(a,c,op,std::integral_constant<bool,op_traits<Op>::simd>());
+    }
+
+    // On-copy implementation c=op(a,b), operator available in registers
+    template<typename T,class Op>
+    inline void binary(const ConstMatrixView<T>& a,
+                       const ConstMatrixView<T>& b,
+                       const MatrixView<T>& c,
+                       const Op& op,
+                       std::true_type) {
+
+      typedef reg_io<T> io;
+      typedef typename io::reg_type regType;
+      const size_t L    = sizeof(regType)/sizeof(T);
+      const size_t cols = a.cols();
+      const size_t vcols = cols - cols%L;
+
+      parallel::forChunks(a.rows(),1,a.entries(),
+                          [&](const size_t begin,const size_t end) {
+        for (size_t r=begin;r<end;++r) {
+          const T* aptr = a[r];
+          const T* bptr = b[r];
+          T* here       = c[r];
+          size_t j=0;
+          for (;j<vcols;j+=L) {
+            io::storeu(here+j,apply<regType>(op,
+                                             io::loadu(aptr+j),
+                                             io::loadu(bptr+j)));
+          }
+          for (;j<cols;++j) {
+            here[j] = op(aptr[j],bptr[j]);
+          }
+        }
+      });
+    }
+
+    // Operator not available in registers for T
+    template<typename T,class Op>
+    inline void binary(const ConstMatrixView<T>& a,
+                       const ConstMatrixView<T>& b,
+                       const MatrixView<T>& c,
+                       const Op& op,
+                       std::false_type) {
+      ::anpi::fallback::binary(a,b,c,op);
+    }
+
+    // On-copy implementation c=op(a,b) on views
+    template<typename T,class Op>
+    inline void binary(const ConstMatrixView<T>& a,
+                       const ConstMatrixView<T>& b,
+                       const MatrixView<T>& c,
+                       const Op& op) {
+      assert( (a.rows() == b.rows()) && (a.cols() == b.cols()) &&
+              (a.rows() == c.rows()) && (a.cols() == c.cols()) );
+      binary(a,b,c,op,std::integral_constant<bool,op_traits<Op>::simd>());
+    }
+
+    // On-copy implementation d=op(a,b,c), operator available in registers
+    template<typename T,class Op>
+    inline void ternary(const ConstMatrixView<T>& a,
+                        const ConstMatrixView<T>& b,
+                        const ConstMatrixView<T>& c,
+                        const MatrixView<T>& d,
+                        const Op& op,
+                        std::true_type) {
+
+      typedef reg_io<T> io;
+      typedef typename io::reg_type regType;
+      const size_t L    = sizeof(regType)/sizeof(T);
+      const size_t cols = a.cols();
+      const size_t vcols = cols - cols%L;
+
+      parallel::forChunks(a.rows(),1,a.entries(),
+                          [&](const size_t begin,const size_t end) {
+        for (size_t r=begin;r<end;++r) {
+          const T* aptr = a[r];
+          const T* bptr = b[r];
+          const T* cptr = c[r];
+          T* here       = d[r];
+          size_t j=0;
+          for (;j<vcols;j+=L) {
+            io::storeu(here+j,apply<regType>(op,
+                                             io::loadu(aptr+j),
+                                             io::loadu(bptr+j),
+                                             io::loadu(cptr+j)));
+          }
+          for (;j<cols;++j) {
+            here[j] = op(aptr[j],bptr[j],cptr[j]);
+          }
+        }
+      });
+    }
+
+    // Operator not available in registers for T
+    template<typename T,class Op>
+    inline void ternary(const ConstMatrixView<T>& a,
+                        const ConstMatrixView<T>& b,
+                        const ConstMatrixView<T>& c,
+                        const MatrixView<T>& d,
+                        const Op& op,
+                        std::false_type) {
+      ::anpi::fallback::ternary(a,b,c,d,op);
+    }
+
+    // On-copy implementation d=op(a,b,c) on views
+    template<typename T,class Op>
+    inline void ternary(const ConstMatrixView<T>& a,
+                        const ConstMatrixView<T>& b,
+                        const ConstMatrixView<T>& c,
+                        const MatrixView<T>& d,
+                        const Op& op) {
+      assert( (a.rows() == b.rows()) && (a.cols() == b.cols()) &&
+              (a.rows() == c.rows()) && (a.cols() == c.cols()) &&
+              (a.rows() == d.rows()) && (a.cols() == d.cols()) );
+      ternary(a,b,c,d,op,std::integral_constant<bool,op_traits<Op>::simd>());
+    }
+
+    /*
+     * Evaluation of matrix expressions, one register at a time
+     */
+
+    /// Check if the whole expression tree can be evaluated in registers
+    template<class E>
+    struct expr_traits {
+      static constexpr bool simd = false;
+    };
+
+    template<typename T,class Alloc>
+    struct expr_traits< expr::Leaf<T,Alloc> > {
+      static constexpr bool simd =
+        is_simd_type<T>::value || is_simd_complex<T>::value;
+    };
+
+    template<class L,class R,class Op,typename T,class Alloc>
+    struct expr_traits< expr::Binary<L,R,Op,T,Alloc> > {
+      static constexpr bool simd =
+        expr_traits<L>::simd && expr_traits<R>::simd && op_traits<Op>::simd;
+    };
+
+    /// i-th register of a leaf, including padding
+    template<class regType,typename T,class Alloc>
+    inline regType evalReg(const expr::Leaf<T,Alloc>& e,const size_t i) {
+      return reinterpret_cast<const regType*>(e.data())[i];
+    }
+
+    /// i-th register of the result of an interior node
+    template<class regType,class L,class R,class Op,typename T,class Alloc>
+    inline regType evalReg(const expr::Binary<L,R,Op,T,Alloc>& e,
+                           const size_t i) {
+      return apply<regType>(e.op(),
+                            evalReg<regType>(e.left(),i),
+                            evalReg<regType>(e.right(),i));
+    }
+
+    /// Whether a leaf of the expression holds the given entries
+    template<typename T,class Alloc>
+    inline bool reads(const expr::Leaf<T,Alloc>& e,const T* p) {
+      return e.data() == p;
+    }
+
+    template<class L,class R,class Op,typename T,class Alloc>
+    inline bool reads(const expr::Binary<L,R,Op,T,Alloc>& e,const T* p) {
+      return reads(e.left(),p) || reads(e.right(),p);
+    }
+
+    // Materialize the expression e into c, one register at a time
+    template<typename T,class Alloc,typename regType,class E>
+    inline void evaluateSIMD(const E& e,
+                             Matrix<T,Alloc>& c) {
+
+      assert(extract_alignment<Alloc>::value >= sizeof(regType));
+
+      const size_t tentries = e.rows()*e.dcols();
+      c.allocate(e.rows(),e.cols());
+
+      regType* here        = reinterpret_cast<regType*>(c.data());
+      const size_t  blocks = ( tentries*sizeof(T) + (sizeof(regType)-1) )/
+        sizeof(regType);
+      const bool stream    = streaming(blocks*sizeof(regType)) &&
+                             !reads(e,c.data());
+
+      parallel::forChunks(blocks,grain<T,Alloc,regType>(e.dcols()),tentries,
+                          [&](const size_t begin,const size_t end) {
+        if (stream) {
+          for (size_t i=begin;i<end;++i) {
+            mm_stream(here+i,evalReg<regType>(e,i));
+          }
+          mm_sfence();
+        } else {
+          for (size_t i=begin;i<end;++i) {
+            here[i] = evalReg<regType>(e,i);
+          }
+        }
+      });
+    }
+
+    /// Register of a leaf starting at entry i, at any address
+    template<class regType,typename T,class Alloc>
+    inline regType evalRegU(const expr::Leaf<T,Alloc>& e,const size_t i) {
+      return reg_io<T>::loadu(e.data()+i);
+    }
+
+    /// Register of an interior node starting at entry i, at any address
+    template<class regType,class L,class R,class Op,typename T,class Alloc>
+    inline regType evalRegU(const expr::Binary<L,R,Op,T,Alloc>& e,
+                            const size_t i) {
+      return apply<regType>(e.op(),
+                            evalRegU<regType>(e.left(),i),
+                            evalRegU<regType>(e.right(),i));
+    }
+
+    /// Partial register of a leaf with the n entries starting at i
+    template<class regType,typename T,class Alloc>
+    inline regType evalPart(const expr::Leaf<T,Alloc>& e,
+                            const size_t i,
+                            const size_t n) {
+      return reg_part<T>::load(e.data()+i,n);
+    }
+
+    /// Partial register of an interior node with the n entries from i
+    template<class regType,class L,class R,class Op,typename T,class Alloc>
+    inline regType evalPart(const expr::Binary<L,R,Op,T,Alloc>& e,
+                            const size_t i,
+                            const size_t n) {
+      return apply<regType>(e.op(),
+                            evalPart<regType>(e.left(),i,n),
+                            evalPart<regType>(e.right(),i,n));
+    }
+
+    /// Source with the entries of an expression (see flatRange)
+    template<typename T,class E>
+    struct flat_expr {
+      const E& e;
+
+      template<class regType>
+      inline regType reg(const size_t i) const {
+        return evalRegU<regType>(e,i);
+      }
+      template<class regType>
+      inline regType part(const size_t i,const size_t n) const {
+        return evalPart<regType>(e,i,n);
+      }
+      inline T at(const size_t i) const { return e.at(i); }
+    };
+
+    // Materialize the expression e into c on any buffer
+    template<typename T,class Alloc,class E>
+    inline void evaluateFlat(const E& e,
+                             Matrix<T,Alloc>& c) {
+
+      const size_t tentries = e.rows()*e.dcols();
+      c.allocate(e.rows(),e.cols());
+
+      T* here = c.data();
+      const flat_expr<T,E> src = { e };
+
+      parallel::forChunks(tentries,::anpi::fallback::grain<T,Alloc>(e.dcols()),
+                          tentries,
+                          [&](const size_t begin,const size_t end) {
+        flatRange(here,begin,end,src);
+      });
+    }
+
+    // Expression can be evaluated in registers
+    template<typename T,class Alloc,class E>
+    inline void evaluate(const MatrixExpression<E,T,Alloc>& e,
+                         Matrix<T,Alloc>& c,
+                         std::true_type) {
+      if (is_aligned_alloc<Alloc>::value) {
+        evaluateSIMD<T,Alloc,typename reg_traits<T>::reg_type>(e.derived(),c);
+      } else { // allocator seems to be unaligned
+        evaluateFlat(e.derived(),c);
+      }
+    }
+
+    // Expression has operations without register support
+    template<typename T,class Alloc,class E>
+    inline void evaluate(const MatrixExpression<E,T,Alloc>& e,
+                         Matrix<T,Alloc>& c,
+                         std::false_type) {
+      ::anpi::fallback::evaluate(e,c);
+    }
+
+    // Materialize the expression e into c
+    template<typename T,class Alloc,class E>
+    inline void evaluate(const MatrixExpression<E,T,Alloc>& e,
+                         Matrix<T,Alloc>& c) {
+      evaluate(e,c,std::integral_constant<bool,expr_traits<E>::simd>());
+    }
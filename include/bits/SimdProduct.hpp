@@ -0,0 +1,278 @@
+/*
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date:   28.12.2017
+ */
+
+/*
+ * Matrix product kernels for one instruction set.
+ *
+ * Like SimdRegisters.hpp, this file has no include guards: SimdDispatch.hpp
+ * includes it once per instruction set.
+ */
+
+    /*
+     * Product
+     *
+     * The blocking scheme follows the usual GotoBLAS/BLIS structure:
+     * a kc x nc panel of b is packed to stay in L3, an mc x kc block of a
+     * is packed to stay in L2, and a register micro-kernel computes mr x nr
+     * tiles of c, reading one nr-wide sliver of the packed b from L1.
+     */
+
+    /// Blocking parameters of the matrix product for a register type
+    template<typename T,class regType>
+    struct gemm_traits {
+      /// Number of T lanes in one register
+      static constexpr size_t lanes = sizeof(regType)/sizeof(T);
+      /// Rows of the register tile
+      static constexpr size_t mr = 6;
+      /// Columns of the register tile (two registers per row)
+      static constexpr size_t nr = 2*lanes;
+      /// Depth of the packed panels
+      static constexpr size_t kc = 256;
+      /// Rows of the packed block of a
+      static constexpr size_t mc = 16*mr;
+      /// Columns of the packed panel of b
+      static constexpr size_t nc = (4096/nr)*nr;
+    };
+
+    /**
+     * Register micro-kernel: c += ap*bp on an mr x nr tile.
+     *
+     * @param kc  depth of the packed slivers
+     * @param ap  packed sliver of a (kc columns of mr elements each)
+     * @param bp  packed sliver of b (kc rows of nr elements each)
+     * @param c   upper-left corner of the destination tile
+     * @param ldc distance between rows of c (usually dcols())
+     * @param m   effective rows of the tile (m <= mr)
+     * @param n   effective columns of the tile (n <= nr)
+     */
+    template<typename T,class regType>
+    inline void gemmKernel(const size_t kc,
+                           const T* ap,
+                           const T* bp,
+                           T* c,
+                           const size_t ldc,
+                           const size_t m,
+                           const size_t n) {
+
+      typedef gemm_traits<T,regType> traits;
+      const size_t L  = traits::lanes;
+      const size_t MR = traits::mr;
+      const size_t NR = traits::nr;
+
+      regType acc[traits::mr][2];
+      for (size_t i=0;i<MR;++i) {
+        acc[i][0] = mm_setzero<T,regType>();
+        acc[i][1] = mm_setzero<T,regType>();
+      }
+
+      for (size_t p=0;p<kc;++p) {
+        const regType b0 = mm_load<T,regType>(bp);
+        const regType b1 = mm_load<T,regType>(bp+L);
+        for (size_t i=0;i<MR;++i) {
+          const regType ai = mm_set1<T,regType>(ap[i]);
+          acc[i][0] = mm_fmadd<T>(ai,b0,acc[i][0]);
+          acc[i][1] = mm_fmadd<T>(ai,b1,acc[i][1]);
+        }
+        ap += MR;
+        bp += NR;
+      }
+
+      if ( (m == MR) && (n == NR) ) {
+        for (size_t i=0;i<MR;++i) {
+          T* crow = c + i*ldc;
+          mm_storeu<T,regType>(crow,
+                               mm_add<T>(mm_loadu<T,regType>(crow),
+                                         acc[i][0]));
+          mm_storeu<T,regType>(crow+L,
+                               mm_add<T>(mm_loadu<T,regType>(crow+L),
+                                         acc[i][1]));
+        }
+      } else {
+        // border tile: spill the registers and add only the valid part
+        alignas(regType) T tile[traits::mr*traits::nr];
+        for (size_t i=0;i<MR;++i) {
+          mm_store<T,regType>(tile+i*NR,acc[i][0]);
+          mm_store<T,regType>(tile+i*NR+L,acc[i][1]);
+        }
+        for (size_t i=0;i<m;++i) {
+          T* crow = c + i*ldc;
+          const T* trow = tile + i*NR;
+          for (size_t j=0;j<n;++j) {
+            crow[j] += trow[j];
+          }
+        }
+      }
+    }
+
+    /**
+     * Pack the block alpha*a(i0:i0+m,p0:p0+k) into slivers of mr rows.
+     *
+     * Each row of pa holds one sliver, stored column by column, with the
+     * rows beyond m filled with zeros.
+     */
+    template<typename T,class PAlloc>
+    inline void gemmPackA(const ConstMatrixView<T>& a,
+                          const T alpha,
+                          const size_t i0,const size_t m,
+                          const size_t p0,const size_t k,
+                          const size_t mr,
+                          Matrix<T,PAlloc>& pa) {
+      for (size_t ir=0,s=0;ir<m;ir+=mr,++s) {
+        T* here = pa[s];
+        const size_t mb = std::min(mr,m-ir);
+        for (size_t p=0;p<k;++p) {
+          size_t i=0;
+          for (;i<mb;++i) {
+            *here++ = alpha*a(i0+ir+i,p0+p);
+          }
+          for (;i<mr;++i) {
+            *here++ = T(0);
+          }
+        }
+      }
+    }
+
+    /**
+     * Pack the panel b(p0:p0+k,j0:j0+n) into slivers of nr columns.
+     *
+     * Each row of pb holds one sliver, stored row by row, with the
+     * columns beyond n filled with zeros.
+     */
+    template<typename T,class PAlloc>
+    inline void gemmPackB(const ConstMatrixView<T>& b,
+                          const size_t p0,const size_t k,
+                          const size_t j0,const size_t n,
+                          const size_t nr,
+                          Matrix<T,PAlloc>& pb) {
+      for (size_t jr=0,s=0;jr<n;jr+=nr,++s) {
+        T* here = pb[s];
+        const size_t nb = std::min(nr,n-jr);
+        for (size_t p=0;p<k;++p) {
+          const T* bptr = b[p0+p] + (j0+jr);
+          size_t j=0;
+          for (;j<nb;++j) {
+            *here++ = *bptr++;
+          }
+          for (;j<nr;++j) {
+            *here++ = T(0);
+          }
+        }
+      }
+    }
+
+    /**
+     * Accumulating implementation c=c+alpha*a*b on views.
+     *
+     * c must already have a.rows() x b.cols() entries and must not
+     * overlap a or b.  The scaling by alpha is done while packing a.
+     */
+    template<typename T,typename regType>
+    inline void multiplyAddSIMD(const T alpha,
+                                const ConstMatrixView<T>& a,
+                                const ConstMatrixView<T>& b,
+                                const MatrixView<T>& c) {
+
+      typedef gemm_traits<T,regType> traits;
+      const size_t MR = traits::mr;
+      const size_t NR = traits::nr;
+      const size_t KC = traits::kc;
+      const size_t MC = traits::mc;
+      const size_t NC = traits::nc;
+
+      // the packing buffers are always aligned to the register size,
+      // independently of what the allocator of the operands provides
+      typedef aligned_row_allocator<T,sizeof(regType)> pack_alloc;
+
+      const size_t m = a.rows();
+      const size_t n = b.cols();
+      const size_t k = a.cols();
+
+      assert( (b.rows()==k) && (c.rows()==m) && (c.cols()==n) );
+
+      if ( (m==0) || (n==0) || (k==0) ) return;
+
+      Matrix<T,pack_alloc> pa((std::min(MC,m)+MR-1)/MR,
+                              std::min(KC,k)*MR,
+                              DoNotInitialize);
+      Matrix<T,pack_alloc> pb((std::min(NC,n)+NR-1)/NR,
+                              std::min(KC,k)*NR,
+                              DoNotInitialize);
+
+      const size_t ldc = c.stride();
+
+      for (size_t jc=0;jc<n;jc+=NC) {
+        const size_t nb = std::min(NC,n-jc);
+        for (size_t pc=0;pc<k;pc+=KC) {
+          const size_t kb = std::min(KC,k-pc);
+          gemmPackB(b,pc,kb,jc,nb,NR,pb);
+          for (size_t ic=0;ic<m;ic+=MC) {
+            const size_t mb = std::min(MC,m-ic);
+            gemmPackA(a,alpha,ic,mb,pc,kb,MR,pa);
+            for (size_t jr=0;jr<nb;jr+=NR) {
+              const T* bp = pb[jr/NR];
+              for (size_t ir=0;ir<mb;ir+=MR) {
+                gemmKernel<T,regType>(kb,
+                                      pa[ir/MR],
+                                      bp,
+                                      c[ic+ir] + (jc+jr),
+                                      ldc,
+                                      std::min(MR,mb-ir),
+                                      std::min(NR,nb-jr));
+              }
+            }
+          }
+        }
+      }
+    }
+
+    /**
+     * On-copy implementation c=a*b on views.
+     *
+     * c must already have a.rows() x b.cols() entries and must not
+     * overlap a or b.
+     */
+    template<typename T,typename regType>
+    inline void multiplySIMD(const ConstMatrixView<T>& a,
+                             const ConstMatrixView<T>& b,
+                             const MatrixView<T>& c) {
+      c.fill(T(0));
+      multiplyAddSIMD<T,regType>(T(1),a,b,c);
+    }
+
+    // On-copy implementation c=a*b for floating point SIMD types
+    template<typename T,class Alloc>
+    inline void multiply(const Matrix<T,Alloc>& a,
+                         const Matrix<T,Alloc>& b,
+                         Matrix<T,Alloc>& c) {
+      // The packing makes the kernel independent of the operands'
+      // alignment, so that every allocator can use the SIMD path
+      c.allocate(a.rows(),b.cols());
+      multiplySIMD<T,typename reg_traits<T>::reg_type>(a.view(),
+                                                       b.view(),
+                                                       c.view());
+    }
+
+    // On-copy implementation c=a*b on views of floating point SIMD types
+    template<typename T>
+    inline void multiply(const ConstMatrixView<T>& a,
+                         const ConstMatrixView<T>& b,
+                         const MatrixView<T>& c) {
+      multiplySIMD<T,typename reg_traits<T>::reg_type>(a,b,c);
+    }
+
+    // Accumulating implementation c=c+alpha*a*b on views of floating
+    // point SIMD types
+    template<typename T>
+    inline void multiplyAdd(const T alpha,
+                            const ConstMatrixView<T>& a,
+                            const ConstMatrixView<T>& b,
+                            const MatrixView<T>& c) {
+      multiplyAddSIMD<T,typename reg_traits<T>::reg_type>(alpha,a,b,c);
+    }
@@ -0,0 +1,358 @@
+/*
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date:   11.01.2018
+ */
+
+/*
+ * Reduction kernels for one instruction set.
+ *
+ * Like SimdRegisters.hpp, this file has no include guards: SimdDispatch.hpp
+ * includes it once per instruction set.
+ */
+
+    /*
+     * Reductions
+     *
+     * The loops keep several independent accumulators, so that each
+     * fused multiply-add does not wait for the latency of the previous
+     * one.  The data is read with unaligned loads: the reductions are
+     * also used on plain std::vector buffers.
+     */
+
+    /// Sum of the lanes of a register
+    template<typename T,class regType>
+    inline T hsum(const regType a) {
+      const size_t lanes = sizeof(regType)/sizeof(T);
+      T buffer[lanes];
+      mm_storeu<T,regType>(buffer,a);
+      T sum = T(0);
+      for (size_t i=0;i<lanes;++i) {
+        sum += buffer[i];
+      }
+      return sum;
+    }
+
+#if ANPI_SIMD_LEVEL == 3
+    // Lane-wise absolute value, maximum and minimum.  As with the
+    // instructions, max and min return b if a lane of a is NaN.
+    inline __m512d reg_abs(const __m512d a) { return _mm512_abs_pd(a); }
+    inline __m512  reg_abs(const __m512 a)  { return _mm512_abs_ps(a); }
+    // masked forms: the unmasked ones pass an undefined merge source,
+    // which GCC reports as a possibly uninitialized value
+    inline __m512d reg_max(const __m512d a,const __m512d b) {
+      return _mm512_maskz_max_pd(__mmask8(0xff),a,b);
+    }
+    inline __m512  reg_max(const __m512 a,const __m512 b) {
+      return _mm512_maskz_max_ps(__mmask16(0xffff),a,b);
+    }
+    inline __m512d reg_min(const __m512d a,const __m512d b) {
+      return _mm512_maskz_min_pd(__mmask8(0xff),a,b);
+    }
+    inline __m512  reg_min(const __m512 a,const __m512 b) {
+      return _mm512_maskz_min_ps(__mmask16(0xffff),a,b);
+    }
+#elif ANPI_SIMD_LEVEL == 2
+    inline __m256d reg_abs(const __m256d a) {
+      return _mm256_andnot_pd(_mm256_set1_pd(-0.0),a);
+    }
+    inline __m256  reg_abs(const __m256 a) {
+      return _mm256_andnot_ps(_mm256_set1_ps(-0.0f),a);
+    }
+    inline __m256d reg_max(const __m256d a,const __m256d b) {
+      return _mm256_max_pd(a,b);
+    }
+    inline __m256  reg_max(const __m256 a,const __m256 b) {
+      return _mm256_max_ps(a,b);
+    }
+    inline __m256d reg_min(const __m256d a,const __m256d b) {
+      return _mm256_min_pd(a,b);
+    }
+    inline __m256  reg_min(const __m256 a,const __m256 b) {
+      return _mm256_min_ps(a,b);
+    }
+#elif ANPI_SIMD_LEVEL == 1
+    inline __m128d reg_abs(const __m128d a) {
+      return _mm_andnot_pd(_mm_set1_pd(-0.0),a);
+    }
+    inline __m128  reg_abs(const __m128 a) {
+      return _mm_andnot_ps(_mm_set1_ps(-0.0f),a);
+    }
+    inline __m128d reg_max(const __m128d a,const __m128d b) {
+      return _mm_max_pd(a,b);
+    }
+    inline __m128  reg_max(const __m128 a,const __m128 b) {
+      return _mm_max_ps(a,b);
+    }
+    inline __m128d reg_min(const __m128d a,const __m128d b) {
+      return _mm_min_pd(a,b);
+    }
+    inline __m128  reg_min(const __m128 a,const __m128 b) {
+      return _mm_min_ps(a,b);
+    }
+#endif
+
+    /*
+     * Terms of the accumulated reductions.  Each one provides its
+     * value at position i as register and as scalar, and the addition
+     * of the register to an accumulator (fused for products).
+     */
+
+    /// Terms a[i]
+    template<typename T>
+    struct sum_term {
+      typedef typename reg_traits<T>::reg_type regType;
+      const T* a;
+
+      inline regType value(const size_t i) const {
+        return mm_loadu<T,regType>(a+i);
+      }
+      inline regType add(const size_t i,const regType s) const {
+        return mm_add<T>(value(i),s);
+      }
+      inline T scalar(const size_t i) const { return a[i]; }
+    };
+
+    /// Terms |a[i]|
+    template<typename T>
+    struct abs_term {
+      typedef typename reg_traits<T>::reg_type regType;
+      const T* a;
+
+      inline regType value(const size_t i) const {
+        return reg_abs(mm_loadu<T,regType>(a+i));
+      }
+      inline regType add(const size_t i,const regType s) const {
+        return mm_add<T>(value(i),s);
+      }
+      inline T scalar(const size_t i) const { return std::abs(a[i]); }
+    };
+
+    /// Terms a[i]*b[i]
+    template<typename T>
+    struct dot_term {
+      typedef typename reg_traits<T>::reg_type regType;
+      const T* a;
+      const T* b;
+
+      inline regType value(const size_t i) const {
+        return mm_mul<T>(mm_loadu<T,regType>(a+i),mm_loadu<T,regType>(b+i));
+      }
+      inline regType add(const size_t i,const regType s) const {
+        return mm_fmadd<T>(mm_loadu<T,regType>(a+i),
+                           mm_loadu<T,regType>(b+i),s);
+      }
+      inline T scalar(const size_t i) const { return a[i]*b[i]; }
+    };
+
+    /// Sum of the n terms, with four independent accumulators
+    template<typename T,class Term>
+    inline T accumulate(const Term& t,const size_t n) {
+      typedef typename reg_traits<T>::reg_type regType;
+      const size_t lanes = sizeof(regType)/sizeof(T);
+
+      regType s0 = mm_setzero<T,regType>();
+      regType s1 = s0, s2 = s0, s3 = s0;
+
+      size_t i=0;
+      for (;i+4*lanes<=n;i+=4*lanes) {
+        s0 = t.add(i,s0);
+        s1 = t.add(i+lanes,s1);
+        s2 = t.add(i+2*lanes,s2);
+        s3 = t.add(i+3*lanes,s3);
+      }
+      for (;i+lanes<=n;i+=lanes) {
+        s0 = t.add(i,s0);
+      }
+
+      T sum = hsum<T>(mm_add<T>(mm_add<T>(s0,s1),mm_add<T>(s2,s3)));
+      for (;i<n;++i) {
+        sum += t.scalar(i);
+      }
+      return sum;
+    }
+
+    /**
+     * Compensated sum of the n terms.
+     *
+     * Each lane of two independent register pairs runs its own Kahan
+     * summation; the lanes and their compensations are finally added
+     * with a scalar Kahan accumulator.
+     */
+    template<typename T,class Term>
+    inline T accumulateKahan(const Term& t,const size_t n) {
+      typedef typename reg_traits<T>::reg_type regType;
+      const size_t lanes = sizeof(regType)/sizeof(T);
+
+      regType s0 = mm_setzero<T,regType>();
+      regType c0 = s0, s1 = s0, c1 = s0;
+
+      size_t i=0;
+      for (;i+2*lanes<=n;i+=2*lanes) {
+        const regType y0 = mm_sub<T>(t.value(i),c0);
+        const regType y1 = mm_sub<T>(t.value(i+lanes),c1);
+        const regType t0 = mm_add<T>(s0,y0);
+        const regType t1 = mm_add<T>(s1,y1);
+        c0 = mm_sub<T>(mm_sub<T>(t0,s0),y0);
+        c1 = mm_sub<T>(mm_sub<T>(t1,s1),y1);
+        s0 = t0;
+        s1 = t1;
+      }
+
+      T buffer[4*lanes];
+      mm_storeu<T,regType>(buffer,s0);
+      mm_storeu<T,regType>(buffer+lanes,s1);
+      mm_storeu<T,regType>(buffer+2*lanes,c0);
+      mm_storeu<T,regType>(buffer+3*lanes,c1);
+
+      ::anpi::bits::kahan<T> k;
+      for (size_t l=0;l<2*lanes;++l) {
+        k.add(buffer[l]);
+      }
+      for (size_t l=2*lanes;l<4*lanes;++l) {
+        k.add(-buffer[l]);
+      }
+      for (;i<n;++i) {
+        k.add(t.scalar(i));
+      }
+      return k.sum;
+    }
+
+    /// Dot product of the n entries at a and b
+    template<typename T>
+    inline T dot(const T* a,const T* b,const size_t n) {
+      const dot_term<T> t = { a,b };
+      return accumulate<T>(t,n);
+    }
+
+    /// Compensated dot product of the n entries at a and b
+    template<typename T>
+    inline T dotKahan(const T* a,const T* b,const size_t n) {
+      const dot_term<T> t = { a,b };
+      return accumulateKahan<T>(t,n);
+    }
+
+    /// Sum of the n entries at a
+    template<typename T>
+    inline T sum(const T* a,const size_t n) {
+      const sum_term<T> t = { a };
+      return accumulate<T>(t,n);
+    }
+
+    /// Compensated sum of the n entries at a
+    template<typename T>
+    inline T sumKahan(const T* a,const size_t n) {
+      const sum_term<T> t = { a };
+      return accumulateKahan<T>(t,n);
+    }
+
+    /// Sum of the absolute values of the n entries at a
+    template<typename T>
+    inline T sumAbs(const T* a,const size_t n) {
+      const abs_term<T> t = { a };
+      return accumulate<T>(t,n);
+    }
+
+    /// Compensated sum of the absolute values of the n entries at a
+    template<typename T>
+    inline T sumAbsKahan(const T* a,const size_t n) {
+      const abs_term<T> t = { a };
+      return accumulateKahan<T>(t,n);
+    }
+
+    // Lane-wise and scalar choices of the extrema.  They are classes
+    // and not lambdas, since GCC does not compile lambdas with the
+    // target options of the enclosing function.
+    struct pick_max {
+      template<class R>
+      inline R operator()(const R a,const R b) const { return reg_max(a,b); }
+    };
+    struct pick_min {
+      template<class R>
+      inline R operator()(const R a,const R b) const { return reg_min(a,b); }
+    };
+    struct greater {
+      template<typename T>
+      inline bool operator()(const T a,const T b) const { return a > b; }
+    };
+    struct less {
+      template<typename T>
+      inline bool operator()(const T a,const T b) const { return a < b; }
+    };
+
+    /**
+     * Extremum of the n entries at a, with four independent
+     * accumulators.  The loaded entries are the first operand of
+     * reg_max/reg_min, so that NaN entries are ignored.
+     *
+     * @param init value of the accumulators, returned for empty ranges
+     * @param pick lane-wise reduction, pick_max or pick_min
+     * @param better whether a scalar entry replaces the current extremum
+     * @param abs whether to take the absolute values first
+     */
+    template<typename T,class Pick,class Better>
+    inline T extremum(const T* a,
+                      const size_t n,
+                      const T init,
+                      Pick pick,
+                      Better better,
+                      const bool abs) {
+      typedef typename reg_traits<T>::reg_type regType;
+      const size_t lanes = sizeof(regType)/sizeof(T);
+
+      regType m0 = mm_set1<T,regType>(init);
+      regType m1 = m0, m2 = m0, m3 = m0;
+
+      size_t i=0;
+      if (abs) {
+        for (;i+4*lanes<=n;i+=4*lanes) {
+          m0 = pick(reg_abs(mm_loadu<T,regType>(a+i)),m0);
+          m1 = pick(reg_abs(mm_loadu<T,regType>(a+i+lanes)),m1);
+          m2 = pick(reg_abs(mm_loadu<T,regType>(a+i+2*lanes)),m2);
+          m3 = pick(reg_abs(mm_loadu<T,regType>(a+i+3*lanes)),m3);
+        }
+      } else {
+        for (;i+4*lanes<=n;i+=4*lanes) {
+          m0 = pick(mm_loadu<T,regType>(a+i),m0);
+          m1 = pick(mm_loadu<T,regType>(a+i+lanes),m1);
+          m2 = pick(mm_loadu<T,regType>(a+i+2*lanes),m2);
+          m3 = pick(mm_loadu<T,regType>(a+i+3*lanes),m3);
+        }
+      }
+
+      T buffer[lanes];
+      mm_storeu<T,regType>(buffer,pick(pick(m0,m1),pick(m2,m3)));
+      T m = init;
+      for (size_t l=0;l<lanes;++l) {
+        m = better(buffer[l],m) ? buffer[l] : m;
+      }
+      for (;i<n;++i) {
+        const T v = abs ? std::abs(a[i]) : a[i];
+        m = better(v,m) ? v : m;
+      }
+      return m;
+    }
+
+    /// Largest of the n entries at a, ignoring NaN
+    template<typename T>
+    inline T max(const T* a,const size_t n) {
+      return extremum(a,n,-std::numeric_limits<T>::infinity(),
+                      pick_max(),greater(),false);
+    }
+
+    /// Smallest of the n entries at a, ignoring NaN
+    template<typename T>
+    inline T min(const T* a,const size_t n) {
+      return extremum(a,n,std::numeric_limits<T>::infinity(),
+                      pick_min(),less(),false);
+    }
+
+    /// Largest absolute value of the n entries at a, ignoring NaN
+    template<typename T>
+    inline T maxAbs(const T* a,const size_t n) {
+      return extremum(a,n,T(0),pick_max(),greater(),true);
+    }
@@ -0,0 +1,1285 @@
+/*
+ * Copyright (C) 2017 
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date:   28.12.2017
+ */
+
+/*
+ * Register wrappers for one instruction set.
+ *
+ * This file has no include guards on purpose: SimdDispatch.hpp includes
+ * it once per instruction set, inside the namespace of that instruction
+ * set and with ANPI_SIMD_LEVEL set to 1 (SSE2), 2 (AVX2+FMA) or
+ * 3 (AVX-512).  The compiler macros like __AVX512F__ cannot be used
+ * here, as they describe the compilation flags and not the target of
+ * the current namespace.
+ */
+
+#if ANPI_SIMD_LEVEL == 3
+    /// Registers used by the kernels of this instruction set
+    template<typename T>
+    struct reg_traits : public avx512_traits<T> {};
+#elif ANPI_SIMD_LEVEL == 2
+    /// Registers used by the kernels of this instruction set
+    template<typename T>
+    struct reg_traits : public avx_traits<T> {};
+#elif ANPI_SIMD_LEVEL == 1
+    /// Registers used by the kernels of this instruction set
+    template<typename T>
+    struct reg_traits : public sse2_traits<T> {};
+#endif
+
+    /// We wrap the intrinsics methods to be polymorphic versions
+    template<typename T,class regType>
+    regType mm_add(regType,regType); // We don't implement this to cause, at
+                                     // least, a linker error if this version is
+                                     // used.
+    //{
+    // Generic function should never be called.
+    // If it is called, then some SIMD chaos is going on...
+    
+    // A way to cause a compile time error would be better
+    // throw std::bad_function_call();
+    // return regType();
+    //}
+    
+#if ANPI_SIMD_LEVEL == 3
+    template<>
+    inline __m512d __attribute__((__always_inline__))
+    mm_add<double>(__m512d a,__m512d b) {
+      return _mm512_add_pd(a,b);
+    }
+    template<>
+    inline __m512 __attribute__((__always_inline__))
+    mm_add<float>(__m512 a,__m512 b) {
+      return _mm512_add_ps(a,b);
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_add<uint64_t>(__m512i a,__m512i b) {
+      return _mm512_add_epi64(a,b);
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_add<int64_t>(__m512i a,__m512i b) {
+      return _mm512_add_epi64(a,b);
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_add<uint32_t>(__m512i a,__m512i b) {
+      return _mm512_add_epi32(a,b);
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_add<int32_t>(__m512i a,__m512i b) {
+      return _mm512_add_epi32(a,b);
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_add<uint16_t>(__m512i a,__m512i b) {
+      return _mm512_add_epi16(a,b);
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_add<int16_t>(__m512i a,__m512i b) {
+      return _mm512_add_epi16(a,b);
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_add<uint8_t>(__m512i a,__m512i b) {
+      return _mm512_add_epi8(a,b);
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_add<int8_t>(__m512i a,__m512i b) {
+      return _mm512_add_epi8(a,b);
+    }
+#elif ANPI_SIMD_LEVEL == 2
+    template<>
+    inline __m256d __attribute__((__always_inline__))
+    mm_add<double>(__m256d a,__m256d b) {
+      return _mm256_add_pd(a,b);
+    }
+    template<>
+    inline __m256 __attribute__((__always_inline__))
+    mm_add<float>(__m256 a,__m256 b) {
+      return _mm256_add_ps(a,b);
+    }
+    template<>
+    inline __m256i __attribute__((__always_inline__))
+    mm_add<uint64_t>(__m256i a,__m256i b) {
+      return _mm256_add_epi64(a,b);
+    }
+    template<>
+    inline __m256i __attribute__((__always_inline__))
+    mm_add<int64_t>(__m256i a,__m256i b) {
+      return _mm256_add_epi64(a,b);
+    }
+    template<>
+    inline __m256i __attribute__((__always_inline__))
+    mm_add<uint32_t>(__m256i a,__m256i b) {
+      return _mm256_add_epi32(a,b);
+    }
+    template<>
+    inline __m256i __attribute__((__always_inline__))
+    mm_add<int32_t>(__m256i a,__m256i b) {
+      return _mm256_add_epi32(a,b);
+    }
+    template<>
+    inline __m256i __attribute__((__always_inline__))
+    mm_add<uint16_t>(__m256i a,__m256i b) {
+      return _mm256_add_epi16(a,b);
+    }
+    template<>
+    inline __m256i __attribute__((__always_inline__))
+    mm_add<int16_t>(__m256i a,__m256i b) {
+      return _mm256_add_epi16(a,b);
+    }
+    template<>
+    inline __m256i __attribute__((__always_inline__))
+    mm_add<uint8_t>(__m256i a,__m256i b) {
+      return _mm256_add_epi8(a,b);
+    }
+    template<>
+    inline __m256i __attribute__((__always_inline__))
+    mm_add<int8_t>(__m256i a,__m256i b) {
+      return _mm256_add_epi8(a,b);
+    }
+#elif ANPI_SIMD_LEVEL == 1
+    template<>
+    inline __m128d __attribute__((__always_inline__))
+    mm_add<double>(__m128d a,__m128d b) {
+      return _mm_add_pd(a,b);
+    }
+    template<>
+    inline __m128 __attribute__((__always_inline__))
+    mm_add<float>(__m128 a,__m128 b) {
+      return _mm_add_ps(a,b);
+    }
+    template<>
+    inline __m128i __attribute__((__always_inline__))
+    mm_add<std::uint64_t>(__m128i a,__m128i b) {
+      return _mm_add_epi64(a,b);
+    }
+    template<>
+    inline __m128i __attribute__((__always_inline__))
+    mm_add<std::int64_t>(__m128i a,__m128i b) {
+      return _mm_add_epi64(a,b);
+    }
+    template<>
+    inline __m128i __attribute__((__always_inline__))
+    mm_add<std::uint32_t>(__m128i a,__m128i b) {
+      return _mm_add_epi32(a,b);
+    }
+    template<>
+    inline __m128i __attribute__((__always_inline__))
+    mm_add<std::int32_t>(__m128i a,__m128i b) {
+      return _mm_add_epi32(a,b);
+    }
+    template<>
+    inline __m128i __attribute__((__always_inline__))
+    mm_add<std::uint16_t>(__m128i a,__m128i b) {
+      return _mm_add_epi16(a,b);
+    }
+    template<>
+    inline __m128i __attribute__((__always_inline__))
+    mm_add<std::int16_t>(__m128i a,__m128i b) {
+      return _mm_add_epi16(a,b);
+    }
+    template<>
+    inline __m128i __attribute__((__always_inline__))
+    mm_add<std::uint8_t>(__m128i a,__m128i b) {
+      return _mm_add_epi8(a,b);
+    }
+    template<>
+    inline __m128i __attribute__((__always_inline__))
+    mm_add<std::int8_t>(__m128i a,__m128i b) {
+      return _mm_add_epi8(a,b);
+    }
+#endif
+
+    /*
+     * Register wrappers used by the matrix product kernels
+     */
+
+    /// Multiply two registers lane-wise
+    template<typename T,class regType>
+    regType mm_mul(regType,regType);
+
+    /// Fused multiply-add a*b+c (emulated if FMA is not available)
+    template<typename T,class regType>
+    regType mm_fmadd(regType,regType,regType);
+
+    /// Register with all lanes set to zero
+    template<typename T,class regType>
+    regType mm_setzero();
+
+    /// Register with all lanes set to the given value
+    template<typename T,class regType>
+    regType mm_set1(const T);
+
+    /// Load from memory aligned to the register size
+    template<typename T,class regType>
+    regType mm_load(const T*);
+
+    /// Load from arbitrary memory positions
+    template<typename T,class regType>
+    regType mm_loadu(const T*);
+
+    /// Store into memory aligned to the register size
+    template<typename T,class regType>
+    void mm_store(T*,regType);
+
+    /// Store into arbitrary memory positions
+    template<typename T,class regType>
+    void mm_storeu(T*,regType);
+
+#if ANPI_SIMD_LEVEL == 3
+    template<>
+    inline __m512d __attribute__((__always_inline__))
+    mm_mul<double>(__m512d a,__m512d b) {
+      return _mm512_mul_pd(a,b);
+    }
+    template<>
+    inline __m512d __attribute__((__always_inline__))
+    mm_fmadd<double>(__m512d a,__m512d b,__m512d c) {
+      return _mm512_fmadd_pd(a,b,c);
+    }
+    template<>
+    inline __m512d __attribute__((__always_inline__))
+    mm_setzero<double,__m512d>() {
+      return _mm512_setzero_pd();
+    }
+    template<>
+    inline __m512d __attribute__((__always_inline__))
+    mm_set1<double,__m512d>(const double v) {
+      return _mm512_set1_pd(v);
+    }
+    template<>
+    inline __m512d __attribute__((__always_inline__))
+    mm_load<double,__m512d>(const double* p) {
+      return _mm512_load_pd(p);
+    }
+    template<>
+    inline __m512d __attribute__((__always_inline__))
+    mm_loadu<double,__m512d>(const double* p) {
+      return _mm512_loadu_pd(p);
+    }
+    template<>
+    inline void __attribute__((__always_inline__))
+    mm_store<double,__m512d>(double* p,__m512d a) {
+      _mm512_store_pd(p,a);
+    }
+    template<>
+    inline void __attribute__((__always_inline__))
+    mm_storeu<double,__m512d>(double* p,__m512d a) {
+      _mm512_storeu_pd(p,a);
+    }
+    template<>
+    inline __m512 __attribute__((__always_inline__))
+    mm_mul<float>(__m512 a,__m512 b) {
+      return _mm512_mul_ps(a,b);
+    }
+    template<>
+    inline __m512 __attribute__((__always_inline__))
+    mm_fmadd<float>(__m512 a,__m512 b,__m512 c) {
+      return _mm512_fmadd_ps(a,b,c);
+    }
+    template<>
+    inline __m512 __attribute__((__always_inline__))
+    mm_setzero<float,__m512>() {
+      return _mm512_setzero_ps();
+    }
+    template<>
+    inline __m512 __attribute__((__always_inline__))
+    mm_set1<float,__m512>(const float v) {
+      return _mm512_set1_ps(v);
+    }
+    template<>
+    inline __m512 __attribute__((__always_inline__))
+    mm_load<float,__m512>(const float* p) {
+      return _mm512_load_ps(p);
+    }
+    template<>
+    inline __m512 __attribute__((__always_inline__))
+    mm_loadu<float,__m512>(const float* p) {
+      return _mm512_loadu_ps(p);
+    }
+    template<>
+    inline void __attribute__((__always_inline__))
+    mm_store<float,__m512>(float* p,__m512 a) {
+      _mm512_store_ps(p,a);
+    }
+    template<>
+    inline void __attribute__((__always_inline__))
+    mm_storeu<float,__m512>(float* p,__m512 a) {
+      _mm512_storeu_ps(p,a);
+    }
+#elif ANPI_SIMD_LEVEL == 2
+    template<>
+    inline __m256d __attribute__((__always_inline__))
+    mm_mul<double>(__m256d a,__m256d b) {
+      return _mm256_mul_pd(a,b);
+    }
+    template<>
+    inline __m256d __attribute__((__always_inline__))
+    mm_fmadd<double>(__m256d a,__m256d b,__m256d c) {
+      return _mm256_fmadd_pd(a,b,c);
+    }
+    template<>
+    inline __m256d __attribute__((__always_inline__))
+    mm_setzero<double,__m256d>() {
+      return _mm256_setzero_pd();
+    }
+    template<>
+    inline __m256d __attribute__((__always_inline__))
+    mm_set1<double,__m256d>(const double v) {
+      return _mm256_set1_pd(v);
+    }
+    template<>
+    inline __m256d __attribute__((__always_inline__))
+    mm_load<double,__m256d>(const double* p) {
+      return _mm256_load_pd(p);
+    }
+    template<>
+    inline __m256d __attribute__((__always_inline__))
+    mm_loadu<double,__m256d>(const double* p) {
+      return _mm256_loadu_pd(p);
+    }
+    template<>
+    inline void __attribute__((__always_inline__))
+    mm_store<double,__m256d>(double* p,__m256d a) {
+      _mm256_store_pd(p,a);
+    }
+    template<>
+    inline void __attribute__((__always_inline__))
+    mm_storeu<double,__m256d>(double* p,__m256d a) {
+      _mm256_storeu_pd(p,a);
+    }
+    template<>
+    inline __m256 __attribute__((__always_inline__))
+    mm_mul<float>(__m256 a,__m256 b) {
+      return _mm256_mul_ps(a,b);
+    }
+    template<>
+    inline __m256 __attribute__((__always_inline__))
+    mm_fmadd<float>(__m256 a,__m256 b,__m256 c) {
+      return _mm256_fmadd_ps(a,b,c);
+    }
+    template<>
+    inline __m256 __attribute__((__always_inline__))
+    mm_setzero<float,__m256>() {
+      return _mm256_setzero_ps();
+    }
+    template<>
+    inline __m256 __attribute__((__always_inline__))
+    mm_set1<float,__m256>(const float v) {
+      return _mm256_set1_ps(v);
+    }
+    template<>
+    inline __m256 __attribute__((__always_inline__))
+    mm_load<float,__m256>(const float* p) {
+      return _mm256_load_ps(p);
+    }
+    template<>
+    inline __m256 __attribute__((__always_inline__))
+    mm_loadu<float,__m256>(const float* p) {
+      return _mm256_loadu_ps(p);
+    }
+    template<>
+    inline void __attribute__((__always_inline__))
+    mm_store<float,__m256>(float* p,__m256 a) {
+      _mm256_store_ps(p,a);
+    }
+    template<>
+    inline void __attribute__((__always_inline__))
+    mm_storeu<float,__m256>(float* p,__m256 a) {
+      _mm256_storeu_ps(p,a);
+    }
+#elif ANPI_SIMD_LEVEL == 1
+    template<>
+    inline __m128d __attribute__((__always_inline__))
+    mm_mul<double>(__m128d a,__m128d b) {
+      return _mm_mul_pd(a,b);
+    }
+    template<>
+    inline __m128d __attribute__((__always_inline__))
+    mm_fmadd<double>(__m128d a,__m128d b,__m128d c) {
+#ifdef __FMA__
+      return _mm_fmadd_pd(a,b,c);
+#else
+      return _mm_add_pd(_mm_mul_pd(a,b),c);
+#endif
+    }
+    template<>
+    inline __m128d __attribute__((__always_inline__))
+    mm_setzero<double,__m128d>() {
+      return _mm_setzero_pd();
+    }
+    template<>
+    inline __m128d __attribute__((__always_inline__))
+    mm_set1<double,__m128d>(const double v) {
+      return _mm_set1_pd(v);
+    }
+    template<>
+    inline __m128d __attribute__((__always_inline__))
+    mm_load<double,__m128d>(const double* p) {
+      return _mm_load_pd(p);
+    }
+    template<>
+    inline __m128d __attribute__((__always_inline__))
+    mm_loadu<double,__m128d>(const double* p) {
+      return _mm_loadu_pd(p);
+    }
+    template<>
+    inline void __attribute__((__always_inline__))
+    mm_store<double,__m128d>(double* p,__m128d a) {
+      _mm_store_pd(p,a);
+    }
+    template<>
+    inline void __attribute__((__always_inline__))
+    mm_storeu<double,__m128d>(double* p,__m128d a) {
+      _mm_storeu_pd(p,a);
+    }
+    template<>
+    inline __m128 __attribute__((__always_inline__))
+    mm_mul<float>(__m128 a,__m128 b) {
+      return _mm_mul_ps(a,b);
+    }
+    template<>
+    inline __m128 __attribute__((__always_inline__))
+    mm_fmadd<float>(__m128 a,__m128 b,__m128 c) {
+#ifdef __FMA__
+      return _mm_fmadd_ps(a,b,c);
+#else
+      return _mm_add_ps(_mm_mul_ps(a,b),c);
+#endif
+    }
+    template<>
+    inline __m128 __attribute__((__always_inline__))
+    mm_setzero<float,__m128>() {
+      return _mm_setzero_ps();
+    }
+    template<>
+    inline __m128 __attribute__((__always_inline__))
+    mm_set1<float,__m128>(const float v) {
+      return _mm_set1_ps(v);
+    }
+    template<>
+    inline __m128 __attribute__((__always_inline__))
+    mm_load<float,__m128>(const float* p) {
+      return _mm_load_ps(p);
+    }
+    template<>
+    inline __m128 __attribute__((__always_inline__))
+    mm_loadu<float,__m128>(const float* p) {
+      return _mm_loadu_ps(p);
+    }
+    template<>
+    inline void __attribute__((__always_inline__))
+    mm_store<float,__m128>(float* p,__m128 a) {
+      _mm_store_ps(p,a);
+    }
+    template<>
+    inline void __attribute__((__always_inline__))
+    mm_storeu<float,__m128>(float* p,__m128 a) {
+      _mm_storeu_ps(p,a);
+    }
+#endif
+
+    /*
+     * Register wrappers used by the elementwise kernels
+     */
+
+    /// Subtract two registers lane-wise
+    template<typename T,class regType>
+    regType mm_sub(regType,regType);
+
+    /// Divide two registers lane-wise (floating point types only)
+    template<typename T,class regType>
+    regType mm_div(regType,regType);
+
+#if ANPI_SIMD_LEVEL == 3
+    template<>
+    inline __m512d __attribute__((__always_inline__))
+    mm_sub<double>(__m512d a,__m512d b) {
+      return _mm512_sub_pd(a,b);
+    }
+    template<>
+    inline __m512 __attribute__((__always_inline__))
+    mm_sub<float>(__m512 a,__m512 b) {
+      return _mm512_sub_ps(a,b);
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_sub<uint64_t>(__m512i a,__m512i b) {
+      return _mm512_sub_epi64(a,b);
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_sub<int64_t>(__m512i a,__m512i b) {
+      return _mm512_sub_epi64(a,b);
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_sub<uint32_t>(__m512i a,__m512i b) {
+      return _mm512_sub_epi32(a,b);
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_sub<int32_t>(__m512i a,__m512i b) {
+      return _mm512_sub_epi32(a,b);
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_sub<uint16_t>(__m512i a,__m512i b) {
+      return _mm512_sub_epi16(a,b);
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_sub<int16_t>(__m512i a,__m512i b) {
+      return _mm512_sub_epi16(a,b);
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_sub<uint8_t>(__m512i a,__m512i b) {
+      return _mm512_sub_epi8(a,b);
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_sub<int8_t>(__m512i a,__m512i b) {
+      return _mm512_sub_epi8(a,b);
+    }
+    template<>
+    inline __m512d __attribute__((__always_inline__))
+    mm_div<double>(__m512d a,__m512d b) {
+      return _mm512_div_pd(a,b);
+    }
+    template<>
+    inline __m512 __attribute__((__always_inline__))
+    mm_div<float>(__m512 a,__m512 b) {
+      return _mm512_div_ps(a,b);
+    }
+#elif ANPI_SIMD_LEVEL == 2
+    template<>
+    inline __m256d __attribute__((__always_inline__))
+    mm_sub<double>(__m256d a,__m256d b) {
+      return _mm256_sub_pd(a,b);
+    }
+    template<>
+    inline __m256 __attribute__((__always_inline__))
+    mm_sub<float>(__m256 a,__m256 b) {
+      return _mm256_sub_ps(a,b);
+    }
+    template<>
+    inline __m256i __attribute__((__always_inline__))
+    mm_sub<uint64_t>(__m256i a,__m256i b) {
+      return _mm256_sub_epi64(a,b);
+    }
+    template<>
+    inline __m256i __attribute__((__always_inline__))
+    mm_sub<int64_t>(__m256i a,__m256i b) {
+      return _mm256_sub_epi64(a,b);
+    }
+    template<>
+    inline __m256i __attribute__((__always_inline__))
+    mm_sub<uint32_t>(__m256i a,__m256i b) {
+      return _mm256_sub_epi32(a,b);
+    }
+    template<>
+    inline __m256i __attribute__((__always_inline__))
+    mm_sub<int32_t>(__m256i a,__m256i b) {
+      return _mm256_sub_epi32(a,b);
+    }
+    template<>
+    inline __m256i __attribute__((__always_inline__))
+    mm_sub<uint16_t>(__m256i a,__m256i b) {
+      return _mm256_sub_epi16(a,b);
+    }
+    template<>
+    inline __m256i __attribute__((__always_inline__))
+    mm_sub<int16_t>(__m256i a,__m256i b) {
+      return _mm256_sub_epi16(a,b);
+    }
+    template<>
+    inline __m256i __attribute__((__always_inline__))
+    mm_sub<uint8_t>(__m256i a,__m256i b) {
+      return _mm256_sub_epi8(a,b);
+    }
+    template<>
+    inline __m256i __attribute__((__always_inline__))
+    mm_sub<int8_t>(__m256i a,__m256i b) {
+      return _mm256_sub_epi8(a,b);
+    }
+    template<>
+    inline __m256d __attribute__((__always_inline__))
+    mm_div<double>(__m256d a,__m256d b) {
+      return _mm256_div_pd(a,b);
+    }
+    template<>
+    inline __m256 __attribute__((__always_inline__))
+    mm_div<float>(__m256 a,__m256 b) {
+      return _mm256_div_ps(a,b);
+    }
+#elif ANPI_SIMD_LEVEL == 1
+    template<>
+    inline __m128d __attribute__((__always_inline__))
+    mm_sub<double>(__m128d a,__m128d b) {
+      return _mm_sub_pd(a,b);
+    }
+    template<>
+    inline __m128 __attribute__((__always_inline__))
+    mm_sub<float>(__m128 a,__m128 b) {
+      return _mm_sub_ps(a,b);
+    }
+    template<>
+    inline __m128i __attribute__((__always_inline__))
+    mm_sub<uint64_t>(__m128i a,__m128i b) {
+      return _mm_sub_epi64(a,b);
+    }
+    template<>
+    inline __m128i __attribute__((__always_inline__))
+    mm_sub<int64_t>(__m128i a,__m128i b) {
+      return _mm_sub_epi64(a,b);
+    }
+    template<>
+    inline __m128i __attribute__((__always_inline__))
+    mm_sub<uint32_t>(__m128i a,__m128i b) {
+      return _mm_sub_epi32(a,b);
+    }
+    template<>
+    inline __m128i __attribute__((__always_inline__))
+    mm_sub<int32_t>(__m128i a,__m128i b) {
+      return _mm_sub_epi32(a,b);
+    }
+    template<>
+    inline __m128i __attribute__((__always_inline__))
+    mm_sub<uint16_t>(__m128i a,__m128i b) {
+      return _mm_sub_epi16(a,b);
+    }
+    template<>
+    inline __m128i __attribute__((__always_inline__))
+    mm_sub<int16_t>(__m128i a,__m128i b) {
+      return _mm_sub_epi16(a,b);
+    }
+    template<>
+    inline __m128i __attribute__((__always_inline__))
+    mm_sub<uint8_t>(__m128i a,__m128i b) {
+      return _mm_sub_epi8(a,b);
+    }
+    template<>
+    inline __m128i __attribute__((__always_inline__))
+    mm_sub<int8_t>(__m128i a,__m128i b) {
+      return _mm_sub_epi8(a,b);
+    }
+    template<>
+    inline __m128d __attribute__((__always_inline__))
+    mm_div<double>(__m128d a,__m128d b) {
+      return _mm_div_pd(a,b);
+    }
+    template<>
+    inline __m128 __attribute__((__always_inline__))
+    mm_div<float>(__m128 a,__m128 b) {
+      return _mm_div_ps(a,b);
+    }
+#endif
+
+    /*
+     * Integer broadcasts, products and fused multiply-add.
+     *
+     * There is no lane-wise product of 8-bit integers, the 32-bit one
+     * requires SSE4.1 and the 64-bit one is only available on AVX-512.
+     * has_mm_mul<T> tells which types can use these.
+     */
+
+#if ANPI_SIMD_LEVEL == 3
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_set1<uint64_t,__m512i>(const uint64_t v) {
+      return _mm512_set1_epi64(static_cast<int64_t>(v));
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_set1<int64_t,__m512i>(const int64_t v) {
+      return _mm512_set1_epi64(static_cast<int64_t>(v));
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_set1<uint32_t,__m512i>(const uint32_t v) {
+      return _mm512_set1_epi32(static_cast<int32_t>(v));
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_set1<int32_t,__m512i>(const int32_t v) {
+      return _mm512_set1_epi32(static_cast<int32_t>(v));
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_set1<uint16_t,__m512i>(const uint16_t v) {
+      return _mm512_set1_epi16(static_cast<int16_t>(v));
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_set1<int16_t,__m512i>(const int16_t v) {
+      return _mm512_set1_epi16(static_cast<int16_t>(v));
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_set1<uint8_t,__m512i>(const uint8_t v) {
+      return _mm512_set1_epi8(static_cast<int8_t>(v));
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_set1<int8_t,__m512i>(const int8_t v) {
+      return _mm512_set1_epi8(static_cast<int8_t>(v));
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_mul<uint64_t>(__m512i a,__m512i b) {
+      return _mm512_mullox_epi64(a,b);
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_fmadd<uint64_t>(__m512i a,__m512i b,__m512i c) {
+      return mm_add<uint64_t>(mm_mul<uint64_t>(a,b),c);
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_mul<int64_t>(__m512i a,__m512i b) {
+      return _mm512_mullox_epi64(a,b);
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_fmadd<int64_t>(__m512i a,__m512i b,__m512i c) {
+      return mm_add<int64_t>(mm_mul<int64_t>(a,b),c);
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_mul<uint32_t>(__m512i a,__m512i b) {
+      return _mm512_mullo_epi32(a,b);
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_fmadd<uint32_t>(__m512i a,__m512i b,__m512i c) {
+      return mm_add<uint32_t>(mm_mul<uint32_t>(a,b),c);
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_mul<int32_t>(__m512i a,__m512i b) {
+      return _mm512_mullo_epi32(a,b);
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_fmadd<int32_t>(__m512i a,__m512i b,__m512i c) {
+      return mm_add<int32_t>(mm_mul<int32_t>(a,b),c);
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_mul<uint16_t>(__m512i a,__m512i b) {
+      return _mm512_mullo_epi16(a,b);
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_fmadd<uint16_t>(__m512i a,__m512i b,__m512i c) {
+      return mm_add<uint16_t>(mm_mul<uint16_t>(a,b),c);
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_mul<int16_t>(__m512i a,__m512i b) {
+      return _mm512_mullo_epi16(a,b);
+    }
+    template<>
+    inline __m512i __attribute__((__always_inline__))
+    mm_fmadd<int16_t>(__m512i a,__m512i b,__m512i c) {
+      return mm_add<int16_t>(mm_mul<int16_t>(a,b),c);
+    }
+#elif ANPI_SIMD_LEVEL == 2
+    template<>
+    inline __m256i __attribute__((__always_inline__))
+    mm_set1<uint64_t,__m256i>(const uint64_t v) {
+      return _mm256_set1_epi64x(static_cast<int64_t>(v));
+    }
+    template<>
+    inline __m256i __attribute__((__always_inline__))
+    mm_set1<int64_t,__m256i>(const int64_t v) {
+      return _mm256_set1_epi64x(static_cast<int64_t>(v));
+    }
+    template<>
+    inline __m256i __attribute__((__always_inline__))
+    mm_set1<uint32_t,__m256i>(const uint32_t v) {
+      return _mm256_set1_epi32(static_cast<int32_t>(v));
+    }
+    template<>
+    inline __m256i __attribute__((__always_inline__))
+    mm_set1<int32_t,__m256i>(const int32_t v) {
+      return _mm256_set1_epi32(static_cast<int32_t>(v));
+    }
+    template<>
+    inline __m256i __attribute__((__always_inline__))
+    mm_set1<uint16_t,__m256i>(const uint16_t v) {
+      return _mm256_set1_epi16(static_cast<int16_t>(v));
+    }
+    template<>
+    inline __m256i __attribute__((__always_inline__))
+    mm_set1<int16_t,__m256i>(const int16_t v) {
+      return _mm256_set1_epi16(static_cast<int16_t>(v));
+    }
+    template<>
+    inline __m256i __attribute__((__always_inline__))
+    mm_set1<uint8_t,__m256i>(const uint8_t v) {
+      return _mm256_set1_epi8(static_cast<int8_t>(v));
+    }
+    template<>
+    inline __m256i __attribute__((__always_inline__))
+    mm_set1<int8_t,__m256i>(const int8_t v) {
+      return _mm256_set1_epi8(static_cast<int8_t>(v));
+    }
+    template<>
+    inline __m256i __attribute__((__always_inline__))
+    mm_mul<uint32_t>(__m256i a,__m256i b) {
+      return _mm256_mullo_epi32(a,b);
+    }
+    template<>
+    inline __m256i __attribute__((__always_inline__))
+    mm_fmadd<uint32_t>(__m256i a,__m256i b,__m256i c) {
+      return mm_add<uint32_t>(mm_mul<uint32_t>(a,b),c);
+    }
+    template<>
+    inline __m256i __attribute__((__always_inline__))
+    mm_mul<int32_t>(__m256i a,__m256i b) {
+      return _mm256_mullo_epi32(a,b);
+    }
+    template<>
+    inline __m256i __attribute__((__always_inline__))
+    mm_fmadd<int32_t>(__m256i a,__m256i b,__m256i c) {
+      return mm_add<int32_t>(mm_mul<int32_t>(a,b),c);
+    }
+    template<>
+    inline __m256i __attribute__((__always_inline__))
+    mm_mul<uint16_t>(__m256i a,__m256i b) {
+      return _mm256_mullo_epi16(a,b);
+    }
+    template<>
+    inline __m256i __attribute__((__always_inline__))
+    mm_fmadd<uint16_t>(__m256i a,__m256i b,__m256i c) {
+      return mm_add<uint16_t>(mm_mul<uint16_t>(a,b),c);
+    }
+    template<>
+    inline __m256i __attribute__((__always_inline__))
+    mm_mul<int16_t>(__m256i a,__m256i b) {
+      return _mm256_mullo_epi16(a,b);
+    }
+    template<>
+    inline __m256i __attribute__((__always_inline__))
+    mm_fmadd<int16_t>(__m256i a,__m256i b,__m256i c) {
+      return mm_add<int16_t>(mm_mul<int16_t>(a,b),c);
+    }
+#elif ANPI_SIMD_LEVEL == 1
+    template<>
+    inline __m128i __attribute__((__always_inline__))
+    mm_set1<uint64_t,__m128i>(const uint64_t v) {
+      return _mm_set1_epi64x(static_cast<int64_t>(v));
+    }
+    template<>
+    inline __m128i __attribute__((__always_inline__))
+    mm_set1<int64_t,__m128i>(const int64_t v) {
+      return _mm_set1_epi64x(static_cast<int64_t>(v));
+    }
+    template<>
+    inline __m128i __attribute__((__always_inline__))
+    mm_set1<uint32_t,__m128i>(const uint32_t v) {
+      return _mm_set1_epi32(static_cast<int32_t>(v));
+    }
+    template<>
+    inline __m128i __attribute__((__always_inline__))
+    mm_set1<int32_t,__m128i>(const int32_t v) {
+      return _mm_set1_epi32(static_cast<int32_t>(v));
+    }
+    template<>
+    inline __m128i __attribute__((__always_inline__))
+    mm_set1<uint16_t,__m128i>(const uint16_t v) {
+      return _mm_set1_epi16(static_cast<int16_t>(v));
+    }
+    template<>
+    inline __m128i __attribute__((__always_inline__))
+    mm_set1<int16_t,__m128i>(const int16_t v) {
+      return _mm_set1_epi16(static_cast<int16_t>(v));
+    }
+    template<>
+    inline __m128i __attribute__((__always_inline__))
+    mm_set1<uint8_t,__m128i>(const uint8_t v) {
+      return _mm_set1_epi8(static_cast<int8_t>(v));
+    }
+    template<>
+    inline __m128i __attribute__((__always_inline__))
+    mm_set1<int8_t,__m128i>(const int8_t v) {
+      return _mm_set1_epi8(static_cast<int8_t>(v));
+    }
+#ifdef __SSE4_1__
+    template<>
+    inline __m128i __attribute__((__always_inline__))
+    mm_mul<uint32_t>(__m128i a,__m128i b) {
+      return _mm_mullo_epi32(a,b);
+    }
+    template<>
+    inline __m128i __attribute__((__always_inline__))
+    mm_fmadd<uint32_t>(__m128i a,__m128i b,__m128i c) {
+      return mm_add<uint32_t>(mm_mul<uint32_t>(a,b),c);
+    }
+#endif
+#ifdef __SSE4_1__
+    template<>
+    inline __m128i __attribute__((__always_inline__))
+    mm_mul<int32_t>(__m128i a,__m128i b) {
+      return _mm_mullo_epi32(a,b);
+    }
+    template<>
+    inline __m128i __attribute__((__always_inline__))
+    mm_fmadd<int32_t>(__m128i a,__m128i b,__m128i c) {
+      return mm_add<int32_t>(mm_mul<int32_t>(a,b),c);
+    }
+#endif
+    template<>
+    inline __m128i __attribute__((__always_inline__))
+    mm_mul<uint16_t>(__m128i a,__m128i b) {
+      return _mm_mullo_epi16(a,b);
+    }
+    template<>
+    inline __m128i __attribute__((__always_inline__))
+    mm_fmadd<uint16_t>(__m128i a,__m128i b,__m128i c) {
+      return mm_add<uint16_t>(mm_mul<uint16_t>(a,b),c);
+    }
+    template<>
+    inline __m128i __attribute__((__always_inline__))
+    mm_mul<int16_t>(__m128i a,__m128i b) {
+      return _mm_mullo_epi16(a,b);
+    }
+    template<>
+    inline __m128i __attribute__((__always_inline__))
+    mm_fmadd<int16_t>(__m128i a,__m128i b,__m128i c) {
+      return mm_add<int16_t>(mm_mul<int16_t>(a,b),c);
+    }
+#endif
+    
+    /**
+     * Check if the lane-wise product of T is available in registers
+     */
+    template<typename T>
+    struct has_mm_mul {
+      static constexpr bool value =
+        is_simd_type<T>::value &&
+        ( std::is_floating_point<T>::value ||
+          (sizeof(T)==2) ||
+#if ANPI_SIMD_LEVEL >= 2 || defined __SSE4_1__
+          (sizeof(T)==4) ||
+#endif
+#if ANPI_SIMD_LEVEL == 3
+          (sizeof(T)==8) ||
+#endif
+          false );
+    };
+
+
+    /*
+     * Unaligned loads and stores of whole registers, for all SIMD types.
+     *
+     * Used by the kernels on views, whose rows can start anywhere.
+     */
+
+    /// Floating point types use the typed wrappers
+    template<typename T,bool = std::is_integral<T>::value>
+    struct reg_io {
+      typedef typename reg_traits<T>::reg_type reg_type;
+      static inline reg_type __attribute__((__always_inline__))
+      loadu(const T* p) {
+        return mm_loadu<T,reg_type>(p);
+      }
+      static inline void __attribute__((__always_inline__))
+      storeu(T* p,const reg_type a) {
+        mm_storeu<T,reg_type>(p,a);
+      }
+    };
+
+#if ANPI_SIMD_LEVEL == 3
+    /// Integer types share the integer register
+    template<typename T>
+    struct reg_io<T,true> {
+      typedef __m512i reg_type;
+      static inline __m512i __attribute__((__always_inline__))
+      loadu(const T* p) {
+        return _mm512_loadu_si512(p);
+      }
+      static inline void __attribute__((__always_inline__))
+      storeu(T* p,const __m512i a) {
+        _mm512_storeu_si512(p,a);
+      }
+    };
+#elif ANPI_SIMD_LEVEL == 2
+    /// Integer types share the integer register
+    template<typename T>
+    struct reg_io<T,true> {
+      typedef __m256i reg_type;
+      static inline __m256i __attribute__((__always_inline__))
+      loadu(const T* p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+      }
+      static inline void __attribute__((__always_inline__))
+      storeu(T* p,const __m256i a) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p),a);
+      }
+    };
+#elif ANPI_SIMD_LEVEL == 1
+    /// Integer types share the integer register
+    template<typename T>
+    struct reg_io<T,true> {
+      typedef __m128i reg_type;
+      static inline __m128i __attribute__((__always_inline__))
+      loadu(const T* p) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+      }
+      static inline void __attribute__((__always_inline__))
+      storeu(T* p,const __m128i a) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p),a);
+      }
+    };
+#endif
+
+    /*
+     * Non-temporal stores of whole registers into memory aligned to the
+     * register size, bypassing the caches.  The stores are weakly
+     * ordered: a kernel using them must end with mm_sfence() before
+     * other threads read the results.
+     */
+
+#if ANPI_SIMD_LEVEL == 3
+    inline void __attribute__((__always_inline__))
+    mm_stream(__m512d* p,const __m512d a) {
+      _mm512_stream_pd(reinterpret_cast<double*>(p),a);
+    }
+    inline void __attribute__((__always_inline__))
+    mm_stream(__m512* p,const __m512 a) {
+      _mm512_stream_ps(reinterpret_cast<float*>(p),a);
+    }
+    inline void __attribute__((__always_inline__))
+    mm_stream(__m512i* p,const __m512i a) {
+      _mm512_stream_si512(p,a);
+    }
+#elif ANPI_SIMD_LEVEL == 2
+    inline void __attribute__((__always_inline__))
+    mm_stream(__m256d* p,const __m256d a) {
+      _mm256_stream_pd(reinterpret_cast<double*>(p),a);
+    }
+    inline void __attribute__((__always_inline__))
+    mm_stream(__m256* p,const __m256 a) {
+      _mm256_stream_ps(reinterpret_cast<float*>(p),a);
+    }
+    inline void __attribute__((__always_inline__))
+    mm_stream(__m256i* p,const __m256i a) {
+      _mm256_stream_si256(p,a);
+    }
+#elif ANPI_SIMD_LEVEL == 1
+    inline void __attribute__((__always_inline__))
+    mm_stream(__m128d* p,const __m128d a) {
+      _mm_stream_pd(reinterpret_cast<double*>(p),a);
+    }
+    inline void __attribute__((__always_inline__))
+    mm_stream(__m128* p,const __m128 a) {
+      _mm_stream_ps(reinterpret_cast<float*>(p),a);
+    }
+    inline void __attribute__((__always_inline__))
+    mm_stream(__m128i* p,const __m128i a) {
+      _mm_stream_si128(p,a);
+    }
+#endif
+
+    /// Order the preceding streaming stores before any later store
+    inline void __attribute__((__always_inline__)) mm_sfence() {
+      _mm_sfence();
+    }
+
+    /*
+     * Loads and stores of the first n entries of a register (0 < n < lanes),
+     * for the heads and tails of unpadded buffers.  Memory beyond those
+     * n entries is never accessed, and loads set the other lanes to zero.
+     *
+     * masked tells if the instruction set has these masked operations for
+     * T; otherwise the kernels process the partial registers with the
+     * scalar operator.
+     */
+
+    /// Partial registers not available
+    template<typename T,
+             size_t Size = sizeof(T),
+             bool Integral = std::is_integral<T>::value>
+    struct reg_part {
+      static constexpr bool masked = false;
+    };
+
+#if ANPI_SIMD_LEVEL == 3
+    /// Mask with the lowest n bits set
+    inline std::uint64_t __attribute__((__always_inline__))
+    lowMask(const size_t n) {
+      return (n >= 64) ? ~std::uint64_t(0) : (std::uint64_t(1) << n) - 1;
+    }
+
+    template<>
+    struct reg_part<double,8,false> {
+      static constexpr bool masked = true;
+      typedef __m512d reg_type;
+      static inline __m512d __attribute__((__always_inline__))
+      load(const double* p,const size_t n) {
+        return _mm512_maskz_loadu_pd(__mmask8(lowMask(n)),p);
+      }
+      static inline void __attribute__((__always_inline__))
+      store(double* p,const size_t n,const __m512d a) {
+        _mm512_mask_storeu_pd(p,__mmask8(lowMask(n)),a);
+      }
+    };
+
+    template<>
+    struct reg_part<float,4,false> {
+      static constexpr bool masked = true;
+      typedef __m512 reg_type;
+      static inline __m512 __attribute__((__always_inline__))
+      load(const float* p,const size_t n) {
+        return _mm512_maskz_loadu_ps(__mmask16(lowMask(n)),p);
+      }
+      static inline void __attribute__((__always_inline__))
+      store(float* p,const size_t n,const __m512 a) {
+        _mm512_mask_storeu_ps(p,__mmask16(lowMask(n)),a);
+      }
+    };
+
+    template<typename T>
+    struct reg_part<T,8,true> {
+      static constexpr bool masked = true;
+      typedef __m512i reg_type;
+      static inline __m512i __attribute__((__always_inline__))
+      load(const T* p,const size_t n) {
+        return _mm512_maskz_loadu_epi64(__mmask8(lowMask(n)),p);
+      }
+      static inline void __attribute__((__always_inline__))
+      store(T* p,const size_t n,const __m512i a) {
+        _mm512_mask_storeu_epi64(p,__mmask8(lowMask(n)),a);
+      }
+    };
+
+    template<typename T>
+    struct reg_part<T,4,true> {
+      static constexpr bool masked = true;
+      typedef __m512i reg_type;
+      static inline __m512i __attribute__((__always_inline__))
+      load(const T* p,const size_t n) {
+        return _mm512_maskz_loadu_epi32(__mmask16(lowMask(n)),p);
+      }
+      static inline void __attribute__((__always_inline__))
+      store(T* p,const size_t n,const __m512i a) {
+        _mm512_mask_storeu_epi32(p,__mmask16(lowMask(n)),a);
+      }
+    };
+
+    template<typename T>
+    struct reg_part<T,2,true> {
+      static constexpr bool masked = true;
+      typedef __m512i reg_type;
+      static inline __m512i __attribute__((__always_inline__))
+      load(const T* p,const size_t n) {
+        return _mm512_maskz_loadu_epi16(__mmask32(lowMask(n)),p);
+      }
+      static inline void __attribute__((__always_inline__))
+      store(T* p,const size_t n,const __m512i a) {
+        _mm512_mask_storeu_epi16(p,__mmask32(lowMask(n)),a);
+      }
+    };
+
+    template<typename T>
+    struct reg_part<T,1,true> {
+      static constexpr bool masked = true;
+      typedef __m512i reg_type;
+      static inline __m512i __attribute__((__always_inline__))
+      load(const T* p,const size_t n) {
+        return _mm512_maskz_loadu_epi8(__mmask64(lowMask(n)),p);
+      }
+      static inline void __attribute__((__always_inline__))
+      store(T* p,const size_t n,const __m512i a) {
+        _mm512_mask_storeu_epi8(p,__mmask64(lowMask(n)),a);
+      }
+    };
+#elif ANPI_SIMD_LEVEL == 2
+    /// Lanes of 64 bits below n set to all ones
+    inline __m256i __attribute__((__always_inline__))
+    laneMask64(const size_t n) {
+      return _mm256_cmpgt_epi64(_mm256_set1_epi64x((long long)(n)),
+                                _mm256_setr_epi64x(0,1,2,3));
+    }
+
+    /// Lanes of 32 bits below n set to all ones
+    inline __m256i __attribute__((__always_inline__))
+    laneMask32(const size_t n) {
+      return _mm256_cmpgt_epi32(_mm256_set1_epi32(int(n)),
+                                _mm256_setr_epi32(0,1,2,3,4,5,6,7));
+    }
+
+    template<>
+    struct reg_part<double,8,false> {
+      static constexpr bool masked = true;
+      typedef __m256d reg_type;
+      static inline __m256d __attribute__((__always_inline__))
+      load(const double* p,const size_t n) {
+        return _mm256_maskload_pd(p,laneMask64(n));
+      }
+      static inline void __attribute__((__always_inline__))
+      store(double* p,const size_t n,const __m256d a) {
+        _mm256_maskstore_pd(p,laneMask64(n),a);
+      }
+    };
+
+    template<>
+    struct reg_part<float,4,false> {
+      static constexpr bool masked = true;
+      typedef __m256 reg_type;
+      static inline __m256 __attribute__((__always_inline__))
+      load(const float* p,const size_t n) {
+        return _mm256_maskload_ps(p,laneMask32(n));
+      }
+      static inline void __attribute__((__always_inline__))
+      store(float* p,const size_t n,const __m256 a) {
+        _mm256_maskstore_ps(p,laneMask32(n),a);
+      }
+    };
+
+    template<typename T>
+    struct reg_part<T,8,true> {
+      static constexpr bool masked = true;
+      typedef __m256i reg_type;
+      static inline __m256i __attribute__((__always_inline__))
+      load(const T* p,const size_t n) {
+        return _mm256_maskload_epi64(reinterpret_cast<const long long*>(p),
+                                     laneMask64(n));
+      }
+      static inline void __attribute__((__always_inline__))
+      store(T* p,const size_t n,const __m256i a) {
+        _mm256_maskstore_epi64(reinterpret_cast<long long*>(p),
+                               laneMask64(n),a);
+      }
+    };
+
+    template<typename T>
+    struct reg_part<T,4,true> {
+      static constexpr bool masked = true;
+      typedef __m256i reg_type;
+      static inline __m256i __attribute__((__always_inline__))
+      load(const T* p,const size_t n) {
+        return _mm256_maskload_epi32(reinterpret_cast<const int*>(p),
+                                     laneMask32(n));
+      }
+      static inline void __attribute__((__always_inline__))
+      store(T* p,const size_t n,const __m256i a) {
+        _mm256_maskstore_epi32(reinterpret_cast<int*>(p),laneMask32(n),a);
+      }
+    };
+#endif
@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date:   09.01.2018
+ */
+
+/*
+ * Sparse matrix-vector product kernels for one instruction set.
+ *
+ * Like SimdRegisters.hpp, this file has no include guards: SimdDispatch.hpp
+ * includes it once per instruction set.
+ */
+
+    /*
+     * Sparse matrix-vector product
+     *
+     * Each row is a dot product between its packed nonzeros and the
+     * entries of x they address.  AVX2 and AVX-512 fetch those entries
+     * with one gather per register; AVX-512 also finishes the row with
+     * a masked gather, which matters as most rows of a discretization
+     * hold fewer nonzeros than one register.  SSE2 has no gather, and
+     * uses two scalar accumulators instead.
+     */
+
+    /// Dot product of one sparse row with x
+    template<typename T>
+    inline T spmvRow(const T* vals,
+                     const sparse_index* cols,
+                     const size_t nnz,
+                     const T* x) {
+      T s0 = T(0), s1 = T(0);
+      size_t k=0;
+      for (;k+1<nnz;k+=2) {
+        s0 += vals[k]*x[cols[k]];
+        s1 += vals[k+1]*x[cols[k+1]];
+      }
+      if (k<nnz) {
+        s0 += vals[k]*x[cols[k]];
+      }
+      return s0+s1;
+    }
+
+#if ANPI_SIMD_LEVEL == 3
+    template<>
+    inline double spmvRow<double>(const double* vals,
+                                  const sparse_index* cols,
+                                  const size_t nnz,
+                                  const double* x) {
+      __m512d acc = _mm512_setzero_pd();
+      size_t k=0;
+      for (;k+8<=nnz;k+=8) {
+        const __m256i idx =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cols+k));
+        acc = _mm512_fmadd_pd(_mm512_loadu_pd(vals+k),
+                              _mm512_mask_i32gather_pd(_mm512_setzero_pd(),
+                                                       __mmask8(0xff),
+                                                       idx,x,8),
+                              acc);
+      }
+      if (k<nnz) {
+        const __mmask8 m = __mmask8((1u << (nnz-k)) - 1u);
+        const __m256i idx = _mm256_maskz_loadu_epi32(m,cols+k);
+        const __m512d xv =
+          _mm512_mask_i32gather_pd(_mm512_setzero_pd(),m,idx,x,8);
+        acc = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(m,vals+k),xv,acc);
+      }
+      // _mm512_reduce_add_pd() would do, but the unmasked extractions
+      // trip GCC's -Wmaybe-uninitialized inside the intrinsics header
+      const __m256d q = _mm256_add_pd(_mm512_maskz_extractf64x4_pd(0xf,acc,0),
+                                      _mm512_maskz_extractf64x4_pd(0xf,acc,1));
+      const __m128d h = _mm_add_pd(_mm256_castpd256_pd128(q),
+                                   _mm256_extractf128_pd(q,1));
+      return _mm_cvtsd_f64(_mm_add_sd(h,_mm_unpackhi_pd(h,h)));
+    }
+
+    template<>
+    inline float spmvRow<float>(const float* vals,
+                                const sparse_index* cols,
+                                const size_t nnz,
+                                const float* x) {
+      __m512 acc = _mm512_setzero_ps();
+      size_t k=0;
+      for (;k+16<=nnz;k+=16) {
+        const __m512i idx = _mm512_loadu_si512(cols+k);
+        acc = _mm512_fmadd_ps(_mm512_loadu_ps(vals+k),
+                              _mm512_mask_i32gather_ps(_mm512_setzero_ps(),
+                                                       __mmask16(0xffff),
+                                                       idx,x,4),
+                              acc);
+      }
+      if (k<nnz) {
+        const __mmask16 m = __mmask16((1u << (nnz-k)) - 1u);
+        const __m512i idx = _mm512_maskz_loadu_epi32(m,cols+k);
+        const __m512 xv =
+          _mm512_mask_i32gather_ps(_mm512_setzero_ps(),m,idx,x,4);
+        acc = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m,vals+k),xv,acc);
+      }
+      const __m256 q = _mm256_add_ps(_mm512_maskz_extractf32x8_ps(0xff,acc,0),
+                                     _mm512_maskz_extractf32x8_ps(0xff,acc,1));
+      __m128 h = _mm_add_ps(_mm256_castps256_ps128(q),
+                            _mm256_extractf128_ps(q,1));
+      h = _mm_add_ps(h,_mm_movehl_ps(h,h));
+      h = _mm_add_ss(h,_mm_shuffle_ps(h,h,1));
+      return _mm_cvtss_f32(h);
+    }
+#elif ANPI_SIMD_LEVEL == 2
+    template<>
+    inline double spmvRow<double>(const double* vals,
+                                  const sparse_index* cols,
+                                  const size_t nnz,
+                                  const double* x) {
+      const __m256d ones = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+      __m256d acc = _mm256_setzero_pd();
+      size_t k=0;
+      for (;k+4<=nnz;k+=4) {
+        const __m128i idx =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(cols+k));
+        acc = _mm256_fmadd_pd(_mm256_loadu_pd(vals+k),
+                              _mm256_mask_i32gather_pd(_mm256_setzero_pd(),x,idx,
+                                                       ones,8),
+                              acc);
+      }
+      const __m128d h = _mm_add_pd(_mm256_castpd256_pd128(acc),
+                                   _mm256_extractf128_pd(acc,1));
+      double sum = _mm_cvtsd_f64(_mm_add_sd(h,_mm_unpackhi_pd(h,h)));
+      for (;k<nnz;++k) {
+        sum += vals[k]*x[cols[k]];
+      }
+      return sum;
+    }
+
+    template<>
+    inline float spmvRow<float>(const float* vals,
+                                const sparse_index* cols,
+                                const size_t nnz,
+                                const float* x) {
+      const __m256 ones = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+      __m256 acc = _mm256_setzero_ps();
+      size_t k=0;
+      for (;k+8<=nnz;k+=8) {
+        const __m256i idx =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cols+k));
+        acc = _mm256_fmadd_ps(_mm256_loadu_ps(vals+k),
+                              _mm256_mask_i32gather_ps(_mm256_setzero_ps(),x,idx,
+                                                       ones,4),
+                              acc);
+      }
+      __m128 h = _mm_add_ps(_mm256_castps256_ps128(acc),
+                            _mm256_extractf128_ps(acc,1));
+      h = _mm_add_ps(h,_mm_movehl_ps(h,h));
+      h = _mm_add_ss(h,_mm_shuffle_ps(h,h,1));
+      float sum = _mm_cvtss_f32(h);
+      for (;k<nnz;++k) {
+        sum += vals[k]*x[cols[k]];
+      }
+      return sum;
+    }
+#endif
+
+    /**
+     * y = A*x for a matrix A in compressed sparse row format.
+     *
+     * See fallback::spmv() in SparseProduct.hpp for the layout.
+     */
+    template<typename T>
+    inline void spmv(const size_t rows,
+                     const size_t* rowPtr,
+                     const sparse_index* cols,
+                     const T* vals,
+                     const T* x,
+                     T* y) {
+      parallel::forChunks(rows,64,rowPtr[rows],[&](size_t begin,size_t end) {
+        for (size_t r=begin;r<end;++r) {
+          const size_t k = rowPtr[r];
+          y[r] = spmvRow(vals+k,cols+k,rowPtr[r+1]-k,x);
+        }
+      });
+    }
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date:   09.01.2018
+ */
+
+#ifndef ANPI_SPARSE_PRODUCT_HPP
+#define ANPI_SPARSE_PRODUCT_HPP
+
+#include "Parallel.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace anpi
+{
+  /// Type of the column indices of the compressed sparse rows
+  typedef std::int32_t sparse_index;
+
+  namespace fallback {
+    /*
+     * Sparse matrix-vector product
+     */
+
+    /**
+     * y = A*x for a matrix A in compressed sparse row format.
+     *
+     * Row r holds the nonzeros vals[rowPtr[r]:rowPtr[r+1]], in the
+     * columns cols[rowPtr[r]:rowPtr[r+1]].  The rows are distributed
+     * among the threads; y must not overlap x.
+     */
+    template<typename T>
+    inline void spmv(const size_t rows,
+                     const size_t* rowPtr,
+                     const sparse_index* cols,
+                     const T* vals,
+                     const T* x,
+                     T* y) {
+      parallel::forChunks(rows,64,rowPtr[rows],[&](size_t begin,size_t end) {
+        for (size_t r=begin;r<end;++r) {
+          T sum = T(0);
+          for (size_t k=rowPtr[r];k<rowPtr[r+1];++k) {
+            sum += vals[k]*x[cols[k]];
+          }
+          y[r] = sum;
+        }
+      });
+    }
+  } // namespace fallback
+} // namespace anpi
+
+#endif
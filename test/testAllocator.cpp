@@ -9,7 +9,11 @@
  */
 
 #include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
 #include <Allocator.hpp>
+#include <MappedAllocator.hpp>
+#include <PoolAllocator.hpp>
+#include <HugePageAllocator.hpp>
 
 #define COMMA ,
 
@@ -69,7 +73,198 @@ BOOST_AUTO_TEST_CASE( Checks ) {
     BOOST_CHECK(ext::row_aligned == true );
   }
 
+  {
+    typedef anpi::extract_alignment<anpi::mapped_allocator<double,32> > ext;
+    BOOST_CHECK(ext::value==32);
+    BOOST_CHECK(ext::aligned == true );
+    BOOST_CHECK(ext::row_aligned == true );
+    val = anpi::is_aligned_alloc<anpi::mapped_allocator<float,16> >::value;
+    BOOST_CHECK(val);
+  }
+
+  {
+    typedef anpi::extract_alignment<anpi::pool_allocator<float,16> > ext;
+    BOOST_CHECK(ext::value==16);
+    BOOST_CHECK(ext::aligned == true );
+    BOOST_CHECK(ext::row_aligned == true );
+  }
+
   
 }
 
+BOOST_AUTO_TEST_CASE( Mapped ) {
+  namespace fs = boost::filesystem;
+  const std::string path =
+    (fs::temp_directory_path() / fs::unique_path("anpi-%%%%-%%%%.mat")).string();
+
+  typedef anpi::mapped_allocator<float> alloc_type;
+  typedef anpi::Matrix<float,alloc_type> mmatrix;
+
+  { // anonymous mappings
+    alloc_type alloc;
+    float* ptr = alloc.allocate(1000);
+    BOOST_CHECK( reinterpret_cast<size_t>(ptr) % anpi::DefaultAlignment == 0);
+    ptr[999] = 1.f;
+    alloc.deallocate(ptr,1000);
+
+    mmatrix a(3,5,2.f);
+    mmatrix b(a);
+    a += b;
+    BOOST_CHECK( a(2,4) == 4.f );
+  }
+
+  { // create and fill a file
+    mmatrix m = anpi::createMapped<float>(path,7,13);
+    BOOST_CHECK( (m.rows()==7) && (m.cols()==13) );
+    BOOST_CHECK( reinterpret_cast<size_t>(m[1]) % anpi::DefaultAlignment == 0);
+    for (size_t i=0;i<m.rows();++i) {
+      for (size_t j=0;j<m.cols();++j) {
+        m(i,j) = float(i*100+j);
+      }
+    }
+  }
+
+  { // the header describes the matrix
+    const anpi::matrix_file_header h = anpi::readMatrixFileHeader(path);
+    BOOST_CHECK( (h.rows==7) && (h.cols==13) && (h.typeSize==sizeof(float)) );
+    BOOST_CHECK( h.dcols*sizeof(float) % anpi::DefaultAlignment == 0 );
+  }
+
+  { // read-write access is written back
+    mmatrix m = anpi::openMapped<float>(path,anpi::MapMode::ReadWrite,
+                                        anpi::MapAdvice::Random);
+    BOOST_CHECK( m(6,12) == 612.f );
+    m(3,4) = -1.f;
+  }
+
+  { // read-only access
+    const mmatrix m =
+      anpi::openMappedReadOnly<float>(path,anpi::MapAdvice::Sequential);
+    BOOST_CHECK( (m.rows()==7) && (m.cols()==13) );
+    BOOST_CHECK( m(3,4) == -1.f );
+    BOOST_CHECK( m(5,6) == 506.f );
+
+    // the SIMD kernels work directly on the mapping
+    mmatrix c = m + m;
+    BOOST_CHECK( c(5,6) == 1012.f );
+  }
+
+  // wrong element type or not a matrix file
+  BOOST_CHECK_THROW( anpi::openMappedReadOnly<double>(path), anpi::Exception );
+  BOOST_CHECK_THROW( anpi::openMappedReadOnly<float>(path + ".none"),
+                     anpi::Exception );
+
+  // files are only created by createMapped, never truncated by openMapped
+  BOOST_CHECK_THROW( anpi::openMapped<float>(path,anpi::MapMode::Create),
+                     anpi::Exception );
+  // read-only mappings are only returned as const matrices
+  BOOST_CHECK_THROW( anpi::openMapped<float>(path,anpi::MapMode::ReadOnly),
+                     anpi::Exception );
+  BOOST_CHECK( anpi::readMatrixFileHeader(path).rows == 7 );
+
+  fs::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE( Pool ) {
+  typedef anpi::pool_cache<64> cache;
+
+  { // size classes waste at most a quarter of the buffer
+    size_t bytes;
+    BOOST_CHECK( cache::sizeClass(1,bytes) == 0 && bytes == 64 );
+    BOOST_CHECK( cache::sizeClass(65,bytes) == 1 && bytes == 80 );
+    BOOST_CHECK( cache::sizeClass(128,bytes) == 4 && bytes == 128 );
+    for (size_t b=1;b<100000;b+=37) {
+      cache::sizeClass(b,bytes);
+      BOOST_CHECK( (bytes >= b) && ( (b<=64) || (4*bytes <= 5*b+4) ) );
+    }
+  }
+
+  typedef anpi::pool_allocator<double,64> alloc_type;
+  alloc_type alloc;
+
+  { // released buffers are recycled
+    double* ptr = alloc.allocate(1000);
+    BOOST_CHECK( reinterpret_cast<size_t>(ptr) % 64 == 0 );
+    alloc.deallocate(ptr,1000);
+    const size_t hits = cache::local().stats().hits;
+    double* other = alloc.allocate(1000);
+    BOOST_CHECK( other == ptr );
+    BOOST_CHECK( cache::local().stats().hits == hits+1 );
+    alloc.deallocate(other,1000);
+  }
+
+  { // temporaries in a loop do not reach the heap after the first pass
+    typedef anpi::Matrix<double,alloc_type> pmatrix;
+    pmatrix a(17,33,1.);
+    pmatrix b(17,33,2.);
+    pmatrix c;
+
+    size_t misses = 0;
+    for (int i=0;i<10;++i) {
+      if (i==1) {
+        misses = cache::local().stats().misses;
+      }
+      pmatrix t(a);
+      t += b;
+      c = t+a;
+    }
+    BOOST_CHECK( cache::local().stats().misses == misses );
+    BOOST_CHECK( c(16,32) == 4. );
+  }
+
+  { // buffers beyond the byte budget of the thread go back to the heap
+    const size_t n = cache::max_cached_bytes/sizeof(double) + 1;
+    const size_t cached = cache::local().stats().cached;
+    double* ptr = alloc.allocate(n);
+    alloc.deallocate(ptr,n);
+    BOOST_CHECK( cache::local().stats().cached == cached );
+
+    const size_t third = cache::max_cached_bytes/(3*sizeof(double));
+    double* parts[cache::max_cached];
+    for (size_t i=0;i<cache::max_cached;++i) {
+      parts[i] = alloc.allocate(third);
+    }
+    for (size_t i=0;i<cache::max_cached;++i) {
+      alloc.deallocate(parts[i],third);
+    }
+    BOOST_CHECK( cache::local().stats().cached < cached+cache::max_cached );
+    BOOST_CHECK( cache::local().stats().bytes <= cache::max_cached_bytes );
+  }
+
+  cache::local().trim();
+  BOOST_CHECK( cache::local().stats().cached == 0 );
+  BOOST_CHECK( cache::local().stats().bytes == 0 );
+}
+
+BOOST_AUTO_TEST_CASE( HugePages ) {
+  typedef anpi::huge_page_allocator<float,64> alloc_type;
+  alloc_type alloc;
+
+  { // small buffers come from the heap
+    float* ptr = alloc.allocate(1024);
+    BOOST_CHECK( reinterpret_cast<size_t>(ptr) % 64 == 0 );
+    BOOST_CHECK( anpi::lastHugePageMode() == anpi::HugePageMode::Heap );
+    alloc.deallocate(ptr,1024);
+  }
+
+  { // large buffers are aligned to the huge pages
+    const size_t n = 3*anpi::HugePageSize/sizeof(float) + 5;
+    float* ptr = alloc.allocate(n);
+    BOOST_CHECK( reinterpret_cast<size_t>(ptr) % anpi::HugePageSize == 0 );
+    BOOST_CHECK( anpi::lastHugePageMode() != anpi::HugePageMode::Heap );
+    BOOST_CHECK( alloc_type::mappedBytes(n) == 4*anpi::HugePageSize );
+    ptr[0] = 1.f;
+    ptr[n-1] = 2.f;
+    alloc.deallocate(ptr,n);
+  }
+
+  { // matrices
+    typedef anpi::Matrix<float,alloc_type> hmatrix;
+    hmatrix a(1024,1000,1.f);
+    hmatrix b(a);
+    hmatrix c = a + b;
+    BOOST_CHECK( c(1023,999) == 2.f );
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
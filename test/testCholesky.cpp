@@ -0,0 +1,99 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date  : 07.01.2018
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "CholeskyDecomposition.hpp"
+#include "testFactorization.hpp"
+#include "testSimd.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+namespace anpi {
+  namespace test {
+
+    template<typename T>
+    void choleskyTest() {
+      typedef Matrix<T> matrix_type;
+      const T eps = T(2000)*std::numeric_limits<T>::epsilon();
+
+      const size_t sizes[] = { 1, 5, 16, 33, 64, 100 };
+      for (size_t n : sizes) {
+        // A = B*B^T + n*I is symmetric positive definite
+        matrix_type B(n,n),Bt(n,n);
+        randomFill(B,unsigned(n));
+        Bt.view().fillTransposed(B.view());
+        matrix_type A = B*Bt;
+        for (size_t i=0;i<n;++i) {
+          A(i,i) += T(n);
+        }
+
+        matrix_type Lr,Lb;
+        choleskyUnblocked(A,Lr);
+        cholesky(A,Lb,16);
+
+        // residual L*L^T - A, relative to the size of the entries
+        matrix_type Lt(n,n);
+        Lt.view().fillTransposed(Lb.view());
+        matrix_type LLt = Lb*Lt;
+        BOOST_CHECK( maxDiff(LLt,A) < T(n)*eps );
+        BOOST_CHECK( maxDiff(Lr,Lb) < eps );
+
+        for (size_t i=0;i+1<n;++i) {
+          BOOST_CHECK( Lb(i,i+1) == T(0) );
+        }
+
+        // one right-hand side
+        std::vector<T> x(n),b(n,T(0)),xs;
+        for (size_t i=0;i<n;++i) {
+          x[i] = T(i%5) - T(2);
+        }
+        for (size_t r=0;r<n;++r) {
+          for (size_t c=0;c<n;++c) {
+            b[r] += A(r,c)*x[c];
+          }
+        }
+        solveCholesky(A,xs,b);
+        for (size_t i=0;i<n;++i) {
+          BOOST_CHECK( std::abs(xs[i]-x[i]) < eps );
+        }
+      }
+
+      // indefinite and non-square matrices
+      {
+        matrix_type S = { {T(1),T(2)}, {T(2),T(1)} },L;
+        BOOST_CHECK_THROW( cholesky(S,L), anpi::Exception );
+
+        matrix_type R(2,3,T(1));
+        BOOST_CHECK_THROW( cholesky(R,L), anpi::Exception );
+      }
+    }
+
+  } // test
+} // anpi
+
+BOOST_AUTO_TEST_SUITE( Cholesky )
+
+BOOST_AUTO_TEST_CASE(Blocked) {
+  anpi::test::choleskyTest<float>();
+  anpi::test::choleskyTest<double>();
+}
+
+BOOST_AUTO_TEST_CASE(Dispatch) {
+  // the trailing update with every level supported by this CPU
+  anpi::test::forEachIsa([&] {
+    anpi::test::choleskyTest<double>();
+  });
+}
+
+BOOST_AUTO_TEST_SUITE_END()
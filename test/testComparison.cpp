@@ -0,0 +1,167 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date  : 14.01.2018
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "Matrix.hpp"
+#include "testFactorization.hpp"
+#include "testSimd.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace anpi {
+  namespace test {
+
+    template<typename T>
+    void comparisonTest() {
+      typedef Matrix<T> matrix_type;
+      const std::uint64_t inf = std::numeric_limits<std::uint64_t>::max();
+      const T nan = std::numeric_limits<T>::quiet_NaN();
+
+      // lengths around the register widths and the unrolled blocks
+      const size_t sizes[] = { 1, 3, 7, 16, 33, 64, 67 };
+      for (size_t cols : sizes) {
+        matrix_type a(5,cols);
+        randomFill(a,unsigned(cols));
+
+        // different garbage in the padding must be ignored
+        matrix_type b(a);
+        for (size_t r=0;r<b.rows();++r) {
+          for (size_t c=b.cols();c<b.dcols();++c) {
+            b[r][c] = T(r+c+1);
+          }
+        }
+        BOOST_CHECK( a == b );
+        BOOST_CHECK( allclose(a,b,T(0),T(0)) );
+        BOOST_CHECK( maxUlpDistance(a,b) == 0 );
+
+        // a difference in the last entry, reached only after all others
+        const size_t r = a.rows()-1, c = a.cols()-1;
+        b(r,c) = std::nextafter(std::nextafter(a(r,c),T(2)),T(2));
+        BOOST_CHECK( a != b );
+        BOOST_CHECK( maxUlpDistance(a,b) == 2 );
+        BOOST_CHECK( maxUlpDistance(b,a,false) == 2 );
+        BOOST_CHECK( allclose(a,b) );
+        BOOST_CHECK( !allclose(a,b,T(0),T(0)) );
+
+        b(r,c) = a(r,c) + T(1);
+        BOOST_CHECK( !allclose(a,b) );
+        BOOST_CHECK( allclose(a,b,T(0),T(1.5)) );
+
+        b(r,c) = nan;
+        BOOST_CHECK( a != b );
+        BOOST_CHECK( !allclose(a,b,T(1),T(1)) );
+        BOOST_CHECK( maxUlpDistance(a,b) == inf );
+
+        // an infinite reference is close only to itself, also in the
+        // vectorized body of the rows
+        b = a;
+        b(0,0) = std::numeric_limits<T>::infinity();
+        BOOST_CHECK( !allclose(a,b) );
+        a(0,0) = -b(0,0);
+        BOOST_CHECK( !allclose(a,b) );
+        a(0,0) = b(0,0);
+        BOOST_CHECK( allclose(a,b) );
+      }
+
+      // signed zeros, infinities and NaN
+      {
+        const T pinf = std::numeric_limits<T>::infinity();
+        matrix_type a = { { T(0), pinf, T(1) } };
+        matrix_type b = { { -T(0), pinf, T(1) } };
+        BOOST_CHECK( a != b ); // bitwise, while the values are equal
+        BOOST_CHECK( allclose(a,b,T(0),T(0)) );
+        BOOST_CHECK( maxUlpDistance(a,b) == 0 );
+
+        // the smallest subnormals of both signs are two steps apart
+        const T tiny = std::numeric_limits<T>::denorm_min();
+        matrix_type c = { { tiny, pinf, T(1) } };
+        matrix_type d = { { -tiny, pinf, T(1) } };
+        BOOST_CHECK( maxUlpDistance(c,d) == 2 );
+
+        // a copy has the same bits, also for NaN
+        matrix_type n = { { nan, pinf, T(1) } };
+        BOOST_CHECK( n == n );
+        matrix_type m(n);
+        BOOST_CHECK( n == m );
+        BOOST_CHECK( !(n != m) );
+        BOOST_CHECK( !allclose(n,m) );
+
+        // an infinite reference is close only to itself
+        matrix_type e = { { T(0), -pinf, T(1) } };
+        matrix_type f = { { T(0), T(1), T(1) } };
+        BOOST_CHECK( !allclose(e,a) );
+        BOOST_CHECK( !allclose(a,e) );
+        BOOST_CHECK( !allclose(f,a) );
+        BOOST_CHECK( !allclose(a,f) );
+        BOOST_CHECK( !allclose(f,a,T(1),T(1)) );
+        BOOST_CHECK( allclose(e,e) );
+      }
+
+      // different sizes
+      {
+        matrix_type a(2,3,T(1)), b(3,2,T(1));
+        BOOST_CHECK( a != b );
+        BOOST_CHECK( !allclose(a,b) );
+        BOOST_CHECK( maxUlpDistance(a,b) == inf );
+      }
+    }
+
+  } // test
+} // anpi
+
+BOOST_AUTO_TEST_SUITE( Comparison )
+
+BOOST_AUTO_TEST_CASE(FloatingPoint) {
+  anpi::test::forEachIsa([&] {
+    anpi::test::comparisonTest<float>();
+    anpi::test::comparisonTest<double>();
+  });
+}
+
+BOOST_AUTO_TEST_CASE(Parallel) {
+  // split a large matrix among threads, differing in one entry only
+  const anpi::test::parallelGuard guard;
+  anpi::parallel::setThreshold(1);
+
+  anpi::Matrix<double> a(300,301),b;
+  anpi::test::randomFill(a,7u);
+  b = a;
+  BOOST_CHECK( anpi::allclose(a,b,0.0,0.0) );
+  b(150,17) = std::nextafter(a(150,17),10.0);
+  BOOST_CHECK( anpi::maxUlpDistance(a,b) == 1 );
+  BOOST_CHECK( !anpi::allclose(a,b,0.0,0.0) );
+}
+
+BOOST_AUTO_TEST_CASE(Integer) {
+  anpi::Matrix<int> a(4,9,3), b(4,9,3);
+  BOOST_CHECK( a == b );
+  BOOST_CHECK( anpi::allclose(a,b,0,0) );
+  b(3,8) = 5;
+  BOOST_CHECK( a != b );
+  BOOST_CHECK( anpi::allclose(a,b,0,2) );
+  BOOST_CHECK( !anpi::allclose(a,b,0,1) );
+
+  // one differing byte at every position around the register widths
+  anpi::test::forEachIsa([&] {
+    const anpi::Matrix<std::uint8_t> c(3,257,std::uint8_t(9));
+    for (size_t col=0;col<c.cols();++col) {
+      anpi::Matrix<std::uint8_t> d(c);
+      BOOST_CHECK( c == d );
+      d(2,col) = 8;
+      BOOST_CHECK( c != d );
+    }
+  });
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,71 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date  : 10.02.2018
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "Dual.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace anpi {
+  namespace test {
+
+    /// Expression using all operations on duals
+    template<typename U>
+    U dualExpression(const U& x) {
+      using std::sin; using std::cos; using std::exp; using std::log;
+      using std::sqrt; using std::pow; using std::atan; using std::tanh;
+      return (sin(x)*cos(2*x) + exp(-x)/x - log(x)*sqrt(x)
+              + pow(x,2.5) - 1/(x*x) + atan(x) - tanh(x/2) + 3) / (x+1);
+    }
+
+    template<typename T>
+    void dualTest() {
+      typedef Dual<T> D;
+      const T x=T(0.7), h=std::cbrt(std::numeric_limits<T>::epsilon());
+      const T tol=(sizeof(T)==sizeof(float)) ? T(1e-2) : T(1e-6);
+
+      // derivative against a central difference
+      const D f = dualExpression(D(x,T(1)));
+      const T fd = (dualExpression(x+h) - dualExpression(x-h))/(T(2)*h);
+      BOOST_CHECK( std::abs(f.value() - dualExpression(x)) <= tol );
+      BOOST_CHECK( std::abs(f.derivative() - fd) <= tol );
+
+      // constants have no derivative, comparisons use the values
+      const D c(T(2));
+      BOOST_CHECK( (c*c + D(x,T(1))).derivative() == T(1) );
+      BOOST_CHECK( c < T(3) && T(1) < c && c == T(2) && c != D(x) );
+      BOOST_CHECK( abs(D(-x,T(1))).derivative() == T(-1) );
+
+      // nested duals carry the second derivative: (x³)'' = 6x
+      typedef Dual<D> DD;
+      const DD y(D(x,T(1)),D(T(1),T(0)));
+      const DD c3 = y*y*y;
+      BOOST_CHECK( std::abs(c3.value().value() - x*x*x) <= tol );
+      BOOST_CHECK( std::abs(c3.derivative().value() - T(3)*x*x) <= tol );
+      BOOST_CHECK( std::abs(c3.derivative().derivative() - T(6)*x) <= tol );
+
+      // and through the math functions: (sin x)'' = -sin x
+      const DD s = sin(y);
+      BOOST_CHECK( std::abs(s.derivative().derivative() + std::sin(x)) <= tol );
+    }
+
+  } // test
+} // anpi
+
+BOOST_AUTO_TEST_SUITE( Dual )
+
+BOOST_AUTO_TEST_CASE(Derivatives) {
+  anpi::test::dualTest<float>();
+  anpi::test::dualTest<double>();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
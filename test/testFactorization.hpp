@@ -0,0 +1,52 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date  : 07.01.2018
+ */
+
+#ifndef ANPI_TEST_FACTORIZATION_HPP
+#define ANPI_TEST_FACTORIZATION_HPP
+
+#include <algorithm>
+#include <cmath>
+
+#include "Matrix.hpp"
+
+/*
+ * Helpers shared by the tests of the matrix factorizations
+ */
+
+namespace anpi {
+  namespace test {
+
+    /// Fill m with reproducible pseudo-random values in [-1,1]
+    template<typename T,class Alloc>
+    void randomFill(Matrix<T,Alloc>& m,unsigned int seed) {
+      for (size_t r=0;r<m.rows();++r) {
+        for (size_t c=0;c<m.cols();++c) {
+          seed = seed*1103515245u + 12345u;
+          m(r,c) = T(int((seed >> 8) % 2001) - 1000)/T(1000);
+        }
+      }
+    }
+
+    /// Largest absolute difference between the entries of a and b
+    template<typename T,class Alloc>
+    T maxDiff(const Matrix<T,Alloc>& a,const Matrix<T,Alloc>& b) {
+      T diff = T(0);
+      for (size_t r=0;r<a.rows();++r) {
+        for (size_t c=0;c<a.cols();++c) {
+          diff = std::max(diff,std::abs(a(r,c)-b(r,c)));
+        }
+      }
+      return diff;
+    }
+
+  } // test
+} // anpi
+
+#endif
@@ -0,0 +1,136 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date  : 13.01.2018
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "FixedMatrix.hpp"
+#include "LUDecomposition.hpp"
+#include "testFactorization.hpp"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace anpi {
+  namespace test {
+
+    /// Fixed matrix with the entries of a random dense matrix
+    template<typename T,size_t R,size_t C>
+    FixedMatrix<T,R,C> randomFixed(const unsigned int seed) {
+      Matrix<T> m(R,C);
+      randomFill(m,seed);
+      return FixedMatrix<T,R,C>(m);
+    }
+
+    /// Largest absolute difference between the entries
+    template<typename T,size_t R,size_t C>
+    T maxDiff(const FixedMatrix<T,R,C>& a,const FixedMatrix<T,R,C>& b) {
+      T d = T(0);
+      for (size_t i=0;i<R*C;++i) {
+        d = std::max(d,std::abs(a.data()[i]-b.data()[i]));
+      }
+      return d;
+    }
+
+    /// Compare all operations against the dynamic matrix
+    template<typename T,size_t N>
+    void fixedTest() {
+      typedef FixedMatrix<T,N,N> fixed_type;
+      const T eps = T(1000)*std::numeric_limits<T>::epsilon();
+
+      for (unsigned int seed=1;seed<5;++seed) {
+        const fixed_type a = randomFixed<T,N,N>(seed);
+        const fixed_type b = randomFixed<T,N,N>(seed+10);
+        const Matrix<T> da(a.view()), db(b.view());
+
+        Matrix<T> dsum = da+db, ddif = da-db, dprod = da*db;
+        BOOST_CHECK( maxDiff(a+b,fixed_type(dsum)) < eps );
+        BOOST_CHECK( maxDiff(a-b,fixed_type(ddif)) < eps );
+        BOOST_CHECK( maxDiff(a*b,fixed_type(dprod)) < eps );
+
+        fixed_type c(a);
+        c += b;
+        BOOST_CHECK( c == a+b );
+        c -= b;
+        BOOST_CHECK( maxDiff(c,a) < eps );
+
+        // determinant against the LU decomposition
+        LUDecomposition<T> dec(da);
+        const T det = determinant(a);
+        BOOST_CHECK( std::abs(det-dec.determinant()) <
+                     eps*std::max(T(1),std::abs(det)) );
+
+        // A*inv(A) = I
+        const fixed_type ai = inverse(a);
+        BOOST_CHECK( maxDiff(a*ai,fixed_type::identity()) < T(10)*eps );
+      }
+    }
+
+  } // test
+} // anpi
+
+BOOST_AUTO_TEST_SUITE( FixedMatrix )
+
+BOOST_AUTO_TEST_CASE(Construction) {
+  anpi::FixedMatrix<double,2,3> a = { {1,2,3}, {4,5,6} };
+  BOOST_CHECK( a.rows() == 2 );
+  BOOST_CHECK( a.cols() == 3 );
+  BOOST_CHECK( a(1,2) == 6 );
+  BOOST_CHECK( a[1][0] == 4 );
+
+  anpi::FixedMatrix<double,3,2> t = anpi::transpose(a);
+  BOOST_CHECK( t(2,1) == 6 );
+  BOOST_CHECK( t(0,1) == 4 );
+
+  // inline storage without padding
+  static_assert(sizeof(anpi::FixedMatrix<double,3,3>) == 9*sizeof(double),
+                "Fixed matrix must not be padded");
+  static_assert(alignof(anpi::FixedMatrix<float,4,4>) == 16,
+                "Fixed matrix must be aligned");
+
+  // round trip through a block of a dynamic matrix
+  anpi::Matrix<double> m(4,5,0.0);
+  m(1,2) = 7;
+  anpi::FixedMatrix<double,2,2> b(m.block(1,1,2,2));
+  BOOST_CHECK( b(0,1) == 7 );
+  b(1,1) = 3;
+  m.block(2,3,2,2).fill(b.view());
+  BOOST_CHECK( m(3,4) == 3 );
+
+  anpi::Matrix<double> d(a.view());
+  BOOST_CHECK( d.rows() == 2 && d.cols() == 3 && d(1,1) == 5 );
+
+  BOOST_CHECK_THROW( (anpi::FixedMatrix<double,3,3>(m)), anpi::Exception );
+}
+
+BOOST_AUTO_TEST_CASE(Operations) {
+  anpi::test::fixedTest<float,2>();
+  anpi::test::fixedTest<float,3>();
+  anpi::test::fixedTest<float,4>();
+  anpi::test::fixedTest<double,2>();
+  anpi::test::fixedTest<double,3>();
+  anpi::test::fixedTest<double,4>();
+  anpi::test::fixedTest<double,6>();
+}
+
+BOOST_AUTO_TEST_CASE(Singular) {
+  anpi::FixedMatrix<double,2,2> s2 = { {1,2}, {2,4} };
+  anpi::FixedMatrix<double,3,3> s3(1.0);
+  anpi::FixedMatrix<double,4,4> s4(0.0);
+  anpi::FixedMatrix<double,5,5> s5(2.0);
+  BOOST_CHECK( anpi::determinant(s2) == 0 );
+  BOOST_CHECK( anpi::determinant(s5) == 0 );
+  BOOST_CHECK_THROW( anpi::inverse(s2), anpi::Exception );
+  BOOST_CHECK_THROW( anpi::inverse(s3), anpi::Exception );
+  BOOST_CHECK_THROW( anpi::inverse(s4), anpi::Exception );
+  BOOST_CHECK_THROW( anpi::inverse(s5), anpi::Exception );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,208 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date  : 11.01.2018
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "IterativeSolvers.hpp"
+#include "testSimd.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace anpi {
+  namespace test {
+
+    /**
+     * 2D Poisson matrix on a k x k grid, symmetric positive definite,
+     * plus shift on the diagonal and asym on the upper neighbours, to
+     * make it nonsymmetric and more or less diagonally dominant.
+     */
+    template<typename T>
+    SparseMatrix<T> poisson2d(const size_t k,
+                              const T shift=T(0),
+                              const T asym=T(0)) {
+      std::vector< Triplet<T> > e;
+      for (size_t i=0;i<k;++i) {
+        for (size_t j=0;j<k;++j) {
+          const size_t r = i*k+j;
+          e.push_back(Triplet<T>(r,r,T(4)+shift));
+          if (i>0)   e.push_back(Triplet<T>(r,r-k,T(-1)));
+          if (i+1<k) e.push_back(Triplet<T>(r,r+k,T(-1)+asym));
+          if (j>0)   e.push_back(Triplet<T>(r,r-1,T(-1)));
+          if (j+1<k) e.push_back(Triplet<T>(r,r+1,T(-1)+asym));
+        }
+      }
+      return SparseMatrix<T>(k*k,k*k,e);
+    }
+
+    /// Relative residual |b-A*x|/|b|
+    template<class M,typename T>
+    T residual(const M& A,const std::vector<T>& b,const std::vector<T>& x) {
+      std::vector<T> r(b.size());
+      bits::apply(A,x,r);
+      T rr = T(0), bb = T(0);
+      for (size_t i=0;i<b.size();++i) {
+        rr += (b[i]-r[i])*(b[i]-r[i]);
+        bb += b[i]*b[i];
+      }
+      return std::sqrt(rr/bb);
+    }
+
+    typedef std::function<size_t(const SparseMatrix<double>&,
+                                 const std::vector<double>&,
+                                 std::vector<double>&)> sparse_solver;
+    typedef std::function<size_t(const Matrix<double>&,
+                                 const std::vector<double>&,
+                                 std::vector<double>&)> dense_solver;
+
+    /// Solve with the sparse and the dense version of the same matrix
+    void solverTest(const SparseMatrix<double>& S,
+                    const sparse_solver& sparse,
+                    const dense_solver& dense) {
+      const double eps = 1.0e-8;
+      Matrix<double> D;
+      S.toDense(D);
+
+      std::vector<double> b(S.rows());
+      for (size_t i=0;i<b.size();++i) {
+        b[i] = double(i%7) - 3.0;
+      }
+
+      std::vector<double> xs,xd;
+      const size_t its = sparse(S,b,xs);
+      const size_t itd = dense(D,b,xd);
+      BOOST_CHECK( its > 0 );
+      BOOST_CHECK( its == itd );
+      BOOST_CHECK( residual(S,b,xs) <= 2*eps );
+      BOOST_CHECK( residual(D,b,xd) <= 2*eps );
+
+      // starting at the solution takes no iterations
+      BOOST_CHECK( sparse(S,b,xs) == 0 );
+    }
+
+    void solversTest() {
+      using namespace std::placeholders;
+      const double eps = 1.0e-8;
+
+      const SparseMatrix<double> spd = poisson2d<double>(12);
+      const SparseMatrix<double> dom = poisson2d<double>(12,1.0,0.5);
+
+      solverTest(spd,
+                 std::bind(solveCG<SparseMatrix<double>,double>,
+                           _1,_2,_3,eps,1000),
+                 std::bind(solveCG<Matrix<double>,double>,
+                           _1,_2,_3,eps,1000));
+      solverTest(dom,
+                 std::bind(solveBiCGSTAB<SparseMatrix<double>,double>,
+                           _1,_2,_3,eps,1000),
+                 std::bind(solveBiCGSTAB<Matrix<double>,double>,
+                           _1,_2,_3,eps,1000));
+      solverTest(dom,
+                 std::bind(solveJacobi<SparseMatrix<double>,double>,
+                           _1,_2,_3,eps,10000),
+                 std::bind(solveJacobi<Matrix<double>,double>,
+                           _1,_2,_3,eps,10000));
+      solverTest(spd,
+                 std::bind(solveGaussSeidel<SparseMatrix<double>,double>,
+                           _1,_2,_3,eps,10000),
+                 std::bind(solveGaussSeidel<Matrix<double>,double>,
+                           _1,_2,_3,eps,10000));
+      solverTest(spd,
+                 std::bind(solveSOR<SparseMatrix<double>,double>,
+                           _1,_2,_3,1.6,eps,10000),
+                 std::bind(solveSOR<Matrix<double>,double>,
+                           _1,_2,_3,1.6,eps,10000));
+
+      // over-relaxation converges faster than Gauss-Seidel here
+      std::vector<double> b(spd.rows(),1.0),x1,x2;
+      const size_t gs  = solveGaussSeidel(spd,b,x1,eps);
+      const size_t sor = solveSOR(spd,b,x2,1.6,eps);
+      BOOST_CHECK( sor < gs );
+
+      // the stopping test is the residual of the returned x: with strong
+      // over-relaxation the residuals seen during the sweep are smaller
+      {
+        const Matrix<double> A = { { 19.0, 6.0 }, { 6.0, 3.0 } };
+        const std::vector<double> bs = { -3.0, -1.0 };
+        for (const double tol : { 1.0e-2, 1.0e-4, 1.0e-8 }) {
+          for (const double omega : { 1.0, 1.6, 1.9 }) {
+            std::vector<double> xo;
+            solveSOR(A,bs,xo,omega,tol);
+            BOOST_CHECK( residual(A,bs,xo) <= tol*(1.0+1.0e-12) );
+          }
+        }
+      }
+
+      // CG on the SPD matrix in float
+      {
+        const SparseMatrix<float> spdf = poisson2d<float>(8);
+        std::vector<float> bf(spdf.rows(),1.0f),xf;
+        solveCG(spdf,bf,xf,1.0e-5f);
+        BOOST_CHECK( residual(spdf,bf,xf) <= 2.0e-5f );
+      }
+
+      // too few iterations, or invalid arguments
+      std::vector<double> x;
+      BOOST_CHECK_THROW( solveCG(spd,b,x,eps,size_t(2)), anpi::Exception );
+      BOOST_CHECK_THROW( solveSOR(spd,b,x,2.5), anpi::Exception );
+      std::vector<double> bshort(3,1.0);
+      BOOST_CHECK_THROW( solveJacobi(spd,bshort,x), anpi::Exception );
+
+      // a rotation makes the first search direction orthogonal to rhat
+      const Matrix<double> rot = { { 0.0, 1.0 }, { -1.0, 0.0 } };
+      const std::vector<double> e1 = { 1.0, 0.0 };
+      std::vector<double> xr;
+      BOOST_CHECK_EXCEPTION( solveBiCGSTAB(rot,e1,xr), anpi::Exception,
+                             [](const anpi::Exception& e) {
+                               return std::string(e.what()) ==
+                                 "BiCGSTAB breakdown";
+                             } );
+    }
+
+    /// Compare the SIMD dot product with the scalar loop
+    template<typename T>
+    void dotTest() {
+      std::vector<T> a(131),b(131);
+      for (size_t i=0;i<a.size();++i) {
+        a[i] = T(i%11) - T(5);
+        b[i] = T(i%3) + T(1)/T(4);
+      }
+      // all lengths and misalignments around the register widths
+      for (size_t off=0;off<3;++off) {
+        for (size_t n=0;n+off<=a.size();n+=7) {
+          const T s = aimpl::dot(a.data()+off,b.data()+off,n);
+          const T f = fallback::dot(a.data()+off,b.data()+off,n);
+          BOOST_CHECK( std::abs(s-f) <= T(1.0e-4)*(T(1)+std::abs(f)) );
+        }
+      }
+    }
+  } // test
+} // anpi
+
+BOOST_AUTO_TEST_SUITE( IterativeSolvers )
+
+BOOST_AUTO_TEST_CASE(Solvers) {
+  anpi::test::solversTest();
+}
+
+BOOST_AUTO_TEST_CASE(Dispatch) {
+  // the dot and axpy kernels with every level supported by this CPU
+  anpi::test::forEachIsa([&] {
+    anpi::test::dotTest<float>();
+    anpi::test::dotTest<double>();
+    anpi::test::solversTest();
+  });
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,133 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date  : 05.01.2018
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "LUDecomposition.hpp"
+#include "testFactorization.hpp"
+#include "testSimd.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+namespace anpi {
+  namespace test {
+
+    /// Check that P*A = L*U
+    template<typename T,class Alloc>
+    void checkFactors(const Matrix<T,Alloc>& A,
+                      const Matrix<T,Alloc>& LU,
+                      const std::vector<size_t>& permut,
+                      const T eps) {
+      const size_t n = A.rows();
+      Matrix<T,Alloc> PA(n,n),L,U;
+      for (size_t r=0;r<n;++r) {
+        for (size_t c=0;c<n;++c) {
+          PA(r,c) = A(permut[r],c);
+        }
+      }
+      unpack(LU,L,U);
+      Matrix<T,Alloc> LxU = L*U;
+      BOOST_CHECK( maxDiff(PA,LxU) < eps );
+    }
+
+    template<typename T>
+    void luTest() {
+      typedef Matrix<T> matrix_type;
+      const T eps = T(2000)*std::numeric_limits<T>::epsilon();
+
+      // sizes smaller, equal and not multiple of the panel width
+      const size_t sizes[] = { 1, 5, 16, 33, 64, 100 };
+      for (size_t n : sizes) {
+        matrix_type A(n,n);
+        randomFill(A,unsigned(n));
+
+        matrix_type LUr,LUb;
+        std::vector<size_t> pr,pb;
+        luUnblocked(A,LUr,pr);
+        lu(A,LUb,pb,16);
+
+        checkFactors(A,LUr,pr,eps);
+        checkFactors(A,LUb,pb,eps);
+
+        // both algorithms choose the same pivots
+        BOOST_CHECK( pr == pb );
+        BOOST_CHECK( maxDiff(LUr,LUb) < eps );
+
+        // one right-hand side
+        std::vector<T> x(n),b(n,T(0)),xs;
+        for (size_t i=0;i<n;++i) {
+          x[i] = T(i%7) - T(3);
+        }
+        for (size_t r=0;r<n;++r) {
+          for (size_t c=0;c<n;++c) {
+            b[r] += A(r,c)*x[c];
+          }
+        }
+        solveLU(A,xs,b);
+        for (size_t i=0;i<n;++i) {
+          BOOST_CHECK( std::abs(xs[i]-x[i]) < T(10)*eps );
+        }
+
+        // many right-hand sides, reusing the factorization
+        LUDecomposition<T> dec(A,16);
+        matrix_type X(n,7),B,Xs;
+        randomFill(X,unsigned(3*n+1));
+        B = A*X;
+        dec.solve(B,Xs);
+        BOOST_CHECK( maxDiff(X,Xs) < T(10)*eps );
+
+        std::vector<T> xd;
+        dec.solve(b,xd);
+        for (size_t i=0;i<n;++i) {
+          BOOST_CHECK( std::abs(xd[i]-x[i]) < T(10)*eps );
+        }
+      }
+
+      // determinant, with one row exchange
+      {
+        matrix_type A = { {T(1),T(2)}, {T(3),T(4)} };
+        LUDecomposition<T> dec(A);
+        BOOST_CHECK( std::abs(dec.determinant()-T(-2)) < eps );
+        BOOST_CHECK( dec.permutation()[0] == 1 );
+      }
+
+      // singular and non-square matrices
+      {
+        matrix_type S = { {T(1),T(2)}, {T(2),T(4)} };
+        LUDecomposition<T> dec;
+        BOOST_CHECK_THROW( dec.factorize(S), anpi::Exception );
+
+        matrix_type R(2,3,T(1)),LU;
+        std::vector<size_t> p;
+        BOOST_CHECK_THROW( lu(R,LU,p), anpi::Exception );
+      }
+    }
+
+  } // test
+} // anpi
+
+BOOST_AUTO_TEST_SUITE( LU )
+
+BOOST_AUTO_TEST_CASE(Blocked) {
+  anpi::test::luTest<float>();
+  anpi::test::luTest<double>();
+}
+
+BOOST_AUTO_TEST_CASE(Dispatch) {
+  // the trailing update with every level supported by this CPU
+  anpi::test::forEachIsa([&] {
+    anpi::test::luTest<double>();
+  });
+}
+
+BOOST_AUTO_TEST_SUITE_END()
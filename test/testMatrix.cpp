@@ -7,11 +7,16 @@
 
 
 #include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
 
 #include <iostream>
 #include <exception>
 #include <cstdlib>
+#include <cmath>
 #include <complex>
+#include <fstream>
+#include <limits>
+#include <memory>
 
 /**
  * Unit tests for the matrix class
@@ -19,6 +24,9 @@
 
 #include "Matrix.hpp"
 #include "Allocator.hpp"
+#include "MatrixIO.hpp"
+#include "MappedAllocator.hpp"
+#include "testSimd.hpp"
 
 // Explicit instantiation of all methods of Matrix
 
@@ -270,10 +278,807 @@ void testArithmetic() {
     c=a-M{ {7,8,9},{10,11,12} };
     BOOST_CHECK( c==r );
   } 
+
+  {
+    M a = { {1,2,3},{ 4, 5, 6} };
+    M b = { {7,8},{9,10},{11,12} };
+    M r = { {58,64},{139,154} };
+
+    M c=a*b;
+    BOOST_CHECK( c==r );
+
+    anpi::fallback::multiply(a,b,c);
+    BOOST_CHECK( c==r );
+
+    anpi::simd::multiply(a,b,c);
+    BOOST_CHECK( c==r );
+
+    // the result may alias an operand
+    M d(a);
+    anpi::simd::multiply(d,b,d);
+    BOOST_CHECK( d==r );
+  }
 }
 
 BOOST_AUTO_TEST_CASE(Arithmetic) {
   dispatchTest(testArithmetic);  
 }
-  
+
+template<class M>
+void testExpressions() {
+  const M a = { {1,2,3},{ 4, 5, 6} };
+  const M b = { {7,8,9},{10,11,12} };
+  const M c = { {3,1,4},{ 1, 5, 9} };
+  const M d = { {2,7,1},{ 8, 2, 8} };
+
+  const M r = { {7,16,9},{21,13,17} }; // a+b-c+d
+
+  { // construction
+    M e = a + b - c + d;
+    BOOST_CHECK( e==r );
+  }
+  { // assignment
+    M e;
+    e = a + b - c + d;
+    BOOST_CHECK( e==r );
+    e = (a + b) - (c - d);
+    BOOST_CHECK( e==r );
+  }
+  { // aliasing with one of the leaves
+    M e(a);
+    e = e + b - c + d;
+    BOOST_CHECK( e==r );
+  }
+  { // compound assignment
+    M e(a);
+    e += b - c + d;
+    BOOST_CHECK( e==r );
+
+    M f = a + b + d;
+    f -= c + c - c;
+    BOOST_CHECK( f==r );
+  }
+  { // temporaries live until the end of the full expression
+    M e;
+    e = M{ {1,2,3},{ 4, 5, 6} } + b - c + d;
+    BOOST_CHECK( e==r );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Expressions) {
+  dispatchTest(testExpressions);
+}
+
+template<class M>
+void testParallel() {
+  typedef typename M::value_type T;
+
+  // odd sizes, so that the rows cannot be evenly split
+  M a(37,53,anpi::DoNotInitialize);
+  M b(37,53,anpi::DoNotInitialize);
+  for (size_t i=0;i<a.rows();++i) {
+    for (size_t j=0;j<a.cols();++j) {
+      a(i,j)=T((i*3+j)%11+1);
+      b(i,j)=T((i+j*5)%7+1);
+    }
+  }
+
+  // serial reference
+  const anpi::test::parallelGuard guard;
+  anpi::parallel::setThreads(1);
+  M rsum = a + b - a + b;
+  M rhad,rdiv,raxpy;
+  anpi::simd::hadamard(a,b,rhad);
+  anpi::simd::divide(a,b,rdiv);
+  anpi::simd::axpy(T(2),a,b,raxpy);
+
+  // force all kernels to be split among several threads
+  anpi::parallel::setThreshold(0);
+  anpi::parallel::setThreads(4);
+
+  M c = a + b - a + b;
+  BOOST_CHECK( c==rsum );
+  anpi::simd::hadamard(a,b,c);
+  BOOST_CHECK( c==rhad );
+  anpi::fallback::hadamard(a,b,c);
+  BOOST_CHECK( c==rhad );
+  anpi::simd::divide(a,b,c);
+  BOOST_CHECK( c==rdiv );
+  anpi::simd::axpy(T(2),a,b,c);
+  BOOST_CHECK( c==raxpy );
+}
+
+BOOST_AUTO_TEST_CASE(Parallel) {
+  BOOST_CHECK( anpi::parallel::threadsFor(0) == 1 );
+  dispatchTest(testParallel);
+}
+
+template<class M>
+void testElementwise() {
+  typedef typename M::value_type T;
+
+  const M a = { {1,2,3},{ 4, 5, 6} };
+  const M b = { {7,8,9},{10,11,12} };
+
+  { // Hadamard product
+    M r = { {7,16,27},{40,55,72} };
+    M c;
+    anpi::simd::hadamard(a,b,c);
+    BOOST_CHECK( c==r );
+    c=a;
+    anpi::simd::hadamard(c,b);
+    BOOST_CHECK( c==r );
+    anpi::fallback::hadamard(a,b,c);
+    BOOST_CHECK( c==r );
+  }
+
+  { // division
+    M n = { {2,6,12},{20,30,42} };
+    M r = { {2,3,4},{5,6,7} };
+    M d = { {1,2,3},{4,5,6} };
+    M c;
+    anpi::simd::divide(n,d,c);
+    BOOST_CHECK( c==r );
+    c=n;
+    anpi::simd::divide(c,d);
+    BOOST_CHECK( c==r );
+    anpi::fallback::divide(n,d,c);
+    BOOST_CHECK( c==r );
+  }
+
+  { // scaling
+    M r = { {3,6,9},{12,15,18} };
+    M c;
+    anpi::simd::scale(a,T(3),c);
+    BOOST_CHECK( c==r );
+    c=a;
+    anpi::simd::scale(c,T(3));
+    BOOST_CHECK( c==r );
+    anpi::fallback::scale(a,T(3),c);
+    BOOST_CHECK( c==r );
+  }
+
+  { // axpy
+    M r = { {9,12,15},{18,21,24} };
+    M z;
+    anpi::simd::axpy(T(2),a,b,z);
+    BOOST_CHECK( z==r );
+    z=b;
+    anpi::simd::axpy(T(2),a,z);
+    BOOST_CHECK( z==r );
+    anpi::fallback::axpy(T(2),a,b,z);
+    BOOST_CHECK( z==r );
+  }
+
+  { // fused multiply-add
+    M r = { {8,18,30},{44,60,78} };
+    M d;
+    anpi::simd::fma(a,b,a,d);
+    BOOST_CHECK( d==r );
+    d=a;
+    anpi::simd::fma(d,b,a);
+    BOOST_CHECK( d==r );
+    anpi::fallback::fma(a,b,a,d);
+    BOOST_CHECK( d==r );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Elementwise) {
+  dispatchTest(testElementwise);
+}
+
+/// Elementwise kernels on every SIMD type
+template<typename T>
+void testElementwiseType() {
+  typedef anpi::Matrix<T> M;
+
+  // odd sizes force row padding
+  M a(5,37,anpi::DoNotInitialize);
+  M b(5,37,anpi::DoNotInitialize);
+  for (size_t i=0;i<a.rows();++i) {
+    for (size_t j=0;j<a.cols();++j) {
+      a(i,j)=T((i+j)%7+1);
+      b(i,j)=T((2*i+j)%5+1);
+    }
+  }
+
+  M c,r;
+  anpi::simd::subtract(a,b,c);
+  anpi::fallback::subtract(a,b,r);
+  BOOST_CHECK( c==r );
+
+  anpi::simd::hadamard(a,b,c);
+  anpi::fallback::hadamard(a,b,r);
+  BOOST_CHECK( c==r );
+
+  anpi::simd::scale(a,T(3),c);
+  anpi::fallback::scale(a,T(3),r);
+  BOOST_CHECK( c==r );
+
+  anpi::simd::axpy(T(2),a,b,c);
+  anpi::fallback::axpy(T(2),a,b,r);
+  BOOST_CHECK( c==r );
+
+  anpi::simd::fma(a,b,a,c);
+  anpi::fallback::fma(a,b,a,r);
+  BOOST_CHECK( c==r );
+}
+
+BOOST_AUTO_TEST_CASE(ElementwiseTypes) {
+  testElementwiseType<double>();
+  testElementwiseType<float>();
+  testElementwiseType<std::int64_t>();
+  testElementwiseType<std::uint64_t>();
+  testElementwiseType<std::int32_t>();
+  testElementwiseType<std::uint32_t>();
+  testElementwiseType<std::int16_t>();
+  testElementwiseType<std::uint16_t>();
+  testElementwiseType<std::int8_t>();
+  testElementwiseType<std::uint8_t>();
+}
+
+template<class M>
+void testProduct() {
+  typedef typename M::value_type T;
+
+  // sizes chosen to exercise all border tiles and several kc panels
+  const size_t m=67, k=301, n=45;
+  M a(m,k,anpi::DoNotInitialize);
+  M b(k,n,anpi::DoNotInitialize);
+  for (size_t i=0;i<m;++i) {
+    for (size_t j=0;j<k;++j) {
+      a(i,j)=T((i*7+j*3)%11)-T(5);
+    }
+  }
+  for (size_t i=0;i<k;++i) {
+    for (size_t j=0;j<n;++j) {
+      b(i,j)=T((i*5+j)%13)-T(6);
+    }
+  }
+
+  M r;
+  anpi::fallback::multiply(a,b,r);
+  M c=a*b;
+
+  BOOST_CHECK( c.rows()==m );
+  BOOST_CHECK( c.cols()==n );
+
+  // all values are small integers, so the result must be exact
+  BOOST_CHECK( c==r );
+}
+
+BOOST_AUTO_TEST_CASE(Product) {
+  testProduct<dmatrix>();
+  testProduct<fmatrix>();
+  testProduct<admatrix>();
+  testProduct<afmatrix>();
+  testProduct<ardmatrix>();
+  testProduct<arfmatrix>();
+  testProduct<arimatrix>();
+}
+
+template<class M>
+void testViews() {
+  typedef typename M::value_type T;
+
+  M m(7,37,anpi::DoNotInitialize);
+  for (size_t i=0;i<m.rows();++i) {
+    for (size_t j=0;j<m.cols();++j) {
+      m(i,j)=T((i*3+j)%17+1);
+    }
+  }
+  const M& cm = m;
+
+  { // slicing
+    anpi::ConstMatrixView<T> b = cm.block(1,2,4,20);
+    BOOST_CHECK( (b.rows()==4) && (b.cols()==20) );
+    BOOST_CHECK( b.stride()==m.dcols() );
+    BOOST_CHECK( b(3,19)==m(4,21) );
+
+    anpi::ConstMatrixView<T> r = cm.rowRange(2,5);
+    BOOST_CHECK( (r.rows()==3) && (r.cols()==37) && (r(0,0)==m(2,0)) );
+
+    anpi::ConstMatrixView<T> c = cm.colRange(30,37);
+    BOOST_CHECK( (c.rows()==7) && (c.cols()==7) && (c(6,6)==m(6,36)) );
+
+    anpi::ConstMatrixView<T> col = cm.columnView(5);
+    BOOST_CHECK( (col.rows()==7) && (col.cols()==1) );
+    for (size_t i=0;i<m.rows();++i) {
+      BOOST_CHECK( col(i,0)==m(i,5) );
+    }
+
+    // nested slices refer to the same entries
+    BOOST_CHECK( b.block(1,1,2,2)(1,1)==m(3,4) );
+  }
+
+  { // copies and writes through views
+    M c(cm.block(1,2,4,20));
+    BOOST_CHECK( (c.rows()==4) && (c.cols()==20) && (c(3,19)==m(4,21)) );
+
+    M w(m);
+    w.block(2,3,2,5).fill(T(0));
+    BOOST_CHECK( (w(2,3)==T(0)) && (w(3,7)==T(0)) );
+    BOOST_CHECK( (w(2,2)==m(2,2)) && (w(3,8)==m(3,8)) );
+
+    w.columnView(1).fill(cm.columnView(0));
+    BOOST_CHECK( (w(6,1)==m(6,0)) && (w(6,2)==m(6,2)) );
+  }
+
+  { // elementwise kernels on unaligned blocks
+    anpi::ConstMatrixView<T> a = cm.block(0,1,5,33);
+    anpi::ConstMatrixView<T> b = cm.block(2,3,5,33);
+
+    // the result is written into a block of a larger matrix
+    M d(7,37,T(0));
+    anpi::MatrixView<T> c = d.block(1,3,5,33);
+
+    anpi::simd::add(a,b,c);
+    BOOST_CHECK( (c(0,0)==a(0,0)+b(0,0)) && (c(4,32)==a(4,32)+b(4,32)) );
+    BOOST_CHECK( (d(0,3)==T(0)) && (d(1,2)==T(0)) && (d(6,36)==T(0)) );
+
+    M r(5,33,anpi::DoNotInitialize);
+    anpi::fallback::fma(a,b,a,r.view());
+    anpi::simd::fma(a,b,a,c);
+    BOOST_CHECK( M(c)==r );
+
+    anpi::fallback::axpy(T(2),a,b,r.view());
+    anpi::simd::axpy(T(2),a,b,c);
+    BOOST_CHECK( M(c)==r );
+
+    anpi::fallback::hadamard(r.view(),b);
+    anpi::simd::hadamard(c,b);
+    BOOST_CHECK( M(c)==r );
+
+    anpi::fallback::divide(r.view(),b);
+    anpi::simd::divide(c,b);
+    BOOST_CHECK( M(c)==r );
+
+    anpi::fallback::scale(a,T(3),r.view());
+    anpi::simd::scale(a,T(3),c);
+    BOOST_CHECK( M(c)==r );
+
+    anpi::fallback::subtract(a,b,r.view());
+    anpi::simd::subtract(a,b,c);
+    BOOST_CHECK( M(c)==r );
+  }
+
+  { // product of blocks
+    M a(37,41,anpi::DoNotInitialize);
+    for (size_t i=0;i<a.rows();++i) {
+      for (size_t j=0;j<a.cols();++j) {
+        a(i,j)=T((i*7+j*3)%11)-T(5);
+      }
+    }
+    const M& ca = a;
+
+    M d(20,20,T(0));
+    anpi::MatrixView<T> c = d.block(2,1,17,13);
+    anpi::simd::multiply(ca.block(1,2,17,29),ca.block(3,5,29,13),c);
+
+    M r;
+    anpi::fallback::multiply(M(ca.block(1,2,17,29)),
+                             M(ca.block(3,5,29,13)),
+                             r);
+    BOOST_CHECK( M(c)==r );
+    BOOST_CHECK( (d(1,1)==T(0)) && (d(2,0)==T(0)) && (d(19,14)==T(0)) );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Views) {
+  dispatchTest(testViews);
+}
+
+template<class M>
+void testSerialization() {
+  typedef typename M::value_type T;
+  namespace fs = boost::filesystem;
+  const std::string path =
+    (fs::temp_directory_path() / fs::unique_path("anpi-%%%%-%%%%.mat")).string();
+
+  M a(5,37,anpi::DoNotInitialize);
+  for (size_t i=0;i<a.rows();++i) {
+    for (size_t j=0;j<a.cols();++j) {
+      a(i,j)=T((i*37+j)%101);
+    }
+  }
+
+  { // round trip
+    anpi::save(path,a);
+    M b;
+    anpi::load(path,b);
+    BOOST_CHECK( (b.rows()==a.rows()) && (b.cols()==a.cols()) );
+    BOOST_CHECK( b==a );
+
+    // loading over a matrix of another size reallocates it
+    M c(2,2,T(1));
+    anpi::load(path,c);
+    BOOST_CHECK( c==a );
+  }
+
+  { // the header describes the stored layout
+    const anpi::matrix_file_header h = anpi::readMatrixFileHeader(path);
+    BOOST_CHECK( (h.rows==a.rows()) && (h.cols==a.cols()) );
+    BOOST_CHECK( h.dcols==a.dcols() );
+    BOOST_CHECK( h.typeSize==sizeof(T) );
+    BOOST_CHECK( h.offset % h.alignment == 0 );
+    BOOST_CHECK( fs::file_size(path) == h.offset + h.rows*h.dcols*sizeof(T) );
+  }
+
+  { // files with another row padding are converted
+    anpi::Matrix<T,anpi::aligned_row_allocator<T,64> > r;
+    anpi::load(path,r);
+    BOOST_CHECK( (r.rows()==a.rows()) && (r.cols()==a.cols()) );
+    BOOST_CHECK( r(4,36)==a(4,36) && r(1,0)==a(1,0) );
+
+    anpi::save(path,r);
+    M b;
+    anpi::load(path,b);
+    BOOST_CHECK( b==a );
+
+    // and files of row-aligned matrices can be mapped without copy
+    const anpi::Matrix<T,anpi::mapped_allocator<T,64> > m =
+      anpi::openMappedReadOnly<T,64>(path);
+    BOOST_CHECK( m(4,36)==a(4,36) && m(3,17)==a(3,17) );
+  }
+
+  { // a row stride other than the allocator's is rejected by the mapping
+    anpi::matrix_file_header h = anpi::readMatrixFileHeader(path);
+    h.dcols = h.cols;
+    std::fstream f(path,std::ios::in | std::ios::out | std::ios::binary);
+    f.write(reinterpret_cast<const char*>(&h),sizeof(h));
+    f.close();
+    BOOST_CHECK_THROW( (anpi::openMappedReadOnly<T,64>(path)),
+                       anpi::Exception );
+  }
+
+  { // empty matrices
+    M e;
+    anpi::save(path,e);
+    M b(2,2,T(1));
+    anpi::load(path,b);
+    BOOST_CHECK( b.empty() );
+  }
+
+  { // headers inconsistent with the file are rejected before allocating
+    anpi::save(path,a);
+    const anpi::matrix_file_header good = anpi::readMatrixFileHeader(path);
+    const auto rewrite = [&path](const anpi::matrix_file_header& h) {
+      std::fstream f(path,std::ios::in | std::ios::out | std::ios::binary);
+      f.write(reinterpret_cast<const char*>(&h),sizeof(h));
+    };
+
+    anpi::matrix_file_header h = good;
+    h.dcols = h.cols-1;
+    rewrite(h);
+    M b;
+    BOOST_CHECK_THROW( anpi::load(path,b), anpi::Exception );
+
+    h = good;
+    h.rows = std::numeric_limits<std::uint64_t>::max()/2;
+    rewrite(h);
+    BOOST_CHECK_THROW( anpi::load(path,b), anpi::Exception );
+
+    h = good;
+    h.offset = 0;
+    rewrite(h);
+    BOOST_CHECK_THROW( anpi::load(path,b), anpi::Exception );
+
+    rewrite(good);
+    fs::resize_file(path,fs::file_size(path)-1);
+    BOOST_CHECK_THROW( anpi::load(path,b), anpi::Exception );
+    BOOST_CHECK_THROW( anpi::readMatrixFileHeader(path), anpi::Exception );
+  }
+
+  // wrong element type
+  anpi::save(path,a);
+  anpi::Matrix<std::int16_t> other;
+  BOOST_CHECK_THROW( anpi::load(path,other), anpi::Exception );
+
+  fs::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(Serialization) {
+  dispatchTest(testSerialization);
+}
+
+BOOST_AUTO_TEST_CASE(Dispatch) {
+  using anpi::simd::Isa;
+
+  Isa parsed = Isa::None;
+  BOOST_CHECK( anpi::simd::parseIsa("avx2",parsed) && (parsed==Isa::AVX2) );
+  BOOST_CHECK( !anpi::simd::parseIsa("mmx",parsed) && (parsed==Isa::AVX2) );
+
+  const Isa detected = anpi::simd::detectIsa();
+  const anpi::test::isaGuard guard;
+  const Isa previous = guard.previous();
+  BOOST_CHECK( previous <= detected );
+
+  // registers are never wider than the alignment of aligned allocators,
+  // while the unaligned ones use partial registers at the buffer ends
+  typedef anpi::aligned_row_allocator<float,16> alloc16;
+  typedef anpi::aligned_row_allocator<float,32> alloc32;
+  BOOST_CHECK( anpi::simd::isaFor<alloc>()   == previous );
+  BOOST_CHECK( anpi::simd::isaFor<alloc16>() <= Isa::SSE2 );
+  BOOST_CHECK( anpi::simd::isaFor<alloc32>() <= Isa::AVX2 );
+
+  // levels beyond the CPU are not selected
+  anpi::simd::setIsa(Isa::AVX512);
+  BOOST_CHECK( anpi::simd::isa() == detected );
+
+  // run the kernels with every level supported by this CPU
+  anpi::test::forEachIsa([&] {
+    dispatchTest(testArithmetic);
+    dispatchTest(testExpressions);
+    dispatchTest(testElementwise);
+    testElementwise< anpi::Matrix<float,alloc16> >();
+    testElementwise< anpi::Matrix<float,alloc32> >();
+
+    testElementwiseType<double>();
+    testElementwiseType<float>();
+    testElementwiseType<std::int64_t>();
+    testElementwiseType<std::int32_t>();
+    testElementwiseType<std::int16_t>();
+    testElementwiseType<std::uint8_t>();
+
+    testProduct<ardmatrix>();
+    testProduct<arfmatrix>();
+    testProduct< anpi::Matrix<float,alloc16> >();
+
+    dispatchTest(testViews);
+  });
+}
+
+/// Allocator whose buffers start one entry after an aligned address
+template<typename T>
+struct shifted_allocator {
+  typedef T value_type;
+
+  shifted_allocator() {}
+  template<typename U>
+  shifted_allocator(const shifted_allocator<U>&) {}
+
+  T* allocate(const size_t n) {
+    return static_cast<T*>(::operator new((n+1)*sizeof(T))) + 1;
+  }
+  void deallocate(T* p,const size_t) {
+    ::operator delete(p-1);
+  }
+  template<typename U>
+  bool operator==(const shifted_allocator<U>&) const { return true; }
+  template<typename U>
+  bool operator!=(const shifted_allocator<U>&) const { return false; }
+};
+
+/// Elementwise kernels on unpadded buffers of every length up to 70
+template<typename T,class Alloc>
+void testUnpadded() {
+  typedef anpi::Matrix<T,Alloc> M;
+
+  for (size_t cols=1;cols<=70;++cols) {
+    M a(3,cols,anpi::DoNotInitialize);
+    M b(3,cols,anpi::DoNotInitialize);
+    for (size_t i=0;i<a.rows();++i) {
+      for (size_t j=0;j<a.cols();++j) {
+        a(i,j)=T((i+j)%7+1);
+        b(i,j)=T((2*i+j)%5+1);
+      }
+    }
+    BOOST_REQUIRE( a.dcols() == cols );
+
+    M c;
+    bool ok=true;
+    anpi::simd::add(a,b,c);
+    for (size_t i=0;i<a.rows();++i) {
+      for (size_t j=0;j<a.cols();++j) {
+        ok = ok && (c(i,j) == T(a(i,j)+b(i,j)));
+      }
+    }
+    anpi::simd::scale(a,T(3),c);
+    for (size_t i=0;i<a.rows();++i) {
+      for (size_t j=0;j<a.cols();++j) {
+        ok = ok && (c(i,j) == T(T(3)*a(i,j)));
+      }
+    }
+    anpi::simd::fma(a,b,a,c);
+    for (size_t i=0;i<a.rows();++i) {
+      for (size_t j=0;j<a.cols();++j) {
+        ok = ok && (c(i,j) == T(a(i,j)*b(i,j)+a(i,j)));
+      }
+    }
+    c = a + b - b + a;
+    for (size_t i=0;i<a.rows();++i) {
+      for (size_t j=0;j<a.cols();++j) {
+        ok = ok && (c(i,j) == T(a(i,j)+a(i,j)));
+      }
+    }
+    c = a;
+    c += b;
+    for (size_t i=0;i<a.rows();++i) {
+      for (size_t j=0;j<a.cols();++j) {
+        ok = ok && (c(i,j) == T(a(i,j)+b(i,j)));
+      }
+    }
+    BOOST_CHECK_MESSAGE( ok, "wrong entries with " << cols << " columns" );
+  }
+}
+
+template<class Alloc>
+void testUnpaddedTypes() {
+  typedef std::allocator_traits<Alloc> traits;
+  typedef typename traits::template rebind_alloc<double>       dalloc;
+  typedef typename traits::template rebind_alloc<float>        falloc;
+  typedef typename traits::template rebind_alloc<std::int64_t> i64alloc;
+  typedef typename traits::template rebind_alloc<std::int32_t> i32alloc;
+  typedef typename traits::template rebind_alloc<std::int16_t> i16alloc;
+  typedef typename traits::template rebind_alloc<std::uint8_t> u8alloc;
+
+  testUnpadded<double,dalloc>();
+  testUnpadded<float,falloc>();
+  testUnpadded<std::int64_t,i64alloc>();
+  testUnpadded<std::int32_t,i32alloc>();
+  testUnpadded<std::int16_t,i16alloc>();
+  testUnpadded<std::uint8_t,u8alloc>();
+}
+
+BOOST_AUTO_TEST_CASE(Unpadded) {
+  anpi::test::forEachIsa([&] {
+    testUnpaddedTypes< std::allocator<float> >();
+    testUnpaddedTypes< shifted_allocator<float> >();
+  });
+
+  // split among threads, with chunks starting at any address
+  const anpi::test::parallelGuard guard;
+  anpi::parallel::setThreshold(0);
+  anpi::parallel::setThreads(4);
+  testUnpaddedTypes< shifted_allocator<float> >();
+}
+
+template<typename R,class Alloc>
+void testComplex() {
+  typedef std::complex<R> C;
+  typedef typename std::allocator_traits<Alloc>::template rebind_alloc<C> calloc;
+  typedef typename std::allocator_traits<Alloc>::template rebind_alloc<R> ralloc;
+  typedef anpi::Matrix<C,calloc> M;
+
+  const R eps = R(8)*std::numeric_limits<R>::epsilon();
+
+  for (size_t cols=1;cols<=40;++cols) {
+    M a(3,cols,anpi::DoNotInitialize);
+    M b(3,cols,anpi::DoNotInitialize);
+    for (size_t i=0;i<a.rows();++i) {
+      for (size_t j=0;j<a.cols();++j) {
+        a(i,j)=C(R((i+j)%7)-R(2.5),R((3*i+j)%5)-R(1.25));
+        b(i,j)=C(R((2*i+j)%5)*R(0.75)-R(1),R((i+2*j)%9)-R(4));
+      }
+    }
+
+    M c;
+    anpi::Matrix<R,ralloc> m;
+    bool ok=true;
+    anpi::simd::add(a,b,c);
+    for (size_t i=0;i<a.rows();++i) {
+      for (size_t j=0;j<a.cols();++j) {
+        ok = ok && (c(i,j) == a(i,j)+b(i,j));
+      }
+    }
+    anpi::simd::subtract(a,b,c);
+    for (size_t i=0;i<a.rows();++i) {
+      for (size_t j=0;j<a.cols();++j) {
+        ok = ok && (c(i,j) == a(i,j)-b(i,j));
+      }
+    }
+    anpi::simd::hadamard(a,b,c);
+    for (size_t i=0;i<a.rows();++i) {
+      for (size_t j=0;j<a.cols();++j) {
+        const C p = a(i,j)*b(i,j);
+        ok = ok && (std::abs(c(i,j)-p) <= eps*(std::abs(p)+R(1)));
+      }
+    }
+    c = a + b - a;
+    for (size_t i=0;i<a.rows();++i) {
+      for (size_t j=0;j<a.cols();++j) {
+        ok = ok && (c(i,j) == (a(i,j)+b(i,j))-a(i,j));
+      }
+    }
+    anpi::simd::conjugate(a,c);
+    for (size_t i=0;i<a.rows();++i) {
+      for (size_t j=0;j<a.cols();++j) {
+        ok = ok && (c(i,j) == std::conj(a(i,j))) &&
+          (std::signbit(c(i,j).imag()) != std::signbit(a(i,j).imag()));
+      }
+    }
+    anpi::simd::magnitude(a,m);
+    ok = ok && (m.rows() == a.rows()) && (m.cols() == a.cols());
+    for (size_t i=0;i<a.rows();++i) {
+      for (size_t j=0;j<a.cols();++j) {
+        ok = ok && (std::abs(m(i,j)-std::abs(a(i,j))) <= eps*m(i,j));
+      }
+    }
+    BOOST_CHECK_MESSAGE( ok, "wrong complex entries with " << cols
+                         << " columns" );
+  }
+
+  // parts whose squares overflow or underflow, between ordinary entries
+  typedef std::numeric_limits<R> lim;
+  const R huge = std::ldexp(R(1),lim::max_exponent-4);
+  const R tiny = std::ldexp(R(1),lim::min_exponent+4);
+  const R sub  = lim::denorm_min();
+  const C special[] = { C(R(3)*huge,R(4)*huge), C(-huge,R(0)),
+                        C(R(3)*tiny,R(-4)*tiny), C(R(0),tiny),
+                        C(R(3)*sub,R(4)*sub), C(sub,R(0)),
+                        C(R(0),R(0)), C(lim::infinity(),lim::quiet_NaN()),
+                        C(lim::quiet_NaN(),R(1)) };
+  for (size_t cols=1;cols<=40;++cols) {
+    M a(3,cols,anpi::DoNotInitialize);
+    for (size_t i=0;i<a.rows();++i) {
+      for (size_t j=0;j<a.cols();++j) {
+        a(i,j)=C(R((i+j)%7)-R(2.5),R((3*i+j)%5)-R(1.25));
+      }
+    }
+    for (size_t s=0;s<sizeof(special)/sizeof(C);++s) {
+      a((s/3)%a.rows(),(5*s)%cols) = special[s];
+    }
+
+    anpi::Matrix<R,ralloc> m;
+    anpi::simd::magnitude(a,m);
+    bool ok=true;
+    for (size_t i=0;i<a.rows();++i) {
+      for (size_t j=0;j<a.cols();++j) {
+        const R ref = std::abs(a(i,j));
+        ok = ok && ((std::isnan(ref) && std::isnan(m(i,j))) ||
+                    (m(i,j) == ref) ||
+                    (std::abs(m(i,j)-ref) <= eps*ref));
+      }
+    }
+    BOOST_CHECK_MESSAGE( ok, "wrong magnitudes of extreme entries with "
+                         << cols << " columns" );
+  }
+}
+
+template<class Alloc>
+void testComplexTypes() {
+  testComplex<double,Alloc>();
+  testComplex<float,Alloc>();
+}
+
+BOOST_AUTO_TEST_CASE(Complex) {
+  anpi::test::forEachIsa([&] {
+    testComplexTypes< std::allocator<float> >();
+    testComplexTypes< shifted_allocator<float> >();
+    testComplexTypes< anpi::aligned_row_allocator<float> >();
+  });
+
+  const anpi::test::parallelGuard guard;
+  anpi::parallel::setThreshold(0);
+  anpi::parallel::setThreads(4);
+  testComplexTypes< shifted_allocator<float> >();
+  testComplexTypes< anpi::aligned_row_allocator<float> >();
+}
+
+BOOST_AUTO_TEST_CASE(Streaming) {
+  BOOST_CHECK( anpi::simd::detectCacheSize() > 0 );
+
+  const anpi::test::streamingGuard guard;
+  anpi::simd::setStreamingThreshold(1024);
+  BOOST_CHECK( !anpi::simd::streaming(1023) );
+  BOOST_CHECK( anpi::simd::streaming(1024) );
+  anpi::simd::setStreamingThreshold(anpi::simd::NoStreaming);
+  BOOST_CHECK( !anpi::simd::streaming(size_t(1) << 40) );
+
+  // force the non-temporal stores on all on-copy kernels
+  anpi::simd::setStreamingThreshold(0);
+
+  anpi::test::forEachIsa([&] {
+    dispatchTest(testArithmetic);
+    dispatchTest(testExpressions);
+    dispatchTest(testElementwise);
+    dispatchTest(testParallel);
+
+    testElementwiseType<double>();
+    testElementwiseType<float>();
+    testElementwiseType<std::int32_t>();
+    testElementwiseType<std::uint8_t>();
+  });
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,111 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date  : 07.01.2018
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "QRDecomposition.hpp"
+#include "testFactorization.hpp"
+#include "testSimd.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+namespace anpi {
+  namespace test {
+
+    template<typename T>
+    void qrTest() {
+      typedef Matrix<T> matrix_type;
+      const T eps = T(2000)*std::numeric_limits<T>::epsilon();
+
+      // square and tall matrices, with panels of 8 columns
+      const size_t shapes[][2] = { {1,1}, {5,5}, {16,16}, {40,33},
+                                   {64,64}, {120,100}, {77,8} };
+      for (const auto& shape : shapes) {
+        const size_t m = shape[0];
+        const size_t n = shape[1];
+        matrix_type A(m,n);
+        randomFill(A,unsigned(m+n));
+
+        matrix_type QRr,QRb,Q,R;
+        std::vector<T> taur,taub;
+        qrUnblocked(A,QRr,taur);
+        qr(A,QRb,taub,8);
+
+        BOOST_CHECK( maxDiff(QRr,QRb) < eps );
+
+        unpackQ(QRb,taub,Q);
+        unpackR(QRb,R);
+
+        // residual Q*R - A
+        matrix_type QxR = Q*R;
+        BOOST_CHECK( maxDiff(QxR,A) < eps );
+
+        // orthonormal columns: Q^T*Q = I
+        matrix_type Qt(n,m);
+        Qt.view().fillTransposed(Q.view());
+        matrix_type QtQ = Qt*Q;
+        matrix_type I(n,n,T(0));
+        for (size_t i=0;i<n;++i) {
+          I(i,i) = T(1);
+        }
+        BOOST_CHECK( maxDiff(QtQ,I) < eps );
+
+        // least squares of a consistent system recovers the solution
+        std::vector<T> x(n),b(m,T(0)),xs;
+        for (size_t i=0;i<n;++i) {
+          x[i] = T(i%5) - T(2);
+        }
+        for (size_t r=0;r<m;++r) {
+          for (size_t c=0;c<n;++c) {
+            b[r] += A(r,c)*x[c];
+          }
+        }
+        solveQR(A,xs,b);
+        BOOST_CHECK( xs.size() == n );
+        for (size_t i=0;i<n;++i) {
+          BOOST_CHECK( std::abs(xs[i]-x[i]) < T(100)*eps );
+        }
+      }
+
+      // least squares residual is orthogonal to the columns of A
+      {
+        matrix_type A = { {T(1),T(0)}, {T(1),T(1)}, {T(1),T(2)} };
+        std::vector<T> b = { T(1), T(2), T(4) },x;
+        solveQR(A,x,b);
+        BOOST_CHECK( std::abs(x[0]-T(5)/T(6)) < eps );
+        BOOST_CHECK( std::abs(x[1]-T(3)/T(2)) < eps );
+
+        matrix_type W(2,3),QR;
+        std::vector<T> tau;
+        BOOST_CHECK_THROW( qr(W,QR,tau), anpi::Exception );
+      }
+    }
+
+  } // test
+} // anpi
+
+BOOST_AUTO_TEST_SUITE( QR )
+
+BOOST_AUTO_TEST_CASE(Blocked) {
+  anpi::test::qrTest<float>();
+  anpi::test::qrTest<double>();
+}
+
+BOOST_AUTO_TEST_CASE(Dispatch) {
+  // the block reflectors with every level supported by this CPU
+  anpi::test::forEachIsa([&] {
+    anpi::test::qrTest<double>();
+  });
+}
+
+BOOST_AUTO_TEST_SUITE_END()
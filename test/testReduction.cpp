@@ -0,0 +1,184 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date  : 15.01.2018
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "MatrixReduction.hpp"
+#include "testFactorization.hpp"
+#include "testSimd.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace anpi {
+  namespace test {
+
+    template<typename T>
+    void reductionTest() {
+      typedef Matrix<T> matrix_type;
+      const T eps = T(100)*std::numeric_limits<T>::epsilon();
+      const Summation modes[] = { Summation::Plain,
+                                  Summation::Pairwise,
+                                  Summation::Kahan };
+
+      // padded rows, and matrices without padding longer than a segment
+      const size_t shapes[][2] = { {1,1}, {3,5}, {7,33}, {64,64},
+                                   {1,10000}, {130,67} };
+      for (const auto& shape : shapes) {
+        matrix_type a(shape[0],shape[1]),b(shape[0],shape[1]);
+        randomFill(a,unsigned(shape[0]+shape[1]));
+        randomFill(b,unsigned(shape[1]));
+
+        // garbage in the padding must be skipped
+        for (size_t r=0;r<a.rows();++r) {
+          for (size_t c=a.cols();c<a.dcols();++c) {
+            a[r][c] = b[r][c] = T(1000);
+          }
+        }
+
+        long double rs=0, ra=0, rd=0;
+        T rmax = a(0,0), rmin = a(0,0);
+        std::pair<size_t,size_t> pmax(0,0), pmin(0,0);
+        for (size_t r=0;r<a.rows();++r) {
+          for (size_t c=0;c<a.cols();++c) {
+            rs += a(r,c);
+            ra += std::abs(a(r,c));
+            rd += (long double)(a(r,c))*b(r,c);
+            if (a(r,c) > rmax) { rmax = a(r,c); pmax = std::make_pair(r,c); }
+            if (a(r,c) < rmin) { rmin = a(r,c); pmin = std::make_pair(r,c); }
+          }
+        }
+        const T scale = T(a.entries());
+
+        for (Summation mode : modes) {
+          BOOST_CHECK( std::abs(sum(a,mode)-T(rs)) < eps*scale );
+          BOOST_CHECK( std::abs(sumAbs(a,mode)-T(ra)) < eps*scale );
+          BOOST_CHECK( std::abs(dot(a,b,mode)-T(rd)) < eps*scale );
+        }
+        BOOST_CHECK( max(a) == rmax );
+        BOOST_CHECK( min(a) == rmin );
+        BOOST_CHECK( maxAbs(a) == std::max(std::abs(rmax),std::abs(rmin)) );
+        BOOST_CHECK( argmax(a) == pmax );
+        BOOST_CHECK( argmin(a) == pmin );
+      }
+
+      // NaN is ignored by the extrema
+      {
+        const T nan = std::numeric_limits<T>::quiet_NaN();
+        matrix_type a(3,21,T(1));
+        a(0,0) = nan;
+        a(1,7) = T(-4);
+        a(2,20) = T(3);
+        a(2,5) = nan;
+        BOOST_CHECK( max(a) == T(3) );
+        BOOST_CHECK( min(a) == T(-4) );
+        BOOST_CHECK( maxAbs(a) == T(4) );
+        BOOST_CHECK( argmax(a) == std::make_pair(size_t(2),size_t(20)) );
+        BOOST_CHECK( argmin(a) == std::make_pair(size_t(1),size_t(7)) );
+        BOOST_CHECK( std::isnan(sum(a)) );
+
+        // a whole row of NaN before the extrema
+        matrix_type b(3,21,nan);
+        b(1,4) = T(-2);
+        b(2,9) = T(6);
+        BOOST_CHECK( argmax(b) == std::make_pair(size_t(2),size_t(9)) );
+        BOOST_CHECK( argmin(b) == std::make_pair(size_t(1),size_t(4)) );
+      }
+
+      // all NaN, with and without padding
+      {
+        const T nan = std::numeric_limits<T>::quiet_NaN();
+        const std::pair<size_t,size_t> origin(0,0);
+        matrix_type a(2,3,nan);
+        BOOST_CHECK( argmax(a) == origin );
+        BOOST_CHECK( argmin(a) == origin );
+
+        Matrix<T,std::allocator<T> > b(2,3,nan);
+        BOOST_CHECK( argmax(b) == origin );
+        BOOST_CHECK( argmin(b) == origin );
+
+        Matrix<T,std::allocator<T> > c(1,10000,nan);
+        BOOST_CHECK( argmax(c) == origin );
+        BOOST_CHECK( argmin(c) == origin );
+        c(0,9999) = T(1);
+        BOOST_CHECK( argmax(c) == std::make_pair(size_t(0),size_t(9999)) );
+        BOOST_CHECK( argmin(c) == std::make_pair(size_t(0),size_t(9999)) );
+      }
+    }
+
+  } // test
+} // anpi
+
+BOOST_AUTO_TEST_SUITE( Reduction )
+
+BOOST_AUTO_TEST_CASE(FloatingPoint) {
+  anpi::test::forEachIsa([&] {
+    anpi::test::reductionTest<float>();
+    anpi::test::reductionTest<double>();
+  });
+}
+
+BOOST_AUTO_TEST_CASE(Compensated) {
+  // 2^22 copies of 0.1f: a single float accumulator drifts far away,
+  // the Kahan sum stays within a few ulp and the pairwise one close
+  const size_t n = size_t(1) << 22;
+  anpi::Matrix<float> a(1,n,0.1f);
+  const double exact = double(0.1f)*double(n);
+
+  anpi::test::forEachIsa([&] {
+    const double kahan = anpi::sum(a,anpi::Summation::Kahan);
+    const double pairwise = anpi::sum(a,anpi::Summation::Pairwise);
+    BOOST_CHECK( std::abs(kahan-exact) <= 4*exact*1.2e-7 );
+    BOOST_CHECK( std::abs(pairwise-exact) <= 64*exact*1.2e-7 );
+  });
+
+  // a scalar plain sum of all entries in one accumulator
+  float naive = 0.0f;
+  for (size_t i=0;i<n;++i) {
+    naive += a(0,i);
+  }
+  BOOST_CHECK( std::abs(naive-exact) > 100*exact*1.2e-7 );
+}
+
+BOOST_AUTO_TEST_CASE(Parallel) {
+  const anpi::test::parallelGuard guard;
+  anpi::parallel::setThreshold(1);
+
+  anpi::Matrix<double> a(200,301);
+  anpi::test::randomFill(a,3u);
+  a(123,45) = 5.0;
+  const double serial = anpi::sum(a,anpi::Summation::Plain,false);
+  BOOST_CHECK( anpi::sum(a) == serial );
+  BOOST_CHECK( anpi::max(a) == 5.0 );
+  BOOST_CHECK( anpi::argmax(a) == std::make_pair(size_t(123),size_t(45)) );
+}
+
+BOOST_AUTO_TEST_CASE(Integer) {
+  anpi::Matrix<std::int32_t> a(5,13,2);
+  a(4,12) = -7;
+  a(0,3) = 9;
+  BOOST_CHECK( anpi::sum(a) == 2*63-7+9 );
+  BOOST_CHECK( anpi::sumAbs(a) == 2*63+7+9 );
+  BOOST_CHECK( anpi::dot(a,a) == 4*63+49+81 );
+  BOOST_CHECK( anpi::max(a) == 9 );
+  BOOST_CHECK( anpi::min(a) == -7 );
+  BOOST_CHECK( anpi::maxAbs(a) == 9 );
+  BOOST_CHECK( anpi::argmin(a) == std::make_pair(size_t(4),size_t(12)) );
+
+  anpi::Matrix<std::int32_t> e;
+  BOOST_CHECK( anpi::sum(e) == 0 );
+  BOOST_CHECK_THROW( anpi::argmax(e), anpi::Exception );
+  BOOST_CHECK_THROW( anpi::dot(a,e), anpi::Exception );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
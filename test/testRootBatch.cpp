@@ -0,0 +1,171 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date  : 10.02.2018
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "RootBatch.hpp"
+#include "testSimd.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace anpi {
+  namespace test {
+
+    /// Equations x³ + x - p[i] = 0, with a single real root each
+    template<typename T>
+    struct cubics {
+      const std::vector<T>& p;
+      explicit cubics(const std::vector<T>& params) : p(params) {}
+
+      void operator()(const T* x,T* fx,
+                      const size_t first,const size_t count) const {
+        for (size_t k=0;k<count;++k) {
+          fx[k] = x[k]*x[k]*x[k] + x[k] - p[first+k];
+        }
+      }
+    };
+
+    /// Root of x³ + x - p by bisection in long double
+    template<typename T>
+    T cubicRoot(const T p) {
+      long double a = -4.0L, b = 4.0L;
+      for (int i=0;i<200;++i) {
+        const long double m = (a+b)/2.0L;
+        if (m*m*m + m - p < 0.0L) {
+          a = m;
+        } else {
+          b = m;
+        }
+      }
+      return T((a+b)/2.0L);
+    }
+
+    template<typename T>
+    void batchTest(const BatchRoot method,const T eps) {
+      const T nan = std::numeric_limits<T>::quiet_NaN();
+      const T ulp = std::numeric_limits<T>::epsilon();
+
+      // sizes around the register widths and the blocks
+      const size_t sizes[] = { 1, 5, 37, 256, 300, 1000 };
+      for (size_t n : sizes) {
+        std::vector<T> p(n),xl(n,T(-3)),xu(n,T(3)),roots(n);
+        for (size_t i=0;i<n;++i) {
+          p[i] = T(-10) + T(20)*T(i)/T(n);
+        }
+
+        // reversed, without sign change, with a root at an end, and NaN
+        if (n > 4) {
+          xl[0] = T(3); xu[0] = T(-3);
+          p[1] = T(0); xl[1] = T(1); xu[1] = T(2);
+          p[2] = T(2); xl[2] = T(1);
+          xu[3] = nan;
+        }
+
+        rootBatch(cubics<T>(p),xl.data(),xu.data(),roots.data(),n,eps,method);
+
+        for (size_t i=0;i<n;++i) {
+          if ((n > 4) && (i==0 || i==1 || i==3)) {
+            BOOST_CHECK( std::isnan(roots[i]) );
+            continue;
+          }
+          if ((n > 4) && (i == 2)) {
+            BOOST_CHECK( roots[i] == T(1) );
+            continue;
+          }
+          const T ref = cubicRoot(p[i]);
+          BOOST_CHECK( std::abs(roots[i]-ref) <= eps + T(8)*ulp*(T(1)+std::abs(ref)) );
+        }
+      }
+    }
+
+    template<typename T>
+    void batchMethods(const T eps) {
+      batchTest<T>(BatchRoot::Bisection,eps);
+      batchTest<T>(BatchRoot::RegulaFalsi,eps);
+      batchTest<T>(BatchRoot::Brent,eps);
+    }
+
+    /// The matrix version must match the array version, padding or not
+    template<typename T>
+    void batchMatrixTest() {
+      typedef Matrix<T> matrix_type;
+      const size_t rows = 7, cols = 13;
+
+      std::vector<T> p(rows*cols);
+      matrix_type xl(rows,cols,T(-3)),xu(rows,cols,T(3)),roots;
+      for (size_t i=0;i<p.size();++i) {
+        p[i] = T(i)/T(10);
+      }
+      xl(2,5) = T(5);
+
+      rootBatch(cubics<T>(p),xl,xu,roots,T(1e-5));
+      BOOST_CHECK( (roots.rows() == rows) && (roots.cols() == cols) );
+
+      std::vector<T> l(p.size(),T(-3)),u(p.size(),T(3)),r(p.size());
+      l[2*cols+5] = T(5);
+      rootBatch(cubics<T>(p),l.data(),u.data(),r.data(),r.size(),T(1e-5));
+
+      for (size_t i=0;i<rows;++i) {
+        for (size_t j=0;j<cols;++j) {
+          const T x = r[i*cols+j];
+          BOOST_CHECK( (roots(i,j) == x) ||
+                       (std::isnan(roots(i,j)) && std::isnan(x)) );
+        }
+      }
+      BOOST_CHECK( std::isnan(roots(2,5)) );
+
+      matrix_type bad(rows,cols+1,T(3));
+      BOOST_CHECK_THROW( rootBatch(cubics<T>(p),xl,bad,roots,T(1e-5)),
+                         anpi::Exception );
+    }
+
+  } // test
+} // anpi
+
+BOOST_AUTO_TEST_SUITE( RootBatch )
+
+BOOST_AUTO_TEST_CASE(Methods) {
+  anpi::test::forEachIsa([&] {
+    anpi::test::batchMethods<float>(1e-5f);
+    anpi::test::batchMethods<double>(1e-10);
+  });
+
+  // types without registers take the scalar lanes
+  anpi::test::batchMethods<long double>(1e-12L);
+}
+
+BOOST_AUTO_TEST_CASE(Matrices) {
+  anpi::test::batchMatrixTest<float>();
+  anpi::test::batchMatrixTest<double>();
+}
+
+BOOST_AUTO_TEST_CASE(Parallel) {
+  // blocks solved in different threads must give the same roots
+  const size_t n = 5000;
+  std::vector<double> p(n),xl(n,-3.0),xu(n,3.0),serial(n),split(n);
+  for (size_t i=0;i<n;++i) {
+    p[i] = std::sin(double(i));
+  }
+
+  const anpi::test::parallelGuard guard;
+  anpi::parallel::setThreshold(std::numeric_limits<size_t>::max());
+  anpi::rootBatch(anpi::test::cubics<double>(p),
+                  xl.data(),xu.data(),serial.data(),n,1e-12);
+  anpi::parallel::setThreshold(1);
+  anpi::rootBatch(anpi::test::cubics<double>(p),
+                  xl.data(),xu.data(),split.data(),n,1e-12);
+
+  BOOST_CHECK( serial == split );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -15,6 +15,9 @@
 #include "RootSecant.hpp"
 #include "RootNewtonRaphson.hpp"
 #include "RootBrent.hpp"
+#include "RootHalley.hpp"
+#include "RootHouseholder.hpp"
+#include "RootOstrowski.hpp"
 
 #include <iostream>
 #include <exception>
@@ -102,6 +105,225 @@ namespace anpi {
         BOOST_CHECK(std::abs(t3<T>(sol))<eps);
       }
     }
+
+    /// Counts the evaluations of t1, to check that it is not copied
+    template<typename T>
+    struct counted {
+      int calls;
+      counted() : calls(0) {}
+      T operator()(const T x) { ++calls; return t1<T>(x); }
+    };
+
+    /// The callable overloads give the same roots as the std::function ones
+    template<typename T>
+    void callableTest() {
+      const T eps=static_cast<T>(1.0e-5);
+      const std::function<T(T)> f1(t1<T>);
+      auto l1 = [](const T x) { return std::abs(x)-std::exp(-x); };
+      T (*p1)(const T) = t1<T>;
+
+      BOOST_CHECK(rootBisection(l1,T(0),T(2),eps) ==
+                  rootBisection(f1,T(0),T(2),eps));
+      BOOST_CHECK(rootBisection(p1,T(0),T(2),eps) ==
+                  rootBisection(f1,T(0),T(2),eps));
+      BOOST_CHECK(rootInterpolation(l1,T(0),T(2),eps) ==
+                  rootInterpolation(f1,T(0),T(2),eps));
+      BOOST_CHECK(rootSecant(l1,T(0),T(2),eps) ==
+                  rootSecant(f1,T(0),T(2),eps));
+      BOOST_CHECK(rootNewtonRaphson(l1,T(0),eps) ==
+                  rootNewtonRaphson(f1,T(0),eps));
+      BOOST_CHECK(rootBrent(l1,T(0),T(2),eps) ==
+                  rootBrent(f1,T(0),T(2),eps));
+
+      // a stateful functor is called by reference
+      counted<T> c;
+      const T sol = rootBisection(c,T(0),T(2),eps);
+      BOOST_CHECK(std::abs(t1<T>(sol)) < eps);
+      BOOST_CHECK(c.calls > 2);
+
+      BOOST_CHECK_THROW(rootBrent(l1,T(2),T(0),eps),Exception);
+    }
+
+    /// t1 for any number type, such as Dual<T>
+    struct g1 {
+      template<typename U>
+      U operator()(const U& x) const {
+        using std::abs; using std::exp;
+        return abs(x)-exp(-x);
+      }
+    };
+
+    /// t2 for any number type, such as Dual<T>
+    struct g2 {
+      template<typename U>
+      U operator()(const U& x) const {
+        using std::exp;
+        return exp(-x*x) - exp(-(x-3)*(x-3)/3);
+      }
+    };
+
+    /// t3 for any number type, such as Dual<T>
+    struct g3 {
+      template<typename U>
+      U operator()(const U& x) const {
+        using std::atan;
+        return x*x-atan(x);
+      }
+    };
+
+    /// Derivative of t1
+    template<typename T>
+    T d1(const T x)  { return ((x < T(0)) ? T(-1) : T(1)) + std::exp(-x); }
+
+    /// Derivative of t2
+    template<typename T>
+    T d2(const T x) {
+      return -T(2)*x*std::exp(-x*x) +
+        T(2)*(x-T(3))/T(3)*std::exp(-sqr(x-T(3))/T(3));
+    }
+
+    /// Derivative of t3
+    template<typename T>
+    T d3(const T x)  { return T(2)*x - T(1)/(T(1)+x*x); }
+
+    /// Counts the evaluations of t3 on any number type
+    struct counted3 {
+      int calls;
+      counted3() : calls(0) {}
+      template<typename U>
+      U operator()(const U& x) { ++calls; return g3()(x); }
+    };
+
+    /// Newton-Raphson with automatic and with analytic derivatives
+    template<typename T>
+    void derivativeTest() {
+      for (T eps=T(1)/T(10); eps>static_cast<T>(1.0e-7); eps/=T(10)) {
+        T sol = rootNewtonRaphsonAD(g1(),T(0),eps);
+        BOOST_CHECK(std::abs(t1<T>(sol))<eps);
+        sol = rootNewtonRaphsonAD(g2(),T(2),eps);
+        BOOST_CHECK(std::abs(t2<T>(sol))<eps);
+        sol = rootNewtonRaphsonAD(g3(),T(1),eps);
+        BOOST_CHECK(std::abs(t3<T>(sol))<eps);
+
+        sol = rootNewtonRaphson(t1<T>,d1<T>,T(0),eps);
+        BOOST_CHECK(std::abs(t1<T>(sol))<eps);
+        sol = rootNewtonRaphson(t2<T>,d2<T>,T(2),eps);
+        BOOST_CHECK(std::abs(t2<T>(sol))<eps);
+        sol = rootNewtonRaphson(t3<T>,d3<T>,T(1),eps);
+        BOOST_CHECK(std::abs(t3<T>(sol))<eps);
+      }
+
+      // same iterates as the analytic derivative, one call per iteration
+      const T eps=static_cast<T>(1.0e-6);
+      counted3 ad,fd;
+      BOOST_CHECK(rootNewtonRaphsonAD(ad,T(1),eps) ==
+                  rootNewtonRaphson(t3<T>,d3<T>,T(1),eps));
+      rootNewtonRaphson([&fd](const T x) { return fd(x); },T(1),eps);
+      BOOST_CHECK(0 < ad.calls);
+      BOOST_CHECK(ad.calls < fd.calls);
+    }
+
+    /// Second derivative of t3
+    template<typename T>
+    T dd3(const T x)  { return T(2) + T(2)*x/sqr(T(1)+x*x); }
+
+    /// Third derivative of t3
+    template<typename T>
+    T ddd3(const T x) { return (T(2)-T(6)*x*x)/(sqr(T(1)+x*x)*(T(1)+x*x)); }
+
+    /// atan for any number type, whose Newton steps overshoot far away
+    struct gAtan {
+      template<typename U>
+      U operator()(const U& x) const { using std::atan; return atan(x); }
+    };
+
+    /// Solve t1, t2 and t3 with a closed solver on functions of any type
+    template<typename T,class Solver>
+    void higherOrderTest(const Solver& solver) {
+      const T eps0=static_cast<T>(0.001);
+      BOOST_CHECK_THROW(solver(g1(),T(2),T(0),eps0),Exception);
+      BOOST_CHECK_THROW(solver(g3(),T(1),T(2),eps0),Exception);
+
+      for (T eps=T(1)/T(10); eps>static_cast<T>(1.0e-7); eps/=T(10)) {
+        T sol = solver(g1(),T(0),T(2),eps);
+        BOOST_CHECK(std::abs(t1<T>(sol)) < eps);
+        sol = solver(g2(),T(0),T(2),eps);
+        BOOST_CHECK(std::abs(t2<T>(sol)) < eps);
+        sol = solver(g3(),T(0),T(0.5),eps);
+        BOOST_CHECK(std::abs(t3<T>(sol)) < eps);
+        sol = solver(g3(),T(0.5),T(2),eps);
+        BOOST_CHECK(std::abs(t3<T>(sol)) < eps);
+
+        // the bisection safeguard keeps the steps inside the bracket
+        sol = solver(gAtan(),T(-1),T(20),eps);
+        BOOST_CHECK(std::abs(sol) < eps);
+      }
+    }
+
+    struct halley {
+      template<typename T,class F>
+      T operator()(F f,T xl,T xu,T eps) const {
+        return rootHalley(f,xl,xu,eps);
+      }
+    };
+
+    struct householder {
+      template<typename T,class F>
+      T operator()(F f,T xl,T xu,T eps) const {
+        return rootHouseholder(f,xl,xu,eps);
+      }
+    };
+
+    struct ostrowski {
+      template<typename T,class F>
+      T operator()(F f,T xl,T xu,T eps) const {
+        return rootOstrowski(f,xl,xu,eps);
+      }
+    };
+
+    /// Derivatives given by the user instead of automatic ones
+    template<typename T>
+    void userDerivativeTest() {
+      const T eps=static_cast<T>(1.0e-6);
+      const T root=rootBrent(t3<T>,T(0.5),T(2),eps);
+      BOOST_CHECK(std::abs(rootHalley(t3<T>,d3<T>,dd3<T>,
+                                      T(0.5),T(2),eps)-root) < eps);
+      BOOST_CHECK(std::abs(rootHouseholder(t3<T>,d3<T>,dd3<T>,ddd3<T>,
+                                           T(0.5),T(2),eps)-root) < eps);
+      BOOST_CHECK(std::abs(rootOstrowski(t3<T>,d3<T>,
+                                         T(0.5),T(2),eps)-root) < eps);
+
+      // automatic derivatives take the same steps
+      BOOST_CHECK(std::abs(rootHalley(g3(),T(0.5),T(2),eps) -
+                           rootHalley(t3<T>,d3<T>,dd3<T>,T(0.5),T(2),eps))
+                  <= T(4)*std::numeric_limits<T>::epsilon());
+
+      // fewer evaluations than Newton with finite differences
+      counted3 h,o,n;
+      rootHalley(h,T(0.5),T(2),eps);
+      rootOstrowski(o,T(0.5),T(2),eps);
+      rootNewtonRaphson([&n](const T x) { return n(x); },T(2),eps);
+      BOOST_CHECK(h.calls < n.calls);
+      BOOST_CHECK(o.calls < n.calls);
+
+      // the evaluation at the Newton point of Ostrowski's step shrinks
+      // the bracket, even if the safeguard rejects the step
+      {
+        g3 f;
+        bits::ostrowskiStep<g3> step = { f };
+        bits::bracket<T> br = { T(0.5),T(2),t3<T>(T(0.5)),t3<T>(T(2)) };
+        const T y = T(2) - t3<T>(T(2))/d3<T>(T(2));
+        const bits::derivatives<T> d = { t3<T>(T(2)),d3<T>(T(2)),T(0),T(0) };
+        step(T(2),d,br);
+        BOOST_CHECK(br.a == T(0.5) && br.b == y);
+        BOOST_CHECK(br.fb == t3<T>(y));
+        BOOST_CHECK(br.a < root && root < br.b);
+
+        // a root at the Newton point closes the bracket
+        br.shrink(root,T(0));
+        BOOST_CHECK(br.a == root && br.b == root && br.best() == root);
+      }
+    }
   } // test
 }  // anpi
 
@@ -133,10 +355,34 @@ BOOST_AUTO_TEST_CASE(NewtonRaphson)
   anpi::test::rootTest<double>(anpi::rootNewtonRaphson<double>);
 }
 
+BOOST_AUTO_TEST_CASE(Derivatives)
+{
+  anpi::test::derivativeTest<float>();
+  anpi::test::derivativeTest<double>();
+}
+
+BOOST_AUTO_TEST_CASE(HigherOrder)
+{
+  anpi::test::higherOrderTest<float>(anpi::test::halley());
+  anpi::test::higherOrderTest<double>(anpi::test::halley());
+  anpi::test::higherOrderTest<float>(anpi::test::householder());
+  anpi::test::higherOrderTest<double>(anpi::test::householder());
+  anpi::test::higherOrderTest<float>(anpi::test::ostrowski());
+  anpi::test::higherOrderTest<double>(anpi::test::ostrowski());
+  anpi::test::userDerivativeTest<float>();
+  anpi::test::userDerivativeTest<double>();
+}
+
 BOOST_AUTO_TEST_CASE(Brent) 
 {
   anpi::test::rootTest<float>(anpi::rootBrent<float>);
   anpi::test::rootTest<double>(anpi::rootBrent<double>);
 }
 
+BOOST_AUTO_TEST_CASE(Callables)
+{
+  anpi::test::callableTest<float>();
+  anpi::test::callableTest<double>();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
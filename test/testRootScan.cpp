@@ -0,0 +1,144 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date  : 10.02.2018
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "RootScan.hpp"
+#include "testSimd.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace anpi {
+  namespace test {
+
+    /// Check that roots are sorted, and each one within tol of expected
+    template<typename T>
+    void checkRoots(const std::vector<T>& roots,
+                    const std::vector<T>& expected,
+                    const T tol) {
+      BOOST_CHECK_EQUAL( roots.size(), expected.size() );
+      for (size_t i=0;i<std::min(roots.size(),expected.size());++i) {
+        BOOST_CHECK( std::abs(roots[i]-expected[i]) <= tol );
+        if (i>0) {
+          BOOST_CHECK( roots[i-1] < roots[i] );
+        }
+      }
+    }
+
+    template<typename T>
+    void scanTest(const T eps) {
+      const T pi = T(3.14159265358979323846L);
+
+      // simple roots at k*pi
+      {
+        std::vector<T> expected;
+        for (int k=1;k<=6;++k) {
+          expected.push_back(T(k)*pi);
+        }
+        checkRoots(rootScan([](const T x) { return std::sin(x); },
+                            T(0.5),T(20),eps),expected,eps);
+      }
+
+      // a touching root at 1 and a simple one at -2
+      {
+        const std::vector<T> expected = { T(-2), T(1) };
+        auto f = [](const T x) { return (x-T(1))*(x-T(1))*(x+T(2)); };
+        checkRoots(rootScan(f,T(-3),T(3.1),eps,100),expected,
+                   std::sqrt(eps));
+      }
+
+      // a minimum that misses zero has no roots
+      {
+        auto f = [](const T x) { return (x-T(1))*(x-T(1)) + T(1e-3); };
+        BOOST_CHECK( rootScan(f,T(-3),T(3.1),eps,100).empty() );
+      }
+
+      // two roots 1±0.01 inside a single subinterval around the minimum
+      {
+        const std::vector<T> expected = { T(0.99), T(1.01) };
+        auto f = [](const T x) { return (x-T(1))*(x-T(1)) - T(1e-4); };
+        checkRoots(rootScan(f,T(-3),T(3.1),eps,100),expected,eps);
+      }
+
+      // roots at the ends of the interval, and a degenerate interval
+      {
+        const std::vector<T> expected = { T(0), T(1) };
+        auto f = [](const T x) { return x*(x-T(1)); };
+        checkRoots(rootScan(f,T(0),T(1),eps,7),expected,T(0));
+        checkRoots(rootScan(f,T(1),T(1),eps),std::vector<T>(1,T(1)),T(0));
+      }
+    }
+
+  } // test
+} // anpi
+
+BOOST_AUTO_TEST_SUITE( RootScan )
+
+BOOST_AUTO_TEST_CASE(Roots) {
+  anpi::test::scanTest<float>(1e-5f);
+  anpi::test::scanTest<double>(1e-10);
+}
+
+BOOST_AUTO_TEST_CASE(Errors) {
+  auto f = [](const double x) { return x; };
+  BOOST_CHECK_THROW( anpi::rootScan(f,1.0,-1.0,1e-6), anpi::Exception );
+  BOOST_CHECK_THROW( anpi::rootScan(f,-1.0,1.0,1e-6,0), anpi::Exception );
+  BOOST_CHECK_THROW( anpi::rootScan(f,0.0,std::nan(""),1e-6),
+                     anpi::Exception );
+}
+
+BOOST_AUTO_TEST_CASE(Blocks) {
+  // a block callable sees aligned blocks and finds the same roots
+  auto f = [](const double x) { return std::sin(50*x)+0.25*std::cos(3*x); };
+  bool aligned = true;
+  auto block = [&](const double* x,double* fx,const size_t,const size_t n) {
+    if ( (reinterpret_cast<std::uintptr_t>(x) % 64 != 0) ||
+         (reinterpret_cast<std::uintptr_t>(fx) % 64 != 0) ) {
+      aligned = false;
+    }
+    for (size_t k=0;k<n;++k) {
+      fx[k] = std::sin(50*x[k])+0.25*std::cos(3*x[k]);
+    }
+  };
+
+  const anpi::test::parallelGuard guard;
+  anpi::parallel::setThreshold(std::numeric_limits<size_t>::max());
+  const std::vector<double> scalar = anpi::rootScan(f,0.0,10.0,1e-12,4096);
+  const std::vector<double> batched =
+    anpi::rootScanBatch(block,0.0,10.0,1e-12,4096);
+
+  BOOST_CHECK( aligned );
+  BOOST_CHECK( scalar == batched );
+  BOOST_CHECK_THROW( anpi::rootScanBatch(block,1.0,-1.0,1e-6),
+                     anpi::Exception );
+}
+
+BOOST_AUTO_TEST_CASE(Parallel) {
+  // sampling and refinement split among threads give the same roots
+  auto f = [](const double x) { return std::sin(50*x)+0.25*std::cos(3*x); };
+
+  const anpi::test::parallelGuard guard;
+  anpi::parallel::setThreshold(std::numeric_limits<size_t>::max());
+  const std::vector<double> serial = anpi::rootScan(f,0.0,10.0,1e-12,4096);
+  anpi::parallel::setThreshold(1);
+  const std::vector<double> split = anpi::rootScan(f,0.0,10.0,1e-12,4096);
+
+  BOOST_CHECK( serial == split );
+  BOOST_CHECK( serial.size() > 150 );
+  for (const double r : serial) {
+    BOOST_CHECK( std::abs(f(r)) < 1e-9 );
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,84 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date  : 07.01.2018
+ */
+
+#ifndef ANPI_TEST_SIMD_HPP
+#define ANPI_TEST_SIMD_HPP
+
+#include <boost/test/unit_test.hpp>
+
+#include "CpuFeatures.hpp"
+#include "Parallel.hpp"
+
+/*
+ * Helpers shared by the tests of the SIMD dispatched kernels
+ */
+
+namespace anpi {
+  namespace test {
+
+    /// Restores the instruction set level active at construction
+    class isaGuard {
+      const simd::Isa _previous;
+    public:
+      isaGuard() : _previous(simd::isa()) {}
+      ~isaGuard() { simd::setIsa(_previous); }
+
+      /// Level active at construction
+      simd::Isa previous() const { return _previous; }
+    private:
+      isaGuard(const isaGuard&);
+      isaGuard& operator=(const isaGuard&);
+    };
+
+    /// Restores the thread settings of the kernels active at construction
+    class parallelGuard {
+      const size_t _threads;
+      const size_t _threshold;
+    public:
+      parallelGuard()
+        : _threads(parallel::_threads()), _threshold(parallel::threshold()) {}
+      ~parallelGuard() {
+        parallel::setThreads(_threads);
+        parallel::setThreshold(_threshold);
+      }
+    private:
+      parallelGuard(const parallelGuard&);
+      parallelGuard& operator=(const parallelGuard&);
+    };
+
+    /// Restores the streaming threshold active at construction
+    class streamingGuard {
+      const size_t _previous;
+    public:
+      streamingGuard() : _previous(simd::streamingThreshold()) {}
+      ~streamingGuard() { simd::setStreamingThreshold(_previous); }
+    private:
+      streamingGuard(const streamingGuard&);
+      streamingGuard& operator=(const streamingGuard&);
+    };
+
+    /**
+     * Call fn() once with each instruction set level supported by this
+     * CPU.  The previous level is restored afterwards, also if fn throws.
+     */
+    template<class F>
+    void forEachIsa(F fn) {
+      const isaGuard guard;
+      for (int l=int(simd::Isa::None);l<=int(simd::detectIsa());++l) {
+        simd::setIsa(simd::Isa(l));
+        BOOST_REQUIRE( simd::isa() == simd::Isa(l) );
+        fn();
+      }
+    }
+
+  } // test
+} // anpi
+
+#endif
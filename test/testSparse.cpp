@@ -0,0 +1,135 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ *
+ * @Author: Pablo Alvarado
+ * @Date  : 09.01.2018
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "SparseMatrix.hpp"
+#include "testFactorization.hpp"
+#include "testSimd.hpp"
+
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+namespace anpi {
+  namespace test {
+
+    /// Product of a dense matrix with a vector
+    template<typename T,class Alloc>
+    std::vector<T> denseProduct(const Matrix<T,Alloc>& A,
+                                const std::vector<T>& x) {
+      std::vector<T> y(A.rows(),T(0));
+      for (size_t r=0;r<A.rows();++r) {
+        for (size_t c=0;c<A.cols();++c) {
+          y[r] += A(r,c)*x[c];
+        }
+      }
+      return y;
+    }
+
+    template<typename T>
+    void sparseTest() {
+      typedef Matrix<T> matrix_type;
+      const T eps = T(100)*std::numeric_limits<T>::epsilon();
+
+      // construction from triplets, in any order and with repetitions
+      {
+        std::vector< Triplet<T> > entries = {
+          {2,1,T(4)}, {0,0,T(1)}, {2,3,T(5)}, {0,2,T(2)},
+          {2,1,T(1)}, {1,3,T(3)}, {3,0,T(0)}
+        };
+        SparseMatrix<T> S(4,4,entries);
+        BOOST_CHECK( S.rows() == 4 );
+        BOOST_CHECK( S.cols() == 4 );
+        BOOST_CHECK( S.nonZeros() == 6 );
+        BOOST_CHECK( S(2,1) == T(5) );
+        BOOST_CHECK( S(1,3) == T(3) );
+        BOOST_CHECK( S(1,1) == T(0) );
+
+        matrix_type D;
+        S.toDense(D);
+        matrix_type E = { { T(1),T(0),T(2),T(0) },
+                          { T(0),T(0),T(0),T(3) },
+                          { T(0),T(5),T(0),T(5) },
+                          { T(0),T(0),T(0),T(0) } };
+        BOOST_CHECK( D == E );
+
+        entries.push_back(Triplet<T>(4,0,T(1)));
+        BOOST_CHECK_THROW( SparseMatrix<T>(4,4,entries), anpi::Exception );
+      }
+
+      // round trip through dense and products, with rows of every
+      // length around the register widths
+      const size_t sizes[] = { 1, 7, 33, 130 };
+      for (size_t n : sizes) {
+        matrix_type A(n,n+3);
+        randomFill(A,unsigned(n));
+        for (size_t r=0;r<A.rows();++r) {
+          for (size_t c=0;c<A.cols();++c) {
+            // keep the first (r % 20) entries of the row, plus the diagonal
+            if ( (c >= (r % 20)) && (c != r) ) {
+              A(r,c) = T(0);
+            }
+          }
+        }
+
+        SparseMatrix<T> S(A);
+        matrix_type D;
+        S.toDense(D);
+        BOOST_CHECK( D == A );
+
+        std::vector<T> x(A.cols());
+        for (size_t i=0;i<x.size();++i) {
+          x[i] = T(i%9) - T(4);
+        }
+        const std::vector<T> yd = denseProduct(A,x);
+        const std::vector<T> ys = S*x;
+        BOOST_CHECK( ys.size() == n );
+        for (size_t i=0;i<n;++i) {
+          BOOST_CHECK( std::abs(ys[i]-yd[i]) < eps*T(20) );
+        }
+      }
+
+      {
+        SparseMatrix<T> S(3,2,std::vector< Triplet<T> >());
+        std::vector<T> x(3),y;
+        BOOST_CHECK_THROW( multiply(S,x,y), anpi::Exception );
+        x.resize(2);
+        multiply(S,x,y);
+        BOOST_CHECK( (y.size() == 3) && (y[0] == T(0)) );
+      }
+    }
+
+  } // test
+} // anpi
+
+BOOST_AUTO_TEST_SUITE( Sparse )
+
+BOOST_AUTO_TEST_CASE(CSR) {
+  anpi::test::sparseTest<float>();
+  anpi::test::sparseTest<double>();
+
+  // types without SIMD kernels
+  anpi::SparseMatrix< std::complex<double> > S(2,2,{{1,0,{0.0,1.0}}});
+  std::vector< std::complex<double> > x = { {1.0,0.0}, {2.0,0.0} };
+  BOOST_CHECK( (S*x)[1] == std::complex<double>(0.0,1.0) );
+}
+
+BOOST_AUTO_TEST_CASE(Dispatch) {
+  // the gather kernels with every level supported by this CPU
+  anpi::test::forEachIsa([&] {
+    anpi::test::sparseTest<float>();
+    anpi::test::sparseTest<double>();
+  });
+}
+
+BOOST_AUTO_TEST_SUITE_END()